@@ -0,0 +1,276 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: benchmark and regression harness of tlap, make bench
+// File version: 0.1
+#pragma once
+
+#include "simd/simd.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+# include <x86intrin.h>
+#endif
+
+// every row is one (suite, name, type, variant, size) point:
+// - variant: "tlap" is the public API as an application calls it (dispatched
+//   isa, threads), a level name ("scalar", "avx2", "avx512") runs that level
+//   of the dispatched kernels on one thread, "std" / "naive" is the reference
+//   the standard library or a plain loop gives
+// - path: the isa the row actually ran
+// - items: the work of one call (elements, or flops for the products)
+// - the time is the median of several samples, each timing a batch of calls
+//   long enough for the clock, after warmup calls; cycles are those of the
+//   time stamp counter (constant rate, not the core clock)
+// - ulp: error of the results in units in the last place of the type against
+//   a long double reference, for the math functions (-1: not measured)
+// inputs are generated before the timed regions. the products and the io
+// round trips also check their results against a plain reference after
+// timing (suite::check): a wrong result fails the run, whatever the isa and
+// the optimization level (make bench-O0).
+namespace bench {
+	struct	options {
+		double		sampleSeconds = 0.002; // least time of one sample
+		size_t		samples = 9;
+		bool		quick = false; // fewer sizes and samples, for a smoke run
+		std::string	filter; // rows whose suite/name contain it, all when empty
+	};
+
+	struct	result {
+		std::string	suite;
+		std::string	name;
+		std::string	type;
+		std::string	variant;
+		std::string	path;
+		size_t		size = 0;
+		double		items = 0;
+		double		nsPerCall = 0;
+		double		cyclesPerCall = 0;
+		double		ulpMax = -1;
+		double		ulpMean = -1;
+
+		std::string	key() const;
+		double		nsPerItem() const;
+		double		cyclesPerItem() const;
+	};
+
+	// max |got - want| over max |want|: the error of a whole result, so that
+	// one tiny reference element does not dominate
+	struct	error_meter {
+		double	diff = 0;
+		double	scale = 0;
+
+		void	add(double got, double want);
+		double	relative() const;
+	};
+
+	class	suite {
+		private:
+			options						_options;
+			std::vector<result>			_results;
+			std::vector<std::string>	_failures;
+
+		public:
+			explicit suite(const options &o);
+
+			const options		&settings() const;
+			bool				wants(const std::string &suite, const std::string &name) const;
+			std::vector<size_t>	sizes(std::initializer_list<size_t> all) const; // the smallest, a middle and the largest one when quick
+
+			// times f() and appends the row
+			template <typename F>
+			result				&run(const std::string &suite, const std::string &name, const std::string &type,
+									const std::string &variant, const std::string &path, size_t size, double items, F f);
+
+			// a result against its reference: an error above bound is a failure
+			bool				check(const std::string &suite, const std::string &name, const std::string &type,
+									size_t size, double error, double bound);
+
+			const std::vector<result>		&results() const;
+			const std::vector<std::string>	&failures() const;
+	};
+
+	template <typename T>
+	constexpr const char	*type_name() {
+		if constexpr (std::is_same<T, float>::value)
+			return "float";
+		else if constexpr (std::is_same<T, double>::value)
+			return "double";
+		else if constexpr (std::is_same<T, tlap::half>::value)
+			return "half";
+		else if constexpr (std::is_same<T, tlap::bfloat16>::value)
+			return "bfloat16";
+		else if constexpr (std::is_same<T, int8_t>::value)
+			return "int8";
+		else if constexpr (std::is_same<T, uint8_t>::value)
+			return "uint8";
+		else
+			return "int";
+	}
+
+	// the compiler must assume p is read and written
+	inline void	keep(const void *p) {
+		asm volatile("" : : "g"(p) : "memory");
+	}
+
+	inline uint64_t	cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+		return __rdtsc();
+#else
+		return 0;
+#endif
+	}
+
+	// |got - want| in units in the last place of T at want
+	template <typename T>
+	double		ulp(T got, long double want);
+
+	// output and baseline
+	void		write_csv(std::ostream &out, const std::vector<result> &results);
+	std::vector<result>	read_csv(std::istream &in);
+	size_t		compare(const suite &current, const std::vector<result> &baseline, double tolerance, std::ostream &report); // regressions
+	void		speedups(const std::vector<result> &results, std::ostream &report); // tlap rows against their std row
+
+	// the suites, one file each
+	void		math(suite &s);
+	void		vector(suite &s);
+	void		matrix(suite &s);
+	void		random(suite &s);
+	void		io(suite &s);
+}
+
+// implementations
+
+namespace bench {
+
+inline std::string	result::key() const {
+	return suite + "," + name + "," + type + "," + variant + "," + std::to_string(size);
+}
+
+inline double	result::nsPerItem() const {
+	return (items > 0 ? nsPerCall / items : 0);
+}
+
+inline double	result::cyclesPerItem() const {
+	return (items > 0 ? cyclesPerCall / items : 0);
+}
+
+inline void	error_meter::add(double got, double want) {
+	diff = std::max(diff, (got == want ? 0.0 : std::fabs(got - want))); // nan and inf compare exactly
+	if (std::isnan(got) != std::isnan(want))
+		diff = std::numeric_limits<double>::infinity();
+	scale = std::max(scale, std::fabs(want));
+}
+
+inline double	error_meter::relative() const {
+	return (diff == 0 ? 0.0 : diff / std::max(scale, std::numeric_limits<double>::min()));
+}
+
+inline suite::suite(const options &o)
+	: _options(o) {
+	if (_options.quick) {
+		_options.samples = std::min<size_t>(_options.samples, 3);
+		_options.sampleSeconds = std::min(_options.sampleSeconds, 0.0005);
+	}
+}
+
+inline const options	&suite::settings() const {
+	return _options;
+}
+
+inline bool	suite::wants(const std::string &suite, const std::string &name) const {
+	return _options.filter.empty() || (suite + "/" + name).find(_options.filter) != std::string::npos;
+}
+
+inline std::vector<size_t>	suite::sizes(std::initializer_list<size_t> all) const {
+	std::vector<size_t>	v(all);
+	if (_options.quick && v.size() > 3)
+		v = {v.front(), v[v.size() / 2], v.back()};
+	return v;
+}
+
+template <typename F>
+result	&suite::run(const std::string &suite, const std::string &name, const std::string &type,
+			const std::string &variant, const std::string &path, size_t size, double items, F f) {
+	using clock = std::chrono::steady_clock;
+	struct	sample { double ns; double cycles; };
+
+	auto timed = [&](size_t calls) {
+		const uint64_t			c0 = cycles();
+		const clock::time_point	t0 = clock::now();
+		for (size_t i = 0; i < calls; ++i)
+			f();
+		const clock::time_point	t1 = clock::now();
+		const uint64_t			c1 = cycles();
+		return sample{std::chrono::duration<double, std::nano>(t1 - t0).count(), static_cast<double>(c1 - c0)};
+	};
+
+	// warmup: first touch of the buffers, pool start, dispatch, caches
+	timed(2);
+	size_t	batch = 1;
+	for (;;) {
+		const double	ns = timed(batch).ns;
+		if (ns >= _options.sampleSeconds * 1e9 || batch >= (size_t(1) << 30))
+			break;
+		const double	grow = (ns > 0 ? _options.sampleSeconds * 1e9 / ns * 1.2 : 16.0);
+		batch = std::max(batch * 2, static_cast<size_t>(static_cast<double>(batch) * std::min(grow, 1024.0)));
+	}
+	std::vector<sample>	samples;
+	for (size_t i = 0; i < _options.samples; ++i)
+		samples.push_back(timed(batch));
+	std::sort(samples.begin(), samples.end(), [](const sample &a, const sample &b) { return a.ns < b.ns; });
+	const sample	&median = samples[samples.size() / 2];
+
+	result	r;
+	r.suite = suite;
+	r.name = name;
+	r.type = type;
+	r.variant = variant;
+	r.path = path;
+	r.size = size;
+	r.items = items;
+	r.nsPerCall = median.ns / static_cast<double>(batch);
+	r.cyclesPerCall = median.cycles / static_cast<double>(batch);
+	_results.push_back(r);
+	return _results.back();
+}
+
+inline bool	suite::check(const std::string &suite, const std::string &name, const std::string &type,
+				size_t size, double error, double bound) {
+	if (error <= bound)
+		return true;
+	_failures.push_back(suite + "," + name + "," + type + "," + std::to_string(size) + "  error " + std::to_string(error)
+		+ " over " + std::to_string(bound));
+	return false;
+}
+
+inline const std::vector<result>	&suite::results() const {
+	return _results;
+}
+
+inline const std::vector<std::string>	&suite::failures() const {
+	return _failures;
+}
+
+template <typename T>
+double	ulp(T got, long double want) {
+	const T	w = static_cast<T>(want);
+	if (std::isnan(got) || std::isnan(w))
+		return (std::isnan(got) && std::isnan(w) ? 0.0 : std::numeric_limits<double>::infinity());
+	if (std::isinf(got) || std::isinf(w))
+		return (got == w ? 0.0 : std::numeric_limits<double>::infinity());
+	// the spacing of T around want, the smallest subnormal at worst
+	int				e = 0;
+	std::frexp(want, &e);
+	const long double	step = std::max(std::ldexp(1.0L, e - std::numeric_limits<T>::digits),
+		static_cast<long double>(std::numeric_limits<T>::denorm_min()));
+	return static_cast<double>(std::fabs(static_cast<long double>(got) - want) / step);
+}
+
+} // namespace bench
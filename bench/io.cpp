@@ -0,0 +1,102 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: binary file round trips: save then load or map, checked exactly
+// File version: 0.1
+
+#include "bench.hpp"
+#include "io/binary.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <random>
+
+namespace bench {
+
+namespace {
+
+// a round trip gives the elements back bit for bit: bound 0. items are the
+// elements of one save and one load, through the page cache
+template <typename T>
+void	roundtrips(suite &s) {
+	const std::string	path = (std::filesystem::temp_directory_path() / "tlap_bench_io.tlap").string();
+
+	for (size_t n : s.sizes({1024, 65536, 1 << 20})) {
+		std::mt19937							gen(5);
+		std::uniform_real_distribution<double>	dis(-1, 1);
+		const double							items = static_cast<double>(n);
+
+		if (s.wants("io", "vector")) {
+			tlap::Vector<T>	v(n);
+			tlap::Vector<T>	back;
+			for (size_t i = 0; i < n; ++i)
+				v[i] = static_cast<T>(dis(gen));
+			s.run("io", "vector", type_name<T>(), "tlap", "file", n, items, [&] {
+				tlap::io::save(path, v);
+				back = tlap::io::loadVector<T>(path);
+				keep(back.data());
+			});
+			error_meter	e;
+			for (size_t i = 0; i < n; ++i)
+				e.add(static_cast<double>(back[i]), static_cast<double>(v[i]));
+			s.check("io", "vector", type_name<T>(), n, (back.shape() == n ? e.relative() : 1.0), 0);
+			s.run("io", "vector_mapped", type_name<T>(), "tlap", "mmap", n, items, [&] {
+				tlap::io::save(path, v);
+				back = tlap::io::mapVector<T>(path);
+				keep(back.data());
+			});
+			error_meter	m;
+			for (size_t i = 0; i < n; ++i)
+				m.add(static_cast<double>(back[i]), static_cast<double>(v[i]));
+			s.check("io", "vector_mapped", type_name<T>(), n, (back.shape() == n ? m.relative() : 1.0), 0);
+			back = tlap::Vector<T>(); // the mapping, before the file goes
+		}
+		if (s.wants("io", "matrix")) {
+			const size_t	rows = n / 32;
+			const size_t	cols = 32 + 3; // padded rows
+			tlap::Matrix<T>	a(rows, cols);
+			tlap::Matrix<T>	back;
+			for (size_t i = 0; i < rows; ++i)
+				for (size_t j = 0; j < cols; ++j)
+					a(i, j) = static_cast<T>(dis(gen));
+			s.run("io", "matrix", type_name<T>(), "tlap", "file", n, static_cast<double>(rows * cols), [&] {
+				tlap::io::save(path, a);
+				back = tlap::io::loadMatrix<T>(path);
+				keep(back.data());
+			});
+			error_meter	e;
+			if (back.rows() == rows && back.cols() == cols)
+				for (size_t i = 0; i < rows; ++i)
+					for (size_t j = 0; j < cols; ++j)
+						e.add(static_cast<double>(back(i, j)), static_cast<double>(a(i, j)));
+			s.check("io", "matrix", type_name<T>(), n, (back.rows() == rows && back.cols() == cols ? e.relative() : 1.0), 0);
+		}
+		if (s.wants("io", "tensor")) {
+			tlap::Tensor<T>	t({n / 64, 64});
+			tlap::Tensor<T>	back;
+			T				*p = t.data();
+			for (size_t i = 0; i < t.size(); ++i)
+				p[i] = static_cast<T>(dis(gen));
+			const tlap::Tensor<T>	view = t.transpose(); // written row-major from the strides
+			const tlap::Tensor<T>	want = view.clone();
+			s.run("io", "tensor_transposed", type_name<T>(), "tlap", "file", n, items, [&] {
+				tlap::io::save(path, view);
+				back = tlap::io::loadTensor<T>(path);
+				keep(back.data());
+			});
+			error_meter	e;
+			const bool	same = back.shape() == want.shape() && back.strides() == want.strides();
+			if (same)
+				for (size_t i = 0; i < want.size(); ++i)
+					e.add(static_cast<double>(back.data()[i]), static_cast<double>(want.data()[i]));
+			s.check("io", "tensor_transposed", type_name<T>(), n, (same ? e.relative() : 1.0), 0);
+		}
+	}
+	std::remove(path.c_str());
+}
+
+} // namespace
+
+void	io(suite &s) {
+	roundtrips<float>(s);
+	roundtrips<double>(s);
+}
+
+} // namespace bench
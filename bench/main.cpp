@@ -0,0 +1,89 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: entry point of the benchmark suite, see bench.hpp
+// File version: 0.1
+
+#include "bench.hpp"
+#include "parallel/pool.hpp"
+#include "simd/dispatch.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+// bench_suite [--quick] [--filter text] [--samples n] [--out file.csv]
+//             [--baseline file.csv] [--tolerance 0.10]
+// the rows go to stdout (or --out) as csv; the machine, the isa paths and the
+// speedup of every tlap row over its std row (libm, <random>, plain loops) to
+// stderr. the exit status is 1 when a result differs from its reference, and
+// with --baseline the run is compared to a previous csv: 1 as well when a row
+// got slower by more than the tolerance, less accurate or went missing
+namespace {
+
+void	usage() {
+	std::cerr << "usage: bench_suite [--quick] [--filter text] [--samples n] [--out file.csv] "
+		"[--baseline file.csv] [--tolerance fraction]\n";
+	std::exit(2);
+}
+
+} // namespace
+
+int	main(int argc, char **argv) {
+	namespace dispatch = tlap::simd::dispatch;
+	bench::options	options;
+	std::string		out;
+	std::string		baseline;
+	double			tolerance = 0.10;
+
+	for (int i = 1; i < argc; ++i) {
+		const std::string	arg = argv[i];
+		auto value = [&] () -> std::string {
+			if (i + 1 >= argc)
+				usage();
+			return argv[++i];
+		};
+		if (arg == "--quick")
+			options.quick = true;
+		else if (arg == "--filter")
+			options.filter = value();
+		else if (arg == "--samples")
+			options.samples = std::max(1ul, std::stoul(value()));
+		else if (arg == "--out")
+			out = value();
+		else if (arg == "--baseline")
+			baseline = value();
+		else if (arg == "--tolerance")
+			tolerance = std::stod(value());
+		else
+			usage();
+	}
+
+	const dispatch::level	isa = dispatch::active(); // its warnings first
+	std::cerr << "tlap bench: isa " << dispatch::name(isa)
+		<< " (cpu " << dispatch::name(dispatch::detected()) << "), threads "
+		<< tlap::parallel::current().concurrency() << ", compiler " << __VERSION__ << "\n";
+
+	bench::suite	s(options);
+	bench::math(s);
+	bench::vector(s);
+	bench::matrix(s);
+	bench::random(s);
+	bench::io(s);
+	bench::speedups(s.results(), std::cerr);
+
+	if (out.empty())
+		bench::write_csv(std::cout, s.results());
+	else {
+		std::ofstream	file(out);
+		if (!file)
+			throw std::runtime_error("Cannot create " + out + ".");
+		bench::write_csv(file, s.results());
+	}
+	for (const std::string &failure : s.failures())
+		std::cerr << "wrong result  " << failure << "\n";
+	if (baseline.empty())
+		return (s.failures().empty() ? 0 : 1);
+	std::ifstream	file(baseline);
+	if (!file)
+		throw std::runtime_error("Cannot read " + baseline + ".");
+	return (bench::compare(s, bench::read_csv(file), tolerance, std::cerr) || !s.failures().empty() ? 1 : 0);
+}
@@ -0,0 +1,148 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: math functions: tlap batch and scalar against libm, time and ulp
+// File version: 0.1
+
+#include "bench.hpp"
+#include "math/math.hpp"
+#include "math/math_batch.hpp"
+#include <random>
+
+namespace bench {
+
+namespace {
+
+constexpr size_t	ulp_samples = 65536; // elements checked per row, the reference is slow
+// the bound of the precise policy (policy.hpp) on the tlap rows, none for fast
+constexpr double	ulp_bound = (std::is_same_v<tlap::default_policy, tlap::precise> ? 1.0
+	: std::numeric_limits<double>::infinity());
+
+template <typename T>
+std::vector<T>	inputs(size_t n, double lo, double hi, unsigned seed = 42) {
+	std::mt19937_64							gen(seed);
+	std::uniform_real_distribution<double>	dis(lo, hi);
+	std::vector<T>							v(n);
+	for (T &x : v)
+		x = static_cast<T>(dis(gen));
+	return v;
+}
+
+// ref(i): the exact result of element i
+template <typename T, typename Ref>
+void	measure_ulp(result &r, const std::vector<T> &out, Ref ref) {
+	const size_t	n = std::min(out.size(), ulp_samples);
+	double			worst = 0;
+	double			total = 0;
+	for (size_t i = 0; i < n; ++i) {
+		const double	u = ulp<T>(out[i], ref(i));
+		worst = std::max(worst, u);
+		total += u;
+	}
+	r.ulpMax = worst;
+	r.ulpMean = (n ? total / static_cast<double>(n) : 0);
+}
+
+// one function: the batch call, the scalar tlap function in a loop, libm in a loop
+template <typename T, typename Batch, typename Scalar, typename Std, typename Ref>
+void	unary(suite &s, const char *name, double lo, double hi, Batch batch, Scalar scalar, Std libm, Ref ref) {
+	if (!s.wants("math", name))
+		return;
+	for (size_t n : s.sizes({16, 256, 4096, 65536, 1 << 20})) {
+		const std::vector<T>	in = inputs<T>(n, lo, hi);
+		std::vector<T>			out(n);
+		const double			items = static_cast<double>(n);
+		auto					exact = [&](size_t i) { return ref(static_cast<long double>(in[i])); };
+
+		result	&b = s.run("math", name, type_name<T>(), "tlap", tlap::simd::dispatch::name(tlap::detail::batch_level<T>(n)), n, items, [&] {
+			batch(in.data(), out.data(), n);
+			keep(out.data());
+		});
+		measure_ulp(b, out, exact);
+		s.check("math", name, type_name<T>(), n, b.ulpMax, ulp_bound);
+		result	&c = s.run("math", name, type_name<T>(), "scalar", "scalar", n, items, [&] {
+			for (size_t i = 0; i < n; ++i)
+				out[i] = scalar(in[i]);
+			keep(out.data());
+		});
+		measure_ulp(c, out, exact);
+		s.check("math", name, type_name<T>(), n, c.ulpMax, ulp_bound);
+		result	&d = s.run("math", name, type_name<T>(), "std", "libm", n, items, [&] {
+			for (size_t i = 0; i < n; ++i)
+				out[i] = libm(in[i]);
+			keep(out.data());
+		});
+		measure_ulp(d, out, exact);
+	}
+}
+
+// f: tlap name, g: std name
+#define BENCH_UNARY(f, g, lo, hi) \
+	unary<T>(s, #f, lo, hi, \
+		[](const T *in, T *out, size_t n) { tlap::f<T>(in, out, n); }, \
+		[](T x) { return static_cast<T>(tlap::f(x)); }, \
+		[](T x) { return static_cast<T>(std::g(x)); }, \
+		[](long double x) { return std::g(x); })
+
+template <typename T>
+void	all(suite &s) {
+	BENCH_UNARY(exp, exp, -80, 80);
+	BENCH_UNARY(ln, log, 1e-6, 1e6);
+	BENCH_UNARY(log2, log2, 1e-6, 1e6);
+	BENCH_UNARY(log10, log10, 1e-6, 1e6);
+	BENCH_UNARY(sqrt, sqrt, 0, 1e6);
+	BENCH_UNARY(cbrt, cbrt, -1e6, 1e6);
+	BENCH_UNARY(sin, sin, -1000, 1000);
+	BENCH_UNARY(cos, cos, -1000, 1000);
+	BENCH_UNARY(tan, tan, -1000, 1000);
+	BENCH_UNARY(asin, asin, -1, 1);
+	BENCH_UNARY(acos, acos, -1, 1);
+	BENCH_UNARY(atan, atan, -1000, 1000);
+	BENCH_UNARY(sinh, sinh, -80, 80);
+	BENCH_UNARY(cosh, cosh, -80, 80);
+	BENCH_UNARY(tanh, tanh, -20, 20);
+	unary<T>(s, "rsqrt", 1e-6, 1e6,
+		[](const T *in, T *out, size_t n) { tlap::rsqrt<T>(in, out, n); },
+		[](T x) { return static_cast<T>(tlap::rsqrt(x)); },
+		[](T x) { return static_cast<T>(T(1) / std::sqrt(x)); },
+		[](long double x) { return 1.0L / std::sqrt(x); });
+
+	if (!s.wants("math", "atan2"))
+		return;
+	for (size_t n : s.sizes({16, 4096, 1 << 20})) {
+		const std::vector<T>	y = inputs<T>(n, -1000, 1000);
+		const std::vector<T>	x = inputs<T>(n, -1000, 1000, 7);
+		std::vector<T>			out(n);
+		const double			items = static_cast<double>(n);
+		auto					exact = [&](size_t i) { return std::atan2(static_cast<long double>(y[i]), static_cast<long double>(x[i])); };
+
+		result	&b = s.run("math", "atan2", type_name<T>(), "tlap", tlap::simd::dispatch::name(tlap::detail::batch_level<T>(n)), n, items, [&] {
+			tlap::atan2<T>(y.data(), x.data(), out.data(), n);
+			keep(out.data());
+		});
+		measure_ulp(b, out, exact);
+		s.check("math", "atan2", type_name<T>(), n, b.ulpMax, ulp_bound);
+		result	&c = s.run("math", "atan2", type_name<T>(), "scalar", "scalar", n, items, [&] {
+			for (size_t i = 0; i < n; ++i)
+				out[i] = static_cast<T>(tlap::atan2(y[i], x[i]));
+			keep(out.data());
+		});
+		measure_ulp(c, out, exact);
+		s.check("math", "atan2", type_name<T>(), n, c.ulpMax, ulp_bound);
+		result	&d = s.run("math", "atan2", type_name<T>(), "std", "libm", n, items, [&] {
+			for (size_t i = 0; i < n; ++i)
+				out[i] = std::atan2(y[i], x[i]);
+			keep(out.data());
+		});
+		measure_ulp(d, out, exact);
+	}
+}
+
+#undef BENCH_UNARY
+
+} // namespace
+
+void	math(suite &s) {
+	all<float>(s);
+	all<double>(s);
+}
+
+} // namespace bench
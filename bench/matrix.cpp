@@ -0,0 +1,249 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: Matrix, Tensor and sparse products against plain loops
+// File version: 0.1
+
+#include "bench.hpp"
+#include "Matrix/Matrix.hpp"
+#include "Sparse/SparseMatrix.hpp"
+#include "Tensor/Tensor.hpp"
+#include "Tensor/einsum.hpp"
+#include "simd/dispatch.hpp"
+#include <random>
+
+namespace bench {
+
+namespace {
+
+namespace dispatch = tlap::simd::dispatch;
+
+constexpr size_t	naive_max = 256; // largest size the triple loops run at
+constexpr size_t	checked_rows = 64; // rows of the larger products checked
+constexpr size_t	dense_max = 4096; // largest spmv checked against the dense matrix
+
+// summation order apart, a product of k terms is off by k roundings at most
+template <typename T>
+double	bound(size_t k) {
+	return 4.0 * static_cast<double>(k) * std::numeric_limits<T>::epsilon();
+}
+
+template <typename T>
+tlap::Matrix<T>	filled(size_t rows, size_t cols, unsigned seed) {
+	std::mt19937							gen(seed);
+	std::uniform_real_distribution<double>	dis(-1, 1);
+	tlap::Matrix<T>							m(rows, cols);
+	for (size_t i = 0; i < rows; ++i)
+		for (size_t j = 0; j < cols; ++j)
+			m(i, j) = static_cast<T>(dis(gen));
+	return m;
+}
+
+template <typename T>
+tlap::Tensor<T>	filled(const tlap::shape_t &shape, unsigned seed) {
+	std::mt19937							gen(seed);
+	std::uniform_real_distribution<double>	dis(-1, 1);
+	tlap::Tensor<T>							t(shape);
+	T										*p = t.data();
+	for (size_t i = 0; i < t.size(); ++i)
+		p[i] = static_cast<T>(dis(gen));
+	return t;
+}
+
+// c against a * b summed in double: every row up to naive_max, checked_rows
+// spread over the larger ones
+template <typename T>
+double	gemm_error(const tlap::Matrix<T> &a, const tlap::Matrix<T> &b, const tlap::Matrix<T> &c) {
+	const size_t	n = a.rows();
+	const size_t	step = (n <= naive_max ? 1 : n / checked_rows);
+	error_meter		e;
+	for (size_t i = 0; i < n; i += step)
+		for (size_t j = 0; j < n; ++j) {
+			double	sum = 0;
+			for (size_t k = 0; k < n; ++k)
+				sum += static_cast<double>(a(i, k)) * static_cast<double>(b(k, j));
+			e.add(static_cast<double>(c(i, j)), sum);
+		}
+	return e.relative();
+}
+
+template <typename T>
+void	products(suite &s) {
+	const char	*active = dispatch::name(dispatch::active());
+
+	if (s.wants("matrix", "gemm"))
+		for (size_t n : s.sizes({16, 64, 256, 512, 1024})) {
+			const tlap::Matrix<T>	a = filled<T>(n, n, 1);
+			const tlap::Matrix<T>	b = filled<T>(n, n, 2);
+			tlap::Matrix<T>			c(n, n);
+			const double			flops = 2.0 * static_cast<double>(n) * n * n;
+
+			s.run("matrix", "gemm", type_name<T>(), "tlap", active, n, flops, [&] {
+				c = a * b;
+				keep(c.data());
+			});
+			s.check("matrix", "gemm", type_name<T>(), n, gemm_error(a, b, c), bound<T>(n));
+			if (n <= naive_max)
+				s.run("matrix", "gemm", type_name<T>(), "naive", "compiler", n, flops, [&] {
+					for (size_t i = 0; i < n; ++i)
+						for (size_t j = 0; j < n; ++j) {
+							T	sum = T(0);
+							for (size_t k = 0; k < n; ++k)
+								sum += a(i, k) * b(k, j);
+							c(i, j) = sum;
+						}
+					keep(c.data());
+				});
+		}
+	if (s.wants("matrix", "gemv"))
+		for (size_t n : s.sizes({64, 256, 1024, 4096})) {
+			const tlap::Matrix<T>	a = filled<T>(n, n, 1);
+			tlap::Vector<T>			x(n);
+			tlap::Vector<T>			y(n);
+			const double			flops = 2.0 * static_cast<double>(n) * n;
+
+			for (size_t i = 0; i < n; ++i)
+				x[i] = static_cast<T>(i % 7);
+			s.run("matrix", "gemv", type_name<T>(), "tlap", active, n, flops, [&] {
+				y = a * x;
+				keep(y.data());
+			});
+			error_meter	e;
+			for (size_t i = 0; i < n; ++i) {
+				double	sum = 0;
+				for (size_t k = 0; k < n; ++k)
+					sum += static_cast<double>(a(i, k)) * static_cast<double>(x[k]);
+				e.add(static_cast<double>(y[i]), sum);
+			}
+			s.check("matrix", "gemv", type_name<T>(), n, e.relative(), bound<T>(n));
+			s.run("matrix", "gemv", type_name<T>(), "naive", "compiler", n, flops, [&] {
+				for (size_t i = 0; i < n; ++i) {
+					T	sum = T(0);
+					for (size_t k = 0; k < n; ++k)
+						sum += a(i, k) * x[k];
+					y[i] = sum;
+				}
+				keep(y.data());
+			});
+		}
+	if (s.wants("matrix", "transpose"))
+		for (size_t n : s.sizes({64, 512, 2048})) {
+			const tlap::Matrix<T>	a = filled<T>(n, n, 1);
+			tlap::Matrix<T>			t(n, n);
+			s.run("matrix", "transpose", type_name<T>(), "tlap", active, n, static_cast<double>(n) * n, [&] {
+				t = a.transpose();
+				keep(t.data());
+			});
+		}
+}
+
+template <typename T>
+void	tensors(suite &s) {
+	const char	*active = dispatch::name(dispatch::active());
+
+	if (s.wants("tensor", "add"))
+		for (size_t n : s.sizes({16, 64, 256})) {
+			const tlap::Tensor<T>	a = filled<T>({n, n, n}, 1);
+			const tlap::Tensor<T>	b = filled<T>({n, n, n}, 2);
+			const tlap::Tensor<T>	bt = b.transpose(); // strided operand
+			tlap::Tensor<T>			c;
+			const double			items = static_cast<double>(a.size());
+
+			s.run("tensor", "add", type_name<T>(), "tlap", active, n, items, [&] {
+				c = a + b;
+				keep(c.data());
+			});
+			s.run("tensor", "add_transposed", type_name<T>(), "tlap", active, n, items, [&] {
+				c = a + bt;
+				keep(c.data());
+			});
+		}
+	if (s.wants("tensor", "einsum"))
+		for (size_t n : s.sizes({16, 64, 128})) {
+			const tlap::Tensor<T>	a = filled<T>({8, n, n}, 1);
+			const tlap::Tensor<T>	b = filled<T>({8, n, n}, 2);
+			tlap::Tensor<T>			c;
+			const double			flops = 2.0 * 8 * static_cast<double>(n) * n * n;
+
+			s.run("tensor", "einsum_bmm", type_name<T>(), "tlap", active, n, flops, [&] {
+				c = tlap::einsum("bij,bjk->bik", a, b);
+				keep(c.data());
+			});
+		}
+}
+
+template <typename T>
+void	sparse(suite &s) {
+	if (!s.wants("sparse", "spmv"))
+		return;
+	const char	*active = dispatch::name(dispatch::active());
+	for (size_t n : s.sizes({1024, 65536, 1 << 20})) {
+		constexpr size_t			per = 16; // non-zeros per row
+		std::mt19937				gen(3);
+		std::vector<tlap::triplet<T>>	entries;
+		for (size_t i = 0; i < n; ++i)
+			for (size_t k = 0; k < per; ++k)
+				entries.push_back({i, gen() % n, T(1)});
+		const tlap::CsrMatrix<T>	csr(n, n, entries);
+		const tlap::CscMatrix<T>	csc(csr);
+		tlap::Vector<T>				x(n);
+		tlap::Vector<T>				y(n);
+		const double				items = static_cast<double>(csr.nnz());
+
+		for (size_t i = 0; i < n; ++i)
+			x[i] = static_cast<T>(static_cast<int>(i % 7) - 3);
+		// the reference: the dense product up to dense_max, the entries
+		// summed in double past it
+		std::vector<double>	want(n, 0.0);
+		if (n <= dense_max) {
+			tlap::Matrix<T>	dense(n, n);
+			for (const tlap::triplet<T> &t : entries)
+				dense(t.row, t.col) += t.value;
+			for (size_t i = 0; i < n; ++i)
+				for (size_t k = 0; k < n; ++k)
+					want[i] += static_cast<double>(dense(i, k)) * static_cast<double>(x[k]);
+		} else
+			for (const tlap::triplet<T> &t : entries)
+				want[t.row] += static_cast<double>(t.value) * static_cast<double>(x[t.col]);
+		auto error = [&] {
+			error_meter	e;
+			for (size_t i = 0; i < n; ++i)
+				e.add(static_cast<double>(y[i]), want[i]);
+			return e.relative();
+		};
+
+		s.run("sparse", "spmv", type_name<T>(), "tlap", active, n, items, [&] {
+			y = csr * x;
+			keep(y.data());
+		});
+		s.check("sparse", "spmv", type_name<T>(), n, error(), bound<T>(per));
+		s.run("sparse", "spmv_csc", type_name<T>(), "tlap", "scalar", n, items, [&] {
+			y = csc * x;
+			keep(y.data());
+		});
+		s.check("sparse", "spmv_csc", type_name<T>(), n, error(), bound<T>(per));
+		s.run("sparse", "spmv", type_name<T>(), "naive", "compiler", n, items, [&] {
+			const size_t	*offsets = csr.offsets();
+			const uint32_t	*index = csr.indices();
+			const T			*values = csr.values();
+			for (size_t i = 0; i < n; ++i) {
+				T	sum = T(0);
+				for (size_t k = offsets[i]; k < offsets[i + 1]; ++k)
+					sum += values[k] * x[index[k]];
+				y[i] = sum;
+			}
+			keep(y.data());
+		});
+	}
+}
+
+} // namespace
+
+void	matrix(suite &s) {
+	products<float>(s);
+	products<double>(s);
+	tensors<float>(s);
+	tensors<double>(s);
+	sparse<float>(s);
+	sparse<double>(s);
+}
+
+} // namespace bench
@@ -0,0 +1,95 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: random fills: philox per isa level and the fills, against the <random> engines
+// File version: 0.1
+
+#include "bench.hpp"
+#include "random/random.hpp"
+#include "simd/dispatch.hpp"
+#include <random>
+
+namespace bench {
+
+namespace {
+
+namespace dispatch = tlap::simd::dispatch;
+
+// 4 words per block
+void	philox(suite &s) {
+	if (!s.wants("random", "philox"))
+		return;
+	for (size_t n : s.sizes({1024, 65536, 1 << 20})) {
+		std::vector<uint32_t>	out(n);
+		const size_t			blocks = n / 4;
+		const double			items = static_cast<double>(n);
+
+		s.run("random", "philox", "uint32", "scalar", "scalar", n, items, [&] {
+			tlap::detail::rng::philox_loop(1, 0, 0, out.data(), blocks);
+			keep(out.data());
+		});
+		if (dispatch::detected() >= dispatch::level::avx2)
+			s.run("random", "philox", "uint32", "avx2", "avx2", n, items, [&] {
+				tlap::detail::rng::philox_avx2(1, 0, 0, out.data(), blocks);
+				keep(out.data());
+			});
+		if (dispatch::detected() >= dispatch::level::avx512)
+			s.run("random", "philox", "uint32", "avx512", "avx512", n, items, [&] {
+				tlap::detail::rng::philox_avx512(1, 0, 0, out.data(), blocks);
+				keep(out.data());
+			});
+		std::mt19937	mt(1);
+		s.run("random", "philox", "uint32", "std", "mt19937", n, items, [&] {
+			for (size_t i = 0; i < n; ++i)
+				out[i] = mt();
+			keep(out.data());
+		});
+	}
+}
+
+template <typename T>
+void	fills(suite &s) {
+	const char	*active = dispatch::name(dispatch::active());
+
+	for (size_t n : s.sizes({1024, 65536, 1 << 20, 1 << 23})) {
+		tlap::Vector<T>			v(n);
+		tlap::random::philox	gen(1);
+		std::mt19937_64			mt(1);
+		const double			items = static_cast<double>(n);
+
+		if (s.wants("random", "uniform")) {
+			s.run("random", "uniform", type_name<T>(), "tlap", active, n, items, [&] {
+				tlap::random::fillUniform(v, T(-1), T(1), gen);
+				keep(v.data());
+			});
+			std::conditional_t<std::is_integral<T>::value, std::uniform_int_distribution<T>, std::uniform_real_distribution<T>>	dis(T(-1), T(1));
+			s.run("random", "uniform", type_name<T>(), "std", "mt19937_64", n, items, [&] {
+				for (size_t i = 0; i < n; ++i)
+					v[i] = dis(mt);
+				keep(v.data());
+			});
+		}
+		if constexpr (std::is_floating_point<T>::value)
+			if (s.wants("random", "normal")) {
+				s.run("random", "normal", type_name<T>(), "tlap", active, n, items, [&] {
+					tlap::random::fillNormal(v, T(0), T(1), gen);
+					keep(v.data());
+				});
+				std::normal_distribution<T>	dis(T(0), T(1));
+				s.run("random", "normal", type_name<T>(), "std", "mt19937_64", n, items, [&] {
+					for (size_t i = 0; i < n; ++i)
+						v[i] = dis(mt);
+					keep(v.data());
+				});
+			}
+	}
+}
+
+} // namespace
+
+void	random(suite &s) {
+	philox(s);
+	fills<float>(s);
+	fills<double>(s);
+	fills<int>(s);
+}
+
+} // namespace bench
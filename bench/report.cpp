@@ -0,0 +1,126 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: csv output of the benchmark rows and the diff against a baseline
+// File version: 0.1
+
+#include "bench.hpp"
+#include <iomanip>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace bench {
+
+namespace {
+
+const char	*columns = "suite,name,type,variant,path,size,items,ns_per_call,ns_per_item,cycles_per_item,ulp_max,ulp_mean";
+
+std::vector<std::string>	split(const std::string &line) {
+	std::vector<std::string>	fields;
+	std::stringstream			in(line);
+	std::string					field;
+	while (std::getline(in, field, ','))
+		fields.push_back(field);
+	return fields;
+}
+
+} // namespace
+
+void	write_csv(std::ostream &out, const std::vector<result> &results) {
+	out << columns << '\n' << std::setprecision(6);
+	for (const result &r : results)
+		out << r.suite << ',' << r.name << ',' << r.type << ',' << r.variant << ',' << r.path << ','
+			<< r.size << ',' << static_cast<unsigned long long>(r.items) << ',' << r.nsPerCall << ',' << r.nsPerItem() << ','
+			<< r.cyclesPerItem() << ',' << r.ulpMax << ',' << r.ulpMean << '\n';
+}
+
+std::vector<result>	read_csv(std::istream &in) {
+	std::vector<result>	results;
+	std::string			line;
+	while (std::getline(in, line)) {
+		if (line.empty() || line[0] == '#' || line == columns)
+			continue;
+		const std::vector<std::string>	f = split(line);
+		if (f.size() != 12)
+			throw std::invalid_argument("Not a benchmark row: " + line);
+		result	r;
+		r.suite = f[0];
+		r.name = f[1];
+		r.type = f[2];
+		r.variant = f[3];
+		r.path = f[4];
+		r.size = std::stoul(f[5]);
+		r.items = std::stod(f[6]);
+		r.nsPerCall = std::stod(f[7]);
+		r.cyclesPerCall = std::stod(f[9]) * r.items;
+		r.ulpMax = std::stod(f[10]);
+		r.ulpMean = std::stod(f[11]);
+		results.push_back(r);
+	}
+	return results;
+}
+
+// slower than the baseline by more than tolerance, a larger worst ulp error
+// (half an ulp of slack for the rounding of the reference), or a baseline row
+// the run wants (--filter) and did not produce: record the baseline with the
+// same arguments on the same machine
+size_t	compare(const suite &current, const std::vector<result> &baseline, double tolerance, std::ostream &report) {
+	std::map<std::string, const result *>	base;
+	std::map<std::string, const result *>	ran;
+	size_t	matched = 0;
+	size_t	regressions = 0;
+	size_t	faster = 0;
+	size_t	missing = 0;
+
+	for (const result &r : baseline)
+		base[r.key()] = &r;
+	for (const result &r : current.results())
+		ran[r.key()] = &r;
+	report << std::fixed << std::setprecision(2);
+	for (const result &r : current.results()) {
+		const auto	it = base.find(r.key());
+		if (it == base.end())
+			continue;
+		const result	&b = *it->second;
+		const double	ratio = (b.nsPerCall > 0 ? r.nsPerCall / b.nsPerCall : 1.0);
+		++matched;
+		if (ratio > 1.0 + tolerance) {
+			report << "slower  x" << ratio << "  " << r.key() << "  (" << b.nsPerItem() << " -> " << r.nsPerItem() << " ns/item)\n";
+			++regressions;
+		} else if (ratio < 1.0 - tolerance)
+			++faster;
+		if (b.ulpMax >= 0 && r.ulpMax > b.ulpMax + 0.5) {
+			report << "less accurate  " << r.key() << "  (" << b.ulpMax << " -> " << r.ulpMax << " ulp)\n";
+			++regressions;
+		}
+	}
+	for (const auto &[key, b] : base)
+		if (current.wants(b->suite, b->name) && ran.find(key) == ran.end()) {
+			report << "missing  " << key << "\n";
+			++missing;
+		}
+	report << matched << " rows compared, " << regressions << " regressions, " << missing << " missing, " << faster
+		<< " faster, tolerance " << tolerance * 100 << "%\n";
+	return regressions + missing;
+}
+
+// time of the std row over that of the tlap row of the same point, for every
+// point that has both
+void	speedups(const std::vector<result> &results, std::ostream &report) {
+	std::map<std::string, const result *>	reference;
+
+	for (const result &r : results)
+		if (r.variant == "std")
+			reference[r.suite + "," + r.name + "," + r.type + "," + std::to_string(r.size)] = &r;
+	report << std::fixed << std::setprecision(2);
+	for (const result &r : results) {
+		if (r.variant != "tlap" || r.nsPerCall <= 0)
+			continue;
+		const auto	it = reference.find(r.suite + "," + r.name + "," + r.type + "," + std::to_string(r.size));
+		if (it != reference.end())
+			report << "speedup over std  x" << it->second->nsPerCall / r.nsPerCall << "  " << r.key() << "  (" << r.path << ")\n";
+	}
+}
+
+} // namespace bench
@@ -0,0 +1,244 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: Vector operations: the API, each dispatched isa level, plain loops
+// File version: 0.1
+
+#include "bench.hpp"
+#include "Vector/Vector.hpp"
+#include "Quant/QuantizedVector.hpp"
+#include "simd/dispatch.hpp"
+#include <numeric>
+#include <random>
+
+namespace bench {
+
+namespace {
+
+namespace dispatch = tlap::simd::dispatch;
+
+template <typename T>
+tlap::Vector<T>	filled(size_t n, unsigned seed) {
+	std::mt19937							gen(seed);
+	std::uniform_real_distribution<double>	dis(-1, 1);
+	tlap::Vector<T>							v(n);
+	for (size_t i = 0; i < n; ++i)
+		v[i] = static_cast<T>(dis(gen));
+	return v;
+}
+
+template <typename T>
+const dispatch::kernels<T>	&level_table(dispatch::level l) {
+	switch (l) {
+		case dispatch::level::avx512:	return dispatch::avx512::table<T>;
+		case dispatch::level::avx2:		return dispatch::avx2::table<T>;
+		default:						return dispatch::scalar::table<T>;
+	}
+}
+
+template <typename H>
+const dispatch::reduced_kernels<H>	&level_reduced(dispatch::level l) {
+	switch (l) {
+		case dispatch::level::avx512:	return dispatch::avx512::reduced_table<H>;
+		case dispatch::level::avx2:		return dispatch::avx2::reduced_table<H>;
+		default:						return dispatch::scalar::reduced_table<H>;
+	}
+}
+
+// every level this cpu runs, for the scalar path and each simd one
+std::vector<dispatch::level>	levels() {
+	std::vector<dispatch::level>	all;
+	for (dispatch::level l : {dispatch::level::scalar, dispatch::level::avx2, dispatch::level::avx512})
+		if (l <= dispatch::detected())
+			all.push_back(l);
+	return all;
+}
+
+// name, the API call, the kernel of one level, the plain loop; each on
+// operands a, b and out
+template <typename T, typename Api, typename Kernel, typename Loop>
+void	op(suite &s, const char *name, Api api, Kernel kernel, Loop loop) {
+	if (!s.wants("vector", name))
+		return;
+	const char	*active = dispatch::name(dispatch::active());
+	for (size_t n : s.sizes({16, 1024, 65536, 1 << 20, 1 << 23})) {
+		const tlap::Vector<T>	a = filled<T>(n, 1);
+		const tlap::Vector<T>	b = filled<T>(n, 2);
+		tlap::Vector<T>			out(n);
+		const double			items = static_cast<double>(n);
+
+		s.run("vector", name, type_name<T>(), "tlap", active, n, items, [&] {
+			api(a, b, out);
+			keep(out.data());
+		});
+		for (dispatch::level l : levels()) {
+			const dispatch::kernels<T>	&k = level_table<T>(l);
+			s.run("vector", name, type_name<T>(), dispatch::name(l), dispatch::name(l), n, items, [&] {
+				kernel(k, a.data(), b.data(), out.data(), a.capacity());
+				keep(out.data());
+			});
+		}
+		s.run("vector", name, type_name<T>(), "std", "compiler", n, items, [&] {
+			loop(a.data(), b.data(), out.data(), n);
+			keep(out.data());
+		});
+	}
+}
+
+template <typename T>
+void	all(suite &s) {
+	using V = tlap::Vector<T>;
+	using K = dispatch::kernels<T>;
+	T	sink = T(0); // of the reductions
+
+	op<T>(s, "add",
+		[](const V &a, const V &b, V &out) { out = a + b; },
+		[](const K &k, const T *a, const T *b, T *out, size_t n) { k.add(out, a, b, n); },
+		[](const T *a, const T *b, T *out, size_t n) { for (size_t i = 0; i < n; ++i) out[i] = a[i] + b[i]; });
+	op<T>(s, "mul",
+		[](const V &a, const V &b, V &out) { out = a * b; },
+		[](const K &k, const T *a, const T *b, T *out, size_t n) { k.mul(out, a, b, n); },
+		[](const T *a, const T *b, T *out, size_t n) { for (size_t i = 0; i < n; ++i) out[i] = a[i] * b[i]; });
+	op<T>(s, "scale",
+		[](const V &a, const V &, V &out) { out = a * T(3); },
+		[](const K &k, const T *a, const T *, T *out, size_t n) { k.scale(out, a, n, T(3)); },
+		[](const T *a, const T *, T *out, size_t n) { for (size_t i = 0; i < n; ++i) out[i] = a[i] * T(3); });
+	op<T>(s, "axpy",
+		[](const V &a, const V &b, V &out) { out = a + b * T(3); },
+		[](const K &k, const T *a, const T *b, T *out, size_t n) { k.axpy(out, a, b, n, T(3)); },
+		[](const T *a, const T *b, T *out, size_t n) { for (size_t i = 0; i < n; ++i) out[i] = a[i] + b[i] * T(3); });
+	op<T>(s, "dot",
+		[&](const V &a, const V &b, V &) { sink += a.dot(b); },
+		[&](const K &k, const T *a, const T *b, T *, size_t n) { sink += k.reduce(dispatch::reduction::dot, false, a, b, n); },
+		[&](const T *a, const T *b, T *, size_t n) { sink += std::inner_product(a, a + n, b, T(0)); });
+	op<T>(s, "sum",
+		[&](const V &a, const V &, V &) { sink += a.sum(); },
+		[&](const K &k, const T *a, const T *, T *, size_t n) { sink += k.reduce(dispatch::reduction::sum, false, a, a, n); },
+		[&](const T *a, const T *, T *, size_t n) { sink += std::accumulate(a, a + n, T(0)); });
+	op<T>(s, "sum_precise",
+		[&](const V &a, const V &, V &) { sink += a.template sum<tlap::precise>(); },
+		[&](const K &k, const T *a, const T *, T *, size_t n) { sink += k.reduce(dispatch::reduction::sum, true, a, a, n); },
+		[&](const T *a, const T *, T *, size_t n) { sink += static_cast<T>(std::accumulate(a, a + n, 0.0L)); });
+	op<T>(s, "max",
+		[&](const V &a, const V &, V &) { sink += a.max(); },
+		[&](const K &k, const T *a, const T *, T *, size_t n) { sink += k.reduce(dispatch::reduction::max, false, a, a, n); },
+		[&](const T *a, const T *, T *, size_t n) { sink += *std::max_element(a, a + n); });
+	// the fused expression against the eager chain of the same operators
+	op<T>(s, "multadd",
+		[](const V &a, const V &b, V &out) { out = a * b + a; },
+		[](const K &k, const T *a, const T *b, T *out, size_t n) { k.mul(out, a, b, n); k.add(out, out, a, n); },
+		[](const T *a, const T *b, T *out, size_t n) { for (size_t i = 0; i < n; ++i) out[i] = a[i] * b[i] + a[i]; });
+	if (s.wants("vector", "multadd"))
+		for (size_t n : s.sizes({1024, 1 << 20})) {
+			const V	a = filled<T>(n, 1);
+			const V	b = filled<T>(n, 2);
+			V		out(n);
+			s.run("vector", "multadd", type_name<T>(), "eager", dispatch::name(dispatch::active()), n, static_cast<double>(n), [&] {
+				V	tmp(a);
+				tmp *= b;
+				tmp += a;
+				out = tmp;
+				keep(out.data());
+			});
+		}
+	if (s.wants("vector", "alloc"))
+		for (size_t n : s.sizes({16, 1024, 65536})) {
+			s.run("vector", "alloc", type_name<T>(), "tlap", "recycler", n, static_cast<double>(n), [&] {
+				V	v(n);
+				keep(v.data());
+			});
+			s.run("vector", "alloc", type_name<T>(), "std", "new", n, static_cast<double>(n), [&] {
+				std::vector<T>	v(n);
+				keep(v.data());
+			});
+		}
+	keep(&sink);
+}
+
+// 16-bit storage: dot and the widening to float, against the float rows of all()
+template <typename H>
+void	reduced(suite &s) {
+	const char	*active = dispatch::name(dispatch::active());
+	float		sink = 0;
+
+	for (size_t n : s.sizes({1024, 65536, 1 << 20, 1 << 23})) {
+		const tlap::Vector<H>	a(filled<float>(n, 1));
+		const tlap::Vector<H>	b(filled<float>(n, 2));
+		std::vector<float>		out(a.capacity());
+		const double			items = static_cast<double>(n);
+
+		if (s.wants("vector", "dot")) {
+			s.run("vector", "dot", type_name<H>(), "tlap", active, n, items, [&] { sink += a.dot(b); });
+			for (dispatch::level l : levels()) {
+				const dispatch::reduced_kernels<H>	&k = level_reduced<H>(l);
+				s.run("vector", "dot", type_name<H>(), dispatch::name(l), dispatch::name(l), n, items, [&] {
+					sink += k.reduce(dispatch::reduction::dot, false, a.data(), b.data(), a.capacity());
+				});
+			}
+		}
+		if (s.wants("vector", "widen"))
+			for (dispatch::level l : levels()) {
+				const dispatch::reduced_kernels<H>	&k = level_reduced<H>(l);
+				s.run("vector", "widen", type_name<H>(), dispatch::name(l), dispatch::name(l), n, items, [&] {
+					k.widen(out.data(), a.data(), a.capacity());
+					keep(out.data());
+				});
+			}
+	}
+	keep(&sink);
+}
+
+// int8 / uint8 codes: dot per kernel table and the similarity scan, against
+// the float rows of all()
+template <typename Q>
+void	quantized(suite &s) {
+	namespace quant = tlap::detail::quant;
+	const char	*active = dispatch::name(dispatch::active());
+	float		sink = 0;
+	int64_t		isink = 0;
+
+	for (size_t n : s.sizes({1024, 65536, 1 << 20, 1 << 23})) {
+		const tlap::QuantizedVector<Q>	a(filled<float>(n, 1));
+		const tlap::QuantizedVector<Q>	b(filled<float>(n, 2));
+		const double					items = static_cast<double>(n);
+
+		if (s.wants("vector", "dot")) {
+			s.run("vector", "dot", type_name<Q>(), "tlap", active, n, items, [&] { sink += a.dot(b); });
+			std::vector<std::pair<const char *, const quant::kernels *>>	tables = {{"scalar", &quant::scalar_table}};
+			if (dispatch::detected() >= dispatch::level::avx2)
+				tables.push_back({"avx2", &quant::avx2_table});
+			if (dispatch::detected() == dispatch::level::avx512 && quant::has_vnni())
+				tables.push_back({"vnni", &quant::vnni_table});
+			for (const auto &[name, k] : tables)
+				s.run("vector", "dot", type_name<Q>(), name, name, n, items, [&] {
+					if constexpr (std::is_same<Q, int8_t>::value)
+						isink += k->dot_s8(a.data(), b.data(), n);
+					else
+						isink += k->dot_u8(a.data(), b.data(), n);
+				});
+		}
+	}
+	if (s.wants("vector", "scan"))
+		for (size_t n : s.sizes({256, 1024})) {
+			const tlap::QuantizedVector<Q>			query(filled<float>(n, 1));
+			std::vector<tlap::QuantizedVector<Q>>	rows;
+			for (unsigned r = 0; r < 4096; ++r)
+				rows.emplace_back(filled<float>(n, r + 2));
+			s.run("vector", "scan", type_name<Q>(), "tlap", active, n, static_cast<double>(n) * rows.size(), [&] {
+				keep(tlap::dotBatch(query, rows).data());
+			});
+		}
+	keep(&sink);
+	keep(&isink);
+}
+
+} // namespace
+
+void	vector(suite &s) {
+	all<float>(s);
+	all<double>(s);
+	reduced<tlap::half>(s);
+	reduced<tlap::bfloat16>(s);
+	quantized<int8_t>(s);
+	quantized<uint8_t>(s);
+}
+
+} // namespace bench
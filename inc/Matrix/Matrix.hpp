@@ -2,6 +2,93 @@
 // Description: Matrix class with a focus on performance
 // File version: 0.1
 
+#pragma once
+
+#include "../Vector/Vector.hpp"
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+
 namespace tlap {
-	
-}
\ No newline at end of file
+
+template <typename T> class Tensor;
+
+template <typename T>
+class Matrix {
+	static_assert(is_element<T>, "Matrix can only be instantiated with arithmetic types, half and bfloat16.");
+
+	// row-major. every row starts on a simd::alignment boundary and is padded
+	// with zeros up to stride() elements, a row is laid out like the storage of
+	// a Vector of cols() elements. elementwise operations run the Vector kernels
+	// over the rows() * stride() elements at once, products go through gemm.hpp
+	private:
+		T		*_data;
+		size_t	_rows;
+		size_t	_cols;
+		size_t	_stride; // padded row length
+
+		void	_allocate(size_t rows, size_t cols); // uninitialized storage, padding zeroed
+		void	_clearPadding();
+
+	public:
+		using value_type = T;
+
+		// constructors and destructor
+		Matrix();
+		Matrix(size_t rows, size_t cols); // zero
+		TEMPLATE_U Matrix(size_t rows, size_t cols, const U &value); // fill constructor
+		TEMPLATE_U Matrix(std::initializer_list<std::initializer_list<U>> rows); // one list per row, throws on ragged rows
+		Matrix(const Matrix &other); // copy constructor
+		Matrix(Matrix &&other) noexcept; // move constructor
+		TEMPLATE_U Matrix(const Matrix<U> &other); // converting copy constructor
+		~Matrix();
+
+		static Matrix			identity(size_t n);
+		static Matrix			uninitialized(size_t rows, size_t cols); // values left undefined (the padding is zero), for a result written in full
+
+		// assignment operators
+		Matrix					&operator=(const Matrix &other);
+		Matrix					&operator=(Matrix &&other) noexcept;
+
+		// comparison operators
+		bool					operator==(const Matrix &other) const;
+		bool					operator!=(const Matrix &other) const;
+
+		// arithmetic operators, * between matrices is the matrix product
+		Matrix					operator+(const Matrix &other) const;
+		Matrix					operator-(const Matrix &other) const;
+		Matrix					operator*(const Matrix &other) const; // throws if cols() != other.rows()
+		Vector<T>				operator*(const Vector<T> &v) const; // throws if cols() != v.shape()
+		Matrix					operator*(const T &scalar) const;
+		Matrix					operator/(const T &scalar) const;
+		Matrix					&operator+=(const Matrix &other);
+		Matrix					&operator-=(const Matrix &other);
+		Matrix					&operator*=(const Matrix &other); // this = this * other
+		Matrix					&operator*=(const T &scalar);
+		Matrix					&operator/=(const T &scalar); // integer division by 0 throws
+
+		// index access
+		const T					&operator()(size_t row, size_t col) const;
+		T						&operator()(size_t row, size_t col);
+		const T					*row(size_t index) const; // cols() elements, aligned, zero padded to stride()
+		T						*row(size_t index);
+		const T					*data() const; // rows() rows of stride() elements
+		T						*data();
+
+		// various operations and methods
+		Matrix					&mulAdd(const Matrix &a, const Matrix &b, const T &alpha, const T &beta); // this = alpha * a * b + beta * this, without temporary
+		Matrix					transpose() const;
+		Tensor<T>				asTensor(); // 2D view of the storage, no copy, see Tensor/Tensor.hpp
+
+		size_t					rows() const;
+		size_t					cols() const;
+		size_t					stride() const; // elements from one row to the next
+};
+
+template <typename U, typename T> requires std::is_arithmetic<U>::value
+Matrix<T>	operator*(const U &scalar, const Matrix<T> &m);
+
+} // namespace tlap
+
+#include "Matrix.tpp" // implementations
+#include "transform.hpp" // batched point transforms
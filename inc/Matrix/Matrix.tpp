@@ -0,0 +1,347 @@
+#pragma once
+
+#include "Matrix.hpp"
+#include "gemm.hpp"
+#include "../simd/simd.hpp"
+#include "../simd/dispatch.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace tlap {
+
+// storage
+
+template <typename T>
+void	Matrix<T>::_allocate(size_t rows, size_t cols) {
+	_rows = rows;
+	_cols = cols;
+	_stride = detail::padded_size<T>(cols);
+	_data = (_rows && _stride ? simd::aligned_alloc<T>(_rows * _stride) : nullptr);
+	_clearPadding();
+}
+
+template <typename T>
+void	Matrix<T>::_clearPadding() {
+	for (size_t i = 0; i < _rows; ++i)
+		for (size_t j = _cols; j < _stride; ++j)
+			_data[i * _stride + j] = T(0);
+}
+
+// constructors and destructor
+
+template <typename T>
+Matrix<T>::Matrix()
+	: _data(nullptr), _rows(0), _cols(0), _stride(0) {
+}
+
+template <typename T>
+Matrix<T>::Matrix(size_t rows, size_t cols) {
+	_allocate(rows, cols);
+	detail::vector_fill(_data, _rows * _stride, T(0));
+}
+
+template <typename T>
+TEMPLATE_U Matrix<T>::Matrix(size_t rows, size_t cols, const U &value) {
+	ARITHMETIC_U;
+	_allocate(rows, cols);
+	detail::vector_fill(_data, _rows * _stride, static_cast<T>(value));
+	_clearPadding();
+}
+
+template <typename T>
+TEMPLATE_U Matrix<T>::Matrix(std::initializer_list<std::initializer_list<U>> rows) {
+	ARITHMETIC_U;
+	const size_t cols = (rows.size() ? rows.begin()->size() : 0);
+	for (const std::initializer_list<U> &r : rows)
+		if (r.size() != cols)
+			throw std::invalid_argument("Matrix rows must have the same size.");
+	_allocate(rows.size(), cols);
+	T *dst = _data;
+	for (const std::initializer_list<U> &r : rows) {
+		std::transform(r.begin(), r.end(), dst, [](const U &x) { return static_cast<T>(x); });
+		dst += _stride;
+	}
+}
+
+template <typename T>
+Matrix<T>::Matrix(const Matrix &other) {
+	_allocate(other._rows, other._cols);
+	if (_data)
+		std::memcpy(_data, other._data, _rows * _stride * sizeof(T));
+}
+
+template <typename T>
+Matrix<T>::Matrix(Matrix &&other) noexcept
+	: _data(other._data), _rows(other._rows), _cols(other._cols), _stride(other._stride) {
+	other._data = nullptr;
+	other._rows = 0;
+	other._cols = 0;
+	other._stride = 0;
+}
+
+template <typename T>
+TEMPLATE_U Matrix<T>::Matrix(const Matrix<U> &other) {
+	_allocate(other.rows(), other.cols());
+	for (size_t i = 0; i < _rows; ++i)
+		std::transform(other.row(i), other.row(i) + _cols, row(i), [](const U &x) { return static_cast<T>(x); });
+}
+
+template <typename T>
+Matrix<T>::~Matrix() {
+	simd::aligned_free(_data);
+}
+
+template <typename T>
+Matrix<T>	Matrix<T>::uninitialized(size_t rows, size_t cols) {
+	Matrix<T> res;
+	res._allocate(rows, cols);
+	return res;
+}
+
+template <typename T>
+Matrix<T>	Matrix<T>::identity(size_t n) {
+	Matrix<T> res(n, n);
+	for (size_t i = 0; i < n; ++i)
+		res(i, i) = T(1);
+	return res;
+}
+
+// assignment operators
+
+template <typename T>
+Matrix<T>	&Matrix<T>::operator=(const Matrix &other) {
+	if (this == &other)
+		return *this;
+	if (_rows * _stride != other._rows * other._stride) {
+		simd::aligned_free(_data);
+		_allocate(other._rows, other._cols);
+	}
+	_rows = other._rows;
+	_cols = other._cols;
+	_stride = other._stride;
+	if (_data)
+		std::memcpy(_data, other._data, _rows * _stride * sizeof(T));
+	return *this;
+}
+
+template <typename T>
+Matrix<T>	&Matrix<T>::operator=(Matrix &&other) noexcept {
+	if (this == &other)
+		return *this;
+	simd::aligned_free(_data);
+	_data = std::exchange(other._data, nullptr);
+	_rows = std::exchange(other._rows, 0);
+	_cols = std::exchange(other._cols, 0);
+	_stride = std::exchange(other._stride, 0);
+	return *this;
+}
+
+// comparison operators
+
+template <typename T>
+bool	Matrix<T>::operator==(const Matrix &other) const {
+	if (_rows != other._rows || _cols != other._cols)
+		return false;
+	if constexpr (detail::dispatched<T>)
+		return simd::dispatch::table<T>().equal(_data, other._data, _rows * _stride);
+	else
+		return std::equal(_data, _data + _rows * _stride, other._data);
+}
+
+template <typename T>
+bool	Matrix<T>::operator!=(const Matrix &other) const {
+	return !(*this == other);
+}
+
+// arithmetic operators
+
+template <typename T>
+Matrix<T>	Matrix<T>::operator+(const Matrix &other) const {
+	Matrix<T> res(*this);
+	return res += other;
+}
+
+template <typename T>
+Matrix<T>	Matrix<T>::operator-(const Matrix &other) const {
+	Matrix<T> res(*this);
+	return res -= other;
+}
+
+template <typename T>
+Matrix<T>	Matrix<T>::operator*(const Matrix &other) const {
+	if (_cols != other._rows)
+		throw std::invalid_argument("Matrix product needs cols() == other.rows().");
+	Matrix<T> res = uninitialized(_rows, other._cols);
+	tlap::gemm(_rows, other._cols, _cols, T(1), _data, _stride, other._data, other._stride, T(0), res._data, res._stride);
+	return res;
+}
+
+template <typename T>
+Vector<T>	Matrix<T>::operator*(const Vector<T> &v) const {
+	if (_cols != v.shape())
+		throw std::invalid_argument("Matrix cols() must match the Vector size.");
+	Vector<T> res = Vector<T>::uninitialized(_rows);
+	tlap::gemv(_rows, _cols, T(1), _data, _stride, v.data(), T(0), res.data());
+	return res;
+}
+
+template <typename T>
+Matrix<T>	Matrix<T>::operator*(const T &scalar) const {
+	Matrix<T> res(*this);
+	return res *= scalar;
+}
+
+template <typename T>
+Matrix<T>	Matrix<T>::operator/(const T &scalar) const {
+	Matrix<T> res(*this);
+	return res /= scalar;
+}
+
+// the elementwise operators run over the padded storage as one Vector would
+
+#define TLAP_MATRIX_BINARY(op, kernel)														\
+	if (_rows != other._rows || _cols != other._cols)										\
+		throw std::invalid_argument("Matrices must have the same shape.");					\
+	detail::vector_split<T>(_rows * _stride, [&](size_t i, size_t n) {						\
+		if constexpr (detail::dispatched<T>)												\
+			simd::dispatch::table<T>().kernel(_data + i, _data + i, other._data + i, n);	\
+		else																				\
+			detail::vector_map(_data + i, _data + i, other._data + i, n, [](auto a, auto b) TLAP_INLINE { return a op b; });	\
+	});																						\
+	return *this;
+
+template <typename T>
+Matrix<T>	&Matrix<T>::operator+=(const Matrix &other) {
+	TLAP_MATRIX_BINARY(+, add)
+}
+
+template <typename T>
+Matrix<T>	&Matrix<T>::operator-=(const Matrix &other) {
+	TLAP_MATRIX_BINARY(-, sub)
+}
+
+#undef TLAP_MATRIX_BINARY
+
+template <typename T>
+Matrix<T>	&Matrix<T>::operator*=(const Matrix &other) {
+	return *this = *this * other;
+}
+
+template <typename T>
+Matrix<T>	&Matrix<T>::operator*=(const T &scalar) {
+	const compute_t<T> s = scalar;
+	detail::vector_split<T>(_rows * _stride, [&](size_t i, size_t n) {
+		if constexpr (detail::dispatched<T>)
+			simd::dispatch::table<T>().scale(_data + i, _data + i, n, s);
+		else
+			detail::vector_map(_data + i, _data + i, n, [s](auto a) TLAP_INLINE { return a * s; });
+	});
+	_clearPadding(); // 0 * inf
+	return *this;
+}
+
+template <typename T>
+Matrix<T>	&Matrix<T>::operator/=(const T &scalar) {
+	const compute_t<T> s = scalar;
+	if constexpr (std::is_integral<T>::value)
+		if (s == 0)
+			throw std::invalid_argument("Division by zero");
+	detail::vector_split<T>(_rows * _stride, [&](size_t i, size_t n) {
+		if constexpr (detail::dispatched<T>)
+			simd::dispatch::table<T>().divide(_data + i, _data + i, n, s);
+		else
+			detail::vector_map(_data + i, _data + i, n, [s](auto a) TLAP_INLINE { return a / s; });
+	});
+	_clearPadding(); // 0 / 0
+	return *this;
+}
+
+template <typename U, typename T> requires std::is_arithmetic<U>::value
+Matrix<T>	operator*(const U &scalar, const Matrix<T> &m) {
+	return m * static_cast<T>(scalar);
+}
+
+// index access
+
+template <typename T>
+const T	&Matrix<T>::operator()(size_t row, size_t col) const {
+	return _data[row * _stride + col];
+}
+
+template <typename T>
+T		&Matrix<T>::operator()(size_t row, size_t col) {
+	return _data[row * _stride + col];
+}
+
+template <typename T>
+const T	*Matrix<T>::row(size_t index) const {
+	return _data + index * _stride;
+}
+
+template <typename T>
+T		*Matrix<T>::row(size_t index) {
+	return _data + index * _stride;
+}
+
+template <typename T>
+const T	*Matrix<T>::data() const {
+	return _data;
+}
+
+template <typename T>
+T		*Matrix<T>::data() {
+	return _data;
+}
+
+// various operations and methods
+
+// gemm cannot write into one of its operands: a temporary only in that case
+template <typename T>
+Matrix<T>	&Matrix<T>::mulAdd(const Matrix &a, const Matrix &b, const T &alpha, const T &beta) {
+	if (a._cols != b._rows || _rows != a._rows || _cols != b._cols)
+		throw std::invalid_argument("mulAdd() needs a (m x k), b (k x n) and this (m x n).");
+	if (&a == this || &b == this)
+		return mulAdd(Matrix<T>(a), Matrix<T>(b), alpha, beta);
+	tlap::gemm(_rows, _cols, a._cols, alpha, a._data, a._stride, b._data, b._stride, beta, _data, _stride);
+	return *this;
+}
+
+// 8 x 8 tiles, so that the writes of one tile stay in a few cache lines
+template <typename T>
+Matrix<T>	Matrix<T>::transpose() const {
+	constexpr size_t	tile = 8;
+	Matrix<T>			res = uninitialized(_cols, _rows);
+
+	for (size_t i0 = 0; i0 < _rows; i0 += tile)
+		for (size_t j0 = 0; j0 < _cols; j0 += tile)
+			for (size_t i = i0; i < std::min(i0 + tile, _rows); ++i)
+				for (size_t j = j0; j < std::min(j0 + tile, _cols); ++j)
+					res._data[j * res._stride + i] = _data[i * _stride + j];
+	return res;
+}
+
+template <typename T>
+size_t	Matrix<T>::rows() const {
+	return _rows;
+}
+
+template <typename T>
+size_t	Matrix<T>::cols() const {
+	return _cols;
+}
+
+template <typename T>
+size_t	Matrix<T>::stride() const {
+	return _stride;
+}
+
+// Vector::transform needs the complete Matrix, it is defined here
+
+template <typename T, typename Enable>
+Vector<T>	&Vector<T, Enable>::transform(const tlap::Matrix<T> &matrix) {
+	return *this = matrix * *this;
+}
+
+} // namespace tlap
@@ -0,0 +1,26 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: general matrix products on raw row-major storage, behind Matrix
+// File version: 0.1
+#pragma once
+
+#include <cstddef>
+
+// BLAS-like entry points on row-major arrays: lda, ldb, ldc are the distances
+// in elements between two rows. float and double run a cache-blocked engine
+// with packed panels and an fma micro-kernel per isa level, picked at run time
+// like the Vector kernels (simd/dispatch.hpp), and spread over the threads of
+// parallel/pool.hpp. half and bfloat16 compute in float: gemv loads their
+// rows into float packs, gemm runs the float engine on widened copies. other
+// arithmetic types run a plain loop.
+// c must not overlap a, b or x.
+namespace tlap {
+	// c (m x n) = alpha * a (m x k) * b (k x n) + beta * c, c is not read when beta == 0
+	template <typename T>
+	void	gemm(size_t m, size_t n, size_t k, T alpha, const T *a, size_t lda, const T *b, size_t ldb, T beta, T *c, size_t ldc);
+
+	// y (m) = alpha * a (m x n) * x (n) + beta * y, y is not read when beta == 0
+	template <typename T>
+	void	gemv(size_t m, size_t n, T alpha, const T *a, size_t lda, const T *x, T beta, T *y);
+}
+
+#include "gemm.tpp"
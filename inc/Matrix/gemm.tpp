@@ -0,0 +1,149 @@
+#pragma once
+
+#include "gemm.hpp"
+#include "../hyperp.hpp"
+#include "../simd/simd.hpp"
+#include "../simd/dispatch.hpp"
+#include "../parallel/pool.hpp"
+#include "../profile/profile.hpp"
+#include "../Vector/Vector.hpp"
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+// one copy of the engine per level, as simd/dispatch.tpp does for its kernels
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#define TLAP_DISPATCH_ISA scalar
+#include "gemm_kernels.tpp"
+#undef TLAP_DISPATCH_ISA
+
+#pragma GCC push_options
+#if !(defined(__AVX2__) && defined(__FMA__) && defined(__F16C__))
+# pragma GCC target("avx2,fma,f16c")
+#endif
+#define TLAP_DISPATCH_ISA avx2
+#include "gemm_kernels.tpp"
+#undef TLAP_DISPATCH_ISA
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#if !(defined(__AVX512F__) && defined(__AVX512DQ__))
+# pragma GCC target("avx512f,avx512dq")
+#endif
+#define TLAP_DISPATCH_ISA avx512
+#include "gemm_kernels.tpp"
+#undef TLAP_DISPATCH_ISA
+#pragma GCC pop_options
+#pragma GCC diagnostic pop
+
+
+namespace tlap {
+
+namespace detail::gemm {
+
+// integers: i-k-j so that the inner loop runs along rows of b and c
+template <typename T>
+void	gemm_loop(size_t m, size_t n, size_t k, T alpha, const T *a, size_t lda, const T *b, size_t ldb, T beta, T *c, size_t ldc) {
+	const bool	parallel = m * n * k >= GEMM_PARALLEL_MIN;
+
+	parallel::parallel_for(0, m, (parallel ? 1 : m), [&](size_t i0, size_t i1) {
+		for (size_t i = i0; i < i1; ++i) {
+			T	*ci = c + i * ldc;
+			for (size_t j = 0; j < n; ++j)
+				ci[j] = (beta != T(0) ? beta * ci[j] : T(0));
+			for (size_t p = 0; p < k; ++p) {
+				const T	aip = alpha * a[i * lda + p];
+				const T	*bp = b + p * ldb;
+				TLAP_SIMD_LOOP
+				for (size_t j = 0; j < n; ++j)
+					ci[j] += aip * bp[j];
+			}
+		}
+	}, "gemm");
+}
+
+template <typename T>
+void	gemv_loop(size_t m, size_t n, T alpha, const T *a, size_t lda, const T *x, T beta, T *y) {
+	const bool	parallel = m * n >= GEMV_PARALLEL_MIN;
+
+	parallel::parallel_for(0, m, (parallel ? 1 : m), [&](size_t i0, size_t i1) {
+		for (size_t i = i0; i < i1; ++i) {
+			T	sum = T(0);
+			for (size_t j = 0; j < n; ++j)
+				sum += a[i * lda + j] * x[j];
+			y[i] = alpha * sum + (beta != T(0) ? beta * y[i] : T(0));
+		}
+	}, "gemv");
+}
+
+// the isa of the compile flags when SIMD_DISPATCH is 0
+template <typename T>
+simd::dispatch::level	level() {
+	if constexpr (dispatched<T> || is_reduced_float<T>)
+		return simd::dispatch::active();
+	return simd::dispatch::native;
+}
+
+// half and bfloat16: the operands widened to float once, O(mk + kn + mn)
+// conversions against O(mnk) flops, the float engine, c rounded back
+template <typename T>
+void	gemm_widened(size_t m, size_t n, size_t k, T alpha, const T *a, size_t lda, const T *b, size_t ldb, T beta, T *c, size_t ldc) {
+	const simd::dispatch::reduced_kernels<T>	&cv = simd::dispatch::reduced<T>();
+	std::vector<float>	wa(m * k), wb(k * n), wc(m * n);
+
+	for (size_t i = 0; i < m; ++i)
+		cv.widen(wa.data() + i * k, a + i * lda, k);
+	for (size_t p = 0; p < k; ++p)
+		cv.widen(wb.data() + p * n, b + p * ldb, n);
+	if (beta != T(0))
+		for (size_t i = 0; i < m; ++i)
+			cv.widen(wc.data() + i * n, c + i * ldc, n);
+	tlap::gemm(m, n, k, float(alpha), wa.data(), k, wb.data(), n, float(beta), wc.data(), n);
+	for (size_t i = 0; i < m; ++i)
+		cv.narrow(c + i * ldc, wc.data() + i * n, n);
+}
+
+} // namespace detail::gemm
+
+template <typename T>
+void	gemm(size_t m, size_t n, size_t k, T alpha, const T *a, size_t lda, const T *b, size_t ldb, T beta, T *c, size_t ldc) {
+	static_assert(is_element<T>, "gemm needs an arithmetic type");
+	TLAP_PROFILE_KERNEL("gemm", T, (detail::packed<T> ? detail::gemm::level<T>() : simd::dispatch::level::scalar), m * n * k);
+	if (!m || !n)
+		return;
+	if (!k || alpha == T(0)) {
+		for (size_t i = 0; i < m; ++i)
+			for (size_t j = 0; j < n; ++j)
+				c[i * ldc + j] = (beta != T(0) ? T(beta * c[i * ldc + j]) : T(0));
+		return;
+	}
+	if constexpr (is_reduced_float<T>)
+		detail::gemm::gemm_widened(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+	else if constexpr (detail::has_pack<T>) {
+		switch (detail::gemm::level<T>()) {
+			case simd::dispatch::level::avx512:	return detail::gemm::avx512::gemm(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+			case simd::dispatch::level::avx2:	return detail::gemm::avx2::gemm(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+			default:							return detail::gemm::scalar::gemm(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+		}
+	} else
+		detail::gemm::gemm_loop(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
+
+template <typename T>
+void	gemv(size_t m, size_t n, T alpha, const T *a, size_t lda, const T *x, T beta, T *y) {
+	static_assert(is_element<T>, "gemv needs an arithmetic type");
+	TLAP_PROFILE_KERNEL("gemv", T, (detail::packed<T> ? detail::gemm::level<T>() : simd::dispatch::level::scalar), m * n);
+	if constexpr (detail::packed<T>) {
+		switch (detail::gemm::level<T>()) {
+			case simd::dispatch::level::avx512:	return detail::gemm::avx512::gemv(m, n, alpha, a, lda, x, beta, y);
+			case simd::dispatch::level::avx2:	return detail::gemm::avx2::gemv(m, n, alpha, a, lda, x, beta, y);
+			default:							return detail::gemm::scalar::gemv(m, n, alpha, a, lda, x, beta, y);
+		}
+	} else
+		detail::gemm::gemv_loop(m, n, alpha, a, lda, x, beta, y);
+}
+
+} // namespace tlap
@@ -0,0 +1,220 @@
+// one level of the gemm engine, included by gemm.tpp once per level with
+// TLAP_DISPATCH_ISA naming both the level and its isa, inside the matching
+// #pragma GCC target region (see simd/dispatch.tpp). no include guard on purpose.
+
+namespace tlap::detail::gemm::TLAP_DISPATCH_ISA {
+
+template <typename T>
+using V = simd::pack<T, simd::isa::TLAP_DISPATCH_ISA>;
+
+// register tile of the micro-kernel: mr rows of C by nv packs of columns, the
+// mr * nv accumulators plus one row of B and a broadcast fill the register file
+// (16 ymm, 32 zmm). the one-lane scalar level keeps a 4 x 8 tile the compiler
+// turns into sse2. kc sizes a packed nr x kc panel of B to L1 (the mr x kc
+// panel of A streams through, a longer kc pays the C tile update less often),
+// mc a packed mc x kc block of A to half of L2, nc a kc x nc block of B to
+// half of L3
+template <typename T>
+struct	blocking {
+	static constexpr size_t	width = V<T>::width;
+	static constexpr size_t	nv = (width == 1 ? 8 : 2);
+	static constexpr size_t	mr = (width == 1 ? 4 : std::is_same<simd::isa::TLAP_DISPATCH_ISA, simd::isa::avx512>::value ? 12 : 6);
+	static constexpr size_t	nr = nv * width;
+	static constexpr size_t	kc = std::clamp<size_t>(CACHE_L1 / (nr * sizeof(T)) / 8 * 8, 128, 512);
+	static constexpr size_t	mc = std::max<size_t>(CACHE_L2 / 2 / (kc * sizeof(T)) / mr, 1) * mr;
+	static constexpr size_t	nc = std::max<size_t>(CACHE_L3 / 2 / (kc * sizeof(T)) / nr, 1) * nr;
+};
+
+// rows x kc of a into an mr-row panel, the mr values of one k side by side,
+// rows past the edge of A zeroed
+template <typename T>
+inline void	pack_a(T *dst, const T *a, size_t lda, size_t rows, size_t kc) {
+	constexpr size_t mr = blocking<T>::mr;
+	const T		*row[mr];
+
+	for (size_t r = 0; r < mr; ++r)
+		row[r] = a + std::min(r, rows - 1) * lda;
+	for (size_t k = 0; k < kc; ++k, dst += mr)
+		for (size_t r = 0; r < mr; ++r)
+			dst[r] = (r < rows ? row[r][k] : T(0));
+}
+
+// kc x cols of b into an nr-column panel, one aligned row of nr values per k,
+// columns past the edge of B zeroed
+template <typename T>
+inline void	pack_b(T *dst, const T *b, size_t ldb, size_t cols, size_t kc) {
+	constexpr size_t nr = blocking<T>::nr;
+
+	for (size_t k = 0; k < kc; ++k, dst += nr, b += ldb) {
+		size_t j = 0;
+		for (; j < cols; ++j)
+			dst[j] = b[j];
+		for (; j < nr; ++j)
+			dst[j] = T(0);
+	}
+}
+
+// c = alpha * a b + beta * c on one mr x nr tile, rows x cols of it inside C.
+// beta == 0 never reads c
+template <typename T>
+inline void	micro(size_t kc, const T *a, const T *b, T *c, size_t ldc, T alpha, T beta, size_t rows, size_t cols) {
+	using P = V<T>;
+	constexpr size_t mr = blocking<T>::mr;
+	constexpr size_t nv = blocking<T>::nv;
+	constexpr size_t nr = blocking<T>::nr;
+	P	acc[mr][nv];
+
+#pragma GCC unroll 16
+	for (size_t r = 0; r < mr; ++r)
+#pragma GCC unroll 8
+		for (size_t v = 0; v < nv; ++v)
+			acc[r][v] = P(T(0));
+	for (size_t k = 0; k < kc; ++k, a += mr, b += nr) {
+		P	bv[nv];
+#pragma GCC unroll 8
+		for (size_t v = 0; v < nv; ++v)
+			bv[v] = P::load(b + v * P::width);
+#pragma GCC unroll 16
+		for (size_t r = 0; r < mr; ++r) {
+			const P av(a[r]);
+#pragma GCC unroll 8
+			for (size_t v = 0; v < nv; ++v)
+				acc[r][v] = fma(av, bv[v], acc[r][v]);
+		}
+	}
+
+	const P	va(alpha);
+	if (rows == mr && cols == nr) {
+		const P	vb(beta);
+#pragma GCC unroll 16
+		for (size_t r = 0; r < mr; ++r)
+#pragma GCC unroll 8
+			for (size_t v = 0; v < nv; ++v) {
+				T	*p = c + r * ldc + v * P::width;
+				P	res = acc[r][v] * va;
+				if (beta != T(0))
+					res = fma(vb, P::loadu(p), res);
+				res.storeu(p);
+			}
+		return;
+	}
+	alignas(simd::alignment) T	tile[mr * nr];
+	for (size_t r = 0; r < mr; ++r)
+		for (size_t v = 0; v < nv; ++v)
+			(acc[r][v] * va).store(tile + r * nr + v * P::width);
+	for (size_t r = 0; r < rows; ++r)
+		for (size_t j = 0; j < cols; ++j)
+			c[r * ldc + j] = tile[r * nr + j] + (beta != T(0) ? beta * c[r * ldc + j] : T(0));
+}
+
+// jc (nc columns of C) > pc (kc of the depth) > ic (mc rows) > jr > ir, the
+// classic five loops around the micro-kernel. both packed blocks are shared:
+// the threads pack them together (one parallel_for each), then split the nr
+// panels of B (jr), each streaming the whole A block out of its own L2. a C
+// with fewer panels than threads (tall-skinny products, the batch steps of
+// einsum) splits the mr x nr tiles of the block instead, so that the A side
+// spreads over the cores too. every tile sums the same way either split
+template <typename T>
+void	gemm(size_t m, size_t n, size_t k, T alpha, const T *a, size_t lda, const T *b, size_t ldb, T beta, T *c, size_t ldc) {
+	using B = blocking<T>;
+	const size_t	kcmax = std::min(B::kc, k);
+	T				*ap = simd::aligned_alloc<T>(std::min(B::mc, (m + B::mr - 1) / B::mr * B::mr) * kcmax);
+	T				*bp = simd::aligned_alloc<T>(std::min(B::nc, (n + B::nr - 1) / B::nr * B::nr) * kcmax);
+	const bool	parallel = m * n * k >= GEMM_PARALLEL_MIN;
+	const size_t	threads = (parallel ? parallel::current().concurrency() : 1);
+
+	for (size_t jc = 0; jc < n; jc += B::nc) {
+		const size_t	ncb = std::min(B::nc, n - jc);
+		const size_t	panels = (ncb + B::nr - 1) / B::nr;
+		for (size_t pc = 0; pc < k; pc += B::kc) {
+			const size_t	kcb = std::min(B::kc, k - pc);
+			const T			betab = (pc ? T(1) : beta); // the first depth block applies beta
+
+			parallel::parallel_for(0, ncb, (parallel ? B::nr : ncb), [&](size_t j0, size_t j1) {
+				for (size_t jr = j0; jr < j1; jr += B::nr)
+					pack_b(bp + jr * kcb, b + pc * ldb + jc + jr, ldb, std::min(B::nr, ncb - jr), kcb);
+			}, "gemm");
+			for (size_t ic = 0; ic < m; ic += B::mc) {
+				const size_t	mcb = std::min(B::mc, m - ic);
+
+				parallel::parallel_for(0, mcb, (parallel ? B::mr : mcb), [&](size_t i0, size_t i1) {
+					for (size_t ir = i0; ir < i1; ir += B::mr)
+						pack_a(ap + ir * kcb, a + (ic + ir) * lda + pc, lda, std::min(B::mr, mcb - ir), kcb);
+				}, "gemm");
+				if (panels >= threads)
+					parallel::parallel_for(0, ncb, (parallel ? B::nr : ncb), [&](size_t j0, size_t j1) {
+						for (size_t jr = j0; jr < j1; jr += B::nr)
+							for (size_t ir = 0; ir < mcb; ir += B::mr)
+								micro(kcb, ap + ir * kcb, bp + jr * kcb, c + (ic + ir) * ldc + jc + jr, ldc,
+									alpha, betab, std::min(B::mr, mcb - ir), std::min(B::nr, ncb - jr));
+					}, "gemm");
+				else {
+					const size_t	rows = (mcb + B::mr - 1) / B::mr; // tile t: panel t / rows, rows t % rows
+					parallel::parallel_for(0, panels * rows, 1, [&](size_t t0, size_t t1) {
+						for (size_t t = t0; t < t1; ++t) {
+							const size_t	jr = t / rows * B::nr;
+							const size_t	ir = t % rows * B::mr;
+							micro(kcb, ap + ir * kcb, bp + jr * kcb, c + (ic + ir) * ldc + jc + jr, ldc,
+								alpha, betab, std::min(B::mr, mcb - ir), std::min(B::nr, ncb - jr));
+						}
+					}, "gemm");
+				}
+			}
+		}
+	}
+	simd::aligned_free(ap);
+	simd::aligned_free(bp);
+}
+
+// y = alpha * a x + beta * y, four rows per step share every load of x.
+// memory bound: no packing, one pass over a. the one-lane scalar level keeps
+// 8 plain partial sums per row instead, which the compiler turns into sse2.
+// half and bfloat16 rows load into float packs, half the bytes of float
+template <typename T>
+void	gemv(size_t m, size_t n, T alpha, const T *a, size_t lda, const T *x, T beta, T *y) {
+	using C = compute_t<T>;
+	using P = std::conditional_t<V<C>::width == 1, C, V<C>>;
+	constexpr size_t			lanes = (V<C>::width == 1 ? 8 : 1);
+	constexpr size_t			step = lanes * V<C>::width;
+	const bool					parallel = m * n >= GEMV_PARALLEL_MIN;
+
+	parallel::parallel_for(0, m, (parallel ? 4 : m), [&](size_t i0, size_t i1) {
+		for (size_t i = i0; i < i1; i += 4) {
+			const size_t	rows = std::min<size_t>(4, m - i);
+			const T			*row[4];
+			P				acc[4][lanes];
+			C				sum[4];
+			size_t			j = 0;
+
+			for (size_t r = 0; r < 4; ++r) {
+				row[r] = a + (i + std::min(r, rows - 1)) * lda; // past the edge: a row again, dropped
+				for (size_t l = 0; l < lanes; ++l)
+					acc[r][l] = P(C(0));
+			}
+			for (; j + step <= n; j += step)
+				for (size_t r = 0; r < 4; ++r)
+#pragma GCC unroll 8
+					for (size_t l = 0; l < lanes; ++l) {
+						if constexpr (lanes == 1)
+							acc[r][l] = fma(P::loadu(row[r] + j), P::loadu(x + j), acc[r][l]);
+						else
+							acc[r][l] += C(row[r][j + l]) * C(x[j + l]);
+					}
+			for (size_t r = 0; r < 4; ++r) {
+				P	total = acc[r][0];
+				for (size_t l = 1; l < lanes; ++l)
+					total = total + acc[r][l];
+				if constexpr (lanes == 1)
+					sum[r] = reduce_add(total);
+				else
+					sum[r] = total;
+				for (size_t t = j; t < n; ++t)
+					sum[r] += C(row[r][t]) * C(x[t]);
+			}
+			for (size_t r = 0; r < rows; ++r)
+				y[i + r] = T(C(alpha) * sum[r] + (beta != T(0) ? C(beta) * C(y[i + r]) : C(0)));
+		}
+	}, "gemv");
+}
+
+} // namespace tlap::detail::gemm::TLAP_DISPATCH_ISA
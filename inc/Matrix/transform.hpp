@@ -0,0 +1,46 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: batched 3x3 / 4x4 transforms of millions of points per call
+// File version: 0.1
+#pragma once
+
+#include "Matrix.hpp"
+#include <cstddef>
+#include <vector>
+
+// Vector::transform and Vector::rotate move one vector per call, transformBatch
+// moves a whole point set: every point is read once, transformed on simd packs
+// and written back in place, tiles of points spread over the threads.
+// the matrix decides the transform of 3-component points:
+//     3x3: linear, p' = M p
+//     3x4: affine, p' = M p + t (t the last column)
+//     4x4: homogeneous (x, y, z, 1), divided by w' unless the last row is 0 0 0 1
+// 4-component points need a 4x4 and are not divided. normalize scales every
+// result to unit length in the same pass (normals, directions), zero results
+// stay zero. float and double only.
+namespace tlap {
+	// component c of point i is at c[c][i * stride]: separate arrays with
+	// stride 1 (structure of arrays, the fast path), or one interleaved buffer
+	template <typename T>
+	struct	PointSet {
+		T		*c[4]; // x, y, z, w; w is null for 3 components
+		size_t	dim;
+		size_t	count;
+		size_t	stride;
+
+		static PointSet	soa(Vector<T> &x, Vector<T> &y, Vector<T> &z); // throws on different sizes
+		static PointSet	soa(Vector<T> &x, Vector<T> &y, Vector<T> &z, Vector<T> &w);
+		static PointSet	soa(T *x, T *y, T *z, T *w, size_t count); // w may be null
+		static PointSet	interleaved(T *data, size_t count, size_t dim, size_t stride); // x y z (w) at data + i * stride
+	};
+
+	// one transform for every point
+	template <typename T>
+	void	transformBatch(const Matrix<T> &m, const PointSet<T> &points, bool normalize = false);
+
+	// one transform per group: group g holds points [ends[g - 1], ends[g]),
+	// ends non decreasing and ends.back() == points.count
+	template <typename T>
+	void	transformBatch(const std::vector<Matrix<T>> &m, const std::vector<size_t> &ends, const PointSet<T> &points, bool normalize = false);
+}
+
+#include "transform.tpp"
@@ -0,0 +1,211 @@
+#pragma once
+
+#include "transform.hpp"
+#include "gemm.hpp"
+#include "../hyperp.hpp"
+#include "../simd/simd.hpp"
+#include "../simd/dispatch.hpp"
+#include "../parallel/pool.hpp"
+#include "../profile/profile.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+namespace tlap {
+
+namespace detail {
+
+// a Matrix read once into a 4 x 4 array, missing rows and columns of the identity
+template <typename T>
+struct	xform {
+	T		m[4][4];
+	bool	projective; // 3 components, divided by w'
+
+	xform(const Matrix<T> &mat, size_t dim) {
+		const bool fits = (dim == 3 && (mat.rows() == 3 || mat.rows() == 4) && (mat.cols() == 3 || mat.cols() == 4)
+			&& !(mat.rows() == 4 && mat.cols() == 3)) || (dim == 4 && mat.rows() == 4 && mat.cols() == 4);
+		if (!fits)
+			throw std::invalid_argument("transformBatch needs a 3x3, 3x4 or 4x4 Matrix for 3 components, a 4x4 for 4.");
+		for (size_t i = 0; i < 4; ++i)
+			for (size_t j = 0; j < 4; ++j)
+				m[i][j] = (i < mat.rows() && j < mat.cols() ? mat(i, j) : T(i == j));
+		projective = dim == 3 && (m[3][0] != T(0) || m[3][1] != T(0) || m[3][2] != T(0) || m[3][3] != T(1));
+	}
+};
+
+// n points of stride 1 at x, y, z, w (w unused for 3 components), P a pack of
+// any isa; the points past the last whole pack go through the one-lane pack
+template <typename P, size_t Dim, bool Projective, bool Normalize, typename T>
+TLAP_INLINE inline void	transform_points(const xform<T> &f, T *x, T *y, T *z, T *w, size_t n) {
+	auto one = [&f, x, y, z, w] <typename X> (size_t i) TLAP_INLINE {
+		const X	vx = X::loadu(x + i), vy = X::loadu(y + i), vz = X::loadu(z + i);
+		const X	vw = (Dim == 4 ? X::loadu(w + i) : X(T(1)));
+		X		r[4];
+
+		for (size_t k = 0; k < Dim + Projective; ++k)
+			r[k] = fma(X(f.m[k][0]), vx, fma(X(f.m[k][1]), vy, fma(X(f.m[k][2]), vz, X(f.m[k][3]) * vw)));
+		if constexpr (Projective) {
+			const X inv = X(T(1)) / r[3];
+			for (size_t k = 0; k < 3; ++k)
+				r[k] = r[k] * inv;
+		}
+		if constexpr (Normalize) {
+			X len2 = r[0] * r[0];
+			for (size_t k = 1; k < Dim; ++k)
+				len2 = fma(r[k], r[k], len2);
+			const auto	nonzero = len2 > X(T(0));
+			const X		inv = X(T(1)) / sqrt(select(nonzero, len2, X(T(1))));
+			for (size_t k = 0; k < Dim; ++k)
+				r[k] = r[k] * inv;
+		}
+		r[0].storeu(x + i);
+		r[1].storeu(y + i);
+		r[2].storeu(z + i);
+		if constexpr (Dim == 4)
+			r[3].storeu(w + i);
+	};
+	size_t	i = 0;
+
+	if constexpr (P::width == 1) {
+		TLAP_SIMD_LOOP // the scalar level, left to the compiler
+		for (size_t j = 0; j < n; ++j)
+			one.template operator()<P>(j);
+		return;
+	}
+	for (; i + P::width <= n; i += P::width)
+		one.template operator()<P>(i);
+	for (; i < n; ++i)
+		one.template operator()<simd::pack<T, simd::isa::scalar>>(i);
+}
+
+// the kernel once per isa level, transform_points and its lambda always
+// inlined into the target function as for the Vector expressions
+template <size_t Dim, bool Projective, bool Normalize, typename T>
+[[gnu::flatten]] TLAP_TARGET_AVX512 void	transform_avx512(const xform<T> &f, T *x, T *y, T *z, T *w, size_t n) {
+	transform_points<simd::pack<T, simd::isa::avx512>, Dim, Projective, Normalize>(f, x, y, z, w, n);
+}
+
+template <size_t Dim, bool Projective, bool Normalize, typename T>
+[[gnu::flatten]] TLAP_TARGET_AVX2 void	transform_avx2(const xform<T> &f, T *x, T *y, T *z, T *w, size_t n) {
+	transform_points<simd::pack<T, simd::isa::avx2>, Dim, Projective, Normalize>(f, x, y, z, w, n);
+}
+
+template <size_t Dim, bool Projective, bool Normalize, typename T>
+void	transform_level(const xform<T> &f, T *x, T *y, T *z, T *w, size_t n) {
+	switch (gemm::level<T>()) {
+		case simd::dispatch::level::avx512:	return transform_avx512<Dim, Projective, Normalize>(f, x, y, z, w, n);
+		case simd::dispatch::level::avx2:	return transform_avx2<Dim, Projective, Normalize>(f, x, y, z, w, n);
+		default:							return transform_points<simd::pack<T, simd::isa::scalar>, Dim, Projective, Normalize>(f, x, y, z, w, n);
+	}
+}
+
+// run time flags to template arguments
+template <typename T>
+void	transform_soa(const xform<T> &f, size_t dim, bool normalize, T *x, T *y, T *z, T *w, size_t n) {
+	TLAP_PROFILE_KERNEL("transform", T, gemm::level<T>(), n);
+	if (dim == 4)
+		return normalize ? transform_level<4, false, true>(f, x, y, z, w, n) : transform_level<4, false, false>(f, x, y, z, w, n);
+	if (f.projective)
+		return normalize ? transform_level<3, true, true>(f, x, y, z, w, n) : transform_level<3, true, false>(f, x, y, z, w, n);
+	return normalize ? transform_level<3, false, true>(f, x, y, z, w, n) : transform_level<3, false, false>(f, x, y, z, w, n);
+}
+
+// points [begin, end) with the transform f; an interleaved set is copied
+// to structure of arrays on the stack and back, TRANSFORM_TILE points at a time
+template <typename T>
+void	transform_range(const xform<T> &f, const PointSet<T> &p, bool normalize, size_t begin, size_t end) {
+	if (p.stride == 1)
+		return transform_soa(f, p.dim, normalize, p.c[0] + begin, p.c[1] + begin, p.c[2] + begin,
+			(p.dim == 4 ? p.c[3] + begin : nullptr), end - begin);
+
+	alignas(simd::alignment) T	soa[4][TRANSFORM_TILE];
+	for (size_t t = begin; t < end; t += TRANSFORM_TILE) {
+		const size_t n = std::min<size_t>(TRANSFORM_TILE, end - t);
+		for (size_t k = 0; k < p.dim; ++k)
+			for (size_t i = 0; i < n; ++i)
+				soa[k][i] = p.c[k][(t + i) * p.stride];
+		transform_soa(f, p.dim, normalize, soa[0], soa[1], soa[2], soa[3], n);
+		for (size_t k = 0; k < p.dim; ++k)
+			for (size_t i = 0; i < n; ++i)
+				p.c[k][(t + i) * p.stride] = soa[k][i];
+	}
+}
+
+// f(begin, end) over tiles of the count points, spread over the threads
+template <typename F>
+void	transform_tiles(size_t count, F f) {
+	const bool	parallel = count >= TRANSFORM_PARALLEL_MIN;
+
+	parallel::parallel_for(0, count, (parallel ? TRANSFORM_TILE : count), [&](size_t begin, size_t end) {
+		for (size_t t = begin; t < end; t += TRANSFORM_TILE)
+			f(t, std::min<size_t>(t + TRANSFORM_TILE, end));
+	}, "transform");
+}
+
+} // namespace detail
+
+// point sets
+
+template <typename T>
+PointSet<T>	PointSet<T>::soa(Vector<T> &x, Vector<T> &y, Vector<T> &z) {
+	if (x.shape() != y.shape() || x.shape() != z.shape())
+		throw std::invalid_argument("Vectors must have the same size.");
+	return {{x.data(), y.data(), z.data(), nullptr}, 3, x.shape(), 1};
+}
+
+template <typename T>
+PointSet<T>	PointSet<T>::soa(Vector<T> &x, Vector<T> &y, Vector<T> &z, Vector<T> &w) {
+	if (x.shape() != y.shape() || x.shape() != z.shape() || x.shape() != w.shape())
+		throw std::invalid_argument("Vectors must have the same size.");
+	return {{x.data(), y.data(), z.data(), w.data()}, 4, x.shape(), 1};
+}
+
+template <typename T>
+PointSet<T>	PointSet<T>::soa(T *x, T *y, T *z, T *w, size_t count) {
+	return {{x, y, z, w}, (w ? size_t(4) : size_t(3)), count, 1};
+}
+
+template <typename T>
+PointSet<T>	PointSet<T>::interleaved(T *data, size_t count, size_t dim, size_t stride) {
+	if ((dim != 3 && dim != 4) || stride < dim)
+		throw std::invalid_argument("interleaved points need 3 or 4 components and stride >= dim.");
+	return {{data, data + 1, data + 2, (dim == 4 ? data + 3 : nullptr)}, dim, count, stride};
+}
+
+// transforms
+
+template <typename T>
+void	transformBatch(const Matrix<T> &m, const PointSet<T> &points, bool normalize) {
+	static_assert(std::is_floating_point<T>::value, "transformBatch needs float or double points");
+	const detail::xform<T> f(m, points.dim);
+
+	detail::transform_tiles(points.count, [&](size_t begin, size_t end) {
+		detail::transform_range(f, points, normalize, begin, end);
+	});
+}
+
+// tiles cut through groups: a tile runs one segment per group it overlaps, so
+// the threads share the work whatever the group sizes
+template <typename T>
+void	transformBatch(const std::vector<Matrix<T>> &m, const std::vector<size_t> &ends, const PointSet<T> &points, bool normalize) {
+	static_assert(std::is_floating_point<T>::value, "transformBatch needs float or double points");
+	if (m.size() != ends.size())
+		throw std::invalid_argument("transformBatch() needs one end per transform.");
+	if (!std::is_sorted(ends.begin(), ends.end()) || (ends.empty() ? points.count : ends.back()) != points.count)
+		throw std::invalid_argument("group ends must be non decreasing and end at points.count.");
+	std::vector<detail::xform<T>> f;
+	f.reserve(m.size());
+	for (const Matrix<T> &mat : m)
+		f.emplace_back(mat, points.dim);
+
+	detail::transform_tiles(points.count, [&](size_t begin, size_t end) {
+		size_t g = std::upper_bound(ends.begin(), ends.end(), begin) - ends.begin();
+		for (size_t s = begin; s < end; ++g) {
+			const size_t e = std::min(ends[g], end);
+			detail::transform_range(f[g], points, normalize, s, e);
+			s = e;
+		}
+	});
+}
+
+} // namespace tlap
@@ -0,0 +1,217 @@
+#pragma once
+
+#include "QuantizedVector.hpp"
+#include "quant_kernels.tpp"
+#include "../hyperp.hpp"
+#include "../math/math.hpp"
+#include "../parallel/pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace tlap {
+
+namespace detail {
+
+// sum of (a - za) * (b - zb) over n codes, from the sum of a * b and the sums
+// of the codes of each side
+inline int64_t	quant_centered(int64_t ab, int64_t sa, int64_t sb, int64_t za, int64_t zb, size_t n) {
+	return ab - za * sb - zb * sa + static_cast<int64_t>(n) * za * zb;
+}
+
+} // namespace detail
+
+// constructors
+
+template <typename Q>
+QuantizedVector<Q>::QuantizedVector()
+	: _block(0) {
+}
+
+// the range of each block from the dispatched min / max reductions, then one
+// pass rounding to the nearest code
+template <typename Q>
+QuantizedVector<Q>::QuantizedVector(const Vector<float> &v, size_t block)
+	: _codes(v.shape()), _block(block ? block : v.shape()) {
+	if (block % 64)
+		throw std::invalid_argument("QuantizedVector blocks must be a multiple of 64 elements.");
+	constexpr float	qmin = (std::is_same<Q, int8_t>::value ? -127.0f : 0.0f);
+	constexpr float	qmax = (std::is_same<Q, int8_t>::value ? 127.0f : 255.0f);
+	const float		*x = v.data();
+
+	for (size_t b0 = 0; b0 < v.shape(); b0 += _block) {
+		const size_t	n = std::min(_block, v.shape() - b0);
+		const float		lo = std::min(detail::vector_fold(simd::dispatch::reduction::min, false, x + b0, x + b0, n), 0.0f);
+		const float		hi = std::max(detail::vector_fold(simd::dispatch::reduction::max, false, x + b0, x + b0, n), 0.0f);
+		float			scale;
+		int32_t			zero;
+
+		if constexpr (std::is_same<Q, int8_t>::value) {
+			scale = std::max(-lo, hi) / qmax;
+			zero = 0;
+		} else {
+			scale = (hi - lo) / qmax;
+			zero = (scale > 0.0f ? static_cast<int32_t>(std::lround(-lo / scale)) : 0);
+		}
+		const float	inv = (scale > 0.0f ? 1.0f / scale : 0.0f);
+		const float	offset = static_cast<float>(zero);
+		Q			*q = _codes.data() + b0;
+		int64_t		sum = 0;
+
+		TLAP_SIMD_LOOP
+		for (size_t i = 0; i < n; ++i) {
+			const float	r = std::clamp(x[b0 + i] * inv + offset, qmin, qmax);
+			q[i] = static_cast<Q>(r < 0.0f ? r - 0.5f : r + 0.5f);
+		}
+		for (size_t i = 0; i < n; ++i)
+			sum += q[i];
+		_scales.push_back(scale);
+		_zeros.push_back(zero);
+		_sums.push_back(sum);
+		_squares.push_back(detail::quant::dot(q, q, n));
+	}
+}
+
+template <typename Q>
+Vector<float>	QuantizedVector<Q>::dequantize() const {
+	Vector<float>	res = Vector<float>::uninitialized(shape());
+	float			*out = res.data();
+
+	for (size_t b = 0; b < blocks(); ++b) {
+		const size_t	b0 = b * _block;
+		const size_t	n = std::min(_block, shape() - b0);
+		const float		s = _scales[b];
+		const float		z = static_cast<float>(_zeros[b]);
+		TLAP_SIMD_LOOP
+		for (size_t i = 0; i < n; ++i)
+			out[b0 + i] = s * (static_cast<float>(_codes[b0 + i]) - z);
+	}
+	return res;
+}
+
+template <typename Q>
+float	QuantizedVector<Q>::operator[](size_t index) const {
+	const size_t b = index / _block;
+	return _scales[b] * static_cast<float>(static_cast<int32_t>(_codes[index]) - _zeros[b]);
+}
+
+// operations
+
+template <typename Q>
+void	QuantizedVector<Q>::_check(const QuantizedVector &other) const {
+	if (shape() != other.shape())
+		throw std::invalid_argument("Vectors must have the same size.");
+	if (_block != other._block)
+		throw std::invalid_argument("QuantizedVectors must have the same block size.");
+}
+
+template <typename Q>
+typename QuantizedVector<Q>::real	QuantizedVector<Q>::dot(const QuantizedVector &other) const {
+	_check(other);
+	double	res = 0.0;
+	for (size_t b = 0; b < blocks(); ++b) {
+		const size_t	b0 = b * _block;
+		const size_t	n = std::min(_block, shape() - b0);
+		const int64_t	ab = detail::quant::dot(_codes.data() + b0, other._codes.data() + b0, n);
+		res += static_cast<double>(_scales[b]) * other._scales[b]
+			* static_cast<double>(detail::quant_centered(ab, _sums[b], other._sums[b], _zeros[b], other._zeros[b], n));
+	}
+	return static_cast<real>(res);
+}
+
+// |a|^2 + |b|^2 - 2 a.b per block, from the stored sums: one pass over the
+// codes, as dot(). the difference loses digits when a and b are close
+template <typename Q>
+typename QuantizedVector<Q>::real	QuantizedVector<Q>::dist(const QuantizedVector &other) const {
+	_check(other);
+	double	res = 0.0;
+	for (size_t b = 0; b < blocks(); ++b) {
+		const size_t	b0 = b * _block;
+		const size_t	n = std::min(_block, shape() - b0);
+		const double	sa = _scales[b], sb = other._scales[b];
+		const int64_t	ab = detail::quant::dot(_codes.data() + b0, other._codes.data() + b0, n);
+		const int64_t	aa = detail::quant_centered(_squares[b], _sums[b], _sums[b], _zeros[b], _zeros[b], n);
+		const int64_t	bb = detail::quant_centered(other._squares[b], other._sums[b], other._sums[b], other._zeros[b], other._zeros[b], n);
+		res += sa * sa * static_cast<double>(aa) + sb * sb * static_cast<double>(bb)
+			- 2.0 * sa * sb * static_cast<double>(detail::quant_centered(ab, _sums[b], other._sums[b], _zeros[b], other._zeros[b], n));
+	}
+	return tlap::sqrt(static_cast<real>(std::max(res, 0.0)));
+}
+
+template <typename Q>
+typename QuantizedVector<Q>::real	QuantizedVector<Q>::norm() const {
+	double	res = 0.0;
+	for (size_t b = 0; b < blocks(); ++b) {
+		const size_t	n = std::min(_block, shape() - b * _block);
+		res += static_cast<double>(_scales[b]) * _scales[b]
+			* static_cast<double>(detail::quant_centered(_squares[b], _sums[b], _sums[b], _zeros[b], _zeros[b], n));
+	}
+	return tlap::sqrt(static_cast<real>(res));
+}
+
+template <typename Q>
+typename QuantizedVector<Q>::real	QuantizedVector<Q>::maxError() const {
+	return (_scales.empty() ? real(0) : *std::max_element(_scales.begin(), _scales.end()) / 2);
+}
+
+template <typename Q>
+size_t	QuantizedVector<Q>::shape() const {
+	return _codes.size();
+}
+
+template <typename Q>
+size_t	QuantizedVector<Q>::block() const {
+	return _block;
+}
+
+template <typename Q>
+size_t	QuantizedVector<Q>::blocks() const {
+	return _scales.size();
+}
+
+template <typename Q>
+const Q	*QuantizedVector<Q>::data() const {
+	return _codes.data();
+}
+
+template <typename Q>
+float	QuantizedVector<Q>::scale(size_t block) const {
+	return _scales[block];
+}
+
+template <typename Q>
+int32_t	QuantizedVector<Q>::zeroPoint(size_t block) const {
+	return _zeros[block];
+}
+
+// batches
+
+namespace detail {
+
+template <typename Q, typename F>
+Vector<float>	quant_batch(const QuantizedVector<Q> &query, const std::vector<QuantizedVector<Q>> &rows, F f) {
+	Vector<float>	res = Vector<float>::uninitialized(rows.size());
+	float			*out = res.data();
+	const bool		parallel = rows.size() * query.shape() >= QUANT_PARALLEL_MIN;
+	const size_t	grain = std::max<size_t>(QUANT_PARALLEL_MIN / std::max<size_t>(query.shape(), 1), 1);
+
+	parallel::parallel_for(0, rows.size(), (parallel ? grain : rows.size()), [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			out[i] = f(rows[i]);
+	}, "quant");
+	return res;
+}
+
+} // namespace detail
+
+template <typename Q>
+Vector<float>	dotBatch(const QuantizedVector<Q> &query, const std::vector<QuantizedVector<Q>> &rows) {
+	return detail::quant_batch(query, rows, [&query](const QuantizedVector<Q> &r) { return query.dot(r); });
+}
+
+template <typename Q>
+Vector<float>	distBatch(const QuantizedVector<Q> &query, const std::vector<QuantizedVector<Q>> &rows) {
+	return detail::quant_batch(query, rows, [&query](const QuantizedVector<Q> &r) { return query.dist(r); });
+}
+
+} // namespace tlap
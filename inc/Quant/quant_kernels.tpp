@@ -0,0 +1,178 @@
+#pragma once
+
+#include "../hyperp.hpp"
+#include "../simd/simd.hpp"
+#include "../simd/dispatch.hpp"
+#include "../profile/profile.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// exact sums of products of int8 / uint8 codes, one function per isa, any n
+// and alignment. the products add up in int32 lanes over QUANT_CHUNK codes at
+// most, too few for a lane to overflow, then in int64.
+// vpdpbusd multiplies unsigned by signed bytes: int8 codes are made unsigned
+// by adding 128 (a ^ 0x80), uint8 ones signed by taking 128 off, and the 128
+// times the sum of the other operand is taken back. vpmaddubsw (avx2) adds
+// its pairs of products with saturation: int8 codes stay in [-127, 127] and
+// go as |a| * sign(b, a), uint8 ones are widened to 16 bits instead
+
+#define TLAP_TARGET_VNNI __attribute__((target("avx512f,avx512bw,avx512vnni")))
+
+namespace tlap::detail::quant {
+
+struct	kernels {
+	int64_t	(*dot_s8)(const int8_t *a, const int8_t *b, size_t n);
+	int64_t	(*dot_u8)(const uint8_t *a, const uint8_t *b, size_t n);
+};
+
+// the compiler vectorizes the int32 loop for the baseline isa
+template <typename Q>
+int64_t	dot_scalar(const Q *a, const Q *b, size_t n) {
+	TLAP_PROFILE_KERNEL("quant.dot", Q, simd::dispatch::level::scalar, n);
+	int64_t	total = 0;
+
+	for (size_t c = 0; c < n; c += QUANT_CHUNK) {
+		const size_t	end = std::min<size_t>(n, c + QUANT_CHUNK);
+		int32_t			sum = 0;
+		TLAP_SIMD_LOOP
+		for (size_t i = c; i < end; ++i)
+			sum += static_cast<int32_t>(a[i]) * static_cast<int32_t>(b[i]);
+		total += sum;
+	}
+	return total;
+}
+
+TLAP_TARGET_AVX2 inline int64_t	dot_s8_avx2(const int8_t *a, const int8_t *b, size_t n) {
+	TLAP_PROFILE_KERNEL("quant.dot", int8_t, simd::dispatch::level::avx2, n);
+	const __m256i	ones = _mm256_set1_epi16(1);
+	int64_t			total = 0;
+
+	for (size_t c = 0; c < n; c += QUANT_CHUNK) {
+		const size_t	end = std::min<size_t>(n, c + QUANT_CHUNK);
+		__m256i			acc = _mm256_setzero_si256();
+		size_t			i = c;
+		for (; i + 32 <= end; i += 32) {
+			const __m256i	va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+			const __m256i	vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+			const __m256i	pairs = _mm256_maddubs_epi16(_mm256_abs_epi8(va), _mm256_sign_epi8(vb, va));
+			acc = _mm256_add_epi32(acc, _mm256_madd_epi16(pairs, ones));
+		}
+		__m128i	s = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+		s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4e));
+		s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xb1));
+		total += _mm_cvtsi128_si32(s);
+		for (; i < end; ++i)
+			total += static_cast<int32_t>(a[i]) * static_cast<int32_t>(b[i]);
+	}
+	return total;
+}
+
+TLAP_TARGET_AVX2 inline int64_t	dot_u8_avx2(const uint8_t *a, const uint8_t *b, size_t n) {
+	TLAP_PROFILE_KERNEL("quant.dot", uint8_t, simd::dispatch::level::avx2, n);
+	int64_t	total = 0;
+
+	for (size_t c = 0; c < n; c += QUANT_CHUNK) {
+		const size_t	end = std::min<size_t>(n, c + QUANT_CHUNK);
+		__m256i			acc = _mm256_setzero_si256();
+		size_t			i = c;
+		for (; i + 32 <= end; i += 32) {
+			const __m256i	va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+			const __m256i	vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+			const __m256i	lo = _mm256_madd_epi16(_mm256_cvtepu8_epi16(_mm256_castsi256_si128(va)), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(vb)));
+			const __m256i	hi = _mm256_madd_epi16(_mm256_cvtepu8_epi16(_mm256_extracti128_si256(va, 1)), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(vb, 1)));
+			acc = _mm256_add_epi32(acc, _mm256_add_epi32(lo, hi));
+		}
+		__m128i	s = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+		s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4e));
+		s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xb1));
+		total += _mm_cvtsi128_si32(s);
+		for (; i < end; ++i)
+			total += static_cast<int32_t>(a[i]) * static_cast<int32_t>(b[i]);
+	}
+	return total;
+}
+
+// the tail is one masked load, zero bytes add nothing
+TLAP_TARGET_VNNI inline int64_t	dot_s8_vnni(const int8_t *a, const int8_t *b, size_t n) {
+	TLAP_PROFILE_KERNEL("quant.dot", int8_t, simd::dispatch::level::avx512, n);
+	const __m512i	flip = _mm512_set1_epi8(static_cast<char>(0x80));
+	const __m512i	ones = _mm512_set1_epi8(1);
+	int64_t			total = 0;
+
+	for (size_t c = 0; c < n; c += QUANT_CHUNK) {
+		const size_t	end = std::min<size_t>(n, c + QUANT_CHUNK);
+		__m512i			acc = _mm512_setzero_si512();
+		__m512i			sumb = _mm512_setzero_si512();
+		for (size_t i = c; i < end; i += 64) {
+			const __mmask64	m = (end - i >= 64 ? ~__mmask64(0) : (__mmask64(1) << (end - i)) - 1);
+			const __m512i	va = _mm512_maskz_loadu_epi8(m, a + i);
+			const __m512i	vb = _mm512_maskz_loadu_epi8(m, b + i);
+			acc = _mm512_dpbusd_epi32(acc, _mm512_xor_si512(va, flip), vb); // (a + 128) * b
+			sumb = _mm512_dpbusd_epi32(sumb, ones, vb);
+		}
+		total += static_cast<int64_t>(_mm512_reduce_add_epi32(acc)) - 128 * static_cast<int64_t>(_mm512_reduce_add_epi32(sumb));
+	}
+	return total;
+}
+
+TLAP_TARGET_VNNI inline int64_t	dot_u8_vnni(const uint8_t *a, const uint8_t *b, size_t n) {
+	TLAP_PROFILE_KERNEL("quant.dot", uint8_t, simd::dispatch::level::avx512, n);
+	const __m512i	flip = _mm512_set1_epi8(static_cast<char>(0x80));
+	const __m512i	zero = _mm512_setzero_si512();
+	int64_t			total = 0;
+
+	for (size_t c = 0; c < n; c += QUANT_CHUNK) {
+		const size_t	end = std::min<size_t>(n, c + QUANT_CHUNK);
+		__m512i			acc = _mm512_setzero_si512();
+		__m512i			suma = _mm512_setzero_si512();
+		for (size_t i = c; i < end; i += 64) {
+			const __mmask64	m = (end - i >= 64 ? ~__mmask64(0) : (__mmask64(1) << (end - i)) - 1);
+			const __m512i	va = _mm512_maskz_loadu_epi8(m, a + i);
+			const __m512i	vb = _mm512_maskz_loadu_epi8(m, b + i);
+			acc = _mm512_dpbusd_epi32(acc, va, _mm512_xor_si512(vb, flip)); // a * (b - 128)
+			suma = _mm512_add_epi64(suma, _mm512_sad_epu8(va, zero));
+		}
+		total += static_cast<int64_t>(_mm512_reduce_add_epi32(acc)) + 128 * static_cast<int64_t>(_mm512_reduce_add_epi64(suma));
+	}
+	return total;
+}
+
+inline constexpr kernels	scalar_table = {dot_scalar<int8_t>, dot_scalar<uint8_t>};
+inline constexpr kernels	avx2_table = {dot_s8_avx2, dot_u8_avx2};
+inline constexpr kernels	vnni_table = {dot_s8_vnni, dot_u8_vnni};
+
+// vnni on the avx512 level of simd::dispatch::active() when the cpu has it,
+// the avx2 kernels on any level from avx2 on
+inline bool	has_vnni() {
+	static const bool	vnni = [] {
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vnni");
+	}();
+	return vnni;
+}
+
+inline const kernels	&table() {
+	static const kernels	&chosen = [] () -> const kernels & {
+		const simd::dispatch::level	l = simd::dispatch::active();
+		if (l == simd::dispatch::level::avx512 && has_vnni())
+			return vnni_table;
+		if (l >= simd::dispatch::level::avx2)
+			return avx2_table;
+		return scalar_table;
+	}();
+	return chosen;
+}
+
+template <typename Q>
+int64_t	dot(const Q *a, const Q *b, size_t n) {
+	if constexpr (std::is_same<Q, int8_t>::value)
+		return table().dot_s8(a, b, n);
+	else
+		return table().dot_u8(a, b, n);
+}
+
+} // namespace tlap::detail::quant
+
+#undef TLAP_TARGET_VNNI
@@ -0,0 +1,100 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: SparseMatrix class, compressed rows or columns
+// File version: 0.1
+#pragma once
+
+#include "SparseVector.hpp"
+#include "../Matrix/Matrix.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace tlap {
+
+// csr: compressed rows, the stored elements row after row. csc: compressed
+// columns, column after column
+enum class sparse_format { csr, csc };
+
+// one element of a coordinate (COO) list
+template <typename T>
+struct	triplet {
+	size_t	row;
+	size_t	col;
+	T		value;
+};
+
+// three arrays, memory in nnz() plus the rows (csr) or columns (csc): the
+// offsets of each row / column into the other two, the column / row of each
+// stored value in increasing order within its row / column, and the values.
+// the column (csr) or row (csc) count must stay below 2^32.
+// products are spread over the threads of parallel/pool.hpp in parts of even
+// work (stored values plus rows), whatever the spread of the non-zeros:
+// - csr * Vector: a gather dot per row (SparseVector), parts of rows
+// - csc * Vector: scatters per column into up to SPARSE_CSC_PARTS partial
+//   results, summed in a fixed order
+// - * Matrix: one axpy of a dense row per stored value, the dispatched Vector
+//   kernel over the padded rows; csr splits the rows of the result, csc its
+//   columns
+// results do not depend on the thread count
+template <typename T, sparse_format F = sparse_format::csr>
+class SparseMatrix {
+	static_assert(std::is_arithmetic<T>::value, "SparseMatrix can only be instantiated with arithmetic types.");
+
+	private:
+		size_t					_rows;
+		size_t					_cols;
+		std::vector<size_t>		_offsets; // major + 1 entries
+		std::vector<uint32_t>	_index;
+		std::vector<T>			_values;
+
+		size_t					_major() const; // rows (csr) or columns (csc)
+		size_t					_minor() const;
+
+	public:
+		using value_type = T;
+		static constexpr sparse_format	format = F;
+
+		// constructors
+		SparseMatrix();
+		SparseMatrix(size_t rows, size_t cols); // zero
+		SparseMatrix(size_t rows, size_t cols, const std::vector<triplet<T>> &entries); // any order, duplicates summed, throws past the shape
+		SparseMatrix(size_t rows, size_t cols, std::vector<size_t> offsets, std::vector<uint32_t> index, std::vector<T> values); // compressed arrays as they are, checked
+		explicit SparseMatrix(const Matrix<T> &dense); // its non-zeros
+		template <sparse_format G> requires (G != F)
+		explicit SparseMatrix(const SparseMatrix<T, G> &other); // csr <-> csc, in nnz() + rows + columns
+
+		// comparison operators, on the stored arrays
+		bool					operator==(const SparseMatrix &other) const;
+		bool					operator!=(const SparseMatrix &other) const;
+
+		// arithmetic operators
+		Vector<T>				operator*(const Vector<T> &x) const; // throws if cols() != x.shape()
+		Matrix<T>				operator*(const Matrix<T> &b) const; // throws if cols() != b.rows()
+		SparseMatrix			operator*(const T &scalar) const;
+		SparseMatrix			&operator*=(const T &scalar);
+
+		// index access
+		T						operator()(size_t row, size_t col) const; // binary search, 0 when not stored
+
+		// various operations and methods
+		auto					transpose() const; // the same arrays read the other way: a csr matrix gives a csc one and back
+		SparseVector<T>			line(size_t index) const; // row (csr) or column (csc) index
+		Matrix<T>				toMatrix() const;
+
+		size_t					rows() const;
+		size_t					cols() const;
+		size_t					nnz() const; // stored elements
+		const size_t			*offsets() const;
+		const uint32_t			*indices() const;
+		const T					*values() const;
+};
+
+template <typename T>
+using CsrMatrix = SparseMatrix<T, sparse_format::csr>;
+template <typename T>
+using CscMatrix = SparseMatrix<T, sparse_format::csc>;
+
+} // namespace tlap
+
+#include "SparseMatrix.tpp"
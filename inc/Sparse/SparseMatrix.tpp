@@ -0,0 +1,362 @@
+#pragma once
+
+#include "SparseMatrix.hpp"
+#include "../hyperp.hpp"
+#include "../parallel/pool.hpp"
+#include "../profile/profile.hpp"
+#include "../simd/dispatch.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace tlap {
+
+namespace detail {
+
+// work of the lines [0, i): their stored values plus one per line, so that
+// runs of empty lines weigh something too
+inline size_t	sparse_work(const std::vector<size_t> &offsets, size_t i) {
+	return offsets[i] + i;
+}
+
+// bounds of parts lines [0, major) of even work, parts + 1 of them
+inline std::vector<size_t>	sparse_parts(const std::vector<size_t> &offsets, size_t parts) {
+	const size_t		major = offsets.size() - 1;
+	const size_t		work = sparse_work(offsets, major);
+	std::vector<size_t>	bounds(parts + 1, major);
+
+	bounds[0] = 0;
+	for (size_t p = 1; p < parts; ++p) {
+		const size_t	target = work / parts * p + work % parts * p / parts;
+		size_t			lo = bounds[p - 1];
+		size_t			hi = major;
+		while (lo < hi) { // first line whose work reaches target
+			const size_t	mid = lo + (hi - lo) / 2;
+			if (sparse_work(offsets, mid) < target)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		bounds[p] = lo;
+	}
+	return bounds;
+}
+
+// f(first, last) over the lines in parts of even work, as many as the threads
+// can take, never less than SPARSE_GRAIN of work each
+template <typename F>
+void	sparse_split(const std::vector<size_t> &offsets, F f) {
+	const size_t	work = sparse_work(offsets, offsets.size() - 1);
+	const size_t	most = parallel::current().concurrency() * PARALLEL_TASKS_PER_THREAD;
+	const size_t	parts = (work < SPARSE_PARALLEL_MIN ? 1 : std::clamp<size_t>(work / SPARSE_GRAIN, 1, most));
+	const std::vector<size_t>	bounds = sparse_parts(offsets, parts);
+
+	parallel::parallel_for(0, parts, 1, [&](size_t begin, size_t end) {
+		for (size_t p = begin; p < end; ++p)
+			f(bounds[p], bounds[p + 1]);
+	}, "sparse");
+}
+
+// out += b * k over n elements of aligned, padded rows
+template <typename T>
+void	sparse_axpy(T *out, const T *b, size_t n, T k) {
+	if constexpr (has_pack<T>)
+		simd::dispatch::table<T>().axpy(out, out, b, n, k);
+	else {
+		TLAP_SIMD_LOOP
+		for (size_t i = 0; i < n; ++i)
+			out[i] += b[i] * k;
+	}
+}
+
+// lines filled with gaps between them (offsets of the raw placement): each
+// line sorted and its duplicates summed, then the lines moved down together
+template <typename T>
+void	sparse_compact(std::vector<size_t> &offsets, std::vector<uint32_t> &index, std::vector<T> &values) {
+	std::vector<std::pair<uint32_t, T>>	order;
+	size_t	kept = 0;
+
+	for (size_t i = 0; i + 1 < offsets.size(); ++i) {
+		const size_t	begin = offsets[i];
+		const size_t	n = sparse_sort(index.data() + begin, values.data() + begin, offsets[i + 1] - begin, order);
+		std::move(index.begin() + begin, index.begin() + begin + n, index.begin() + kept);
+		std::move(values.begin() + begin, values.begin() + begin + n, values.begin() + kept);
+		offsets[i] = kept;
+		kept += n;
+	}
+	offsets.back() = kept;
+	index.resize(kept);
+	values.resize(kept);
+}
+
+} // namespace detail
+
+// storage
+
+template <typename T, sparse_format F>
+size_t	SparseMatrix<T, F>::_major() const {
+	return (F == sparse_format::csr ? _rows : _cols);
+}
+
+template <typename T, sparse_format F>
+size_t	SparseMatrix<T, F>::_minor() const {
+	return (F == sparse_format::csr ? _cols : _rows);
+}
+
+// constructors
+
+template <typename T, sparse_format F>
+SparseMatrix<T, F>::SparseMatrix()
+	: _rows(0), _cols(0), _offsets(1, 0) {
+}
+
+template <typename T, sparse_format F>
+SparseMatrix<T, F>::SparseMatrix(size_t rows, size_t cols)
+	: _rows(rows), _cols(cols), _offsets(_major() + 1, 0) {
+	detail::sparse_check_size(_minor());
+}
+
+template <typename T, sparse_format F>
+SparseMatrix<T, F>::SparseMatrix(size_t rows, size_t cols, const std::vector<triplet<T>> &entries)
+	: SparseMatrix(rows, cols) {
+	auto major = [](const triplet<T> &e) { return (F == sparse_format::csr ? e.row : e.col); };
+	auto minor = [](const triplet<T> &e) { return (F == sparse_format::csr ? e.col : e.row); };
+
+	for (const triplet<T> &e : entries) {
+		if (e.row >= _rows || e.col >= _cols)
+			throw std::invalid_argument("Triplet out of the SparseMatrix shape.");
+		++_offsets[major(e) + 1];
+	}
+	for (size_t i = 0; i < _major(); ++i)
+		_offsets[i + 1] += _offsets[i];
+	_index.resize(entries.size());
+	_values.resize(entries.size());
+	std::vector<size_t>	next(_offsets.begin(), _offsets.end() - 1);
+	for (const triplet<T> &e : entries) {
+		const size_t	p = next[major(e)]++;
+		_index[p] = static_cast<uint32_t>(minor(e));
+		_values[p] = e.value;
+	}
+	detail::sparse_compact(_offsets, _index, _values);
+}
+
+template <typename T, sparse_format F>
+SparseMatrix<T, F>::SparseMatrix(size_t rows, size_t cols, std::vector<size_t> offsets, std::vector<uint32_t> index, std::vector<T> values)
+	: _rows(rows), _cols(cols), _offsets(std::move(offsets)), _index(std::move(index)), _values(std::move(values)) {
+	detail::sparse_check_size(_minor());
+	if (_offsets.size() != _major() + 1 || _offsets.front() != 0 || _offsets.back() != _index.size() || _index.size() != _values.size())
+		throw std::invalid_argument("Compressed arrays do not fit the SparseMatrix shape.");
+	for (size_t i = 0; i < _major(); ++i) {
+		if (_offsets[i] > _offsets[i + 1])
+			throw std::invalid_argument("Compressed offsets must not decrease.");
+		for (size_t k = _offsets[i]; k < _offsets[i + 1]; ++k)
+			if (_index[k] >= _minor() || (k > _offsets[i] && _index[k - 1] >= _index[k]))
+				throw std::invalid_argument("Compressed indices must increase within a line and stay in the shape.");
+	}
+}
+
+template <typename T, sparse_format F>
+SparseMatrix<T, F>::SparseMatrix(const Matrix<T> &dense)
+	: SparseMatrix(dense.rows(), dense.cols()) {
+	for (size_t i = 0; i < _major(); ++i) {
+		for (size_t j = 0; j < _minor(); ++j) {
+			const T	v = (F == sparse_format::csr ? dense(i, j) : dense(j, i));
+			if (v != T(0)) {
+				_index.push_back(static_cast<uint32_t>(j));
+				_values.push_back(v);
+			}
+		}
+		_offsets[i + 1] = _index.size();
+	}
+}
+
+template <typename T, sparse_format F>
+template <sparse_format G> requires (G != F)
+SparseMatrix<T, F>::SparseMatrix(const SparseMatrix<T, G> &other)
+	: SparseMatrix(other.rows(), other.cols()) {
+	const size_t	lines = _minor(); // of other
+	const size_t	*offsets = other.offsets();
+	const uint32_t	*index = other.indices();
+	const T			*values = other.values();
+
+	for (size_t k = 0; k < other.nnz(); ++k)
+		++_offsets[index[k] + 1];
+	for (size_t i = 0; i < _major(); ++i)
+		_offsets[i + 1] += _offsets[i];
+	_index.resize(other.nnz());
+	_values.resize(other.nnz());
+	std::vector<size_t>	next(_offsets.begin(), _offsets.end() - 1);
+	for (size_t o = 0; o < lines; ++o) // in line order of other: each of ours fills sorted
+		for (size_t k = offsets[o]; k < offsets[o + 1]; ++k) {
+			const size_t	p = next[index[k]]++;
+			_index[p] = static_cast<uint32_t>(o);
+			_values[p] = values[k];
+		}
+}
+
+// comparison operators
+
+template <typename T, sparse_format F>
+bool	SparseMatrix<T, F>::operator==(const SparseMatrix &other) const {
+	return _rows == other._rows && _cols == other._cols && _offsets == other._offsets
+		&& _index == other._index && _values == other._values;
+}
+
+template <typename T, sparse_format F>
+bool	SparseMatrix<T, F>::operator!=(const SparseMatrix &other) const {
+	return !(*this == other);
+}
+
+// arithmetic operators
+
+template <typename T, sparse_format F>
+Vector<T>	SparseMatrix<T, F>::operator*(const Vector<T> &x) const {
+	if (_cols != x.shape())
+		throw std::invalid_argument("SparseMatrix cols() must match the Vector size.");
+	TLAP_PROFILE_KERNEL("sparse.spmv", T, (F == sparse_format::csr ? detail::sparse_level<T>() : simd::dispatch::level::scalar), nnz());
+	if constexpr (F == sparse_format::csr) {
+		Vector<T>	y = Vector<T>::uninitialized(_rows);
+		detail::sparse_split(_offsets, [&](size_t first, size_t last) {
+			for (size_t i = first; i < last; ++i)
+				y[i] = detail::sparse_dot(_values.data() + _offsets[i], _index.data() + _offsets[i], x.data(), _offsets[i + 1] - _offsets[i]);
+		});
+		return y;
+	} else {
+		// the part count depends on the work only, so does the order of the sums
+		const size_t	work = detail::sparse_work(_offsets, _cols);
+		const size_t	parts = (work < SPARSE_PARALLEL_MIN ? 1 : std::clamp<size_t>(work / SPARSE_GRAIN, 1, SPARSE_CSC_PARTS));
+		const std::vector<size_t>	bounds = detail::sparse_parts(_offsets, parts);
+		std::vector<Vector<T>>		partial(parts);
+
+		parallel::parallel_for(0, parts, 1, [&](size_t begin, size_t end) {
+			for (size_t p = begin; p < end; ++p) {
+				partial[p] = Vector<T>(_rows);
+				T	*acc = partial[p].data();
+				for (size_t j = bounds[p]; j < bounds[p + 1]; ++j) {
+					const T	xj = x[j];
+					if (xj == T(0))
+						continue;
+					for (size_t k = _offsets[j]; k < _offsets[j + 1]; ++k)
+						acc[_index[k]] += _values[k] * xj;
+				}
+			}
+		}, "sparse");
+		for (size_t p = 1; p < parts; ++p)
+			partial[0] += partial[p];
+		return std::move(partial[0]);
+	}
+}
+
+template <typename T, sparse_format F>
+Matrix<T>	SparseMatrix<T, F>::operator*(const Matrix<T> &b) const {
+	if (_cols != b.rows())
+		throw std::invalid_argument("SparseMatrix cols() must match the Matrix rows().");
+	TLAP_PROFILE_KERNEL("sparse.spmm", T, detail::sparse_level<T>(), nnz() * b.cols());
+	Matrix<T>	c(_rows, b.cols());
+	const size_t	n = c.stride();
+
+	if constexpr (F == sparse_format::csr)
+		detail::sparse_split(_offsets, [&](size_t first, size_t last) {
+			for (size_t i = first; i < last; ++i)
+				for (size_t k = _offsets[i]; k < _offsets[i + 1]; ++k)
+					detail::sparse_axpy(c.row(i), b.row(_index[k]), n, _values[k]);
+		});
+	else {
+		// every task reads all of the matrix and owns whole aligned blocks of columns
+		const size_t	work = detail::sparse_work(_offsets, _cols) * n;
+		const size_t	grain = (work < SPARSE_PARALLEL_MIN ? n : detail::vector_block<T>);
+		parallel::parallel_for(0, n, grain, [&](size_t begin, size_t end) {
+			for (size_t j = 0; j < _cols; ++j)
+				for (size_t k = _offsets[j]; k < _offsets[j + 1]; ++k)
+					detail::sparse_axpy(c.row(_index[k]) + begin, b.row(j) + begin, end - begin, _values[k]);
+		}, "sparse");
+	}
+	return c;
+}
+
+template <typename T, sparse_format F>
+SparseMatrix<T, F>	SparseMatrix<T, F>::operator*(const T &scalar) const {
+	SparseMatrix	result(*this);
+	return result *= scalar;
+}
+
+template <typename T, sparse_format F>
+SparseMatrix<T, F>	&SparseMatrix<T, F>::operator*=(const T &scalar) {
+	for (T &v : _values)
+		v *= scalar;
+	return *this;
+}
+
+// index access
+
+template <typename T, sparse_format F>
+T		SparseMatrix<T, F>::operator()(size_t row, size_t col) const {
+	const size_t	major = (F == sparse_format::csr ? row : col);
+	const size_t	minor = (F == sparse_format::csr ? col : row);
+	const auto		first = _index.begin() + _offsets[major];
+	const auto		last = _index.begin() + _offsets[major + 1];
+	const auto		it = std::lower_bound(first, last, minor);
+	return (it != last && *it == minor ? _values[it - _index.begin()] : T(0));
+}
+
+// various operations and methods
+
+template <typename T, sparse_format F>
+auto	SparseMatrix<T, F>::transpose() const {
+	constexpr sparse_format	G = (F == sparse_format::csr ? sparse_format::csc : sparse_format::csr);
+	return SparseMatrix<T, G>(_cols, _rows, _offsets, _index, _values);
+}
+
+template <typename T, sparse_format F>
+SparseVector<T>	SparseMatrix<T, F>::line(size_t index) const {
+	if (index >= _major())
+		throw std::invalid_argument("Line index out of the SparseMatrix shape.");
+	return SparseVector<T>(_minor(),
+		std::vector<uint32_t>(_index.begin() + _offsets[index], _index.begin() + _offsets[index + 1]),
+		std::vector<T>(_values.begin() + _offsets[index], _values.begin() + _offsets[index + 1]));
+}
+
+template <typename T, sparse_format F>
+Matrix<T>	SparseMatrix<T, F>::toMatrix() const {
+	Matrix<T>	dense(_rows, _cols);
+	for (size_t i = 0; i < _major(); ++i)
+		for (size_t k = _offsets[i]; k < _offsets[i + 1]; ++k) {
+			if constexpr (F == sparse_format::csr)
+				dense(i, _index[k]) = _values[k];
+			else
+				dense(_index[k], i) = _values[k];
+		}
+	return dense;
+}
+
+template <typename T, sparse_format F>
+size_t	SparseMatrix<T, F>::rows() const {
+	return _rows;
+}
+
+template <typename T, sparse_format F>
+size_t	SparseMatrix<T, F>::cols() const {
+	return _cols;
+}
+
+template <typename T, sparse_format F>
+size_t	SparseMatrix<T, F>::nnz() const {
+	return _index.size();
+}
+
+template <typename T, sparse_format F>
+const size_t	*SparseMatrix<T, F>::offsets() const {
+	return _offsets.data();
+}
+
+template <typename T, sparse_format F>
+const uint32_t	*SparseMatrix<T, F>::indices() const {
+	return _index.data();
+}
+
+template <typename T, sparse_format F>
+const T	*SparseMatrix<T, F>::values() const {
+	return _values.data();
+}
+
+} // namespace tlap
@@ -0,0 +1,71 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: SparseVector class, memory and time in the number of non-zeros
+// File version: 0.1
+#pragma once
+
+#include "../Vector/Vector.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace tlap {
+
+// the stored elements as two arrays, their positions in increasing order and
+// their values. a position not stored is a zero; a stored value may be zero
+// too (duplicates that cancel). positions are 32 bits: shape() < 2^32.
+// products with dense Vectors gather the dense elements with the simd gathers
+// of the dispatched kernels (simd/dispatch.hpp) for float and double
+template <typename T>
+class SparseVector {
+	static_assert(std::is_arithmetic<T>::value, "SparseVector can only be instantiated with arithmetic types.");
+
+	private:
+		size_t					_size;
+		std::vector<uint32_t>	_index;
+		std::vector<T>			_values;
+
+	public:
+		using value_type = T;
+		using real = typename Vector<T>::real;
+
+		// constructors
+		SparseVector();
+		explicit SparseVector(size_t size); // zero
+		SparseVector(size_t size, std::vector<uint32_t> index, std::vector<T> values); // any order, duplicates summed, throws past size
+		explicit SparseVector(const Vector<T> &dense); // its non-zeros
+
+		// comparison operators, on the stored arrays
+		bool					operator==(const SparseVector &other) const;
+		bool					operator!=(const SparseVector &other) const;
+
+		// arithmetic operators
+		SparseVector			operator*(const T &scalar) const;
+		SparseVector			&operator*=(const T &scalar);
+		SparseVector			&operator/=(const T &scalar); // integer division by 0 throws
+
+		// index access
+		T						operator[](size_t index) const; // binary search, 0 when not stored
+
+		// various operations and methods
+		T						dot(const SparseVector &other) const; // merge of the two position lists
+		T						dot(const Vector<T> &dense) const; // gathers of dense
+		real					norm() const;
+		void					addTo(Vector<T> &dense, const T &alpha = T(1)) const; // dense += alpha * this
+		Vector<T>				toVector() const;
+
+		size_t					shape() const;
+		size_t					nnz() const; // stored elements
+		const uint32_t			*indices() const;
+		const T					*values() const;
+};
+
+namespace detail {
+	// sum of values[i] * x[index[i]]: the dispatched gather kernel for float and double
+	template <typename T>
+	T		sparse_dot(const T *values, const uint32_t *index, const T *x, size_t n);
+}
+
+} // namespace tlap
+
+#include "SparseVector.tpp"
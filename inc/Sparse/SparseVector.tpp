@@ -0,0 +1,221 @@
+#pragma once
+
+#include "SparseVector.hpp"
+#include "../profile/profile.hpp"
+#include "../simd/dispatch.hpp"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace tlap {
+
+namespace detail {
+
+// the level of sparse_dot and sparse_axpy: the dispatched table where T has one
+template <typename T>
+simd::dispatch::level	sparse_level() {
+	return (has_pack<T> ? simd::dispatch::active() : simd::dispatch::level::scalar);
+}
+
+template <typename T>
+T		sparse_dot(const T *values, const uint32_t *index, const T *x, size_t n) {
+	TLAP_PROFILE_KERNEL("sparse.dot", T, sparse_level<T>(), n);
+	if constexpr (has_pack<T>)
+		return simd::dispatch::table<T>().gather_dot(values, index, x, n);
+	else {
+		T	sum = T(0);
+		for (size_t i = 0; i < n; ++i)
+			sum += values[i] * x[index[i]];
+		return sum;
+	}
+}
+
+inline void	sparse_check_size(size_t size) {
+	if (size > std::numeric_limits<uint32_t>::max())
+		throw std::invalid_argument("Sparse dimensions must stay below 2^32.");
+}
+
+// n pairs of index / values sorted on the index, stable, the values of equal
+// indices summed in their order of input; returns the count left.
+// order is scratch of at least n
+template <typename T>
+size_t	sparse_sort(uint32_t *index, T *values, size_t n, std::vector<std::pair<uint32_t, T>> &order) {
+	bool	sorted = true;
+	for (size_t i = 1; i < n && sorted; ++i)
+		sorted = index[i - 1] < index[i];
+	if (sorted)
+		return n;
+	order.resize(n);
+	for (size_t i = 0; i < n; ++i)
+		order[i] = {index[i], values[i]};
+	std::stable_sort(order.begin(), order.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+	size_t	kept = 0;
+	for (size_t i = 0; i < n; ++i) {
+		if (kept && index[kept - 1] == order[i].first) {
+			values[kept - 1] += order[i].second;
+			continue;
+		}
+		index[kept] = order[i].first;
+		values[kept++] = order[i].second;
+	}
+	return kept;
+}
+
+} // namespace detail
+
+// constructors
+
+template <typename T>
+SparseVector<T>::SparseVector()
+	: _size(0) {
+}
+
+template <typename T>
+SparseVector<T>::SparseVector(size_t size)
+	: _size(size) {
+	detail::sparse_check_size(size);
+}
+
+template <typename T>
+SparseVector<T>::SparseVector(size_t size, std::vector<uint32_t> index, std::vector<T> values)
+	: _size(size), _index(std::move(index)), _values(std::move(values)) {
+	detail::sparse_check_size(size);
+	if (_index.size() != _values.size())
+		throw std::invalid_argument("A SparseVector needs one value per position.");
+	for (uint32_t i : _index)
+		if (i >= _size)
+			throw std::invalid_argument("Position past the size of the SparseVector.");
+	std::vector<std::pair<uint32_t, T>>	order;
+	const size_t	kept = detail::sparse_sort(_index.data(), _values.data(), _index.size(), order);
+	_index.resize(kept);
+	_values.resize(kept);
+}
+
+template <typename T>
+SparseVector<T>::SparseVector(const Vector<T> &dense)
+	: _size(dense.shape()) {
+	detail::sparse_check_size(_size);
+	for (size_t i = 0; i < _size; ++i)
+		if (dense[i] != T(0)) {
+			_index.push_back(static_cast<uint32_t>(i));
+			_values.push_back(dense[i]);
+		}
+}
+
+// comparison operators
+
+template <typename T>
+bool	SparseVector<T>::operator==(const SparseVector &other) const {
+	return _size == other._size && _index == other._index && _values == other._values;
+}
+
+template <typename T>
+bool	SparseVector<T>::operator!=(const SparseVector &other) const {
+	return !(*this == other);
+}
+
+// arithmetic operators
+
+template <typename T>
+SparseVector<T>	SparseVector<T>::operator*(const T &scalar) const {
+	SparseVector	result(*this);
+	return result *= scalar;
+}
+
+template <typename T>
+SparseVector<T>	&SparseVector<T>::operator*=(const T &scalar) {
+	for (T &v : _values)
+		v *= scalar;
+	return *this;
+}
+
+template <typename T>
+SparseVector<T>	&SparseVector<T>::operator/=(const T &scalar) {
+	if (!std::is_floating_point<T>::value && scalar == T(0))
+		throw std::invalid_argument("Division by zero");
+	for (T &v : _values)
+		v /= scalar;
+	return *this;
+}
+
+// index access
+
+template <typename T>
+T		SparseVector<T>::operator[](size_t index) const {
+	const auto	it = std::lower_bound(_index.begin(), _index.end(), index);
+	return (it != _index.end() && *it == index ? _values[it - _index.begin()] : T(0));
+}
+
+// various operations and methods
+
+template <typename T>
+T		SparseVector<T>::dot(const SparseVector &other) const {
+	if (_size != other._size)
+		throw std::invalid_argument("Vectors must have the same size.");
+	T		sum = T(0);
+	size_t	i = 0;
+	size_t	j = 0;
+	while (i < _index.size() && j < other._index.size()) {
+		if (_index[i] < other._index[j])
+			++i;
+		else if (other._index[j] < _index[i])
+			++j;
+		else
+			sum += _values[i++] * other._values[j++];
+	}
+	return sum;
+}
+
+template <typename T>
+T		SparseVector<T>::dot(const Vector<T> &dense) const {
+	if (_size != dense.shape())
+		throw std::invalid_argument("Vectors must have the same size.");
+	return detail::sparse_dot(_values.data(), _index.data(), dense.data(), _index.size());
+}
+
+template <typename T>
+typename SparseVector<T>::real	SparseVector<T>::norm() const {
+	T	sum = T(0);
+	for (const T &v : _values)
+		sum += v * v;
+	return tlap::sqrt(static_cast<real>(sum));
+}
+
+template <typename T>
+void	SparseVector<T>::addTo(Vector<T> &dense, const T &alpha) const {
+	if (_size != dense.shape())
+		throw std::invalid_argument("Vectors must have the same size.");
+	for (size_t i = 0; i < _index.size(); ++i)
+		dense[_index[i]] += alpha * _values[i];
+}
+
+template <typename T>
+Vector<T>	SparseVector<T>::toVector() const {
+	Vector<T>	dense(_size);
+	for (size_t i = 0; i < _index.size(); ++i)
+		dense[_index[i]] = _values[i];
+	return dense;
+}
+
+template <typename T>
+size_t	SparseVector<T>::shape() const {
+	return _size;
+}
+
+template <typename T>
+size_t	SparseVector<T>::nnz() const {
+	return _index.size();
+}
+
+template <typename T>
+const uint32_t	*SparseVector<T>::indices() const {
+	return _index.data();
+}
+
+template <typename T>
+const T	*SparseVector<T>::values() const {
+	return _values.data();
+}
+
+} // namespace tlap
@@ -2,6 +2,121 @@
 // Description: Tensor class with a focus on performance
 // File version: 0.1
 
+#pragma once
+
+#include "../Vector/Vector.hpp"
+#include "../Matrix/Matrix.hpp"
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
 namespace tlap {
-	
-}
\ No newline at end of file
+
+using shape_t = std::vector<size_t>;
+using strides_t = std::vector<ptrdiff_t>; // in elements, 0 on a broadcast dimension
+
+template <typename T>
+class Tensor {
+	static_assert(is_element<T>, "Tensor can only be instantiated with arithmetic types, half and bfloat16.");
+
+	// a Tensor is a view: shape and strides over storage it shares with every
+	// Tensor it was copied, sliced or reshaped from. copies are shallow and
+	// writes through one view are seen by all of them, clone() makes a deep copy.
+	// new storage is contiguous (row-major) and simd::alignment aligned. views of
+	// a Vector or a Matrix (asTensor()) do not own it and must not outlive them.
+	private:
+		std::shared_ptr<T>	_storage; // owner, null for borrowed storage
+		T					*_data; // first element of this view
+		shape_t				_shape;
+		strides_t			_strides;
+
+		Tensor(std::shared_ptr<T> storage, T *data, shape_t shape, strides_t strides);
+
+	public:
+		using value_type = T;
+
+		// constructors
+		Tensor(); // 0 dimensions, no element
+		explicit Tensor(const shape_t &shape); // zero
+		TEMPLATE_U Tensor(const shape_t &shape, const U &value); // fill constructor
+		TEMPLATE_U Tensor(const shape_t &shape, std::initializer_list<U> values); // row-major, throws if the count differs
+		static Tensor			uninitialized(const shape_t &shape); // values left undefined, for a result written in full
+		static Tensor			borrow(T *data, const shape_t &shape, const strides_t &strides); // view of external storage
+		static Tensor			adopt(std::shared_ptr<T> owner, T *data, const shape_t &shape, const strides_t &strides); // view of external storage kept alive by owner (a mapped file...)
+
+		// comparison operators, same shape and elements
+		bool					operator==(const Tensor &other) const;
+		bool					operator!=(const Tensor &other) const;
+
+		// elementwise arithmetic, other broadcast to the shape of this
+		Tensor					&operator+=(const Tensor &other);
+		Tensor					&operator-=(const Tensor &other);
+		Tensor					&operator*=(const Tensor &other);
+		Tensor					&operator/=(const Tensor &other);
+		Tensor					&operator+=(const T &scalar);
+		Tensor					&operator-=(const T &scalar);
+		Tensor					&operator*=(const T &scalar);
+		Tensor					&operator/=(const T &scalar);
+
+		// element access, one index per dimension
+		template <typename... I> requires (std::is_integral<I>::value && ...)
+		const T					&operator()(I... index) const;
+		template <typename... I> requires (std::is_integral<I>::value && ...)
+		T						&operator()(I... index);
+		const T					*data() const;
+		T						*data();
+
+		// views, no copy
+		Tensor					view() const;
+		Tensor					slice(size_t dim, size_t begin, size_t end, size_t step = 1) const; // [begin, end) every step along dim
+		Tensor					select(size_t dim, size_t index) const; // drops dim
+		Tensor					transpose() const; // all dimensions reversed
+		Tensor					transpose(size_t dim0, size_t dim1) const;
+		Tensor					permute(const shape_t &order) const; // dimension i of the result is order[i] of this
+		Tensor					broadcastTo(const shape_t &shape) const; // numpy rules, throws if not broadcastable
+		Tensor					squeeze() const; // without its dimensions of size 1
+		Tensor					unsqueeze(size_t dim) const; // new dimension of size 1 before dim
+		Tensor					reshape(const shape_t &shape) const; // a view when the strides allow it, a copy otherwise
+
+		// copies
+		Tensor					clone() const; // contiguous deep copy
+		Tensor					contiguous() const; // this when already contiguous, clone() otherwise
+		Tensor					&assign(const Tensor &other); // copies the values of other, broadcast, into this view
+		Tensor					&fill(const T &value);
+
+		size_t					dims() const;
+		const shape_t			&shape() const;
+		size_t					shape(size_t dim) const;
+		const strides_t			&strides() const;
+		size_t					size() const; // number of elements
+		bool					isContiguous() const; // row-major without gaps
+};
+
+// elementwise with numpy broadcasting, the result has the broadcast shape
+template <typename T>
+Tensor<T>	operator+(const Tensor<T> &a, const Tensor<T> &b);
+template <typename T>
+Tensor<T>	operator-(const Tensor<T> &a, const Tensor<T> &b);
+template <typename T>
+Tensor<T>	operator*(const Tensor<T> &a, const Tensor<T> &b);
+template <typename T>
+Tensor<T>	operator/(const Tensor<T> &a, const Tensor<T> &b);
+template <typename T, typename U> requires std::is_arithmetic<U>::value
+Tensor<T>	operator+(const Tensor<T> &a, const U &scalar);
+template <typename T, typename U> requires std::is_arithmetic<U>::value
+Tensor<T>	operator-(const Tensor<T> &a, const U &scalar);
+template <typename T, typename U> requires std::is_arithmetic<U>::value
+Tensor<T>	operator*(const Tensor<T> &a, const U &scalar);
+template <typename U, typename T> requires std::is_arithmetic<U>::value
+Tensor<T>	operator*(const U &scalar, const Tensor<T> &a);
+template <typename T, typename U> requires std::is_arithmetic<U>::value
+Tensor<T>	operator/(const Tensor<T> &a, const U &scalar); // integer division by 0 throws
+
+inline shape_t	broadcastShape(const shape_t &a, const shape_t &b); // throws if not broadcastable
+
+} // namespace tlap
+
+#include "Tensor.tpp" // implementations
+#include "einsum.hpp" // contractions
@@ -0,0 +1,637 @@
+#pragma once
+
+#include "Tensor.hpp"
+#include "../hyperp.hpp"
+#include "../simd/simd.hpp"
+#include "../simd/dispatch.hpp"
+#include "../Vector/VectorExpr.hpp"
+#include "../Matrix/gemm.hpp"
+#include "../parallel/pool.hpp"
+#include "../profile/profile.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace tlap {
+
+namespace detail {
+
+// out = b, for assign() and clone(): a is never read
+struct	tensor_copy { template <typename X> TLAP_INLINE static X apply(const X &, const X &b) { return b; } };
+
+template <typename T>
+std::shared_ptr<T>	tensor_alloc(size_t n) {
+	if (!n)
+		return nullptr;
+	return std::shared_ptr<T>(simd::aligned_alloc<T>(n), [](T *p) { simd::aligned_free(p); });
+}
+
+inline strides_t	row_major(const shape_t &shape) {
+	strides_t	strides(shape.size());
+	ptrdiff_t	s = 1;
+	for (size_t d = shape.size(); d-- > 0;) {
+		strides[d] = s;
+		s *= static_cast<ptrdiff_t>(shape[d]);
+	}
+	return strides;
+}
+
+inline size_t	shape_size(const shape_t &shape) {
+	return std::accumulate(shape.begin(), shape.end(), size_t(1), std::multiplies<size_t>());
+}
+
+// lowest and one past the highest element a view reaches, to detect overlaps
+template <typename T>
+std::pair<const T *, const T *>	tensor_span(const T *data, const shape_t &shape, const strides_t &strides) {
+	const T *lo = data, *hi = data;
+	for (size_t d = 0; d < shape.size(); ++d) {
+		if (!shape[d])
+			return {data, data};
+		(strides[d] < 0 ? lo : hi) += strides[d] * static_cast<ptrdiff_t>(shape[d] - 1);
+	}
+	return {lo, hi + 1};
+}
+
+// the strides of shape over the same elements as (oshape, ostrides), false if
+// it needs a copy. the numpy rule: dimensions of the new shape may only split
+// or merge runs of old dimensions that are contiguous with each other
+inline bool	reshape_strides(const shape_t &oshape, const strides_t &ostrides, const shape_t &shape, strides_t &strides) {
+	shape_t		od;
+	strides_t	os;
+	for (size_t d = 0; d < oshape.size(); ++d)
+		if (oshape[d] != 1) {
+			od.push_back(oshape[d]);
+			os.push_back(ostrides[d]);
+		}
+
+	strides.assign(shape.size(), 0);
+	size_t oi = 0, oj = 1, ni = 0, nj = 1;
+	while (ni < shape.size() && oi < od.size()) {
+		size_t np = shape[ni], op = od[oi];
+		while (np != op) {
+			if (np < op)
+				np *= shape[nj++];
+			else
+				op *= od[oj++];
+		}
+		for (size_t k = oi; k + 1 < oj; ++k)
+			if (os[k] != static_cast<ptrdiff_t>(od[k + 1]) * os[k + 1])
+				return false;
+		strides[nj - 1] = os[oj - 1];
+		for (size_t k = nj - 1; k > ni; --k)
+			strides[k - 1] = strides[k] * static_cast<ptrdiff_t>(shape[k]);
+		ni = nj++;
+		oi = oj++;
+	}
+	for (size_t k = ni; k < shape.size(); ++k) // trailing dimensions of size 1
+		strides[k] = 1;
+	return true;
+}
+
+// one row of n elements: o[i * so] = op(a[i * sa], b[i * sb]). the stride 1
+// and broadcast (stride 0) operands of a contiguous output run on packs,
+// unaligned since a view may start anywhere. P is T for the element loops.
+// always inlined into the isa kernels below with the Op, -O0 included
+template <typename P, typename Op, typename T>
+TLAP_INLINE inline void	tensor_row(T *o, ptrdiff_t so, const T *a, ptrdiff_t sa, const T *b, ptrdiff_t sb, size_t n) {
+	size_t i = 0;
+
+	if constexpr (!std::is_same<P, T>::value) {
+		if (so == 1 && sa == 1 && sb == 1)
+			for (; i + P::width <= n; i += P::width)
+				Op::apply(P::loadu(a + i), P::loadu(b + i)).storeu(o + i);
+		else if (so == 1 && sa == 1 && sb == 0)
+			for (const P vb(*b); i + P::width <= n; i += P::width)
+				Op::apply(P::loadu(a + i), vb).storeu(o + i);
+		else if (so == 1 && sa == 0 && sb == 1)
+			for (const P va(*a); i + P::width <= n; i += P::width)
+				Op::apply(va, P::loadu(b + i)).storeu(o + i);
+	} else if (so == 1 && sa == 1 && sb == 1) {
+		TLAP_SIMD_LOOP
+		for (size_t j = 0; j < n; ++j)
+			o[j] = Op::apply(a[j], b[j]);
+		return;
+	}
+	for (; i < n; ++i)
+		o[i * so] = Op::apply(a[i * sa], b[i * sb]);
+}
+
+template <typename Op, typename T>
+[[gnu::flatten]] TLAP_TARGET_AVX512 void	tensor_row_avx512(T *o, ptrdiff_t so, const T *a, ptrdiff_t sa, const T *b, ptrdiff_t sb, size_t n) {
+	tensor_row<simd::pack<compute_t<T>, simd::isa::avx512>, Op>(o, so, a, sa, b, sb, n);
+}
+
+template <typename Op, typename T>
+[[gnu::flatten]] TLAP_TARGET_AVX2 void	tensor_row_avx2(T *o, ptrdiff_t so, const T *a, ptrdiff_t sa, const T *b, ptrdiff_t sb, size_t n) {
+	tensor_row<simd::pack<compute_t<T>, simd::isa::avx2>, Op>(o, so, a, sa, b, sb, n);
+}
+
+// out = op(a, b) elementwise over shape, every operand given by its strides
+// in that shape (0 where broadcast). dimensions that are contiguous for all
+// three are merged first and size 1 ones dropped, so that the inner row is as
+// long as possible. an input strided along the inner row (a transposed view)
+// goes by TENSOR_TILE x TENSOR_TILE tiles of the two inner dimensions instead,
+// so that the lines it reads are reused from L1. rows or tiles are spread over
+// the threads
+template <typename Op, typename T>
+void	tensor_apply(const shape_t &shape, T *out, const strides_t &so, const T *a, const strides_t &sa, const T *b, const strides_t &sb) {
+	TLAP_PROFILE_KERNEL("tensor.elementwise", T, (packed<T> ? gemm::level<T>() : simd::dispatch::level::scalar),
+		std::accumulate(shape.begin(), shape.end(), size_t(1), std::multiplies<size_t>()));
+	shape_t		n;
+	strides_t	s[3];
+	const strides_t	*in[3] = {&so, &sa, &sb};
+
+	for (size_t d = 0; d < shape.size(); ++d) {
+		if (!shape[d])
+			return;
+		if (shape[d] == 1)
+			continue;
+		bool merge = !n.empty();
+		for (size_t k = 0; k < 3 && merge; ++k)
+			merge = s[k].back() == (*in[k])[d] * static_cast<ptrdiff_t>(shape[d]);
+		if (merge)
+			n.back() *= shape[d];
+		else
+			n.push_back(shape[d]);
+		for (size_t k = 0; k < 3; ++k) {
+			if (merge)
+				s[k].back() = (*in[k])[d];
+			else
+				s[k].push_back((*in[k])[d]);
+		}
+	}
+	if (n.empty()) { // a single element
+		n.push_back(1);
+		for (size_t k = 0; k < 3; ++k)
+			s[k].push_back(0);
+	}
+
+	const size_t	nd = n.size();
+	const size_t	inner = n.back();
+	const bool		tiled = nd >= 2 && (std::abs(s[1].back()) > 1 || std::abs(s[2].back()) > 1);
+	const size_t	outer = (tiled ? nd - 2 : nd - 1); // dimensions walked by index
+	const size_t	mid = (tiled ? n[nd - 2] : 1); // rows inside one unit of work
+	const size_t	rb = (tiled ? TENSOR_TILE : 1);
+	const size_t	cb = (tiled ? TENSOR_TILE : inner);
+	const size_t	blocks = (mid + rb - 1) / rb;
+	const size_t	units = std::accumulate(n.begin(), n.begin() + outer, size_t(1), std::multiplies<size_t>()) * blocks;
+	const simd::dispatch::level	level = gemm::level<T>();
+	const bool					parallel = units * rb * inner >= TENSOR_PARALLEL_MIN;
+
+	parallel::parallel_for(0, units, (parallel ? 1 : units), [&](size_t u0, size_t u1) {
+		for (size_t u = u0; u < u1; ++u) {
+			ptrdiff_t	off[3] = {0, 0, 0};
+			size_t		rem = u / blocks;
+			for (size_t d = outer; d-- > 0;) {
+				const ptrdiff_t i = static_cast<ptrdiff_t>(rem % n[d]);
+				rem /= n[d];
+				for (size_t k = 0; k < 3; ++k)
+					off[k] += i * s[k][d];
+			}
+			const size_t	r0 = u % blocks * rb;
+			const ptrdiff_t	io = s[0].back(), ia = s[1].back(), ib = s[2].back();
+
+			for (size_t c0 = 0; c0 < inner; c0 += cb)
+				for (size_t r = r0; r < std::min(r0 + rb, mid); ++r) {
+					const ptrdiff_t	ri = static_cast<ptrdiff_t>(r), ci = static_cast<ptrdiff_t>(c0);
+					T				*o = out + off[0] + (tiled ? ri * s[0][nd - 2] : 0) + ci * io;
+					const T			*pa = a + off[1] + (tiled ? ri * s[1][nd - 2] : 0) + ci * ia;
+					const T			*pb = b + off[2] + (tiled ? ri * s[2][nd - 2] : 0) + ci * ib;
+					const size_t	len = std::min(cb, inner - c0);
+
+					if constexpr (packed<T>) {
+						switch (level) {
+							case simd::dispatch::level::avx512:	tensor_row_avx512<Op>(o, io, pa, ia, pb, ib, len); break;
+							case simd::dispatch::level::avx2:	tensor_row_avx2<Op>(o, io, pa, ia, pb, ib, len); break;
+							default:							tensor_row<T, Op>(o, io, pa, ia, pb, ib, len);
+						}
+					} else
+						tensor_row<T, Op>(o, io, pa, ia, pb, ib, len);
+				}
+		}
+	}, "tensor");
+}
+
+} // namespace detail
+
+// constructors
+
+template <typename T>
+Tensor<T>::Tensor(std::shared_ptr<T> storage, T *data, shape_t shape, strides_t strides)
+	: _storage(std::move(storage)), _data(data), _shape(std::move(shape)), _strides(std::move(strides)) {
+}
+
+template <typename T>
+Tensor<T>::Tensor()
+	: _data(nullptr) {
+}
+
+template <typename T>
+Tensor<T>::Tensor(const shape_t &shape)
+	: Tensor(shape, T(0)) {
+}
+
+template <typename T>
+TEMPLATE_U Tensor<T>::Tensor(const shape_t &shape, const U &value)
+	: _storage(detail::tensor_alloc<T>(detail::shape_size(shape))), _data(_storage.get()), _shape(shape), _strides(detail::row_major(shape)) {
+	ARITHMETIC_U;
+	std::fill(_data, _data + size(), static_cast<T>(value));
+}
+
+template <typename T>
+TEMPLATE_U Tensor<T>::Tensor(const shape_t &shape, std::initializer_list<U> values)
+	: _storage(detail::tensor_alloc<T>(detail::shape_size(shape))), _data(_storage.get()), _shape(shape), _strides(detail::row_major(shape)) {
+	ARITHMETIC_U;
+	if (values.size() != size())
+		throw std::invalid_argument("Tensor needs one value per element.");
+	std::transform(values.begin(), values.end(), _data, [](const U &x) { return static_cast<T>(x); });
+}
+
+template <typename T>
+Tensor<T>	Tensor<T>::uninitialized(const shape_t &shape) {
+	std::shared_ptr<T>	storage = detail::tensor_alloc<T>(detail::shape_size(shape));
+	T					*data = storage.get();
+
+	return Tensor(std::move(storage), data, shape, detail::row_major(shape));
+}
+
+template <typename T>
+Tensor<T>	Tensor<T>::adopt(std::shared_ptr<T> owner, T *data, const shape_t &shape, const strides_t &strides) {
+	if (shape.size() != strides.size())
+		throw std::invalid_argument("Tensor needs one stride per dimension.");
+	return Tensor(std::move(owner), data, shape, strides);
+}
+
+template <typename T>
+Tensor<T>	Tensor<T>::borrow(T *data, const shape_t &shape, const strides_t &strides) {
+	if (shape.size() != strides.size())
+		throw std::invalid_argument("Tensor needs one stride per dimension.");
+	return Tensor(nullptr, data, shape, strides);
+}
+
+// comparison operators
+
+template <typename T>
+bool	Tensor<T>::operator==(const Tensor &other) const {
+	if (_shape != other._shape)
+		return false;
+	const Tensor a = contiguous(), b = other.contiguous();
+	return std::equal(a._data, a._data + size(), b._data);
+}
+
+template <typename T>
+bool	Tensor<T>::operator!=(const Tensor &other) const {
+	return !(*this == other);
+}
+
+// elementwise arithmetic
+
+// other is read through a copy when it overlaps this with another layout
+#define TLAP_TENSOR_INPLACE(Op)																		\
+	for (size_t d = 0; d < _shape.size(); ++d)															\
+		if (!_strides[d] && _shape[d] > 1)																\
+			throw std::invalid_argument("Cannot write through a broadcast view.");						\
+	Tensor	src = other.broadcastTo(_shape);															\
+	auto	[lo, hi] = detail::tensor_span<T>(_data, _shape, _strides);									\
+	auto	[olo, ohi] = detail::tensor_span<T>(src._data, src._shape, src._strides);					\
+	if (olo < hi && lo < ohi && !(src._data == _data && src._strides == _strides))						\
+		src = src.clone();																			\
+	detail::tensor_apply<Op>(_shape, _data, _strides, _data, _strides, src._data, src._strides);		\
+	return *this;
+
+template <typename T>
+Tensor<T>	&Tensor<T>::operator+=(const Tensor &other) {
+	TLAP_TENSOR_INPLACE(expr::add)
+}
+
+template <typename T>
+Tensor<T>	&Tensor<T>::operator-=(const Tensor &other) {
+	TLAP_TENSOR_INPLACE(expr::sub)
+}
+
+template <typename T>
+Tensor<T>	&Tensor<T>::operator*=(const Tensor &other) {
+	TLAP_TENSOR_INPLACE(expr::mul)
+}
+
+template <typename T>
+Tensor<T>	&Tensor<T>::operator/=(const Tensor &other) {
+	TLAP_TENSOR_INPLACE(expr::div)
+}
+
+template <typename T>
+Tensor<T>	&Tensor<T>::assign(const Tensor &other) {
+	TLAP_TENSOR_INPLACE(detail::tensor_copy)
+}
+
+#undef TLAP_TENSOR_INPLACE
+
+// a scalar is a Tensor of no dimension, broadcast with stride 0
+template <typename T>
+Tensor<T>	&Tensor<T>::operator+=(const T &scalar) {
+	return *this += Tensor<T>({}, scalar);
+}
+
+template <typename T>
+Tensor<T>	&Tensor<T>::operator-=(const T &scalar) {
+	return *this -= Tensor<T>({}, scalar);
+}
+
+template <typename T>
+Tensor<T>	&Tensor<T>::operator*=(const T &scalar) {
+	return *this *= Tensor<T>({}, scalar);
+}
+
+template <typename T>
+Tensor<T>	&Tensor<T>::operator/=(const T &scalar) {
+	if constexpr (std::is_integral<T>::value)
+		if (scalar == 0)
+			throw std::invalid_argument("Division by zero");
+	return *this /= Tensor<T>({}, scalar);
+}
+
+template <typename T>
+Tensor<T>	&Tensor<T>::fill(const T &value) {
+	return assign(Tensor<T>({}, value));
+}
+
+#define TLAP_TENSOR_BINARY(Op)																		\
+	const shape_t	shape = broadcastShape(a.shape(), b.shape());										\
+	Tensor<T>		res = Tensor<T>::uninitialized(shape);											\
+	const Tensor<T>	ba = a.broadcastTo(shape), bb = b.broadcastTo(shape);								\
+	detail::tensor_apply<Op>(shape, res.data(), res.strides(), ba.data(), ba.strides(), bb.data(), bb.strides());	\
+	return res;
+
+template <typename T>
+Tensor<T>	operator+(const Tensor<T> &a, const Tensor<T> &b) {
+	TLAP_TENSOR_BINARY(expr::add)
+}
+
+template <typename T>
+Tensor<T>	operator-(const Tensor<T> &a, const Tensor<T> &b) {
+	TLAP_TENSOR_BINARY(expr::sub)
+}
+
+template <typename T>
+Tensor<T>	operator*(const Tensor<T> &a, const Tensor<T> &b) {
+	TLAP_TENSOR_BINARY(expr::mul)
+}
+
+template <typename T>
+Tensor<T>	operator/(const Tensor<T> &a, const Tensor<T> &b) {
+	TLAP_TENSOR_BINARY(expr::div)
+}
+
+#undef TLAP_TENSOR_BINARY
+
+template <typename T, typename U> requires std::is_arithmetic<U>::value
+Tensor<T>	operator+(const Tensor<T> &a, const U &scalar) {
+	return a + Tensor<T>({}, scalar);
+}
+
+template <typename T, typename U> requires std::is_arithmetic<U>::value
+Tensor<T>	operator-(const Tensor<T> &a, const U &scalar) {
+	return a - Tensor<T>({}, scalar);
+}
+
+template <typename T, typename U> requires std::is_arithmetic<U>::value
+Tensor<T>	operator*(const Tensor<T> &a, const U &scalar) {
+	return a * Tensor<T>({}, scalar);
+}
+
+template <typename U, typename T> requires std::is_arithmetic<U>::value
+Tensor<T>	operator*(const U &scalar, const Tensor<T> &a) {
+	return a * scalar;
+}
+
+template <typename T, typename U> requires std::is_arithmetic<U>::value
+Tensor<T>	operator/(const Tensor<T> &a, const U &scalar) {
+	if constexpr (std::is_integral<T>::value)
+		if (static_cast<T>(scalar) == 0)
+			throw std::invalid_argument("Division by zero");
+	return a / Tensor<T>({}, scalar);
+}
+
+inline shape_t	broadcastShape(const shape_t &a, const shape_t &b) {
+	shape_t res(std::max(a.size(), b.size()));
+	for (size_t i = 0; i < res.size(); ++i) {
+		const size_t da = (i < a.size() ? a[a.size() - 1 - i] : 1);
+		const size_t db = (i < b.size() ? b[b.size() - 1 - i] : 1);
+		if (da != db && da != 1 && db != 1)
+			throw std::invalid_argument("Tensor shapes cannot be broadcast together.");
+		res[res.size() - 1 - i] = (da == 1 ? db : da);
+	}
+	return res;
+}
+
+// element access
+
+template <typename T>
+template <typename... I> requires (std::is_integral<I>::value && ...)
+const T	&Tensor<T>::operator()(I... index) const {
+	const std::array<ptrdiff_t, sizeof...(I)>	idx = {static_cast<ptrdiff_t>(index)...};
+	ptrdiff_t									off = 0;
+	for (size_t d = 0; d < idx.size(); ++d)
+		off += idx[d] * _strides[d];
+	return _data[off];
+}
+
+template <typename T>
+template <typename... I> requires (std::is_integral<I>::value && ...)
+T		&Tensor<T>::operator()(I... index) {
+	return const_cast<T &>(static_cast<const Tensor &>(*this)(index...));
+}
+
+template <typename T>
+const T	*Tensor<T>::data() const {
+	return _data;
+}
+
+template <typename T>
+T		*Tensor<T>::data() {
+	return _data;
+}
+
+// views
+
+template <typename T>
+Tensor<T>	Tensor<T>::view() const {
+	return *this;
+}
+
+template <typename T>
+Tensor<T>	Tensor<T>::slice(size_t dim, size_t begin, size_t end, size_t step) const {
+	if (dim >= _shape.size() || step == 0)
+		throw std::invalid_argument("slice() needs a dimension of the Tensor and a step > 0.");
+	end = std::min(end, _shape[dim]);
+	Tensor res(*this);
+	res._shape[dim] = (begin < end ? (end - begin + step - 1) / step : 0);
+	if (res._shape[dim])
+		res._data += static_cast<ptrdiff_t>(begin) * _strides[dim];
+	res._strides[dim] *= static_cast<ptrdiff_t>(step);
+	return res;
+}
+
+template <typename T>
+Tensor<T>	Tensor<T>::select(size_t dim, size_t index) const {
+	if (dim >= _shape.size() || index >= _shape[dim])
+		throw std::invalid_argument("select() index out of the Tensor.");
+	Tensor res(*this);
+	res._data += static_cast<ptrdiff_t>(index) * _strides[dim];
+	res._shape.erase(res._shape.begin() + dim);
+	res._strides.erase(res._strides.begin() + dim);
+	return res;
+}
+
+template <typename T>
+Tensor<T>	Tensor<T>::transpose() const {
+	Tensor res(*this);
+	std::reverse(res._shape.begin(), res._shape.end());
+	std::reverse(res._strides.begin(), res._strides.end());
+	return res;
+}
+
+template <typename T>
+Tensor<T>	Tensor<T>::transpose(size_t dim0, size_t dim1) const {
+	if (dim0 >= _shape.size() || dim1 >= _shape.size())
+		throw std::invalid_argument("transpose() needs dimensions of the Tensor.");
+	Tensor res(*this);
+	std::swap(res._shape[dim0], res._shape[dim1]);
+	std::swap(res._strides[dim0], res._strides[dim1]);
+	return res;
+}
+
+template <typename T>
+Tensor<T>	Tensor<T>::permute(const shape_t &order) const {
+	shape_t sorted(order);
+	std::sort(sorted.begin(), sorted.end());
+	if (sorted.size() != _shape.size())
+		throw std::invalid_argument("permute() needs every dimension once.");
+	for (size_t d = 0; d < sorted.size(); ++d)
+		if (sorted[d] != d)
+			throw std::invalid_argument("permute() needs every dimension once.");
+	Tensor res(*this);
+	for (size_t d = 0; d < order.size(); ++d) {
+		res._shape[d] = _shape[order[d]];
+		res._strides[d] = _strides[order[d]];
+	}
+	return res;
+}
+
+template <typename T>
+Tensor<T>	Tensor<T>::broadcastTo(const shape_t &shape) const {
+	if (shape.size() < _shape.size())
+		throw std::invalid_argument("Tensor shapes cannot be broadcast together.");
+	const size_t	lead = shape.size() - _shape.size();
+	strides_t		strides(shape.size(), 0);
+	for (size_t d = 0; d < _shape.size(); ++d) {
+		if (_shape[d] == shape[lead + d])
+			strides[lead + d] = _strides[d];
+		else if (_shape[d] != 1)
+			throw std::invalid_argument("Tensor shapes cannot be broadcast together.");
+	}
+	return Tensor(_storage, _data, shape, strides);
+}
+
+template <typename T>
+Tensor<T>	Tensor<T>::squeeze() const {
+	Tensor res(_storage, _data, {}, {});
+	for (size_t d = 0; d < _shape.size(); ++d)
+		if (_shape[d] != 1) {
+			res._shape.push_back(_shape[d]);
+			res._strides.push_back(_strides[d]);
+		}
+	return res;
+}
+
+template <typename T>
+Tensor<T>	Tensor<T>::unsqueeze(size_t dim) const {
+	if (dim > _shape.size())
+		throw std::invalid_argument("unsqueeze() needs a dimension up to dims().");
+	Tensor res(*this);
+	const ptrdiff_t stride = (dim < _shape.size() ? _strides[dim] * static_cast<ptrdiff_t>(_shape[dim]) : 1);
+	res._shape.insert(res._shape.begin() + dim, 1);
+	res._strides.insert(res._strides.begin() + dim, stride);
+	return res;
+}
+
+template <typename T>
+Tensor<T>	Tensor<T>::reshape(const shape_t &shape) const {
+	if (detail::shape_size(shape) != size())
+		throw std::invalid_argument("reshape() must keep the number of elements.");
+	strides_t strides;
+	if (!size())
+		return Tensor(_storage, _data, shape, detail::row_major(shape));
+	if (detail::reshape_strides(_shape, _strides, shape, strides))
+		return Tensor(_storage, _data, shape, strides);
+	return clone().reshape(shape);
+}
+
+// copies
+
+template <typename T>
+Tensor<T>	Tensor<T>::clone() const {
+	Tensor res = uninitialized(_shape);
+	if (size())
+		detail::tensor_apply<detail::tensor_copy>(_shape, res._data, res._strides, _data, strides_t(_shape.size(), 0), _data, _strides);
+	return res;
+}
+
+template <typename T>
+Tensor<T>	Tensor<T>::contiguous() const {
+	return isContiguous() ? *this : clone();
+}
+
+template <typename T>
+size_t	Tensor<T>::dims() const {
+	return _shape.size();
+}
+
+template <typename T>
+const shape_t	&Tensor<T>::shape() const {
+	return _shape;
+}
+
+template <typename T>
+size_t	Tensor<T>::shape(size_t dim) const {
+	return _shape[dim];
+}
+
+template <typename T>
+const strides_t	&Tensor<T>::strides() const {
+	return _strides;
+}
+
+template <typename T>
+size_t	Tensor<T>::size() const {
+	return detail::shape_size(_shape);
+}
+
+template <typename T>
+bool	Tensor<T>::isContiguous() const {
+	ptrdiff_t s = 1;
+	for (size_t d = _shape.size(); d-- > 0;) {
+		if (_shape[d] != 1 && _strides[d] != s)
+			return false;
+		s *= static_cast<ptrdiff_t>(_shape[d]);
+	}
+	return true;
+}
+
+// Vector and Matrix views, defined here since they need the complete Tensor
+
+template <typename T, typename Enable>
+Tensor<T>	Vector<T, Enable>::asTensor() {
+	return Tensor<T>::borrow(_data, {_size}, {1});
+}
+
+template <typename T>
+Tensor<T>	Matrix<T>::asTensor() {
+	return Tensor<T>::borrow(_data, {_rows, _cols}, {static_cast<ptrdiff_t>(_stride), 1});
+}
+
+} // namespace tlap
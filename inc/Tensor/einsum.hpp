@@ -0,0 +1,32 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: tensor contractions written as einsum equations, lowered to gemm
+// File version: 0.1
+#pragma once
+
+#include "Tensor.hpp"
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// einsum("bij,bjk->bik", a, b): one letter (a-z, A-Z) per dimension of every
+// operand, the letters of the result after "->". without "->" the result keeps
+// the letters seen exactly once, in ascii order (numpy). a letter repeated in
+// one operand takes its diagonal, a letter missing from the result is summed
+// over. all the dimensions of a letter have the same size: no broadcasting, no
+// "...".
+// operands are contracted two at a time in the order of fewest multiply-adds:
+// every order is tried up to EINSUM_OPTIMAL_MAX operands, past it the cheapest
+// pair goes first. a pairwise contraction sums out the letters only one side
+// uses, permutes and folds both sides to batch x m x k and batch x k x n and
+// runs one gemm per batch (Matrix/gemm.hpp); a side is copied only when its
+// permuted view is not contiguous. the plan (order, sums, permutations and
+// folded sizes) is built once per equation and operand shapes and cached.
+namespace tlap {
+	// throws on a malformed equation or mismatched sizes, the result is always new storage
+	template <typename T>
+	Tensor<T>	einsum(const std::string &equation, const std::vector<Tensor<T>> &operands);
+	template <typename T, typename... R> requires (std::is_same<R, Tensor<T>>::value && ...)
+	Tensor<T>	einsum(const std::string &equation, const Tensor<T> &first, const R &...rest);
+}
+
+#include "einsum.tpp"
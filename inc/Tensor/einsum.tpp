@@ -0,0 +1,352 @@
+#pragma once
+
+#include "einsum.hpp"
+#include "../hyperp.hpp"
+#include "../simd/simd.hpp"
+#include "../Matrix/gemm.hpp"
+#include "../parallel/pool.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace tlap {
+
+namespace detail {
+
+// one pairwise contraction of a plan, on slots: slot i < operand count holds
+// operand i, the result of step s goes to slot operand count + s
+struct	einsum_step {
+	size_t	lhs, rhs;
+	shape_t	sumL, sumR; // dimensions summed out first, in decreasing order
+	shape_t	permL, permR; // then to batch, m, k and batch, k, n
+	size_t	batch, m, n, k; // folded sizes
+	shape_t	shape; // of the result: batch, m then n dimensions
+};
+
+struct	einsum_plan {
+	std::vector<std::vector<size_t>>	diag; // per operand: dimension of its diagonal view for every dimension, empty without a repeated letter
+	std::vector<shape_t>				diagShape;
+	std::vector<einsum_step>			steps;
+	shape_t								sum; // dimensions of the last slot summed out, decreasing
+	shape_t								perm; // then permuted to the result
+};
+
+using einsum_set = uint64_t; // a bit per letter
+
+inline size_t	einsum_letter(char c) {
+	if (c >= 'a' && c <= 'z')
+		return c - 'a';
+	if (c >= 'A' && c <= 'Z')
+		return 26 + (c - 'A');
+	throw std::invalid_argument(std::string("einsum: '") + c + "' is not a dimension letter.");
+}
+
+inline einsum_set	einsum_mask(const std::string &letters) {
+	einsum_set s = 0;
+	for (char c : letters)
+		s |= einsum_set(1) << einsum_letter(c);
+	return s;
+}
+
+// positions in from of the letters of s, in decreasing order
+inline shape_t	einsum_positions(const std::string &from, einsum_set s) {
+	shape_t res;
+	for (size_t i = from.size(); i-- > 0;)
+		if (s >> einsum_letter(from[i]) & 1)
+			res.push_back(i);
+	return res;
+}
+
+inline std::string	einsum_drop(const std::string &from, einsum_set s) {
+	std::string res;
+	for (char c : from)
+		if (!(s >> einsum_letter(c) & 1))
+			res += c;
+	return res;
+}
+
+inline std::shared_ptr<const einsum_plan>	einsum_compile(const std::string &equation, const std::vector<shape_t> &shapes) {
+	const size_t	arrow = equation.find("->");
+	const std::string	inputs = equation.substr(0, arrow);
+	std::vector<std::string>	terms(1);
+	size_t			size[52];
+	size_t			count[52] = {};
+	auto			plan = std::make_shared<einsum_plan>();
+
+	for (char c : inputs) {
+		if (c == ',')
+			terms.emplace_back();
+		else
+			terms.back() += c;
+	}
+	if (terms.size() != shapes.size())
+		throw std::invalid_argument("einsum needs one term per operand.");
+	std::fill(size, size + 52, size_t(-1));
+
+	// letters and their sizes, a diagonal view for the terms repeating one
+	const size_t	n = terms.size();
+	std::vector<std::string>	slot(n);
+	std::vector<einsum_set>		mask(n);
+	plan->diag.resize(n);
+	plan->diagShape.resize(n);
+	for (size_t i = 0; i < n; ++i) {
+		if (terms[i].size() != shapes[i].size())
+			throw std::invalid_argument("einsum needs one letter per dimension of every operand.");
+		for (size_t d = 0; d < terms[i].size(); ++d) {
+			const size_t l = einsum_letter(terms[i][d]);
+			if (size[l] != size_t(-1) && size[l] != shapes[i][d])
+				throw std::invalid_argument(std::string("einsum: different sizes for '") + terms[i][d] + "'.");
+			size[l] = shapes[i][d];
+			++count[l];
+			if (slot[i].find(terms[i][d]) == std::string::npos) {
+				slot[i] += terms[i][d];
+				plan->diagShape[i].push_back(shapes[i][d]);
+			}
+		}
+		if (slot[i].size() != terms[i].size())
+			for (char c : terms[i])
+				plan->diag[i].push_back(slot[i].find(c));
+		mask[i] = einsum_mask(slot[i]);
+	}
+
+	std::string	output;
+	if (arrow == std::string::npos) {
+		for (size_t l = 0; l < 52; ++l) // 'A'-'Z' first, ascii order
+			if (count[(l + 26) % 52] == 1)
+				output += static_cast<char>(l < 26 ? 'A' + l : 'a' + l - 26);
+	} else {
+		output = equation.substr(arrow + 2);
+		for (size_t i = 0; i < output.size(); ++i)
+			if (!count[einsum_letter(output[i])] || output.find(output[i], i + 1) != std::string::npos)
+				throw std::invalid_argument("einsum: result letters must appear in an operand, once.");
+	}
+	const einsum_set	out = einsum_mask(output);
+
+	// letters a group of operands still needs once contracted: those of the
+	// result or of an operand outside the group. a pairwise contraction costs
+	// the product of the sizes of every letter the two sides keep
+	auto letters = [&](einsum_set group) {
+		einsum_set inside = 0, outside = out;
+		for (size_t i = 0; i < n; ++i)
+			(group >> i & 1 ? inside : outside) |= mask[i];
+		return inside & outside;
+	};
+	auto cost = [&](einsum_set l) {
+		double c = 1;
+		for (size_t i = 0; i < 52; ++i)
+			if (l >> i & 1)
+				c *= static_cast<double>(size[i]);
+		return c;
+	};
+	auto pair = [&](einsum_set g0, einsum_set g1) { return cost(letters(g0) | letters(g1)); };
+
+	// groups of operands as bit sets, in the order the steps contract them
+	std::vector<std::pair<einsum_set, einsum_set>>	order;
+	if (n > 1 && n <= EINSUM_OPTIMAL_MAX) {
+		const size_t			all = (size_t(1) << n) - 1;
+		std::vector<double>		best(all + 1, 0);
+		std::vector<size_t>		split(all + 1, 0);
+		for (size_t g = 1; g <= all; ++g) {
+			if (!(g & (g - 1)))
+				continue;
+			const size_t low = g & -g;
+			best[g] = -1;
+			for (size_t g0 = (g - 1) & g; g0; g0 = (g0 - 1) & g) {
+				if (!(g0 & low))
+					continue;
+				const double c = best[g0] + best[g ^ g0] + pair(g0, g ^ g0);
+				if (best[g] < 0 || c < best[g]) {
+					best[g] = c;
+					split[g] = g0;
+				}
+			}
+		}
+		std::function<void(size_t)> walk = [&](size_t g) {
+			if (!(g & (g - 1)))
+				return;
+			walk(split[g]);
+			walk(g ^ split[g]);
+			order.emplace_back(split[g], g ^ split[g]);
+		};
+		walk(all);
+	} else if (n > 1) {
+		std::vector<einsum_set> live;
+		for (size_t i = 0; i < n; ++i)
+			live.push_back(einsum_set(1) << i);
+		while (live.size() > 1) {
+			size_t	bi = 0, bj = 1;
+			double	bc = -1;
+			for (size_t i = 0; i < live.size(); ++i)
+				for (size_t j = i + 1; j < live.size(); ++j) {
+					const double c = pair(live[i], live[j]);
+					if (bc < 0 || c < bc) {
+						bc = c;
+						bi = i;
+						bj = j;
+					}
+				}
+			order.emplace_back(live[bi], live[bj]);
+			live[bi] |= live[bj];
+			live.erase(live.begin() + bj);
+		}
+	}
+
+	// the steps: slots of each group, sums, permutations and folded sizes
+	std::unordered_map<einsum_set, size_t>	slotOf;
+	for (size_t i = 0; i < n; ++i)
+		slotOf[einsum_set(1) << i] = i;
+	for (const auto &[g0, g1] : order) {
+		einsum_step			s;
+		const einsum_set	keep = letters(g0 | g1);
+		const std::string	&a = slot[slotOf[g0]], &b = slot[slotOf[g1]];
+		const einsum_set	ma = einsum_mask(a), mb = einsum_mask(b);
+
+		s.lhs = slotOf[g0];
+		s.rhs = slotOf[g1];
+		s.sumL = einsum_positions(a, ma & ~mb & ~keep);
+		s.sumR = einsum_positions(b, mb & ~ma & ~keep);
+		const std::string	ra = einsum_drop(a, ma & ~mb & ~keep), rb = einsum_drop(b, mb & ~ma & ~keep);
+		std::string			batch, m, k, nn;
+		for (char c : ra) {
+			if (b.find(c) == std::string::npos)
+				m += c;
+			else
+				(keep >> einsum_letter(c) & 1 ? batch : k) += c;
+		}
+		for (char c : rb)
+			if (a.find(c) == std::string::npos)
+				nn += c;
+		s.batch = s.m = s.n = s.k = 1;
+		for (char c : batch + m + k)
+			s.permL.push_back(ra.find(c));
+		for (char c : batch + k + nn)
+			s.permR.push_back(rb.find(c));
+		for (char c : batch)
+			s.batch *= size[einsum_letter(c)];
+		for (char c : m)
+			s.m *= size[einsum_letter(c)];
+		for (char c : nn)
+			s.n *= size[einsum_letter(c)];
+		for (char c : k)
+			s.k *= size[einsum_letter(c)];
+		for (char c : batch + m + nn)
+			s.shape.push_back(size[einsum_letter(c)]);
+		slotOf[g0 | g1] = n + plan->steps.size();
+		slot.push_back(batch + m + nn);
+		plan->steps.push_back(std::move(s));
+	}
+
+	const std::string	&last = slot.back();
+	plan->sum = einsum_positions(last, einsum_mask(last) & ~out);
+	const std::string	kept = einsum_drop(last, ~out);
+	for (char c : output)
+		plan->perm.push_back(kept.find(c));
+	return plan;
+}
+
+// plans by equation and operand shapes, emptied when full
+inline std::shared_ptr<const einsum_plan>	einsum_cached(const std::string &equation, const std::vector<shape_t> &shapes) {
+	static std::mutex	lock;
+	static std::unordered_map<std::string, std::shared_ptr<const einsum_plan>>	cache;
+	std::string			key = equation;
+
+	for (const shape_t &s : shapes) {
+		key += '|';
+		for (size_t d : s)
+			key += std::to_string(d) + ',';
+	}
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		const auto it = cache.find(key);
+		if (it != cache.end())
+			return it->second;
+	}
+	std::shared_ptr<const einsum_plan>	plan = einsum_compile(equation, shapes);
+	std::lock_guard<std::mutex>			guard(lock);
+	if (cache.size() >= EINSUM_CACHE_SIZE)
+		cache.clear();
+	cache.emplace(std::move(key), plan);
+	return plan;
+}
+
+// t summed over dimension dim, new storage
+template <typename T>
+Tensor<T>	einsum_sum(const Tensor<T> &t, size_t dim) {
+	shape_t	shape = t.shape();
+	shape.erase(shape.begin() + dim);
+	if (!t.shape(dim))
+		return Tensor<T>(shape);
+	Tensor<T> res = t.select(dim, 0).clone();
+	for (size_t i = 1; i < t.shape(dim); ++i)
+		res += t.select(dim, i);
+	return res;
+}
+
+// c[i] = a[i] b[i] for every batch i; small products run whole on one thread
+// each, large ones thread inside gemm
+template <typename T>
+void	einsum_gemm(const einsum_step &s, const T *a, const T *b, T *c) {
+	const bool	parallel = s.m * s.n * s.k < GEMM_PARALLEL_MIN && s.batch * s.m * s.n * s.k >= GEMM_PARALLEL_MIN;
+
+	parallel::parallel_for(0, s.batch, (parallel ? 1 : s.batch), [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			tlap::gemm(s.m, s.n, s.k, T(1), a + i * s.m * s.k, s.k, b + i * s.k * s.n, s.n, T(0), c + i * s.m * s.n, s.n);
+	}, "einsum");
+}
+
+} // namespace detail
+
+template <typename T>
+Tensor<T>	einsum(const std::string &equation, const std::vector<Tensor<T>> &operands) {
+	std::vector<shape_t>	shapes;
+	std::vector<Tensor<T>>	slot;
+
+	for (const Tensor<T> &t : operands)
+		shapes.push_back(t.shape());
+	const auto	plan = detail::einsum_cached(equation, shapes);
+
+	// diagonals are views with the strides of the repeated dimensions added,
+	// borrowed: the operands outlive the call and are only read
+	for (size_t i = 0; i < operands.size(); ++i) {
+		if (plan->diag[i].empty()) {
+			slot.push_back(operands[i]);
+			continue;
+		}
+		strides_t	strides(plan->diagShape[i].size(), 0);
+		for (size_t d = 0; d < plan->diag[i].size(); ++d)
+			strides[plan->diag[i][d]] += operands[i].strides()[d];
+		slot.push_back(Tensor<T>::borrow(const_cast<T *>(operands[i].data()), plan->diagShape[i], strides));
+	}
+
+	for (const detail::einsum_step &s : plan->steps) {
+		Tensor<T>	a = slot[s.lhs], b = slot[s.rhs];
+		for (size_t d : s.sumL)
+			a = detail::einsum_sum(a, d);
+		for (size_t d : s.sumR)
+			b = detail::einsum_sum(b, d);
+		a = a.permute(s.permL).contiguous();
+		b = b.permute(s.permR).contiguous();
+
+		Tensor<T>	c = Tensor<T>::uninitialized(s.shape);
+		detail::einsum_gemm(s, a.data(), b.data(), c.data());
+		slot[s.lhs] = slot[s.rhs] = Tensor<T>(); // intermediates freed as soon as used
+		slot.push_back(std::move(c));
+	}
+
+	Tensor<T>	res = slot.back();
+	for (size_t d : plan->sum)
+		res = detail::einsum_sum(res, d);
+	res = res.permute(plan->perm);
+	return (plan->steps.empty() && plan->sum.empty() ? res.clone() : res.contiguous());
+}
+
+template <typename T, typename... R> requires (std::is_same<R, Tensor<T>>::value && ...)
+Tensor<T>	einsum(const std::string &equation, const Tensor<T> &first, const R &...rest) {
+	return einsum(equation, std::vector<Tensor<T>>{first, rest...});
+}
+
+} // namespace tlap
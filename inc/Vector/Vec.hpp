@@ -0,0 +1,115 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: fixed-size, stack-allocated vector for 2D/3D/4D geometry
+// File version: 0.1
+
+#pragma once
+
+#include "Vector.hpp"
+#include <cstddef>
+#include <type_traits>
+
+
+namespace tlap {
+
+// Vec<T, N> is the compile-time sized counterpart of Vector<T>: the same
+// methods, no heap, and every method constexpr except the trigonometric ones.
+// N <= 4 is stored as 4 lanes aligned on 4 elements (one SSE register for
+// float), the unused lanes are kept at zero so that every operation can run
+// on all 4 lanes.
+template <typename T, size_t N>
+class Vec {
+	static_assert(std::is_arithmetic<T>::value, "Vec can only be instantiated with arithmetic types.");
+	static_assert(N > 0, "Vec needs at least one element.");
+
+	public:
+		using value_type = T;
+		using real = std::conditional_t<std::is_floating_point<T>::value, T, float>; // lengths and angles
+		static constexpr size_t	lanes = (N <= 4 ? 4 : N);
+
+	private:
+		alignas(N <= 4 ? 4 * sizeof(T) : alignof(T)) T	_data[lanes];
+
+		constexpr void			_clearPadding();
+
+	public:
+		// constructors
+		constexpr Vec(); // zero
+		constexpr explicit Vec(const T &value); // fill constructor
+		template <typename... U> requires (N > 1 && sizeof...(U) == N && (std::is_arithmetic<U>::value && ...))
+		constexpr Vec(const U &...values); // Vec<float, 3> v(1, 2, 3)
+		TEMPLATE_U constexpr explicit Vec(const Vec<U, N> &other); // converting constructor
+		explicit Vec(const Vector<T> &other); // throws if other.shape() != N
+
+		Vector<T>				toVector() const;
+
+		// comparison operators
+		constexpr bool			operator==(const Vec &other) const;
+		constexpr bool			operator!=(const Vec &other) const;
+
+		// arithmetic operators, elementwise (dot() for the dot product)
+		constexpr Vec			operator-() const;
+		constexpr Vec			operator+(const Vec &other) const;
+		constexpr Vec			operator-(const Vec &other) const;
+		constexpr Vec			operator*(const Vec &other) const;
+		constexpr Vec			operator*(const T &scalar) const;
+		constexpr Vec			operator/(const T &scalar) const;
+		constexpr Vec			&operator+=(const Vec &other);
+		constexpr Vec			&operator-=(const Vec &other);
+		constexpr Vec			&operator*=(const Vec &other);
+		constexpr Vec			&operator*=(const T &scalar);
+		constexpr Vec			&operator/=(const T &scalar);
+
+		// index access operators
+		constexpr const T		&operator[](size_t index) const;
+		constexpr T				&operator[](size_t index);
+		constexpr const T		*data() const; // N elements, then zeros up to lanes
+		constexpr T				*data();
+
+		// various operations and methods, same meaning as in Vector
+		constexpr Vec			&add(const Vec &other);
+		constexpr Vec			&sub(const Vec &other);
+		constexpr Vec			&scaleUp(const T &scalar);
+		constexpr Vec			&scaleDown(const T &scalar); // integer division by 0 throws
+		constexpr Vec			&linComb(const Vec &other, const T &factor1, const T &factor2);
+		constexpr Vec			&lerp(const Vec &other, const T &factor);
+
+		constexpr T				dot(const Vec &other) const;
+		constexpr Vec			&cross(const Vec &other) requires (N == 3);
+		constexpr real			norm1() const;
+		constexpr real			norm() const;
+		constexpr real			normInf() const;
+
+		constexpr Vec			&normalize(); // throws on a zero vector
+		constexpr Vec			&resize(const T &len);
+		constexpr Vec			&clamp(const T &low, const T &high);
+		template <typename F>
+		constexpr Vec			&apply(F func); // on each element
+
+		constexpr Vec			&reflect(const Vec &normal); // normal of unit length
+		constexpr Vec			&refract(const Vec &normal, const T &eta); // unit vectors, zero on total internal reflection
+		constexpr Vec			&project(const Vec &onto); // orthogonal projection on onto
+
+		Vec						&rotate(const T &angle) requires (N == 2);
+		Vec						&rotate(const Vec &axis, const T &angle, const Vec &center) requires (N == 3); // right-handed, around the line through center
+		real					cos(const Vec &other) const;
+		real					angle(const Vec &other) const;
+		constexpr real			dist(const Vec &other) const;
+
+		constexpr real			len() const;
+		static constexpr size_t	shape() { return N; }
+};
+
+template <typename U, typename T, size_t N> requires std::is_arithmetic<U>::value
+constexpr Vec<T, N>	operator*(const U &scalar, const Vec<T, N> &v);
+template <typename T, size_t N>
+constexpr T			dot(const Vec<T, N> &a, const Vec<T, N> &b);
+template <typename T>
+constexpr Vec<T, 3>	cross(const Vec<T, 3> &a, const Vec<T, 3> &b);
+
+template <typename T> using Vec2 = Vec<T, 2>;
+template <typename T> using Vec3 = Vec<T, 3>;
+template <typename T> using Vec4 = Vec<T, 4>;
+
+} // namespace tlap
+
+#include "Vec.tpp" // implementations
@@ -0,0 +1,454 @@
+#pragma once
+
+#include "Vec.hpp"
+#include "../simd/simd.hpp"
+#include "../math/math.hpp"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+namespace tlap {
+
+namespace detail {
+
+// float Vecs of up to 4 elements are one SSE register, SSE2 is the x86-64
+// baseline so these need no dispatch. element loops cover the rest (the
+// compiler packs the 4-lane ones by itself) and the constant evaluation
+template <typename T, size_t N>
+inline constexpr bool	vec_sse = std::is_same<T, float>::value && N <= 4;
+
+inline float	vec_dot4(const float *a, const float *b) {
+	__m128 p = _mm_mul_ps(_mm_load_ps(a), _mm_load_ps(b));
+	__m128 s = _mm_add_ps(p, _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtss_f32(_mm_add_ss(s, _mm_movehl_ps(s, s)));
+}
+
+// a x b = (a * b.yzx - a.yzx * b).yzx, the zero 4th lanes stay zero
+inline void		vec_cross4(const float *a, const float *b, float *out) {
+	__m128 va = _mm_load_ps(a);
+	__m128 vb = _mm_load_ps(b);
+	__m128 a_yzx = _mm_shuffle_ps(va, va, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 b_yzx = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 c = _mm_sub_ps(_mm_mul_ps(va, b_yzx), _mm_mul_ps(a_yzx, vb));
+	_mm_store_ps(out, _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1)));
+}
+
+template <typename T>
+constexpr T		vec_abs(T x) {
+	if constexpr (std::is_signed<T>::value)
+		return (x < T(0) ? static_cast<T>(-x) : x);
+	else
+		return x;
+}
+
+// Newton from above while constant evaluated, tlap::sqrt otherwise
+template <typename R>
+constexpr R		vec_sqrt(R x) {
+	if (!std::is_constant_evaluated())
+		return tlap::sqrt(x);
+	if (x < R(0))
+		return std::numeric_limits<R>::quiet_NaN();
+	if (x == R(0) || x == std::numeric_limits<R>::infinity() || x != x)
+		return x;
+	R y = (x > R(1) ? x : R(1));
+	for (;;) {
+		R next = (y + x / y) / R(2);
+		if (!(next < y))
+			return y;
+		y = next;
+	}
+}
+
+} // namespace detail
+
+// storage
+
+template <typename T, size_t N>
+constexpr void	Vec<T, N>::_clearPadding() {
+	for (size_t i = N; i < lanes; ++i)
+		_data[i] = T(0);
+}
+
+// constructors
+
+template <typename T, size_t N>
+constexpr Vec<T, N>::Vec()
+	: _data{} {
+}
+
+template <typename T, size_t N>
+constexpr Vec<T, N>::Vec(const T &value)
+	: _data{} {
+	for (size_t i = 0; i < N; ++i)
+		_data[i] = value;
+}
+
+template <typename T, size_t N>
+template <typename... U> requires (N > 1 && sizeof...(U) == N && (std::is_arithmetic<U>::value && ...))
+constexpr Vec<T, N>::Vec(const U &...values)
+	: _data{static_cast<T>(values)...} {
+}
+
+template <typename T, size_t N>
+TEMPLATE_U constexpr Vec<T, N>::Vec(const Vec<U, N> &other)
+	: _data{} {
+	for (size_t i = 0; i < N; ++i)
+		_data[i] = static_cast<T>(other[i]);
+}
+
+template <typename T, size_t N>
+Vec<T, N>::Vec(const Vector<T> &other)
+	: _data{} {
+	if (other.shape() != N)
+		throw std::invalid_argument("Vector and Vec must have the same size.");
+	for (size_t i = 0; i < N; ++i)
+		_data[i] = other[i];
+}
+
+template <typename T, size_t N>
+Vector<T>	Vec<T, N>::toVector() const {
+	Vector<T> res = Vector<T>::uninitialized(N);
+	for (size_t i = 0; i < N; ++i)
+		res[i] = _data[i];
+	return res;
+}
+
+// comparison operators
+
+template <typename T, size_t N>
+constexpr bool	Vec<T, N>::operator==(const Vec &other) const {
+	for (size_t i = 0; i < N; ++i)
+		if (_data[i] != other._data[i])
+			return false;
+	return true;
+}
+
+template <typename T, size_t N>
+constexpr bool	Vec<T, N>::operator!=(const Vec &other) const {
+	return !(*this == other);
+}
+
+// arithmetic operators
+
+template <typename T, size_t N>
+constexpr Vec<T, N>	Vec<T, N>::operator-() const {
+	Vec res;
+	for (size_t i = 0; i < lanes; ++i)
+		res._data[i] = static_cast<T>(-_data[i]);
+	return res;
+}
+
+template <typename T, size_t N>
+constexpr Vec<T, N>	Vec<T, N>::operator+(const Vec &other) const {
+	Vec res(*this);
+	return res += other;
+}
+
+template <typename T, size_t N>
+constexpr Vec<T, N>	Vec<T, N>::operator-(const Vec &other) const {
+	Vec res(*this);
+	return res -= other;
+}
+
+template <typename T, size_t N>
+constexpr Vec<T, N>	Vec<T, N>::operator*(const Vec &other) const {
+	Vec res(*this);
+	return res *= other;
+}
+
+template <typename T, size_t N>
+constexpr Vec<T, N>	Vec<T, N>::operator*(const T &scalar) const {
+	Vec res(*this);
+	return res *= scalar;
+}
+
+template <typename T, size_t N>
+constexpr Vec<T, N>	Vec<T, N>::operator/(const T &scalar) const {
+	Vec res(*this);
+	return res /= scalar;
+}
+
+template <typename T, size_t N>
+constexpr Vec<T, N>	&Vec<T, N>::operator+=(const Vec &other) {
+	for (size_t i = 0; i < lanes; ++i)
+		_data[i] = static_cast<T>(_data[i] + other._data[i]);
+	return *this;
+}
+
+template <typename T, size_t N>
+constexpr Vec<T, N>	&Vec<T, N>::operator-=(const Vec &other) {
+	for (size_t i = 0; i < lanes; ++i)
+		_data[i] = static_cast<T>(_data[i] - other._data[i]);
+	return *this;
+}
+
+template <typename T, size_t N>
+constexpr Vec<T, N>	&Vec<T, N>::operator*=(const Vec &other) {
+	for (size_t i = 0; i < lanes; ++i)
+		_data[i] = static_cast<T>(_data[i] * other._data[i]);
+	return *this;
+}
+
+template <typename T, size_t N>
+constexpr Vec<T, N>	&Vec<T, N>::operator*=(const T &scalar) {
+	return scaleUp(scalar);
+}
+
+template <typename T, size_t N>
+constexpr Vec<T, N>	&Vec<T, N>::operator/=(const T &scalar) {
+	return scaleDown(scalar);
+}
+
+template <typename U, typename T, size_t N> requires std::is_arithmetic<U>::value
+constexpr Vec<T, N>	operator*(const U &scalar, const Vec<T, N> &v) {
+	return v * static_cast<T>(scalar);
+}
+
+// index access operators
+
+template <typename T, size_t N>
+constexpr const T	&Vec<T, N>::operator[](size_t index) const {
+	return _data[index];
+}
+
+template <typename T, size_t N>
+constexpr T		&Vec<T, N>::operator[](size_t index) {
+	return _data[index];
+}
+
+template <typename T, size_t N>
+constexpr const T	*Vec<T, N>::data() const {
+	return _data;
+}
+
+template <typename T, size_t N>
+constexpr T		*Vec<T, N>::data() {
+	return _data;
+}
+
+// various operations and methods
+
+template <typename T, size_t N>
+constexpr Vec<T, N>	&Vec<T, N>::add(const Vec &other) {
+	return *this += other;
+}
+
+template <typename T, size_t N>
+constexpr Vec<T, N>	&Vec<T, N>::sub(const Vec &other) {
+	return *this -= other;
+}
+
+template <typename T, size_t N>
+constexpr Vec<T, N>	&Vec<T, N>::scaleUp(const T &scalar) {
+	for (size_t i = 0; i < lanes; ++i)
+		_data[i] = static_cast<T>(_data[i] * scalar);
+	_clearPadding(); // 0 * inf
+	return *this;
+}
+
+template <typename T, size_t N>
+constexpr Vec<T, N>	&Vec<T, N>::scaleDown(const T &scalar) {
+	if constexpr (std::is_integral<T>::value)
+		if (scalar == 0)
+			throw std::invalid_argument("Division by zero");
+	for (size_t i = 0; i < lanes; ++i)
+		_data[i] = static_cast<T>(_data[i] / scalar);
+	_clearPadding(); // 0 / 0
+	return *this;
+}
+
+// this = this * factor1 + other * factor2
+template <typename T, size_t N>
+constexpr Vec<T, N>	&Vec<T, N>::linComb(const Vec &other, const T &factor1, const T &factor2) {
+	for (size_t i = 0; i < lanes; ++i)
+		_data[i] = static_cast<T>(_data[i] * factor1 + other._data[i] * factor2);
+	_clearPadding();
+	return *this;
+}
+
+// this = this + (other - this) * factor
+template <typename T, size_t N>
+constexpr Vec<T, N>	&Vec<T, N>::lerp(const Vec &other, const T &factor) {
+	for (size_t i = 0; i < lanes; ++i)
+		_data[i] = static_cast<T>(_data[i] + (other._data[i] - _data[i]) * factor);
+	_clearPadding();
+	return *this;
+}
+
+template <typename T, size_t N>
+constexpr T		Vec<T, N>::dot(const Vec &other) const {
+	if constexpr (detail::vec_sse<T, N>)
+		if (!std::is_constant_evaluated())
+			return detail::vec_dot4(_data, other._data);
+	T res = T(0);
+	for (size_t i = 0; i < N; ++i)
+		res = static_cast<T>(res + _data[i] * other._data[i]);
+	return res;
+}
+
+template <typename T, size_t N>
+constexpr Vec<T, N>	&Vec<T, N>::cross(const Vec &other) requires (N == 3) {
+	if constexpr (detail::vec_sse<T, N>)
+		if (!std::is_constant_evaluated()) {
+			detail::vec_cross4(_data, other._data, _data);
+			return *this;
+		}
+	const T x = _data[1] * other._data[2] - _data[2] * other._data[1];
+	const T y = _data[2] * other._data[0] - _data[0] * other._data[2];
+	const T z = _data[0] * other._data[1] - _data[1] * other._data[0];
+	_data[0] = x;
+	_data[1] = y;
+	_data[2] = z;
+	return *this;
+}
+
+template <typename T, size_t N>
+constexpr typename Vec<T, N>::real	Vec<T, N>::norm1() const {
+	real res = real(0);
+	for (size_t i = 0; i < N; ++i)
+		res += static_cast<real>(detail::vec_abs(_data[i]));
+	return res;
+}
+
+template <typename T, size_t N>
+constexpr typename Vec<T, N>::real	Vec<T, N>::norm() const {
+	return detail::vec_sqrt(static_cast<real>(dot(*this)));
+}
+
+template <typename T, size_t N>
+constexpr typename Vec<T, N>::real	Vec<T, N>::normInf() const {
+	real res = real(0);
+	for (size_t i = 0; i < N; ++i)
+		res = std::max(res, static_cast<real>(detail::vec_abs(_data[i])));
+	return res;
+}
+
+template <typename T, size_t N>
+constexpr Vec<T, N>	&Vec<T, N>::normalize() {
+	real n = norm();
+	if (n == real(0))
+		throw std::invalid_argument("Cannot normalize a zero vector.");
+	if constexpr (std::is_floating_point<T>::value)
+		return scaleUp(T(1) / n);
+	else
+		return scaleDown(static_cast<T>(n));
+}
+
+template <typename T, size_t N>
+constexpr Vec<T, N>	&Vec<T, N>::resize(const T &len) {
+	normalize();
+	return scaleUp(len);
+}
+
+template <typename T, size_t N>
+constexpr Vec<T, N>	&Vec<T, N>::clamp(const T &low, const T &high) {
+	for (size_t i = 0; i < N; ++i)
+		_data[i] = std::min(std::max(_data[i], low), high);
+	return *this;
+}
+
+template <typename T, size_t N>
+template <typename F>
+constexpr Vec<T, N>	&Vec<T, N>::apply(F func) {
+	for (size_t i = 0; i < N; ++i)
+		_data[i] = static_cast<T>(func(_data[i]));
+	return *this;
+}
+
+// this - 2 * dot(this, normal) * normal
+template <typename T, size_t N>
+constexpr Vec<T, N>	&Vec<T, N>::reflect(const Vec &normal) {
+	const T d = static_cast<T>(2 * dot(normal));
+	return *this -= normal * d;
+}
+
+// snell's law for a unit incident this and a unit normal facing it,
+// eta = n1 / n2 the ratio of the refractive indices
+template <typename T, size_t N>
+constexpr Vec<T, N>	&Vec<T, N>::refract(const Vec &normal, const T &eta) {
+	const real d = static_cast<real>(dot(normal));
+	const real k = real(1) - static_cast<real>(eta) * static_cast<real>(eta) * (real(1) - d * d);
+	if (k < real(0))
+		return *this = Vec();
+	const T f = static_cast<T>(static_cast<real>(eta) * d + detail::vec_sqrt(k));
+	return linComb(normal, eta, static_cast<T>(-f));
+}
+
+template <typename T, size_t N>
+constexpr Vec<T, N>	&Vec<T, N>::project(const Vec &onto) {
+	const T oo = onto.dot(onto);
+	if (oo == T(0))
+		throw std::invalid_argument("Cannot project on a zero vector.");
+	const real f = static_cast<real>(dot(onto)) / static_cast<real>(oo);
+	Vec res;
+	for (size_t i = 0; i < N; ++i)
+		res._data[i] = static_cast<T>(onto._data[i] * f);
+	return *this = res;
+}
+
+template <typename T, size_t N>
+Vec<T, N>	&Vec<T, N>::rotate(const T &angle) requires (N == 2) {
+	real s, c;
+	tlap::sincos(static_cast<real>(angle), s, c);
+	const real x = static_cast<real>(_data[0]);
+	const real y = static_cast<real>(_data[1]);
+	_data[0] = static_cast<T>(x * c - y * s);
+	_data[1] = static_cast<T>(x * s + y * c);
+	return *this;
+}
+
+// rodrigues: v cos + (k x v) sin + k (k . v)(1 - cos), k the unit axis and
+// v = this - center
+template <typename T, size_t N>
+Vec<T, N>	&Vec<T, N>::rotate(const Vec &axis, const T &angle, const Vec &center) requires (N == 3) {
+	using R = Vec<real, 3>;
+	real s, c;
+	tlap::sincos(static_cast<real>(angle), s, c);
+	R k(axis);
+	k.normalize();
+	R v = R(*this) - R(center);
+	R kv = tlap::cross(k, v);
+	R res = v * c + kv * s + k * (k.dot(v) * (real(1) - c)) + R(center);
+	return *this = Vec(res);
+}
+
+template <typename T, size_t N>
+typename Vec<T, N>::real	Vec<T, N>::cos(const Vec &other) const {
+	real n = norm() * other.norm();
+	if (n == real(0))
+		throw std::invalid_argument("The angle with a zero vector is undefined.");
+	return std::clamp(static_cast<real>(dot(other)) / n, real(-1), real(1));
+}
+
+template <typename T, size_t N>
+typename Vec<T, N>::real	Vec<T, N>::angle(const Vec &other) const {
+	return tlap::acos(cos(other));
+}
+
+template <typename T, size_t N>
+constexpr typename Vec<T, N>::real	Vec<T, N>::dist(const Vec &other) const {
+	Vec d(*this);
+	d -= other;
+	return d.norm();
+}
+
+template <typename T, size_t N>
+constexpr typename Vec<T, N>::real	Vec<T, N>::len() const {
+	return norm();
+}
+
+// free functions
+
+template <typename T, size_t N>
+constexpr T		dot(const Vec<T, N> &a, const Vec<T, N> &b) {
+	return a.dot(b);
+}
+
+template <typename T>
+constexpr Vec<T, 3>	cross(const Vec<T, 3> &a, const Vec<T, 3> &b) {
+	Vec<T, 3> res(a);
+	return res.cross(b);
+}
+
+} // namespace tlap
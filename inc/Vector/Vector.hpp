@@ -4,60 +4,117 @@
 
 #pragma once
 
+#include "../math/policy.hpp"
+#include "../math/half.hpp"
+#include <concepts>
+#include <cstddef>
+#include <initializer_list>
+#include <iosfwd>
 #include <type_traits>
 #include <vector>
 #include <list>
 
-typedef unsigned int size_t;
-
 #define TEMPLATE_U template <typename U>
 #define TEMPLATE_UV template <typename U, typename V>
-#define ARITHMETIC_U static_assert(std::is_arithmetic<U>::value, "U must be an arithmetic type!")
+#define ARITHMETIC_U static_assert(tlap::is_element<U>, "U must be an arithmetic type!")
 
 
 namespace tlap {
 
-template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
-class Vector {
-	static_assert(std::is_arithmetic<T>::value, "Vector can only be instantiated with arithmetic types.");
+template <typename T> class Matrix;
+template <typename T> class Tensor;
+template <typename T> class VectorView;
+
+// base of the lazy expression nodes of VectorExpr.hpp
+struct vector_expr {};
+
+template <typename Expr>
+concept vector_expression = std::derived_from<Expr, vector_expr>;
+
+namespace detail {
+	template <typename T, typename Expr>
+	void	vector_eval(T *out, const Expr &expr); // out[i] = expr[i] over padded storage
+}
 
+template <typename T, typename = std::enable_if_t<is_element<T>>>
+class Vector {
+	static_assert(is_element<T>, "Vector can only be instantiated with arithmetic types, half and bfloat16.");
+
+	// storage is simd::alignment aligned and padded to a whole number of
+	// aligned blocks, the padding is kept at zero. every elementwise operation
+	// runs whole packs over the padded storage, there is no scalar tail.
+	// external storage (adopted, or viewed by a VectorView) must be the same:
+	// aligned, with room for the padding, which is zeroed when it is not.
+	// half and bfloat16 elements are loaded into float packs and computed on
+	// in float: reductions accumulate in float and return a float (compute)
 	private:
 		T		*_data;
-		T		*_newData = nullptr;
 		size_t	_size;
+		size_t	_capacity; // padded size
+		void	(*_release)(T *data, void *context) = nullptr; // gives external storage back, null for storage of tlap
+		void	*_context = nullptr;
+
+		void	_allocate(size_t size); // uninitialized storage, padding zeroed
+		void	_clearPadding();
+		void	_free();
+
+	protected:
+		void	_adopt(T *data, size_t size, size_t capacity, void (*release)(T *, void *), void *context); // throws unless shareable()
 
 	public:
+		using value_type = T;
+		using real = std::conditional_t<std::is_floating_point<T>::value, T, float>; // norms, distances and angles, as Vec
+		using compute = compute_t<T>; // sums and dot products, float for half and bfloat16
+
 		// constructors and destructor
 		Vector();
 		Vector(size_t size);
 		TEMPLATE_U Vector(size_t size, const U &value); // fill constructor
 		TEMPLATE_U Vector(std::initializer_list<U> list); // initializer list constructor
-		TEMPLATE_U Vector(const Vector<U> &other); // copy constructor
-		TEMPLATE_U Vector(Vector<U> &&other) noexcept; // move constructor
-		TEMPLATE_U Vector(const std::vector<U> &other); // std::vector copy constructor
-		TEMPLATE_U Vector(std::vector<U> &&other); // std::vector move constructor
+		Vector(const Vector &other); // copy constructor
+		Vector(Vector &&other) noexcept; // move constructor
+		TEMPLATE_U Vector(const Vector<U> &other); // converting copy constructor
+		template <typename U, typename A>
+		Vector(const std::vector<U, A> &other); // std::vector copy constructor
+		template <typename U, typename A>
+		Vector(std::vector<U, A> &&other); // takes the buffer over when it is shareable (always with memory::aligned_allocator<T>), copies it otherwise
+		template <typename D>
+		Vector(T *data, size_t size, size_t capacity, D deleter); // adopts capacity elements at data, deleter(data) when done; throws unless shareable()
+		template <vector_expression Expr>
+		Vector(const Expr &expr); // evaluates a lazy expression, see VectorExpr.hpp
 		~Vector();
+		static Vector			uninitialized(size_t size); // values left undefined (the padding is zero), for a result written in full
+		static bool				shareable(const T *data, size_t size, size_t capacity); // aligned, capacity >= the padded size
 	
 		// assignment operators
+		Vector<T>				&operator=(const Vector &other);
+		Vector<T>				&operator=(Vector &&other) noexcept; // move assignment
 		TEMPLATE_U Vector<T>	&operator=(const Vector<U> &other);
-		TEMPLATE_U Vector<T>	&operator=(Vector<U> &&other) noexcept; // move assignment
+		template <vector_expression Expr>
+		Vector<T>				&operator=(const Expr &expr); // operands may include *this
 	
 		// comparison operators
 		TEMPLATE_U bool			operator==(const Vector<U> &other) const;
 		TEMPLATE_U bool			operator!=(const Vector<U> &other) const;
+		template <vector_expression Expr>
+		bool					operator==(const Expr &expr) const;
+		template <vector_expression Expr>
+		bool					operator!=(const Expr &expr) const;
 	
-		// arithmetic operators
-		TEMPLATE_U Vector<T>	operator+(const Vector<U> &other) const;
-		TEMPLATE_U Vector<T>	operator-(const Vector<U> &other) const;
-		TEMPLATE_U Vector<T>	operator*(const Vector<U> &other) const; // dot product
-		TEMPLATE_U Vector<T>	operator*(const U &scalar) const;
-		TEMPLATE_U Vector<T>	operator/(const U &scalar) const;
+		// arithmetic operators: + - * / are free functions building lazy
+		// expressions, see VectorExpr.hpp (* is elementwise, dot() for the dot product)
 		// compound assignment operators
 		TEMPLATE_U Vector<T>	&operator+=(const Vector<U> &other);
 		TEMPLATE_U Vector<T>	&operator-=(const Vector<U> &other);
 		TEMPLATE_U Vector<T>	&operator*=(const Vector<U> &other);
 		TEMPLATE_U Vector<T>	&operator*=(const U &scalar);
 		TEMPLATE_U Vector<T>	&operator/=(const U &scalar);
+		template <vector_expression Expr>
+		Vector<T>				&operator+=(const Expr &expr);
+		template <vector_expression Expr>
+		Vector<T>				&operator-=(const Expr &expr);
+		template <vector_expression Expr>
+		Vector<T>				&operator*=(const Expr &expr);
 	
 		// stream operator
 		friend std::ostream		&operator<<(std::ostream &os, const Vector<T> &vector);
@@ -65,24 +122,40 @@ class Vector {
 		// index access operators
 		const T					&operator[](size_t index) const; // read-access
 		T						&operator[](size_t index); // write-access
+		const T					*data() const; // raw storage, shape() elements, aligned, zero padded to capacity()
+		T						*data();
 
 		// various operations and methods
 		TEMPLATE_U Vector<T>	&add(const Vector<U> &other);
 		TEMPLATE_U Vector<T>	&sub(const Vector<U> &other);
 
-		TEMPLATE_U Vector<T>	&scaleUp(const T &scalar); // multiply by scalar
-		TEMPLATE_U Vector<T>	&scaleDown(const T &scalar); // divide by scalar
+		Vector<T>				&scaleUp(const compute &scalar); // multiply by scalar
+		Vector<T>				&scaleDown(const compute &scalar); // divide by scalar
 
 		TEMPLATE_U Vector<T>	&linComb(const Vector<T> &other, const U &factor1, const U &factor2); // linear combination with 1 vector
 		TEMPLATE_U Vector<T>	&linComb(const std::list<Vector<T>> &others, const std::list<U> &factors, const U &factor1); // linear combination with multiple vectors
 
-		T						lerp(const Vector<T> &other, const T &factor) const; // linear interpolation
-		T						dot(const Vector<T> &other) const; // dot product
+		Vector<T>				&lerp(const Vector<T> &other, const T &factor); // linear interpolation, this + (other - this) * factor
+
+		// reductions, float, double, half and bfloat16 on the dispatched kernels. big vectors are
+		// cut into REDUCE_BLOCK blocks shared by the threads, whose partial results
+		// are added pairwise in a fixed order: the result does not depend on the
+		// number of threads. tlap::precise sums with a Kahan correction, tlap::fast
+		// without (REDUCE_POLICY by default, hyperp.hpp)
+		template <math_policy P = reduce_policy>
+		compute					dot(const Vector<T> &other) const; // dot product
+		template <math_policy P = reduce_policy>
+		compute					sum() const;
+		T						min() const; // throws on an empty vector
+		T						max() const; // throws on an empty vector
+		size_t					argmax() const; // first index of the largest element, throws on an empty vector
 	
 		Vector<T>				&cross(const Vector<T> &other); // cross product
-		float					norm1() const; // Manhattan norm (sum of abs values)
-		float					norm() const; // Euclidean norm (len of vector)
-		float					normInf() const; // Infinity norm (max abs value)
+		template <math_policy P = reduce_policy>
+		real					norm1() const; // Manhattan norm (sum of abs values)
+		template <math_policy P = reduce_policy>
+		real					norm() const; // Euclidean norm (len of vector)
+		real					normInf() const; // Infinity norm (max abs value)
 
 		Vector<T>				&normalize(); // resize to unit vector
 		Vector<T>				&resize(const T &len); // resize vector to len
@@ -90,6 +163,8 @@ class Vector {
 
 		Vector<T>				&apply(T (*func)(T)); // apply function to each element
 		Vector<T>				&apply(T (*func)(const T &)); // apply function to each element
+		template <typename F>
+		Vector<T>				&apply(F func); // called on simd packs when invocable with one (a generic lambda must then be valid for packs), on elements otherwise; packs of a big Vector from several threads at once
 
 		Vector<T>				&reflect(const Vector<T> &normal); // reflect vector on normal
 		Vector<T>				&refract(const Vector<T> &normal, const T &eta); // refract vector on normal with eta
@@ -97,19 +172,26 @@ class Vector {
 	
 		Vector<T>				&rotate(const T &angle); // rotate vector by angle
 		Vector<T>				&rotate(const Vector<T> &axis, const T &angle, const Vector<T> &center); // rotate vector around axis by angle around center
-		float					cos(const Vector<T> &other) const; // cosine of angle between vectors
-		float					angle(const Vector<T> &other) const; // angle between vectors
+		template <math_policy P = reduce_policy>
+		real					cos(const Vector<T> &other) const; // cosine of angle between vectors, throws on a zero vector
+		template <math_policy P = reduce_policy>
+		real					angle(const Vector<T> &other) const; // angle between vectors
 
-		float					dist(const Vector<T> &other) const; // distance between vectors
+		template <math_policy P = reduce_policy>
+		real					dist(const Vector<T> &other) const; // distance between vectors
 
 		Vector<T>				&transform(const tlap::Matrix<T> &matrix); // transform vector by matrix
+		Tensor<T>				asTensor(); // 1D view of the storage, no copy, see Tensor/Tensor.hpp
 
-		float					len() const; // length of vector
+		real					len() const; // length of vector
 		size_t					shape() const; // dimension of vector
+		size_t					capacity() const; // padded storage size
 		Vector<T>				&reshape(size_t size); // resize vector
 		void					print() const; // print vector "Vector{X}D: [x1, x2, ..., xn]"
 };
 
 } // namespace tlap
 
-#include "Vector.tpp" // implementations
\ No newline at end of file
+#include "Vector.tpp" // implementations
+#include "VectorExpr.hpp" // lazy arithmetic operators
+#include "VectorView.hpp" // views of external storage
\ No newline at end of file
@@ -1,50 +1,870 @@
+#pragma once
+
 #include "Vector.hpp"
-#include <immintrin.h>
-
-template <typename T>
-void simd_fill_tab(T *tab, size_t n, T v) {
-    if (n >= SIMD_THRESHOLD) {
-#ifdef __AVX__ // AVX for 256-bit SIMD operations, adjust for different types
-        size_t i = 0;
-        if constexpr (std::is_same<T, float>::value) {
-            __m256 simd_val = _mm256_set1_ps(v); // AVX 256-bit for float
-            size_t simd_count = n / 8; // Each __m256 holds 8 floats
-            for (; i < simd_count * 8; i += 8)
-				_mm256_storeu_ps(&tab[i], simd_val);
-        } else if constexpr (std::is_same<T, double>::value) {
-            __m256d simd_val = _mm256_set1_pd(v); // AVX 256-bit for double
-            size_t simd_count = n / 4; // Each __m256d holds 4 doubles
-            for (; i < simd_count * 4; i += 4)
-				_mm256_storeu_pd(&tab[i], simd_val);
-        } else if constexpr (std::is_same<T, int>::value) {
-            __m256i simd_val = _mm256_set1_epi32(v); // AVX 256-bit for int
-            size_t simd_count = n / 8; // Each __m256i holds 8 ints
-            for (; i < simd_count * 8; i += 8)
-				_mm256_storeu_si256((__m256i*)&tab[i], simd_val);
-        } else
-            for (; i < n; ++i)
-				tab[i] = v;
-        for (; i < n; ++i)
-			tab[i] = v;
-
-#else
-        for (size_t i = 0; i < n; ++i)
-			tab[i] = v;
+#include "../hyperp.hpp"
+#include "../simd/simd.hpp"
+#include "../simd/dispatch.hpp"
+#include "../math/math.hpp"
+#include "../parallel/pool.hpp"
+#include "../profile/profile.hpp"
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace tlap {
+
+namespace detail {
+
+template <typename T>
+inline constexpr bool	has_pack = std::is_same<T, float>::value || std::is_same<T, double>::value;
+
+// float and double go through the kernels of the isa picked at run time,
+// the other types through the element loops below
+template <typename T>
+inline constexpr bool	dispatched = has_pack<T> && SIMD_DISPATCH;
+
+// types computed on packs: half and bfloat16 load into float packs, always
+// of the isa picked at run time
+template <typename T>
+inline constexpr bool	packed = has_pack<T> || is_reduced_float<T>;
+
+// elements per aligned block, Vector storage is a whole number of blocks,
+// so a block always holds a whole number of native packs
+template <typename T>
+inline constexpr size_t	vector_block = simd::alignment / sizeof(T);
+
+template <typename T>
+constexpr size_t	padded_size(size_t n) {
+	return (n + vector_block<T> - 1) / vector_block<T> * vector_block<T>;
+}
+
+// f(i, len) over [0, n), n a multiple of vector_block<T>: on the calling
+// thread below VECTOR_PARALLEL_MIN elements, in pieces of whole VECTOR_GRAIN
+// element chunks over the threads above
+template <typename T, typename F>
+void	vector_split(size_t n, F f) {
+	parallel::parallel_for(0, n, (n >= VECTOR_PARALLEL_MIN ? VECTOR_GRAIN : n), [&](size_t begin, size_t end) {
+		f(begin, end - begin);
+	}, "vector");
+}
+
+// pack<T> only exists for float and double, it must not be named for other types
+template <typename T, typename F>
+constexpr bool	pack_invocable() {
+	if constexpr (packed<T>)
+		return std::invocable<F, simd::pack<compute_t<T>>>;
+	else
+		return false;
+}
+
+// a functor of the caller (apply()): unlike the library lambdas it cannot be
+// marked TLAP_INLINE, and without optimization nothing inlines it into the isa
+// kernels below, so it only gets the scalar level there
+template <typename F>
+struct	foreign {
+	F	f;
+
+	template <typename... X>
+	TLAP_INLINE auto	operator()(X... x) const { return f(x...); }
+};
+
+template <typename F>
+inline constexpr bool	is_foreign = false;
+template <typename F>
+inline constexpr bool	is_foreign<foreign<F>> = true;
+
+// the level vector_map runs on: that of the dispatched kernels, the isa of
+// the compile flags for float and double built with SIMD_DISPATCH 0
+template <typename T, typename F>
+simd::dispatch::level	map_level() {
+#if !defined(__OPTIMIZE__)
+	if constexpr (is_foreign<F>)
+		return simd::dispatch::level::scalar;
 #endif
-    } else
-        for (size_t i = 0; i < n; ++i)
-			tab[i] = v;
+	if constexpr (dispatched<T> || is_reduced_float<T>)
+		return simd::dispatch::active();
+	return simd::dispatch::native;
 }
 
-namespace tlap {
+// out[i] = f(a[i]...) on packs of compute_t<T>: float and double, float for
+// half and bfloat16 storage. one copy per isa level as for the expressions
+// (VectorExpr.tpp): map_packs and the library lambdas are always inlined,
+// flatten pulls in a foreign f when optimizing
+template <typename X, typename T, typename F, typename... A>
+TLAP_INLINE inline void	map_packs(T *out, size_t n, F f, const A *...a) {
+	for (size_t i = 0; i < n; i += X::width)
+		f(X::load(a + i)...).store(out + i);
+}
+
+template <typename T, typename F, typename... A>
+[[gnu::flatten]] TLAP_TARGET_AVX512 void	map_packs_avx512(T *out, size_t n, F f, const A *...a) {
+	map_packs<simd::pack<compute_t<T>, simd::isa::avx512>>(out, n, f, a...);
+}
+
+template <typename T, typename F, typename... A>
+[[gnu::flatten]] TLAP_TARGET_AVX2 void	map_packs_avx2(T *out, size_t n, F f, const A *...a) {
+	map_packs<simd::pack<compute_t<T>, simd::isa::avx2>>(out, n, f, a...);
+}
+
+template <typename T, typename F, typename... A>
+void	map_level_packs(T *out, size_t n, F f, const A *...a) {
+	switch (map_level<T, F>()) {
+		case simd::dispatch::level::avx512:	return map_packs_avx512(out, n, f, a...);
+		case simd::dispatch::level::avx2:	return map_packs_avx2(out, n, f, a...);
+		default:							return map_packs<simd::pack<compute_t<T>, simd::isa::scalar>>(out, n, f, a...);
+	}
+}
+
+// a * b + c, fused on packs
+template <typename X>
+TLAP_INLINE inline X	mul_add(X a, X b, X c) {
+	if constexpr (std::is_arithmetic<X>::value)
+		return static_cast<X>(a * b + c);
+	else
+		return fma(a, b, c);
+}
+
+// min(max(a, lo), hi), out of the members: Vector::min / max would hide the
+// pack functions
+template <typename X>
+TLAP_INLINE inline X	clamp_to(X a, X lo, X hi) {
+	if constexpr (std::is_arithmetic<X>::value)
+		return std::min(std::max(a, lo), hi);
+	else
+		return min(max(a, lo), hi);
+}
+
+// out[i] = f(a[i]) / f(a[i], b[i]) for i < n. n is a multiple of vector_block<T>
+// and the pointers are aligned; f gets packs for float and double, single
+// elements for the other types (vectorized by the compiler).
+// measured (make bench, vector/multadd): once there is no scalar tail the packs are never
+// slower than the element loop, even for 3 elements, so there is no size
+// threshold here
+template <typename T, typename F>
+void	vector_map(T *out, const T *a, size_t n, F f) {
+	TLAP_PROFILE_KERNEL("vector.map", T, (packed<T> ? map_level<T, F>() : simd::dispatch::level::scalar), n);
+	if constexpr (packed<T>)
+		map_level_packs(out, n, f, a);
+	else {
+		TLAP_SIMD_LOOP
+		for (size_t i = 0; i < n; ++i)
+			out[i] = static_cast<T>(f(a[i]));
+	}
+}
+
+template <typename T, typename F>
+void	vector_map(T *out, const T *a, const T *b, size_t n, F f) {
+	TLAP_PROFILE_KERNEL("vector.map", T, (packed<T> ? map_level<T, F>() : simd::dispatch::level::scalar), n);
+	if constexpr (packed<T>)
+		map_level_packs(out, n, f, a, b);
+	else {
+		TLAP_SIMD_LOOP
+		for (size_t i = 0; i < n; ++i)
+			out[i] = static_cast<T>(f(a[i], b[i]));
+	}
+}
+
+template <typename T>
+void	vector_fill(T *out, size_t n, T value) {
+	vector_split<T>(n, [=](size_t i, size_t len) {
+		if constexpr (dispatched<T>)
+			simd::dispatch::table<T>().fill(out + i, len, value);
+		else if constexpr (has_pack<T>) {
+			using V = simd::pack<T>;
+			const V v = value;
+			for (size_t j = i; j < i + len; j += V::width)
+				v.store(out + j);
+		} else {
+			TLAP_SIMD_LOOP
+			for (size_t j = i; j < i + len; ++j)
+				out[j] = value;
+		}
+	});
+}
+
+// one block of a reduction on the element loops, for the types without
+// dispatched kernels: integers (exact, so the compiler vectorizes the loops as
+// written) and float / double built with SIMD_DISPATCH 0
+template <typename T>
+T		vector_fold_loop(simd::dispatch::reduction r, bool compensated, const T *a, const T *b, size_t n) {
+	using R = simd::dispatch::reduction;
+	auto	mag = [](T x) {
+		if constexpr (std::is_unsigned<T>::value)
+			return x;
+		else
+			return static_cast<T>(x < T(0) ? -x : x);
+	};
+
+	if (r == R::min || r == R::max || r == R::amax) {
+		T res = (r == R::amax ? mag(a[0]) : a[0]);
+		for (size_t i = 1; i < n; ++i) {
+			const T x = (r == R::amax ? mag(a[i]) : a[i]);
+			res = (r == R::min ? std::min(res, x) : std::max(res, x));
+		}
+		return res;
+	}
+	auto	term = [r, mag](T x, T y) {
+		switch (r) {
+			case R::sum:	return x;
+			case R::asum:	return mag(x);
+			case R::dot:	return static_cast<T>(x * y);
+			default:		return static_cast<T>((x - y) * (x - y));
+		}
+	};
+	T		acc[8] = {}, err[8] = {};
+	size_t	i = 0;
+	for (; i + 8 <= n; i += 8)
+		for (size_t k = 0; k < 8; ++k) {
+			if (std::is_floating_point<T>::value && compensated) {
+				const T t = term(a[i + k], b[i + k]) - err[k];
+				const T u = acc[k] + t;
+				err[k] = (u - acc[k]) - t;
+				acc[k] = u;
+			} else
+				acc[k] += term(a[i + k], b[i + k]);
+		}
+	for (; i < n; ++i)
+		acc[0] += term(a[i], b[i]);
+	return static_cast<T>(((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7])))
+		- static_cast<T>(((err[0] + err[1]) + (err[2] + err[3])) + ((err[4] + err[5]) + (err[6] + err[7])));
+}
+
+template <typename T>
+compute_t<T>	vector_fold(simd::dispatch::reduction r, bool compensated, const T *a, const T *b, size_t n) {
+	if constexpr (dispatched<T>)
+		return simd::dispatch::table<T>().reduce(r, compensated, a, b, n);
+	else if constexpr (is_reduced_float<T>)
+		return simd::dispatch::reduced<T>().reduce(r, compensated, a, b, n);
+	else
+		return vector_fold_loop(r, compensated, a, b, n);
+}
+
+// block(begin, end) over the REDUCE_BLOCK blocks of n elements, spread over the
+// threads, the partial results merged pairwise in block order. the blocks and
+// the merge tree only depend on n, not on the number of threads
+template <typename Block, typename Merge>
+auto	vector_blocks(size_t n, Block block, Merge merge) {
+	using R = decltype(block(size_t(0), size_t(0)));
+	const size_t	blocks = (n + REDUCE_BLOCK - 1) / REDUCE_BLOCK;
+
+	if (blocks <= 1)
+		return block(0, n);
+	std::vector<R>	part(blocks);
+	const bool		parallel = n >= REDUCE_PARALLEL_MIN;
+
+	parallel::parallel_for(0, blocks, (parallel ? 1 : blocks), [&](size_t b0, size_t b1) {
+		for (size_t i = b0; i < b1; ++i)
+			part[i] = block(i * REDUCE_BLOCK, std::min<size_t>(n, (i + 1) * REDUCE_BLOCK));
+	}, "reduce");
+	for (size_t w = 1; w < blocks; w *= 2)
+		for (size_t i = 0; i + w < blocks; i += 2 * w)
+			part[i] = merge(part[i], part[i + w]);
+	return part[0];
+}
+
+// sums over the padded storage (the zero padding adds nothing), min / max
+// over the n elements
+template <typename T>
+compute_t<T>	vector_sum(simd::dispatch::reduction r, bool compensated, const T *a, const T *b, size_t n) {
+	using C = compute_t<T>;
+	return vector_blocks(n, [=](size_t begin, size_t end) {
+		return vector_fold(r, compensated, a + begin, b + begin, end - begin);
+	}, [](C x, C y) { return static_cast<C>(x + y); });
+}
+
+template <typename T>
+compute_t<T>	vector_extremum(simd::dispatch::reduction r, const T *a, size_t n) {
+	using C = compute_t<T>;
+	return vector_blocks(n, [=](size_t begin, size_t end) {
+		return vector_fold(r, false, a + begin, a + begin, end - begin);
+	}, [r](C x, C y) { return (r == simd::dispatch::reduction::min ? std::min(x, y) : std::max(x, y)); });
+}
+
+} // namespace detail
+
+// storage
+
+template <typename T, typename Enable>
+void	Vector<T, Enable>::_allocate(size_t size) {
+	_size = size;
+	_capacity = detail::padded_size<T>(size);
+	_data = (_capacity ? simd::aligned_alloc<T>(_capacity) : nullptr);
+	_clearPadding();
+}
+
+template <typename T, typename Enable>
+void	Vector<T, Enable>::_clearPadding() {
+	for (size_t i = _size; i < _capacity; ++i)
+		_data[i] = T(0);
+}
+
+template <typename T, typename Enable>
+void	Vector<T, Enable>::_free() {
+	if (_release)
+		_release(_data, _context);
+	else
+		simd::aligned_free(_data);
+	_release = nullptr;
+	_context = nullptr;
+}
+
+// the padding is only written where it is not zero already: a read-only
+// mapping with zero padding can be shared
+template <typename T, typename Enable>
+void	Vector<T, Enable>::_adopt(T *data, size_t size, size_t capacity, void (*release)(T *, void *), void *context) {
+	if (!shareable(data, size, capacity))
+		throw std::invalid_argument("Shared storage must be simd::alignment aligned with room for the padded size.");
+	_data = data;
+	_size = size;
+	_capacity = detail::padded_size<T>(size);
+	_release = release;
+	_context = context;
+	for (size_t i = _size; i < _capacity; ++i)
+		if (_data[i] != T(0))
+			_data[i] = T(0);
+}
+
+template <typename T, typename Enable>
+bool	Vector<T, Enable>::shareable(const T *data, size_t size, size_t capacity) {
+	if (!size)
+		return true;
+	return data && reinterpret_cast<uintptr_t>(data) % simd::alignment == 0 && capacity >= detail::padded_size<T>(size);
+}
+
+// constructors and destructor
+
+template <typename T, typename Enable>
+Vector<T, Enable>::Vector()
+	: _data(nullptr), _size(0), _capacity(0) {
+}
+
+template <typename T, typename Enable>
+Vector<T, Enable>::Vector(size_t size) {
+	_allocate(size);
+	detail::vector_fill(_data, _capacity, T(0));
+}
+
+template <typename T, typename Enable>
+TEMPLATE_U Vector<T, Enable>::Vector(size_t size, const U &value) {
+	ARITHMETIC_U;
+	_allocate(size);
+	detail::vector_fill(_data, _capacity, static_cast<T>(value));
+	_clearPadding();
+}
+
+template <typename T, typename Enable>
+TEMPLATE_U Vector<T, Enable>::Vector(std::initializer_list<U> list) {
+	ARITHMETIC_U;
+	_allocate(list.size());
+	std::transform(list.begin(), list.end(), _data, [](const U &x) { return static_cast<T>(x); });
+}
+
+template <typename T, typename Enable>
+Vector<T, Enable>::Vector(const Vector &other) {
+	_allocate(other._size);
+	if (_capacity)
+		std::memcpy(_data, other._data, _capacity * sizeof(T));
+}
+
+template <typename T, typename Enable>
+Vector<T, Enable>::Vector(Vector &&other) noexcept
+	: _data(other._data), _size(other._size), _capacity(other._capacity), _release(other._release), _context(other._context) {
+	other._data = nullptr;
+	other._size = 0;
+	other._capacity = 0;
+	other._release = nullptr;
+	other._context = nullptr;
+}
+
+// float to half or bfloat16 and back in bulk, the other pairs one element at a time
+template <typename T, typename Enable>
+TEMPLATE_U Vector<T, Enable>::Vector(const Vector<U> &other) {
+	_allocate(other.shape());
+	if constexpr (is_reduced_float<T> && std::is_same<U, float>::value)
+		detail::vector_split<T>(_capacity, [&](size_t i, size_t n) {
+			simd::dispatch::reduced<T>().narrow(_data + i, other.data() + i, std::min(i + n, _size) - std::min(i, _size));
+		});
+	else if constexpr (std::is_same<T, float>::value && is_reduced_float<U>)
+		detail::vector_split<T>(_capacity, [&](size_t i, size_t n) {
+			simd::dispatch::reduced<U>().widen(_data + i, other.data() + i, std::min(i + n, _size) - std::min(i, _size));
+		});
+	else
+		std::transform(other.data(), other.data() + _size, _data, [](const U &x) { return static_cast<T>(x); });
+}
+
+template <typename T, typename Enable>
+template <typename U, typename A>
+Vector<T, Enable>::Vector(const std::vector<U, A> &other) {
+	ARITHMETIC_U;
+	_allocate(other.size());
+	std::transform(other.begin(), other.end(), _data, [](const U &x) { return static_cast<T>(x); });
+}
+
+// the std::vector itself moves to the heap and keeps its buffer, the Vector
+// deletes it when done. memory::aligned_allocator rounds every buffer up to
+// whole aligned blocks, which leaves room for the padding past capacity()
+template <typename T, typename Enable>
+template <typename U, typename A>
+Vector<T, Enable>::Vector(std::vector<U, A> &&other) {
+	ARITHMETIC_U;
+	if constexpr (std::is_same<T, U>::value) {
+		size_t room = other.capacity();
+		if constexpr (std::is_same<A, memory::aligned_allocator<T>>::value)
+			room = detail::padded_size<T>(room);
+		if (shareable(other.data(), other.size(), room)) {
+			auto *owner = new std::vector<U, A>(std::move(other));
+			_adopt(owner->data(), owner->size(), room, [](T *, void *c) { delete static_cast<std::vector<U, A> *>(c); }, owner);
+			return;
+		}
+	}
+	_allocate(other.size());
+	std::transform(other.begin(), other.end(), _data, [](const U &x) { return static_cast<T>(x); });
+}
+
+// the deleter is only taken once the storage is known to fit: on a throw the
+// caller still owns data
+template <typename T, typename Enable>
+template <typename D>
+Vector<T, Enable>::Vector(T *data, size_t size, size_t capacity, D deleter) {
+	if (!shareable(data, size, capacity))
+		throw std::invalid_argument("Shared storage must be simd::alignment aligned with room for the padded size.");
+	D *owner = new D(std::move(deleter));
+	_adopt(data, size, capacity, [](T *p, void *c) {
+		D *d = static_cast<D *>(c);
+		(*d)(p);
+		delete d;
+	}, owner);
+}
+
+template <typename T, typename Enable>
+Vector<T, Enable>::~Vector() {
+	_free();
+}
+
+template <typename T, typename Enable>
+Vector<T, Enable>	Vector<T, Enable>::uninitialized(size_t size) {
+	Vector<T> res;
+	res._allocate(size);
+	return res;
+}
+
+// assignment operators
+
+template <typename T, typename Enable>
+Vector<T>	&Vector<T, Enable>::operator=(const Vector &other) {
+	if (this == &other)
+		return *this;
+	if (_capacity != other._capacity) {
+		_free();
+		_allocate(other._size);
+	}
+	_size = other._size;
+	if (_capacity)
+		std::memcpy(_data, other._data, _capacity * sizeof(T));
+	return *this;
+}
+
+template <typename T, typename Enable>
+Vector<T>	&Vector<T, Enable>::operator=(Vector &&other) noexcept {
+	if (this == &other)
+		return *this;
+	_free();
+	_data = other._data;
+	_size = other._size;
+	_capacity = other._capacity;
+	_release = other._release;
+	_context = other._context;
+	other._data = nullptr;
+	other._size = 0;
+	other._capacity = 0;
+	other._release = nullptr;
+	other._context = nullptr;
+	return *this;
+}
+
+template <typename T, typename Enable>
+TEMPLATE_U Vector<T>	&Vector<T, Enable>::operator=(const Vector<U> &other) {
+	return *this = Vector<T>(other);
+}
+
+// comparison operators
+
+template <typename T, typename Enable>
+TEMPLATE_U bool	Vector<T, Enable>::operator==(const Vector<U> &other) const {
+	if (_size != other.shape())
+		return false;
+	if constexpr (std::is_same<T, U>::value && detail::dispatched<T>)
+		return simd::dispatch::table<T>().equal(_data, other.data(), _capacity);
+	else if constexpr (std::is_same<T, U>::value && detail::has_pack<T>) {
+		using V = simd::pack<T>;
+		for (size_t i = 0; i < _capacity; i += V::width)
+			if (!(V::load(_data + i) == V::load(other.data() + i)).all())
+				return false;
+		return true;
+	} else
+		return std::equal(_data, _data + _size, other.data());
+}
+
+template <typename T, typename Enable>
+TEMPLATE_U bool	Vector<T, Enable>::operator!=(const Vector<U> &other) const {
+	return !(*this == other);
+}
+
+// compound assignment operators
+// a Vector<U> operand is converted to Vector<T> first, so the kernels only
+// ever see one element type
+
+#define TLAP_VECTOR_BINARY(op, kernel)														\
+	if (_size != other.shape())																\
+		throw std::invalid_argument("Vectors must have the same size.");					\
+	if constexpr (std::is_same<T, U>::value)												\
+		detail::vector_split<T>(_capacity, [&](size_t i, size_t n) {						\
+			if constexpr (detail::dispatched<T>)											\
+				simd::dispatch::table<T>().kernel(_data + i, _data + i, other.data() + i, n);	\
+			else																			\
+				detail::vector_map(_data + i, _data + i, other.data() + i, n, [](auto a, auto b) TLAP_INLINE { return a op b; });	\
+		});																					\
+	else																					\
+		*this op##= Vector<T>(other);														\
+	return *this;
+
+template <typename T, typename Enable>
+TEMPLATE_U Vector<T>	&Vector<T, Enable>::operator+=(const Vector<U> &other) {
+	TLAP_VECTOR_BINARY(+, add)
+}
+
+template <typename T, typename Enable>
+TEMPLATE_U Vector<T>	&Vector<T, Enable>::operator-=(const Vector<U> &other) {
+	TLAP_VECTOR_BINARY(-, sub)
+}
+
+template <typename T, typename Enable>
+TEMPLATE_U Vector<T>	&Vector<T, Enable>::operator*=(const Vector<U> &other) {
+	TLAP_VECTOR_BINARY(*, mul)
+}
+
+#undef TLAP_VECTOR_BINARY
+
+template <typename T, typename Enable>
+TEMPLATE_U Vector<T>	&Vector<T, Enable>::operator*=(const U &scalar) {
+	ARITHMETIC_U;
+	return scaleUp(static_cast<compute>(scalar));
+}
+
+template <typename T, typename Enable>
+TEMPLATE_U Vector<T>	&Vector<T, Enable>::operator/=(const U &scalar) {
+	ARITHMETIC_U;
+	return scaleDown(static_cast<compute>(scalar));
+}
+
+// index access operators
+
+template <typename T, typename Enable>
+const T	&Vector<T, Enable>::operator[](size_t index) const {
+	return _data[index];
+}
+
+template <typename T, typename Enable>
+T		&Vector<T, Enable>::operator[](size_t index) {
+	return _data[index];
+}
+
+template <typename T, typename Enable>
+const T	*Vector<T, Enable>::data() const {
+	return _data;
+}
+
+template <typename T, typename Enable>
+T		*Vector<T, Enable>::data() {
+	return _data;
+}
+
+// various operations and methods
+
+template <typename T, typename Enable>
+TEMPLATE_U Vector<T>	&Vector<T, Enable>::add(const Vector<U> &other) {
+	return *this += other;
+}
+
+template <typename T, typename Enable>
+TEMPLATE_U Vector<T>	&Vector<T, Enable>::sub(const Vector<U> &other) {
+	return *this -= other;
+}
+
+template <typename T, typename Enable>
+Vector<T>	&Vector<T, Enable>::scaleUp(const compute &scalar) {
+	const compute s = scalar;
+	detail::vector_split<T>(_capacity, [&](size_t i, size_t n) {
+		if constexpr (detail::dispatched<T>)
+			simd::dispatch::table<T>().scale(_data + i, _data + i, n, s);
+		else
+			detail::vector_map(_data + i, _data + i, n, [s](auto a) TLAP_INLINE { return a * s; });
+	});
+	_clearPadding(); // 0 * inf
+	return *this;
+}
+
+template <typename T, typename Enable>
+Vector<T>	&Vector<T, Enable>::scaleDown(const compute &scalar) {
+	const compute s = scalar;
+	if constexpr (std::is_integral<T>::value)
+		if (s == 0)
+			throw std::invalid_argument("Division by zero");
+	detail::vector_split<T>(_capacity, [&](size_t i, size_t n) {
+		if constexpr (detail::dispatched<T>)
+			simd::dispatch::table<T>().divide(_data + i, _data + i, n, s);
+		else
+			detail::vector_map(_data + i, _data + i, n, [s](auto a) TLAP_INLINE { return a / s; });
+	});
+	_clearPadding(); // 0 / 0
+	return *this;
+}
+
+// this = this * factor1 + other * factor2
+template <typename T, typename Enable>
+TEMPLATE_U Vector<T>	&Vector<T, Enable>::linComb(const Vector<T> &other, const U &factor1, const U &factor2) {
+	ARITHMETIC_U;
+	if (_size != other._size)
+		throw std::invalid_argument("Vectors must have the same size.");
+	const compute f1 = static_cast<compute>(factor1);
+	const compute f2 = static_cast<compute>(factor2);
+	detail::vector_split<T>(_capacity, [&](size_t i, size_t n) {
+		if constexpr (detail::dispatched<T>)
+			simd::dispatch::table<T>().axpby(_data + i, _data + i, other._data + i, n, f1, f2);
+		else
+			detail::vector_map(_data + i, _data + i, other._data + i, n, [f1, f2](auto a, auto b) TLAP_INLINE {
+				using X = decltype(a);
+				return detail::mul_add(a, X(f1), X(b * X(f2)));
+			});
+	});
+	_clearPadding();
+	return *this;
+}
+
+// this = this * factor1 + sum of others[i] * factors[i], one tile at a time:
+// the tile of this stays in L1 while each other Vector streams through once,
+// so memory is read once per operand instead of once per operand and pass
+template <typename T, typename Enable>
+TEMPLATE_U Vector<T>	&Vector<T, Enable>::linComb(const std::list<Vector<T>> &others, const std::list<U> &factors, const U &factor1) {
+	ARITHMETIC_U;
+	if (others.size() != factors.size())
+		throw std::invalid_argument("linComb() needs one factor per vector.");
+	for (const Vector<T> &v : others)
+		if (v._size != _size)
+			throw std::invalid_argument("Vectors must have the same size.");
+
+	std::vector<std::pair<const T *, compute>> terms;
+	auto f = factors.begin();
+	for (const Vector<T> &v : others)
+		terms.emplace_back(v._data, static_cast<compute>(*f++));
+
+	const compute	f1 = static_cast<compute>(factor1);
+	const size_t	tile = std::max<size_t>(VECTOR_TILE / sizeof(T) / detail::vector_block<T>, 1) * detail::vector_block<T>;
+	detail::vector_split<T>(_capacity, [&](size_t begin, size_t n) {
+		for (size_t i = begin; i < begin + n; i += tile) {
+			size_t	len = std::min(tile, begin + n - i);
+			T		*out = _data + i;
+			if constexpr (detail::dispatched<T>) {
+				const simd::dispatch::kernels<T> &k = simd::dispatch::table<T>();
+				k.scale(out, out, len, f1);
+				for (const auto &[p, fk] : terms)
+					k.axpy(out, out, p + i, len, fk);
+			} else {
+				detail::vector_map(out, out, len, [f1](auto a) TLAP_INLINE { return a * f1; });
+				for (const auto &[p, fk] : terms) {
+					const compute kf = fk;
+					detail::vector_map(out, out, p + i, len, [kf](auto a, auto b) TLAP_INLINE {
+						using X = decltype(a);
+						return detail::mul_add(b, X(kf), a);
+					});
+				}
+			}
+		}
+	});
+	_clearPadding();
+	return *this;
+}
+
+// reductions
+
+template <typename T, typename Enable>
+template <math_policy P>
+typename Vector<T, Enable>::compute	Vector<T, Enable>::dot(const Vector<T> &other) const {
+	if (_size != other._size)
+		throw std::invalid_argument("Vectors must have the same size.");
+	return detail::vector_sum(simd::dispatch::reduction::dot, std::is_same<P, precise>::value, _data, other._data, _capacity);
+}
+
+template <typename T, typename Enable>
+template <math_policy P>
+typename Vector<T, Enable>::compute	Vector<T, Enable>::sum() const {
+	return detail::vector_sum(simd::dispatch::reduction::sum, std::is_same<P, precise>::value, _data, _data, _capacity);
+}
+
+template <typename T, typename Enable>
+T		Vector<T, Enable>::min() const {
+	if (!_size)
+		throw std::invalid_argument("min() of an empty vector.");
+	return static_cast<T>(detail::vector_extremum(simd::dispatch::reduction::min, _data, _size));
+}
+
+template <typename T, typename Enable>
+T		Vector<T, Enable>::max() const {
+	if (!_size)
+		throw std::invalid_argument("max() of an empty vector.");
+	return static_cast<T>(detail::vector_extremum(simd::dispatch::reduction::max, _data, _size));
+}
+
+// the max of each block, then its first index found again in the block while
+// it is still in cache. ties go to the lower index
+template <typename T, typename Enable>
+size_t	Vector<T, Enable>::argmax() const {
+	if (!_size)
+		throw std::invalid_argument("argmax() of an empty vector.");
+	const std::pair<T, size_t> res = detail::vector_blocks(_size, [this](size_t begin, size_t end) {
+		const T m = static_cast<T>(detail::vector_fold(simd::dispatch::reduction::max, false, _data + begin, _data + begin, end - begin));
+		return std::pair<T, size_t>(m, std::find(_data + begin, _data + end, m) - _data);
+	}, [](const std::pair<T, size_t> &x, const std::pair<T, size_t> &y) { return (y.first > x.first ? y : x); });
+	return std::min(res.second, _size - 1); // a nan max is found nowhere
+}
+
+template <typename T, typename Enable>
+template <math_policy P>
+typename Vector<T, Enable>::real	Vector<T, Enable>::norm1() const {
+	return static_cast<real>(detail::vector_sum(simd::dispatch::reduction::asum, std::is_same<P, precise>::value, _data, _data, _capacity));
+}
+
+template <typename T, typename Enable>
+template <math_policy P>
+typename Vector<T, Enable>::real	Vector<T, Enable>::norm() const {
+	return tlap::sqrt(static_cast<real>(dot<P>(*this)));
+}
+
+template <typename T, typename Enable>
+typename Vector<T, Enable>::real	Vector<T, Enable>::normInf() const {
+	if (!_size)
+		return real(0);
+	return static_cast<real>(detail::vector_extremum(simd::dispatch::reduction::amax, _data, _size));
+}
+
+template <typename T, typename Enable>
+template <math_policy P>
+typename Vector<T, Enable>::real	Vector<T, Enable>::dist(const Vector<T> &other) const {
+	if (_size != other._size)
+		throw std::invalid_argument("Vectors must have the same size.");
+	return tlap::sqrt(static_cast<real>(detail::vector_sum(simd::dispatch::reduction::dist2,
+		std::is_same<P, precise>::value, _data, other._data, _capacity)));
+}
+
+template <typename T, typename Enable>
+template <math_policy P>
+typename Vector<T, Enable>::real	Vector<T, Enable>::cos(const Vector<T> &other) const {
+	const real n = norm<P>() * other.template norm<P>();
+	if (n == real(0))
+		throw std::invalid_argument("The angle with a zero vector is undefined.");
+	return std::clamp(static_cast<real>(dot<P>(other)) / n, real(-1), real(1));
+}
+
+template <typename T, typename Enable>
+template <math_policy P>
+typename Vector<T, Enable>::real	Vector<T, Enable>::angle(const Vector<T> &other) const {
+	return tlap::acos(cos<P>(other));
+}
+
+// float and double scale by rsqrt(dot), one rounding less than a division by
+// the norm (half and bfloat16 by the float rsqrt)
+template <typename T, typename Enable>
+Vector<T>	&Vector<T, Enable>::normalize() {
+	compute sq = dot(*this);
+	if (sq == compute(0))
+		throw std::invalid_argument("Cannot normalize a zero vector.");
+	if constexpr (std::is_floating_point<compute>::value)
+		return scaleUp(tlap::rsqrt(sq));
+	else
+		return scaleDown(static_cast<T>(norm()));
+}
+
+template <typename T, typename Enable>
+Vector<T>	&Vector<T, Enable>::resize(const T &len) {
+	normalize();
+	return scaleUp(len);
+}
+
+template <typename T, typename Enable>
+Vector<T>	&Vector<T, Enable>::clamp(const T &low, const T &high) {
+	const compute lo = low;
+	const compute hi = high;
+	detail::vector_split<T>(_capacity, [&](size_t i, size_t n) {
+		if constexpr (detail::dispatched<T>)
+			simd::dispatch::table<T>().clamp(_data + i, _data + i, n, lo, hi);
+		else
+			detail::vector_map(_data + i, _data + i, n, [lo, hi](auto a) TLAP_INLINE {
+				using X = decltype(a);
+				return detail::clamp_to(a, X(lo), X(hi));
+			});
+	});
+	_clearPadding();
+	return *this;
+}
+
+template <typename T, typename Enable>
+Vector<T>	&Vector<T, Enable>::apply(T (*func)(T)) {
+	for (size_t i = 0; i < _size; ++i)
+		_data[i] = func(_data[i]);
+	return *this;
+}
+
+template <typename T, typename Enable>
+Vector<T>	&Vector<T, Enable>::apply(T (*func)(const T &)) {
+	for (size_t i = 0; i < _size; ++i)
+		_data[i] = func(_data[i]);
+	return *this;
+}
+
+template <typename T, typename Enable>
+template <typename F>
+Vector<T>	&Vector<T, Enable>::apply(F func) {
+	if constexpr (detail::pack_invocable<T, F>()) {
+		detail::vector_split<T>(_capacity, [&](size_t i, size_t n) { detail::vector_map(_data + i, _data + i, n, detail::foreign<F>{func}); });
+		_clearPadding();
+	} else
+		for (size_t i = 0; i < _size; ++i)
+			_data[i] = static_cast<T>(func(_data[i]));
+	return *this;
+}
+
+template <typename T, typename Enable>
+typename Vector<T, Enable>::real	Vector<T, Enable>::len() const {
+	return norm();
+}
+
+template <typename T, typename Enable>
+size_t	Vector<T, Enable>::shape() const {
+	return _size;
+}
 
-Vector::Vector()
-	: _data(nullptr), _size(0) {
+template <typename T, typename Enable>
+size_t	Vector<T, Enable>::capacity() const {
+	return _capacity;
 }
 
-Vector::Vector(size_t size)
-	: _data(new T[size]), _size(size) {
-	simd_fill_tab(_data, size, T(0));
+// keeps the first min(size, shape()) elements, new ones are 0
+template <typename T, typename Enable>
+Vector<T>	&Vector<T, Enable>::reshape(size_t size) {
+	if (detail::padded_size<T>(size) == _capacity) {
+		_size = std::min(_size, size);
+		_clearPadding();
+		_size = size;
+		return *this;
+	}
+	Vector<T> res(size);
+	if (std::min(_size, size))
+		std::memcpy(res._data, _data, std::min(_size, size) * sizeof(T));
+	return *this = std::move(res);
 }
 
-}
\ No newline at end of file
+} // namespace tlap
@@ -0,0 +1,115 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: lazy Vector arithmetic, a whole expression runs as one loop
+// File version: 0.1
+#pragma once
+
+#include "Vector.hpp"
+#include "../simd/simd.hpp"
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+
+// a + b, a - b, a * b (elementwise), a * s, s * a and a / s on Vectors of the
+// same element type build an expression node instead of a Vector. nothing is
+// computed until the node constructs or is assigned to a Vector, which then
+// runs the whole expression as a single loop over packs, without temporaries:
+//     Vector<float> r = a * s + b - c; // one pass over a, b, c and r
+// nodes point into the Vectors they read and must not outlive them, so
+// auto x = a + b is only safe while a and b live. sizes are checked when the
+// node is built. Vector<T> op Vector<U> is not fused: U converts to T and the
+// result is computed at once, as before. half and bfloat16 expressions run on
+// float packs, rounded once when stored.
+// nodes are built for every isa level of simd/dispatch.hpp, gcc notes the pack
+// arguments of their (always inlined, see VectorExpr.tpp) load functions
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+namespace tlap::expr {
+	// leaves: a Vector's padded storage, a scalar broadcast to every element
+	template <typename T>
+	struct	ref : vector_expr {
+		using value_type = T;
+		const T	*data;
+		size_t	n;
+
+		ref(const Vector<T> &v) : data(v.data()), n(v.shape()) {}
+		size_t		size() const { return n; }
+		template <typename X>
+		TLAP_INLINE X	load(size_t i) const;
+	};
+
+	template <typename T>
+	struct	scalar : vector_expr {
+		using value_type = T;
+		compute_t<T>	s; // float for half and bfloat16
+		size_t			n;
+
+		scalar(compute_t<T> value, size_t size) : s(value), n(size) {}
+		size_t		size() const { return n; }
+		template <typename X>
+		TLAP_INLINE X	load(size_t) const { return X(s); }
+	};
+
+	// elementwise operations, X is a pack or a single element
+	struct	add { template <typename X> TLAP_INLINE static X apply(const X &a, const X &b) { return static_cast<X>(a + b); } };
+	struct	sub { template <typename X> TLAP_INLINE static X apply(const X &a, const X &b) { return static_cast<X>(a - b); } };
+	struct	mul { template <typename X> TLAP_INLINE static X apply(const X &a, const X &b) { return static_cast<X>(a * b); } };
+	struct	div { template <typename X> TLAP_INLINE static X apply(const X &a, const X &b) { return static_cast<X>(a / b); } };
+
+	template <typename Op, typename L, typename R>
+	struct	binary : vector_expr {
+		using value_type = typename L::value_type;
+		L	l;
+		R	r;
+
+		binary(const L &left, const R &right); // throws if the sizes differ
+		size_t		size() const { return l.size(); }
+		template <typename X>
+		TLAP_INLINE X	load(size_t i) const { return Op::apply(l.template load<X>(i), r.template load<X>(i)); }
+	};
+
+	// a Vector or an expression
+	template <typename A>
+	struct	is_vector : std::false_type {};
+	template <typename T>
+	struct	is_vector<Vector<T>> : std::true_type {};
+
+	template <typename A>
+	concept operand = is_vector<A>::value || vector_expression<A>;
+
+	template <typename A>
+	using leaf_t = std::conditional_t<vector_expression<A>, A, ref<typename A::value_type>>;
+
+	// two operands that fuse: same element type
+	template <typename A, typename B>
+	concept fusable = operand<A> && operand<B> && std::same_as<typename A::value_type, typename B::value_type>;
+}
+#pragma GCC diagnostic pop
+
+namespace tlap {
+	template <typename A, typename B> requires expr::fusable<A, B>
+	auto		operator+(const A &a, const B &b);
+	template <typename A, typename B> requires expr::fusable<A, B>
+	auto		operator-(const A &a, const B &b);
+	template <typename A, typename B> requires expr::fusable<A, B>
+	auto		operator*(const A &a, const B &b); // elementwise
+	template <typename A, typename U> requires expr::operand<A> && std::is_arithmetic<U>::value
+	auto		operator*(const A &a, const U &scalar);
+	template <typename U, typename A> requires expr::operand<A> && std::is_arithmetic<U>::value
+	auto		operator*(const U &scalar, const A &a);
+	template <typename A, typename U> requires expr::operand<A> && std::is_arithmetic<U>::value
+	auto		operator/(const A &a, const U &scalar); // integer division by 0 throws
+
+	// a + (b - a) * t, lazy
+	template <typename A, typename B> requires expr::fusable<A, B>
+	auto		lerp(const A &a, const B &b, typename A::value_type t);
+
+	// element types that differ: eager, U converted to T
+	template <typename T, typename U> requires (!std::same_as<T, U>)
+	Vector<T>	operator+(const Vector<T> &a, const Vector<U> &b);
+	template <typename T, typename U> requires (!std::same_as<T, U>)
+	Vector<T>	operator-(const Vector<T> &a, const Vector<U> &b);
+	template <typename T, typename U> requires (!std::same_as<T, U>)
+	Vector<T>	operator*(const Vector<T> &a, const Vector<U> &b);
+}
+
+#include "VectorExpr.tpp"
@@ -0,0 +1,211 @@
+#pragma once
+
+#include "VectorExpr.hpp"
+#include "../simd/simd.hpp"
+#include "../simd/dispatch.hpp"
+#include "../profile/profile.hpp"
+#include <stdexcept>
+
+namespace tlap {
+
+namespace expr {
+
+template <typename T>
+template <typename X>
+TLAP_INLINE inline X	ref<T>::load(size_t i) const {
+	if constexpr (is_element<X>)
+		return data[i];
+	else
+		return X::load(data + i);
+}
+
+template <typename Op, typename L, typename R>
+binary<Op, L, R>::binary(const L &left, const R &right)
+	: l(left), r(right) {
+	if (l.size() != r.size())
+		throw std::invalid_argument("Vectors must have the same size.");
+}
+
+template <typename A>
+leaf_t<A>	leaf(const A &a) {
+	return leaf_t<A>(a);
+}
+
+} // namespace expr
+
+namespace detail {
+
+// one loop over the padded elements [begin, end), X a pack or the element type itself
+template <typename X, typename T, typename Expr>
+TLAP_INLINE inline void	expr_loop(T *out, const Expr &expr, size_t begin, size_t end) {
+	if constexpr (std::is_arithmetic<X>::value) {
+		TLAP_SIMD_LOOP
+		for (size_t i = begin; i < end; ++i)
+			out[i] = expr.template load<T>(i);
+	} else
+		for (size_t i = begin; i < end; i += X::width)
+			expr.template load<X>(i).store(out + i);
+}
+
+// an expression is a new loop for every expression type, it cannot go through
+// the fixed kernel tables of simd/dispatch.hpp: the loop is instantiated once
+// per isa level instead. the node calls are always inlined into the target
+// function (TLAP_INLINE), flatten alone leaves them out of line at -O0
+template <typename T, typename Expr>
+[[gnu::flatten]] TLAP_TARGET_AVX512 void	expr_loop_avx512(T *out, const Expr &expr, size_t begin, size_t end) {
+	expr_loop<simd::pack<compute_t<T>, simd::isa::avx512>>(out, expr, begin, end);
+}
+
+template <typename T, typename Expr>
+[[gnu::flatten]] TLAP_TARGET_AVX2 void	expr_loop_avx2(T *out, const Expr &expr, size_t begin, size_t end) {
+	expr_loop<simd::pack<compute_t<T>, simd::isa::avx2>>(out, expr, begin, end);
+}
+
+template <typename T, typename Expr>
+void	vector_eval(T *out, const Expr &expr) {
+	TLAP_PROFILE_KERNEL("vector.expr", T, (dispatched<T> || is_reduced_float<T> ? simd::dispatch::active() : (has_pack<T> ? simd::dispatch::native : simd::dispatch::level::scalar)), expr.size());
+	vector_split<T>(padded_size<T>(expr.size()), [&](size_t i, size_t n) {
+		if constexpr (dispatched<T> || is_reduced_float<T>) {
+			switch (simd::dispatch::active()) {
+				case simd::dispatch::level::avx512:	return expr_loop_avx512(out, expr, i, i + n);
+				case simd::dispatch::level::avx2:	return expr_loop_avx2(out, expr, i, i + n);
+				default:
+					if constexpr (is_reduced_float<T>)
+						return expr_loop<simd::pack<float, simd::isa::scalar>>(out, expr, i, i + n);
+					else
+						return expr_loop<T>(out, expr, i, i + n); // left to the compiler
+			}
+		} else if constexpr (has_pack<T>)
+			expr_loop<simd::pack<T>>(out, expr, i, i + n);
+		else
+			expr_loop<T>(out, expr, i, i + n);
+	});
+}
+
+} // namespace detail
+
+// Vector members taking an expression
+
+template <typename T, typename Enable>
+template <vector_expression Expr>
+Vector<T, Enable>::Vector(const Expr &expr) {
+	static_assert(std::is_same<typename Expr::value_type, T>::value, "the expression must have the element type of the Vector");
+	_allocate(expr.size());
+	detail::vector_eval(_data, expr);
+	_clearPadding();
+}
+
+// evaluated in place when the size matches: every element only reads the
+// same element of the operands, so *this may be one of them
+template <typename T, typename Enable>
+template <vector_expression Expr>
+Vector<T>	&Vector<T, Enable>::operator=(const Expr &expr) {
+	static_assert(std::is_same<typename Expr::value_type, T>::value, "the expression must have the element type of the Vector");
+	if (expr.size() != _size)
+		return *this = Vector<T>(expr);
+	detail::vector_eval(_data, expr);
+	_clearPadding();
+	return *this;
+}
+
+template <typename T, typename Enable>
+template <vector_expression Expr>
+bool	Vector<T, Enable>::operator==(const Expr &expr) const {
+	return *this == Vector<T>(expr);
+}
+
+template <typename T, typename Enable>
+template <vector_expression Expr>
+bool	Vector<T, Enable>::operator!=(const Expr &expr) const {
+	return !(*this == expr);
+}
+
+template <typename T, typename Enable>
+template <vector_expression Expr>
+Vector<T>	&Vector<T, Enable>::operator+=(const Expr &expr) {
+	return *this = *this + expr;
+}
+
+template <typename T, typename Enable>
+template <vector_expression Expr>
+Vector<T>	&Vector<T, Enable>::operator-=(const Expr &expr) {
+	return *this = *this - expr;
+}
+
+template <typename T, typename Enable>
+template <vector_expression Expr>
+Vector<T>	&Vector<T, Enable>::operator*=(const Expr &expr) {
+	return *this = *this * expr;
+}
+
+// one pass over this and other
+template <typename T, typename Enable>
+Vector<T>	&Vector<T, Enable>::lerp(const Vector<T> &other, const T &factor) {
+	return *this = tlap::lerp(*this, other, factor);
+}
+
+// lazy operators
+
+template <typename A, typename B> requires expr::fusable<A, B>
+auto		operator+(const A &a, const B &b) {
+	return expr::binary<expr::add, expr::leaf_t<A>, expr::leaf_t<B>>(expr::leaf(a), expr::leaf(b));
+}
+
+template <typename A, typename B> requires expr::fusable<A, B>
+auto		operator-(const A &a, const B &b) {
+	return expr::binary<expr::sub, expr::leaf_t<A>, expr::leaf_t<B>>(expr::leaf(a), expr::leaf(b));
+}
+
+template <typename A, typename B> requires expr::fusable<A, B>
+auto		operator*(const A &a, const B &b) {
+	return expr::binary<expr::mul, expr::leaf_t<A>, expr::leaf_t<B>>(expr::leaf(a), expr::leaf(b));
+}
+
+template <typename A, typename U> requires expr::operand<A> && std::is_arithmetic<U>::value
+auto		operator*(const A &a, const U &scalar) {
+	using T = typename A::value_type;
+	expr::leaf_t<A> l = expr::leaf(a);
+	return expr::binary<expr::mul, expr::leaf_t<A>, expr::scalar<T>>(l, expr::scalar<T>(static_cast<compute_t<T>>(scalar), l.size()));
+}
+
+template <typename U, typename A> requires expr::operand<A> && std::is_arithmetic<U>::value
+auto		operator*(const U &scalar, const A &a) {
+	return a * scalar;
+}
+
+template <typename A, typename U> requires expr::operand<A> && std::is_arithmetic<U>::value
+auto		operator/(const A &a, const U &scalar) {
+	using T = typename A::value_type;
+	if constexpr (std::is_integral<T>::value)
+		if (static_cast<T>(scalar) == 0)
+			throw std::invalid_argument("Division by zero");
+	expr::leaf_t<A> l = expr::leaf(a);
+	return expr::binary<expr::div, expr::leaf_t<A>, expr::scalar<T>>(l, expr::scalar<T>(static_cast<compute_t<T>>(scalar), l.size()));
+}
+
+template <typename A, typename B> requires expr::fusable<A, B>
+auto		lerp(const A &a, const B &b, typename A::value_type t) {
+	return a + (b - a) * static_cast<compute_t<typename A::value_type>>(t);
+}
+
+// eager operators
+
+template <typename T, typename U> requires (!std::same_as<T, U>)
+Vector<T>	operator+(const Vector<T> &a, const Vector<U> &b) {
+	Vector<T> res(a);
+	return res += b;
+}
+
+template <typename T, typename U> requires (!std::same_as<T, U>)
+Vector<T>	operator-(const Vector<T> &a, const Vector<U> &b) {
+	Vector<T> res(a);
+	return res -= b;
+}
+
+template <typename T, typename U> requires (!std::same_as<T, U>)
+Vector<T>	operator*(const Vector<T> &a, const Vector<U> &b) {
+	Vector<T> res(a);
+	return res *= b;
+}
+
+} // namespace tlap
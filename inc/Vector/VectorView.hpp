@@ -0,0 +1,52 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: Vector over storage it does not own, shared memory, network buffers
+// File version: 0.1
+#pragma once
+
+#include "Vector.hpp"
+#include <cstddef>
+#include <span>
+
+// a VectorView is a Vector whose storage belongs to someone else: every Vector
+// operation runs on it in place, and it binds to const Vector<T> & and
+// Vector<T> & parameters. the storage must be what Vector storage is (see
+// Vector::shareable): simd::alignment aligned, with room(size) elements: the
+// size rounded up to whole aligned blocks. the room is given explicitly, as
+// the view writes its padding [size, room(size)): zeroed when it is not
+// already, and the elementwise operations compute on it. nothing past
+// room(size) is touched. a buffer without that room is copied into a Vector
+// instead.
+// copying a view gives a view of the same storage, assigning to one writes
+// the elements and needs the same size; a Vector copied from it owns a copy.
+// resizing is not allowed, through a Vector<T> & it leaves the storage for
+// storage of its own
+namespace tlap {
+	template <typename T>
+	class	VectorView : public Vector<T> {
+		private:
+			static void	_keep(T *, void *) {}
+
+		public:
+			VectorView(T *data, size_t size, size_t capacity); // capacity elements at data, throws below room(size)
+			VectorView(std::span<T> storage, size_t size); // the first size elements of storage, throws as above
+			VectorView(Vector<T> &v); // v must outlive the view and keep its size
+			VectorView(Vector<T> &&) = delete;
+			VectorView(const VectorView &other); // the same storage
+
+			static size_t			room(size_t size); // the elements a view of size needs
+
+			VectorView				&operator=(const VectorView &other); // throws if the sizes differ
+			VectorView				&operator=(const Vector<T> &other); // throws if the sizes differ
+			template <vector_expression Expr>
+			VectorView				&operator=(const Expr &expr); // throws if the sizes differ
+
+			Vector<T>				&reshape(size_t size) = delete;
+	};
+
+	namespace expr {
+		template <typename T>
+		struct	is_vector<VectorView<T>> : std::true_type {};
+	}
+}
+
+#include "VectorView.tpp"
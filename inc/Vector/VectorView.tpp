@@ -0,0 +1,59 @@
+#pragma once
+
+#include "VectorView.hpp"
+#include <stdexcept>
+
+namespace tlap {
+
+// constructors
+
+template <typename T>
+VectorView<T>::VectorView(T *data, size_t size, size_t capacity) {
+	this->_adopt(data, size, capacity, _keep, nullptr);
+}
+
+template <typename T>
+VectorView<T>::VectorView(std::span<T> storage, size_t size)
+	: VectorView(storage.data(), size, storage.size()) {
+}
+
+template <typename T>
+VectorView<T>::VectorView(Vector<T> &v)
+	: VectorView(v.data(), v.shape(), v.capacity()) {
+}
+
+template <typename T>
+VectorView<T>::VectorView(const VectorView &other)
+	: VectorView(const_cast<T *>(other.data()), other.shape(), other.capacity()) {
+}
+
+template <typename T>
+size_t	VectorView<T>::room(size_t size) {
+	return detail::padded_size<T>(size);
+}
+
+// assignment writes through, Vector assignment does when the sizes match
+
+template <typename T>
+VectorView<T>	&VectorView<T>::operator=(const VectorView &other) {
+	return *this = static_cast<const Vector<T> &>(other);
+}
+
+template <typename T>
+VectorView<T>	&VectorView<T>::operator=(const Vector<T> &other) {
+	if (other.shape() != this->shape())
+		throw std::invalid_argument("Vectors must have the same size.");
+	Vector<T>::operator=(other);
+	return *this;
+}
+
+template <typename T>
+template <vector_expression Expr>
+VectorView<T>	&VectorView<T>::operator=(const Expr &expr) {
+	if (expr.size() != this->shape())
+		throw std::invalid_argument("Vectors must have the same size.");
+	Vector<T>::operator=(expr);
+	return *this;
+}
+
+} // namespace tlap
@@ -5,12 +5,52 @@
 # define PI 3.14159265358979323846
 # define E 2.71828182845904523536
 # define PHI 1.61803398874989484820
-# define EPSILON 1e-10
 # define LN2 0.69314718055994530942
 # define LN10 2.30258509299404568402
-# define EXP_LIMIT 709
-# define EXP_TERMS 50
-# define LN_TERMS 50
 # define FACTORIAL_SWITCH 20
-# define MAX_RECURSION 50000
-# define SIMD_THRESHOLD 128
\ No newline at end of file
+# define SIMD_MATH_THRESHOLD 16 // below it, batch math on unpadded arrays runs the one-lane kernels only
+# define BATCH_PARALLEL_MIN 32768 // elements below which a batch math call stays on the calling thread
+# define BATCH_GRAIN 4096 // elements of the smallest piece of one spread over the threads, a whole number of packs
+# ifndef MATH_POLICY
+#  define MATH_POLICY tlap::precise // tlap::precise or tlap::fast, see math/policy.hpp
+# endif
+# ifndef REDUCE_POLICY
+#  define REDUCE_POLICY tlap::fast // tlap::fast or tlap::precise (compensated) Vector sums, see Vector/Vector.hpp
+# endif
+# define REDUCE_BLOCK 8192 // elements per block of a Vector reduction, the unit of work of one thread
+# define REDUCE_PARALLEL_MIN 262144 // elements below which a Vector reduction stays on the calling thread
+# define VECTOR_PARALLEL_MIN 262144 // elements below which an elementwise Vector or Matrix operation stays on the calling thread
+# define VECTOR_GRAIN 16384 // elements of the smallest piece of one spread over the threads, a whole number of aligned blocks
+# define VECTOR_TILE 8192 // bytes per operand and step of the fused multi-Vector loops, the result tile stays in L1
+# define MEMORY_RECYCLE_MAX 16777216 // bytes of the largest block the recycler keeps for reuse, see memory/allocator.hpp
+# define MEMORY_RECYCLE_KEEP 8 // freed blocks kept per size class and thread
+# define MEMORY_RECYCLE_BYTES 67108864 // freed bytes kept per thread
+# define MEMORY_ARENA_CHUNK 1048576 // bytes of the chunks of an arena
+# define IO_BLOCK 8388608 // bytes per block of the out-of-core pipelines, three per file in memory, see io/chunked.hpp
+# define PARALLEL_TASKS_PER_THREAD 4 // most tasks of one parallel_for per thread, see parallel/pool.hpp
+# define CACHE_L1 32768 // data cache bytes per core, the gemm blocking of Matrix/gemm_kernels.tpp is sized on them
+# define CACHE_L2 1048576
+# define CACHE_L3 8388608 // share of the last level cache one gemm call may fill
+# define GEMM_PARALLEL_MIN 262144 // m * n * k below which a gemm stays on the calling thread
+# define GEMV_PARALLEL_MIN 262144 // same for m * n of a gemv
+# define TRANSFORM_TILE 1024 // points per tile of transformBatch, the unit of work of one thread
+# define TRANSFORM_PARALLEL_MIN 65536 // points below which transformBatch stays on the calling thread
+# define TENSOR_TILE 32 // rows and columns of the tiles of an elementwise Tensor operation over a transposed input
+# define TENSOR_PARALLEL_MIN 262144 // elements below which an elementwise Tensor operation stays on the calling thread
+# define SPARSE_PARALLEL_MIN 65536 // work (stored values + rows) below which a sparse product stays on the calling thread, see Sparse/SparseMatrix.hpp
+# define SPARSE_GRAIN 8192 // least work of one part of a sparse product
+# define SPARSE_CSC_PARTS 8 // most partial results, each of the size of the result, of a csc * Vector product
+# define QUANT_CHUNK 16384 // codes per int32 partial sum of the int8 / uint8 kernels, no lane overflows below 2^31 / 255^2
+# define QUANT_PARALLEL_MIN 262144 // codes below which a dotBatch / distBatch stays on the calling thread, see Quant/QuantizedVector.hpp
+# define RANDOM_TILE 1024 // elements one fill generates at once, a multiple of 16: the values only depend on the generator and the index, see random/random.hpp
+# define RANDOM_PARALLEL_MIN 65536 // elements below which a fill stays on the calling thread
+# define RANDOM_GRAIN 16384 // elements of the smallest piece of a fill spread over the threads, a whole number of tiles
+# define EINSUM_OPTIMAL_MAX 8 // operands up to which einsum tries every contraction order, greedy past it
+# define EINSUM_CACHE_SIZE 256 // einsum plans kept, the cache is emptied when full
+# ifndef TLAP_PROFILE
+#  define TLAP_PROFILE 0 // 1: kernel and allocation counters, trace regions, see profile/profile.hpp
+# endif
+# define PROFILE_TRACE_MAX 1048576 // trace regions kept per thread, the later ones are only counted
+# ifndef SIMD_DISPATCH
+#  define SIMD_DISPATCH 1 // 0: Vector kernels and batch math only use the isa of the compile flags, see simd/dispatch.hpp
+# endif
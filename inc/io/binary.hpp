@@ -0,0 +1,112 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: binary files of Vector, Matrix and Tensor, mapped or streamed
+// File version: 0.1
+#pragma once
+
+#include "../Tensor/Tensor.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+// one array per file. a header, then the payload at an offset that is a
+// multiple of its alignment (64, simd::alignment), zero padded to whole
+// aligned blocks:
+//   "TLAP", byte order mark 0x01020304 (u32), version (u16), dtype (u8),
+//   rank (u8), alignment (u32), payload offset (u64), payload bytes (u64),
+//   shape (u64 x rank), strides in elements (i64 x rank)
+// every field in the byte order of the writer, which the mark tells. files
+// written here are row-major. a Vector maps straight onto the file (its
+// padding is in the payload), a Tensor maps any strides, a Matrix is copied
+// into its padded rows. mapping needs the byte order of this machine, the
+// copying loads and the reader swap it.
+// errors: std::invalid_argument for a file that is not one of these or does
+// not fit the request (dtype, rank), std::runtime_error when the system fails
+// (open, read, write, mmap)
+namespace tlap::io {
+	enum class dtype : uint8_t { f32 = 1, f64, i8, u8, i16, u16, i32, u32, i64, u64 };
+
+	template <typename T>
+	constexpr dtype	dtype_of();
+
+	struct	header {
+		dtype		type;
+		shape_t		shape;
+		strides_t	strides;
+		size_t		alignment;
+		size_t		offset; // of the payload, in bytes from the start of the file
+		size_t		bytes; // of the payload, padding included
+		bool		swapped; // written in the other byte order
+
+		size_t		size() const; // elements of shape, throws std::invalid_argument past size_t
+		size_t		extent() const; // elements from the first to the last one the strides reach, + 1; throws as size()
+	};
+
+	header		inspect(const std::string &path);
+
+	template <typename T>
+	void		save(const std::string &path, const Vector<T> &v);
+	template <typename T>
+	void		save(const std::string &path, const Matrix<T> &m);
+	template <typename T>
+	void		save(const std::string &path, const Tensor<T> &t); // a strided view is written row-major
+
+	// copies, T must be the dtype of the file
+	template <typename T>
+	Vector<T>	loadVector(const std::string &path); // rank 1
+	template <typename T>
+	Matrix<T>	loadMatrix(const std::string &path); // rank 2
+	template <typename T>
+	Tensor<T>	loadTensor(const std::string &path); // the strides of the file
+
+	// no copy: the pages are read as they are touched, the mapping lives as
+	// long as the Vector or the last Tensor sharing it. read maps the file
+	// copy-on-write (writes stay in memory), write maps it shared (writes go
+	// to the file)
+	enum class access { read, write };
+
+	template <typename T>
+	Vector<T>	mapVector(const std::string &path, access mode = access::read); // rank 1, stride 1
+	template <typename T>
+	Tensor<T>	mapTensor(const std::string &path, access mode = access::read);
+
+	// arrays bigger than memory: a writer takes the elements of shape in
+	// row-major order in as many write() calls as it takes, a reader hands out
+	// the payload in as many read() calls
+	template <typename T>
+	class	writer {
+		private:
+			std::ofstream	_out;
+			size_t			_size;
+			size_t			_written;
+
+		public:
+			writer(const std::string &path, const shape_t &shape); // the header now, the payload as it comes
+			~writer(); // a writer not closed leaves a short file, that inspect() rejects
+			writer(const writer &) = delete;
+			writer	&operator=(const writer &) = delete;
+
+			void	write(const T *data, size_t n); // the next n elements, throws past the size of shape
+			void	close(); // pads the payload, throws if elements are missing
+	};
+
+	template <typename T>
+	class	reader {
+		private:
+			std::ifstream	_in;
+			header			_info;
+			size_t			_next;
+
+		public:
+			explicit reader(const std::string &path); // throws if T is not the dtype of the file
+			reader(const reader &) = delete;
+			reader	&operator=(const reader &) = delete;
+
+			const header	&info() const;
+			size_t			read(T *out, size_t n); // the next elements of the payload, at most n, 0 at the end; in the byte order of this machine
+			void			seek(size_t element);
+			size_t			tell() const;
+	};
+}
+
+#include "binary.tpp"
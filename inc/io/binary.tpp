@@ -0,0 +1,423 @@
+#pragma once
+
+#include "binary.hpp"
+#include "../simd/simd.hpp"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <unistd.h>
+#endif
+
+namespace tlap::io {
+
+template <typename T>
+constexpr dtype	dtype_of() {
+	static_assert(std::is_arithmetic<T>::value && sizeof(T) <= 8 && !std::is_same<T, long double>::value, "no dtype for this type");
+	if constexpr (std::is_floating_point<T>::value)
+		return (sizeof(T) == 4 ? dtype::f32 : dtype::f64);
+	else {
+		constexpr bool s = std::is_signed<T>::value;
+		switch (sizeof(T)) {
+			case 1:		return (s ? dtype::i8 : dtype::u8);
+			case 2:		return (s ? dtype::i16 : dtype::u16);
+			case 4:		return (s ? dtype::i32 : dtype::u32);
+			default:	return (s ? dtype::i64 : dtype::u64);
+		}
+	}
+}
+
+namespace detail {
+
+inline constexpr char		magic[4] = {'T', 'L', 'A', 'P'};
+inline constexpr uint32_t	order_mark = 0x01020304;
+inline constexpr uint16_t	version = 1;
+inline constexpr size_t		fixed = 32; // bytes before the shape
+
+inline size_t	round_up(size_t n, size_t a) {
+	return (n + a - 1) / a * a;
+}
+
+inline size_t	dtype_size(dtype t) {
+	switch (t) {
+		case dtype::i8: case dtype::u8:		return 1;
+		case dtype::i16: case dtype::u16:	return 2;
+		case dtype::f32: case dtype::i32: case dtype::u32:	return 4;
+		default:							return 8;
+	}
+}
+
+template <typename U>
+U		swap(U x) {
+	if constexpr (sizeof(U) == 1)
+		return x;
+	else {
+		using B = std::conditional_t<sizeof(U) == 2, uint16_t, std::conditional_t<sizeof(U) == 4, uint32_t, uint64_t>>;
+		B b;
+		std::memcpy(&b, &x, sizeof(U));
+		if constexpr (sizeof(U) == 2)
+			b = __builtin_bswap16(b);
+		else if constexpr (sizeof(U) == 4)
+			b = __builtin_bswap32(b);
+		else
+			b = __builtin_bswap64(b);
+		std::memcpy(&x, &b, sizeof(U));
+		return x;
+	}
+}
+
+template <typename U>
+void	put(char *p, U v) {
+	std::memcpy(p, &v, sizeof(U));
+}
+
+template <typename U>
+U		get(const char *p, bool swapped) {
+	U v;
+	std::memcpy(&v, p, sizeof(U));
+	return (swapped ? swap(v) : v);
+}
+
+// the header and the zeros up to the payload
+inline std::vector<char>	encode(dtype type, const shape_t &shape, const strides_t &strides, size_t bytes) {
+	const size_t		offset = round_up(fixed + 16 * shape.size(), simd::alignment);
+	std::vector<char>	buf(offset, 0);
+	char				*p = buf.data();
+
+	if (shape.size() > 255)
+		throw std::invalid_argument("A file holds at most 255 dimensions.");
+	std::memcpy(p, magic, 4);
+	put<uint32_t>(p + 4, order_mark);
+	put<uint16_t>(p + 8, version);
+	put<uint8_t>(p + 10, static_cast<uint8_t>(type));
+	put<uint8_t>(p + 11, static_cast<uint8_t>(shape.size()));
+	put<uint32_t>(p + 12, simd::alignment);
+	put<uint64_t>(p + 16, offset);
+	put<uint64_t>(p + 24, bytes);
+	for (size_t d = 0; d < shape.size(); ++d) {
+		put<uint64_t>(p + fixed + 8 * d, shape[d]);
+		put<int64_t>(p + fixed + 8 * (shape.size() + d), strides[d]);
+	}
+	return buf;
+}
+
+inline std::ifstream	open_in(const std::string &path) {
+	std::ifstream in(path, std::ios::binary);
+	if (!in)
+		throw std::runtime_error("Cannot open " + path + ".");
+	return in;
+}
+
+// leaves in at the payload
+inline header	parse(std::istream &in, size_t fileSize) {
+	char	p[fixed];
+	header	h;
+
+	if (!in.read(p, fixed) || std::memcmp(p, magic, 4))
+		throw std::invalid_argument("Not a tlap file.");
+	const uint32_t mark = get<uint32_t>(p + 4, false);
+	h.swapped = (mark != order_mark);
+	if (h.swapped && swap(mark) != order_mark)
+		throw std::invalid_argument("Not a tlap file.");
+	if (get<uint16_t>(p + 8, h.swapped) != version)
+		throw std::invalid_argument("Unsupported tlap file version.");
+	const uint8_t type = get<uint8_t>(p + 10, false);
+	const size_t rank = get<uint8_t>(p + 11, false);
+	if (type < static_cast<uint8_t>(dtype::f32) || type > static_cast<uint8_t>(dtype::u64))
+		throw std::invalid_argument("Unknown element type in a tlap file.");
+	h.type = static_cast<dtype>(type);
+	h.alignment = get<uint32_t>(p + 12, h.swapped);
+	h.offset = get<uint64_t>(p + 16, h.swapped);
+	h.bytes = get<uint64_t>(p + 24, h.swapped);
+	if (!h.alignment || (h.alignment & (h.alignment - 1)) || h.offset % h.alignment || h.offset < fixed + 16 * rank)
+		throw std::invalid_argument("Corrupt tlap file header.");
+
+	std::vector<char> dims(16 * rank);
+	if (!in.read(dims.data(), static_cast<std::streamsize>(dims.size())))
+		throw std::invalid_argument("Corrupt tlap file header.");
+	h.shape.resize(rank);
+	h.strides.resize(rank);
+	for (size_t d = 0; d < rank; ++d) {
+		h.shape[d] = get<uint64_t>(dims.data() + 8 * d, h.swapped);
+		h.strides[d] = get<int64_t>(dims.data() + 8 * (rank + d), h.swapped);
+		if (h.strides[d] < 0)
+			throw std::invalid_argument("Corrupt tlap file header.");
+	}
+	size_t	need = 0; // size() and extent() throw on a shape or strides out of size_t
+	if (h.size() && __builtin_mul_overflow(h.extent(), dtype_size(h.type), &need))
+		throw std::invalid_argument("Corrupt tlap file header.");
+	if (h.offset > fileSize || h.bytes > fileSize - h.offset || need > h.bytes)
+		throw std::invalid_argument("Truncated tlap file.");
+	in.seekg(static_cast<std::streamoff>(h.offset));
+	return h;
+}
+
+inline header	parse(std::ifstream &in) {
+	in.seekg(0, std::ios::end);
+	const size_t size = static_cast<size_t>(in.tellg());
+	in.seekg(0);
+	return parse(in, size);
+}
+
+template <typename T>
+void	expect(const header &h) {
+	if (h.type != dtype_of<T>())
+		throw std::invalid_argument("The file holds another element type.");
+}
+
+// every dimension that has more than one element at its row-major stride
+inline void	expect_row_major(const header &h, size_t rank) {
+	bool		dense = (h.shape.size() == rank);
+	ptrdiff_t	s = 1;
+	for (size_t d = h.shape.size(); dense && d-- > 0;) {
+		dense = h.shape[d] <= 1 || h.strides[d] == s;
+		s *= static_cast<ptrdiff_t>(h.shape[d]);
+	}
+	if (!dense)
+		throw std::invalid_argument("The file does not hold a row-major array of that rank.");
+}
+
+template <typename T>
+void	swap_all(T *p, size_t n) {
+	for (size_t i = 0; i < n; ++i)
+		p[i] = swap(p[i]);
+}
+
+// the whole file, unmapped when the last owner is done
+struct	mapping {
+	char	*base;
+	size_t	length;
+	header	info;
+};
+
+inline void	unmap([[maybe_unused]] const mapping &m) {
+#if defined(__unix__) || defined(__APPLE__)
+	::munmap(m.base, m.length);
+#endif
+}
+
+template <typename T>
+mapping	map_file(const std::string &path, [[maybe_unused]] access mode) {
+#if defined(__unix__) || defined(__APPLE__)
+	std::ifstream	in = open_in(path);
+	mapping			m;
+
+	m.info = parse(in);
+	expect<T>(m.info);
+	if (m.info.swapped)
+		throw std::invalid_argument("The file has the other byte order: load it, it cannot be mapped.");
+	m.length = m.info.offset + m.info.bytes;
+
+	const int fd = ::open(path.c_str(), (mode == access::read ? O_RDONLY : O_RDWR));
+	if (fd < 0)
+		throw std::runtime_error("Cannot open " + path + ".");
+	void *p = ::mmap(nullptr, m.length, PROT_READ | PROT_WRITE, (mode == access::read ? MAP_PRIVATE : MAP_SHARED), fd, 0);
+	::close(fd);
+	if (p == MAP_FAILED)
+		throw std::runtime_error("Cannot map " + path + ".");
+	m.base = static_cast<char *>(p);
+	return m;
+#else
+	(void)path;
+	throw std::runtime_error("Mapping a file needs mmap().");
+#endif
+}
+
+} // namespace detail
+
+// header
+
+// both throw std::invalid_argument when the count does not fit in size_t: a
+// corrupt header must not wrap around to a small size
+inline size_t	header::size() const {
+	size_t n = 1;
+	if (std::find(shape.begin(), shape.end(), size_t(0)) != shape.end())
+		return 0;
+	for (size_t s : shape)
+		if (__builtin_mul_overflow(n, s, &n))
+			throw std::invalid_argument("Corrupt tlap file header.");
+	return n;
+}
+
+inline size_t	header::extent() const {
+	size_t last = 0;
+	for (size_t d = 0; d < shape.size(); ++d) {
+		size_t	span;
+		if (!shape[d])
+			return 0;
+		if (__builtin_mul_overflow(shape[d] - 1, static_cast<size_t>(strides[d]), &span) || __builtin_add_overflow(last, span, &last))
+			throw std::invalid_argument("Corrupt tlap file header.");
+	}
+	if (__builtin_add_overflow(last, size_t(1), &last))
+		throw std::invalid_argument("Corrupt tlap file header.");
+	return last;
+}
+
+inline header	inspect(const std::string &path) {
+	std::ifstream in = detail::open_in(path);
+	return detail::parse(in);
+}
+
+// writer
+
+template <typename T>
+writer<T>::writer(const std::string &path, const shape_t &shape)
+	: _out(path, std::ios::binary | std::ios::trunc), _size(tlap::detail::shape_size(shape)), _written(0) {
+	if (!_out)
+		throw std::runtime_error("Cannot create " + path + ".");
+	const std::vector<char> head = detail::encode(dtype_of<T>(), shape, tlap::detail::row_major(shape),
+		detail::round_up(_size * sizeof(T), simd::alignment));
+	if (!_out.write(head.data(), static_cast<std::streamsize>(head.size())))
+		throw std::runtime_error("Cannot write " + path + ".");
+}
+
+template <typename T>
+writer<T>::~writer() {
+	if (_out.is_open())
+		_out.close();
+}
+
+template <typename T>
+void	writer<T>::write(const T *data, size_t n) {
+	if (n > _size - _written)
+		throw std::invalid_argument("More elements than the shape holds.");
+	if (!_out.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(n * sizeof(T))))
+		throw std::runtime_error("Cannot write the payload.");
+	_written += n;
+}
+
+template <typename T>
+void	writer<T>::close() {
+	if (!_out.is_open())
+		return;
+	if (_written != _size)
+		throw std::invalid_argument("Elements of the shape are missing.");
+	const std::vector<char> pad(detail::round_up(_size * sizeof(T), simd::alignment) - _size * sizeof(T), 0);
+	_out.write(pad.data(), static_cast<std::streamsize>(pad.size()));
+	_out.close();
+	if (!_out)
+		throw std::runtime_error("Cannot write the payload.");
+}
+
+// reader
+
+template <typename T>
+reader<T>::reader(const std::string &path)
+	: _in(detail::open_in(path)), _info(detail::parse(_in)), _next(0) {
+	detail::expect<T>(_info);
+}
+
+template <typename T>
+const header	&reader<T>::info() const {
+	return _info;
+}
+
+template <typename T>
+size_t	reader<T>::read(T *out, size_t n) {
+	n = std::min(n, _info.extent() - _next);
+	if (!_in.read(reinterpret_cast<char *>(out), static_cast<std::streamsize>(n * sizeof(T))))
+		throw std::runtime_error("Cannot read the payload.");
+	if (_info.swapped)
+		detail::swap_all(out, n);
+	_next += n;
+	return n;
+}
+
+template <typename T>
+void	reader<T>::seek(size_t element) {
+	if (element > _info.extent())
+		throw std::invalid_argument("Seek past the end of the payload.");
+	_in.clear();
+	_in.seekg(static_cast<std::streamoff>(_info.offset + element * sizeof(T)));
+	_next = element;
+}
+
+template <typename T>
+size_t	reader<T>::tell() const {
+	return _next;
+}
+
+// whole arrays
+
+template <typename T>
+void	save(const std::string &path, const Vector<T> &v) {
+	writer<T> w(path, {v.shape()});
+	w.write(v.data(), v.shape());
+	w.close();
+}
+
+template <typename T>
+void	save(const std::string &path, const Matrix<T> &m) {
+	writer<T> w(path, {m.rows(), m.cols()});
+	for (size_t i = 0; i < m.rows(); ++i)
+		w.write(m.row(i), m.cols());
+	w.close();
+}
+
+template <typename T>
+void	save(const std::string &path, const Tensor<T> &t) {
+	const Tensor<T>	c = t.contiguous();
+	writer<T>		w(path, c.shape());
+	w.write(c.data(), c.size());
+	w.close();
+}
+
+template <typename T>
+Vector<T>	loadVector(const std::string &path) {
+	reader<T> r(path);
+	detail::expect_row_major(r.info(), 1);
+	Vector<T> res = Vector<T>::uninitialized(r.info().shape[0]);
+	r.read(res.data(), res.shape());
+	return res;
+}
+
+template <typename T>
+Matrix<T>	loadMatrix(const std::string &path) {
+	reader<T> r(path);
+	detail::expect_row_major(r.info(), 2);
+	Matrix<T> res = Matrix<T>::uninitialized(r.info().shape[0], r.info().shape[1]);
+	for (size_t i = 0; i < res.rows(); ++i)
+		r.read(res.row(i), res.cols());
+	return res;
+}
+
+template <typename T>
+Tensor<T>	loadTensor(const std::string &path) {
+	reader<T>			r(path);
+	const size_t		n = r.info().extent();
+	std::shared_ptr<T>	storage(simd::aligned_alloc<T>(n), [](T *p) { simd::aligned_free(p); });
+
+	r.read(storage.get(), n);
+	return Tensor<T>::adopt(storage, storage.get(), r.info().shape, r.info().strides);
+}
+
+// mapped
+
+template <typename T>
+Vector<T>	mapVector(const std::string &path, access mode) {
+	const detail::mapping	m = detail::map_file<T>(path, mode);
+	T						*data = reinterpret_cast<T *>(m.base + m.info.offset);
+
+	try {
+		detail::expect_row_major(m.info, 1);
+		return Vector<T>(data, m.info.shape[0], m.info.bytes / sizeof(T), [m](T *) { detail::unmap(m); });
+	} catch (...) {
+		detail::unmap(m);
+		throw;
+	}
+}
+
+template <typename T>
+Tensor<T>	mapTensor(const std::string &path, access mode) {
+	const detail::mapping	m = detail::map_file<T>(path, mode);
+	T						*data = reinterpret_cast<T *>(m.base + m.info.offset);
+
+	return Tensor<T>::adopt(std::shared_ptr<T>(data, [m](T *) { detail::unmap(m); }), data, m.info.shape, m.info.strides);
+}
+
+} // namespace tlap::io
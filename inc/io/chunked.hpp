@@ -0,0 +1,53 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: out-of-core pipelines over binary files bigger than memory
+// File version: 0.1
+#pragma once
+
+#include "binary.hpp"
+#include "../Vector/VectorView.hpp"
+#include "../math/policy.hpp"
+#include <cstddef>
+#include <string>
+
+// the payload of row-major files of io/binary.hpp streamed in blocks of
+// IO_BLOCK bytes: while a block is computed, the next one is read and the
+// one before is written back, on threads of their own, so a pass over the
+// file costs the slower of the disk and the kernels, not their sum. at most
+// three blocks per file are in memory.
+// a block reaches the callback as a VectorView over aligned, padded storage,
+// so every Vector operation runs on it with its simd kernels and its threads.
+// the Rows variants hand out one row (the last dimension) at a time, each
+// laid out as Vector storage of its own.
+// inputs of one call have the same shape, an output is written with that
+// shape and must not be one of the inputs. reductions sum the partials of the
+// blocks in file order: the result depends on IO_BLOCK, not on the threads.
+// errors: as io/binary.hpp
+namespace tlap::io {
+	template <typename T, typename F>
+	void	scan(const std::string &path, F f); // f(const VectorView<T> &block, size_t first), first the index of its first element
+	template <typename T, typename F>
+	void	scan(const std::string &a, const std::string &b, F f); // f(const VectorView<T> &a, const VectorView<T> &b, size_t first)
+	template <typename T, typename F>
+	void	transform(const std::string &in, const std::string &out, F f); // f(VectorView<T> &block, size_t first) updates the block in place
+	template <typename T, typename F>
+	void	transform(const std::string &a, const std::string &b, const std::string &out, F f); // f(VectorView<T> &a, const VectorView<T> &b, size_t first), the result in a
+
+	template <typename T, typename F>
+	void	scanRows(const std::string &path, F f); // f(const VectorView<T> &row, size_t index)
+	template <typename T, typename F>
+	void	transformRows(const std::string &in, const std::string &out, F f); // f(VectorView<T> &row, size_t index)
+
+	template <typename T, math_policy P = reduce_policy>
+	T		sum(const std::string &path);
+	template <typename T, math_policy P = reduce_policy>
+	T		dot(const std::string &a, const std::string &b);
+	template <typename T, math_policy P = reduce_policy>
+	typename Vector<T>::real	norm(const std::string &path); // euclidean, of the whole payload
+
+	template <typename T>
+	Vector<T>	gemv(const std::string &matrix, const Vector<T> &x); // a (m x n) * x of a rank-2 file, whole rows per block
+	template <typename T, math_policy P = reduce_policy>
+	void		normalizeRows(const std::string &in, const std::string &out); // every row to norm 1, zero rows stay zero
+}
+
+#include "chunked.tpp"
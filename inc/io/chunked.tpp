@@ -0,0 +1,275 @@
+#pragma once
+
+#include "chunked.hpp"
+#include "../Matrix/gemm.hpp"
+#include "../hyperp.hpp"
+#include <algorithm>
+#include <array>
+#include <future>
+#include <stdexcept>
+#include <type_traits>
+
+namespace tlap::io {
+
+namespace detail {
+
+// a block in memory: up to rows rows of len elements, stride apart
+struct	layout {
+	size_t	len;
+	size_t	stride;
+	size_t	rows;
+};
+
+// rows read into a block, the last one may be short (flat blocks)
+struct	filled {
+	size_t	rows;
+	size_t	last;
+};
+
+template <typename T>
+layout	flat_layout(size_t unit) { // blocks of whole units, unit elements (the rows of a gemv)
+	const size_t	room = std::max<size_t>(IO_BLOCK / sizeof(T), 1);
+	const size_t	len = std::max<size_t>(room / unit, 1) * unit;
+	return {len, tlap::detail::padded_size<T>(len), 1};
+}
+
+template <typename T>
+layout	row_layout(size_t len) {
+	const size_t	stride = tlap::detail::padded_size<T>(std::max<size_t>(len, 1));
+	return {len, stride, std::max<size_t>(IO_BLOCK / sizeof(T) / stride, 1)};
+}
+
+inline void	expect_same(const header &a, const header &b) {
+	if (a.shape != b.shape)
+		throw std::invalid_argument("The files must have the same shape.");
+}
+
+inline size_t	row_length(const header &h) {
+	return (h.shape.empty() ? 1 : h.shape.back());
+}
+
+// K readers in step through their payloads, f(blocks, filled, first) per
+// block, then out (when given) writes the block of the first reader. three
+// sets of buffers rotate: the read of block i + 1 and the write of block i - 1
+// run while f computes block i, and a set is read into again only once its
+// write is done
+template <typename T, size_t K, typename F>
+void	run_blocks(const std::array<reader<T> *, K> &in, writer<T> *out, const layout &l, F f) {
+	constexpr size_t	sets = 3;
+	const size_t		total = in[0]->info().size();
+	std::array<std::array<Vector<T>, K>, sets>	buffers;
+
+	for (auto &set : buffers)
+		for (auto &b : set)
+			b = Vector<T>::uninitialized(l.stride * l.rows);
+	auto read = [&](size_t s) {
+		filled	got = {0, 0};
+		size_t	left = total - in[0]->tell();
+		while (got.rows < l.rows && left) {
+			const size_t	n = std::min(l.len, left);
+			for (size_t k = 0; k < K; ++k)
+				if (in[k]->read(buffers[s][k].data() + got.rows * l.stride, n) != n)
+					throw std::runtime_error("Cannot read the payload.");
+			got.last = n;
+			left -= n;
+			++got.rows;
+		}
+		return got;
+	};
+	auto write = [&, out](size_t s, filled got) {
+		for (size_t r = 0; r < got.rows; ++r)
+			out->write(buffers[s][0].data() + r * l.stride, (r + 1 == got.rows ? got.last : l.len));
+	};
+	std::future<filled>	reading = std::async(std::launch::async, read, size_t(0));
+	std::future<void>	writing;
+	for (size_t i = 0, first = 0;; ++i) {
+		const filled	got = reading.get();
+		if (!got.rows)
+			break;
+		const size_t	s = i % sets;
+		reading = std::async(std::launch::async, read, (i + 1) % sets);
+		std::array<T *, K>	blocks;
+		for (size_t k = 0; k < K; ++k)
+			blocks[k] = buffers[s][k].data();
+		f(blocks, got, first);
+		first += (got.rows - 1) * l.len + got.last;
+		if (out) {
+			if (writing.valid())
+				writing.get();
+			writing = std::async(std::launch::async, write, s, got);
+		}
+	}
+	if (writing.valid())
+		writing.get();
+	if (out)
+		out->close();
+}
+
+// flat blocks of whole units: f(blocks, n, first), n the elements read
+template <typename T, size_t K, typename F>
+void	run_flat(const std::array<reader<T> *, K> &in, writer<T> *out, size_t unit, F f) {
+	run_blocks<T, K>(in, out, flat_layout<T>(unit), [&](const std::array<T *, K> &blocks, const filled &got, size_t first) {
+		f(blocks, got.last, first);
+	});
+}
+
+// rows padded to Vector storage: f(row, index) for each
+template <typename T, typename F>
+void	run_rows(reader<T> &in, writer<T> *out, F f) {
+	const layout	l = row_layout<T>(row_length(in.info()));
+	run_blocks<T, 1>({&in}, out, l, [&](const std::array<T *, 1> &blocks, const filled &got, size_t first) {
+		for (size_t r = 0; r < got.rows; ++r) {
+			VectorView<T>	row(blocks[0] + r * l.stride, l.len, l.stride);
+			f(row, (l.len ? first / l.len : 0) + r);
+		}
+	});
+}
+
+template <typename T>
+reader<T>	&open_dense(reader<T> &r) {
+	expect_row_major(r.info(), r.info().shape.size());
+	return r;
+}
+
+// partials of the blocks in file order, compensated (Kahan) when asked
+template <typename T>
+struct	accumulator {
+	bool	compensated;
+	T		total = T(0);
+	T		carry = T(0);
+
+	void	add(T x) {
+		if (!compensated) {
+			total += x;
+			return;
+		}
+		const T	y = x - carry;
+		const T	t = total + y;
+		carry = (t - total) - y;
+		total = t;
+	}
+};
+
+}
+
+// blocks
+
+template <typename T, typename F>
+void	scan(const std::string &path, F f) {
+	reader<T>	in(path);
+	detail::run_flat<T, 1>({&detail::open_dense(in)}, nullptr, 1, [&](const std::array<T *, 1> &b, size_t n, size_t first) {
+		const VectorView<T>	block(b[0], n, tlap::detail::padded_size<T>(n));
+		f(block, first);
+	});
+}
+
+template <typename T, typename F>
+void	scan(const std::string &a, const std::string &b, F f) {
+	reader<T>	ra(a);
+	reader<T>	rb(b);
+	detail::expect_same(detail::open_dense(ra).info(), detail::open_dense(rb).info());
+	detail::run_flat<T, 2>({&ra, &rb}, nullptr, 1, [&](const std::array<T *, 2> &p, size_t n, size_t first) {
+		const VectorView<T>	x(p[0], n, tlap::detail::padded_size<T>(n));
+		const VectorView<T>	y(p[1], n, tlap::detail::padded_size<T>(n));
+		f(x, y, first);
+	});
+}
+
+template <typename T, typename F>
+void	transform(const std::string &in, const std::string &out, F f) {
+	reader<T>	r(in);
+	writer<T>	w(out, detail::open_dense(r).info().shape);
+	detail::run_flat<T, 1>({&r}, &w, 1, [&](const std::array<T *, 1> &b, size_t n, size_t first) {
+		VectorView<T>	block(b[0], n, tlap::detail::padded_size<T>(n));
+		f(block, first);
+	});
+}
+
+template <typename T, typename F>
+void	transform(const std::string &a, const std::string &b, const std::string &out, F f) {
+	reader<T>	ra(a);
+	reader<T>	rb(b);
+	detail::expect_same(detail::open_dense(ra).info(), detail::open_dense(rb).info());
+	writer<T>	w(out, ra.info().shape);
+	detail::run_flat<T, 2>({&ra, &rb}, &w, 1, [&](const std::array<T *, 2> &p, size_t n, size_t first) {
+		VectorView<T>		x(p[0], n, tlap::detail::padded_size<T>(n));
+		const VectorView<T>	y(p[1], n, tlap::detail::padded_size<T>(n));
+		f(x, y, first);
+	});
+}
+
+// rows
+
+template <typename T, typename F>
+void	scanRows(const std::string &path, F f) {
+	reader<T>	in(path);
+	detail::run_rows<T>(detail::open_dense(in), nullptr, [&](VectorView<T> &row, size_t index) {
+		f(static_cast<const VectorView<T> &>(row), index);
+	});
+}
+
+template <typename T, typename F>
+void	transformRows(const std::string &in, const std::string &out, F f) {
+	reader<T>	r(in);
+	writer<T>	w(out, detail::open_dense(r).info().shape);
+	detail::run_rows<T>(r, &w, f);
+}
+
+// reductions
+
+template <typename T, math_policy P>
+T		sum(const std::string &path) {
+	detail::accumulator<T>	acc{std::is_same<P, precise>::value};
+	scan<T>(path, [&](const VectorView<T> &block, size_t) {
+		acc.add(block.template sum<P>());
+	});
+	return acc.total;
+}
+
+template <typename T, math_policy P>
+T		dot(const std::string &a, const std::string &b) {
+	detail::accumulator<T>	acc{std::is_same<P, precise>::value};
+	scan<T>(a, b, [&](const VectorView<T> &x, const VectorView<T> &y, size_t) {
+		acc.add(x.template dot<P>(y));
+	});
+	return acc.total;
+}
+
+template <typename T, math_policy P>
+typename Vector<T>::real	norm(const std::string &path) {
+	detail::accumulator<T>	acc{std::is_same<P, precise>::value};
+	scan<T>(path, [&](const VectorView<T> &block, size_t) {
+		acc.add(block.template dot<P>(block));
+	});
+	return tlap::sqrt(static_cast<typename Vector<T>::real>(acc.total));
+}
+
+// matrices
+
+template <typename T>
+Vector<T>	gemv(const std::string &matrix, const Vector<T> &x) {
+	reader<T>	r(matrix);
+	detail::expect_row_major(r.info(), 2);
+	const size_t	m = r.info().shape[0];
+	const size_t	n = r.info().shape[1];
+	if (x.shape() != n)
+		throw std::invalid_argument("Vector size must match the matrix columns.");
+	Vector<T>	y(m);
+	if (!n)
+		return y;
+	detail::run_flat<T, 1>({&r}, nullptr, n, [&](const std::array<T *, 1> &a, size_t len, size_t first) {
+		tlap::gemv(len / n, n, T(1), a[0], n, x.data(), T(0), y.data() + first / n);
+	});
+	return y;
+}
+
+template <typename T, math_policy P>
+void	normalizeRows(const std::string &in, const std::string &out) {
+	transformRows<T>(in, out, [](VectorView<T> &row, size_t) {
+		const typename Vector<T>::real	length = row.template norm<P>();
+		if (length != 0)
+			row /= length;
+	});
+}
+
+}
@@ -0,0 +1,73 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: 16-bit floating point storage types, computed on as float
+// File version: 0.1
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include <type_traits>
+
+// half (ieee binary16: 5 exponent, 10 mantissa bits) and bfloat16 (the upper
+// half of a float: 8 exponent, 7 mantissa bits) halve the bytes of float
+// storage. they only store: every operation converts to float, and a
+// float converts back rounding to nearest even. Vector, Matrix and Tensor
+// take them as element types and compute on float packs (simd.hpp loads
+// and stores them); reductions accumulate in float and return a float, see
+// compute_t
+namespace	tlap {
+	struct	half {
+		uint16_t	bits;
+
+		half() = default;
+		constexpr half(float x);
+		constexpr operator float() const;
+		static constexpr half	fromBits(uint16_t b);
+
+		half	&operator+=(float x);
+		half	&operator-=(float x);
+		half	&operator*=(float x);
+		half	&operator/=(float x);
+	};
+
+	struct	bfloat16 {
+		uint16_t	bits;
+
+		bfloat16() = default;
+		constexpr bfloat16(float x);
+		constexpr operator float() const;
+		static constexpr bfloat16	fromBits(uint16_t b);
+
+		bfloat16	&operator+=(float x);
+		bfloat16	&operator-=(float x);
+		bfloat16	&operator*=(float x);
+		bfloat16	&operator/=(float x);
+	};
+
+	template <typename T>
+	inline constexpr bool	is_reduced_float = std::is_same<T, half>::value || std::is_same<T, bfloat16>::value;
+
+	// what Vector, Matrix and Tensor store
+	template <typename T>
+	inline constexpr bool	is_element = std::is_arithmetic<T>::value || is_reduced_float<T>;
+
+	// what a reduction over T accumulates in and returns
+	template <typename T>
+	using compute_t = std::conditional_t<is_reduced_float<T>, float, T>;
+
+	constexpr uint16_t	float_to_half(float x); // round to nearest even, nan stays a (quiet) nan
+	constexpr float		half_to_float(uint16_t h);
+	constexpr uint16_t	float_to_bfloat16(float x);
+	constexpr float		bfloat16_to_float(uint16_t h);
+
+	std::ostream	&operator<<(std::ostream &os, half h);
+	std::ostream	&operator<<(std::ostream &os, bfloat16 h);
+}
+
+template <>
+struct	std::numeric_limits<tlap::half>;
+template <>
+struct	std::numeric_limits<tlap::bfloat16>;
+
+#include "half.tpp"
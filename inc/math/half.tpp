@@ -0,0 +1,160 @@
+#pragma once
+
+#include "half.hpp"
+#include <bit>
+#include <ostream>
+
+namespace tlap {
+
+// conversions, branch-light enough for the compiler to vectorize a loop of
+// them: the subnormal cases go through one float addition
+
+constexpr uint16_t	float_to_half(float x) {
+	constexpr uint32_t	infinity = 255u << 23;
+	constexpr uint32_t	overflow = (127u + 16) << 23; // 65536, rounds to inf from 65520 on
+	constexpr uint32_t	magic = ((127u - 15) + (23 - 10) + 1) << 23; // aligns a subnormal mantissa on bit 0
+	uint32_t			u = std::bit_cast<uint32_t>(x);
+	const uint32_t		sign = (u >> 16) & 0x8000;
+	uint16_t			h;
+
+	u &= 0x7fffffff;
+	if (u >= overflow)
+		h = (u > infinity ? 0x7e00 : 0x7c00);
+	else if (u < (113u << 23)) // below 2^-14: subnormal or zero
+		h = static_cast<uint16_t>(std::bit_cast<uint32_t>(std::bit_cast<float>(u) + std::bit_cast<float>(magic)) - magic);
+	else
+		h = static_cast<uint16_t>((u + ((15u - 127) << 23) + 0xfff + ((u >> 13) & 1)) >> 13);
+	return static_cast<uint16_t>(h | sign);
+}
+
+constexpr float	half_to_float(uint16_t h) {
+	constexpr uint32_t	exponent = 0x7c00u << 13;
+	uint32_t			u = (h & 0x7fffu) << 13;
+	const uint32_t		e = u & exponent;
+
+	u += (127u - 15) << 23;
+	if (e == exponent) // inf or nan
+		u += (128u - 16) << 23;
+	else if (!e) // zero or subnormal
+		u = std::bit_cast<uint32_t>(std::bit_cast<float>(u + (1u << 23)) - std::bit_cast<float>(113u << 23));
+	return std::bit_cast<float>(u | (static_cast<uint32_t>(h & 0x8000) << 16));
+}
+
+constexpr uint16_t	float_to_bfloat16(float x) {
+	const uint32_t	u = std::bit_cast<uint32_t>(x);
+	if ((u & 0x7fffffff) > 0x7f800000)
+		return static_cast<uint16_t>((u >> 16) | 0x40);
+	return static_cast<uint16_t>((u + 0x7fff + ((u >> 16) & 1)) >> 16);
+}
+
+constexpr float	bfloat16_to_float(uint16_t h) {
+	return std::bit_cast<float>(static_cast<uint32_t>(h) << 16);
+}
+
+// half
+
+constexpr half::half(float x) : bits(float_to_half(x)) {}
+
+constexpr half::operator float() const {
+	return half_to_float(bits);
+}
+
+constexpr half	half::fromBits(uint16_t b) {
+	half h;
+	h.bits = b;
+	return h;
+}
+
+inline half	&half::operator+=(float x) { return *this = half(float(*this) + x); }
+inline half	&half::operator-=(float x) { return *this = half(float(*this) - x); }
+inline half	&half::operator*=(float x) { return *this = half(float(*this) * x); }
+inline half	&half::operator/=(float x) { return *this = half(float(*this) / x); }
+
+// bfloat16
+
+constexpr bfloat16::bfloat16(float x) : bits(float_to_bfloat16(x)) {}
+
+constexpr bfloat16::operator float() const {
+	return bfloat16_to_float(bits);
+}
+
+constexpr bfloat16	bfloat16::fromBits(uint16_t b) {
+	bfloat16 h;
+	h.bits = b;
+	return h;
+}
+
+inline bfloat16	&bfloat16::operator+=(float x) { return *this = bfloat16(float(*this) + x); }
+inline bfloat16	&bfloat16::operator-=(float x) { return *this = bfloat16(float(*this) - x); }
+inline bfloat16	&bfloat16::operator*=(float x) { return *this = bfloat16(float(*this) * x); }
+inline bfloat16	&bfloat16::operator/=(float x) { return *this = bfloat16(float(*this) / x); }
+
+inline std::ostream	&operator<<(std::ostream &os, half h) {
+	return os << static_cast<float>(h);
+}
+
+inline std::ostream	&operator<<(std::ostream &os, bfloat16 h) {
+	return os << static_cast<float>(h);
+}
+
+} // namespace tlap
+
+template <>
+struct	std::numeric_limits<tlap::half> {
+	static constexpr bool	is_specialized = true;
+	static constexpr bool	is_signed = true;
+	static constexpr bool	is_integer = false;
+	static constexpr bool	is_exact = false;
+	static constexpr bool	has_infinity = true;
+	static constexpr bool	has_quiet_NaN = true;
+	static constexpr bool	has_signaling_NaN = true;
+	static constexpr bool	is_iec559 = true;
+	static constexpr bool	is_bounded = true;
+	static constexpr int	digits = 11;
+	static constexpr int	digits10 = 3;
+	static constexpr int	max_digits10 = 5;
+	static constexpr int	radix = 2;
+	static constexpr int	min_exponent = -13;
+	static constexpr int	max_exponent = 16;
+	static constexpr float_round_style	round_style = round_to_nearest;
+
+	static constexpr tlap::half	min() { return tlap::half::fromBits(0x0400); }
+	static constexpr tlap::half	max() { return tlap::half::fromBits(0x7bff); }
+	static constexpr tlap::half	lowest() { return tlap::half::fromBits(0xfbff); }
+	static constexpr tlap::half	epsilon() { return tlap::half::fromBits(0x1400); }
+	static constexpr tlap::half	round_error() { return tlap::half::fromBits(0x3800); }
+	static constexpr tlap::half	infinity() { return tlap::half::fromBits(0x7c00); }
+	static constexpr tlap::half	quiet_NaN() { return tlap::half::fromBits(0x7e00); }
+	static constexpr tlap::half	signaling_NaN() { return tlap::half::fromBits(0x7d00); }
+	static constexpr tlap::half	denorm_min() { return tlap::half::fromBits(0x0001); }
+};
+
+template <>
+struct	std::numeric_limits<tlap::bfloat16> {
+	static constexpr bool	is_specialized = true;
+	static constexpr bool	is_signed = true;
+	static constexpr bool	is_integer = false;
+	static constexpr bool	is_exact = false;
+	static constexpr bool	has_infinity = true;
+	static constexpr bool	has_quiet_NaN = true;
+	static constexpr bool	has_signaling_NaN = true;
+	static constexpr bool	is_iec559 = false;
+	static constexpr bool	is_bounded = true;
+	static constexpr int	digits = 8;
+	static constexpr int	digits10 = 2;
+	static constexpr int	max_digits10 = 4;
+	static constexpr int	radix = 2;
+	static constexpr int	min_exponent = -125;
+	static constexpr int	max_exponent = 128;
+	static constexpr float_round_style	round_style = round_to_nearest;
+
+	static constexpr tlap::bfloat16	min() { return tlap::bfloat16::fromBits(0x0080); }
+	static constexpr tlap::bfloat16	max() { return tlap::bfloat16::fromBits(0x7f7f); }
+	static constexpr tlap::bfloat16	lowest() { return tlap::bfloat16::fromBits(0xff7f); }
+	static constexpr tlap::bfloat16	epsilon() { return tlap::bfloat16::fromBits(0x3c00); }
+	static constexpr tlap::bfloat16	round_error() { return tlap::bfloat16::fromBits(0x3f00); }
+	static constexpr tlap::bfloat16	infinity() { return tlap::bfloat16::fromBits(0x7f80); }
+	static constexpr tlap::bfloat16	quiet_NaN() { return tlap::bfloat16::fromBits(0x7fc0); }
+	static constexpr tlap::bfloat16	signaling_NaN() { return tlap::bfloat16::fromBits(0x7fa0); }
+	static constexpr tlap::bfloat16	denorm_min() { return tlap::bfloat16::fromBits(0x0001); }
+};
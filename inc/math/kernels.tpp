@@ -0,0 +1,1348 @@
+#pragma once
+
+// branch-free polynomial kernels shared by the batch and scalar math functions.
+// every kernel is written against the simd::pack interface, so the same code
+// runs on one lane (scalar tails) or on a full AVX2 / AVX-512 register.
+// kernels take the accuracy policy first, kernel::exp<fast>(v), precise by default.
+#include <cstdint>
+#include <type_traits>
+#include "../simd/simd.hpp"
+#include "policy.hpp"
+
+
+namespace tlap::kernel {
+
+template <typename V>
+using value_t = typename V::value_type;
+
+// the type a function of the precise policy runs in: float arguments of the
+// functions whose float kernels would miss 1 ulp go through the double
+// kernels instead and are rounded once (math.tpp, math_batch.tpp)
+template <typename T>
+using wide_t = std::conditional_t<std::is_same<T, float>::value, double, T>;
+
+// c0 + x * (c1 + x * (c2 + ...))
+template <typename V, typename C>
+TLAP_INLINE inline V	horner(V, C c) {
+	return V(static_cast<value_t<V>>(c));
+}
+
+template <typename V, typename C, typename... Cs>
+TLAP_INLINE inline V	horner(V x, C c, Cs... cs) {
+	return fma(horner(x, cs...), x, V(static_cast<value_t<V>>(c)));
+}
+
+template <typename P>
+inline constexpr bool	is_fast = std::is_same<P, fast>::value;
+
+// 1 / x, a / b and sqrt(x); the fast policy starts from the rcp / rsqrt
+// estimate and doubles its correct bits with each Newton step.
+// x must be finite and non-zero on the fast path
+template <typename P, typename V>
+TLAP_INLINE inline V	recip(V x) {
+	if constexpr (is_fast<P>) {
+		const V	one = value_t<V>(1);
+		V		r = rcp(x);
+
+		for (int bits = V::approx_bits; bits < std::numeric_limits<value_t<V>>::digits; bits *= 2)
+			r = fma(r, fma(-x, r, one), r);
+		return r;
+	} else
+		return V(value_t<V>(1)) / x;
+}
+
+template <typename P, typename V>
+TLAP_INLINE inline V	quot(V a, V b) {
+	if constexpr (is_fast<P>)
+		return a * recip<P>(b);
+	else
+		return a / b;
+}
+
+template <typename P, typename V>
+TLAP_INLINE inline V	rroot2(V x) {
+	if constexpr (is_fast<P>) {
+		const V	half = value_t<V>(0.5);
+		V		y = rsqrt(x);
+
+		for (int bits = V::approx_bits; bits < std::numeric_limits<value_t<V>>::digits; bits *= 2)
+			y = fma(y, fma(-half * x * y, y, half), y);
+		return y;
+	} else
+		return V(value_t<V>(1)) / sqrt(x);
+}
+
+template <typename P, typename V>
+TLAP_INLINE inline V	root2(V x) {
+	if constexpr (is_fast<P>) {
+		using L = std::numeric_limits<value_t<V>>;
+		V res = x * rroot2<P>(x);
+		res = select(x < V(value_t<V>(0)), V(L::quiet_NaN()), res);
+		return select((x == V(value_t<V>(0))) | (x == V(L::infinity())), x, res);
+	} else
+		return sqrt(x);
+}
+
+
+// exp and log
+
+// y * 2^k for an integer-valued k up to twice the exponent range: 2^k is
+// applied in two halves so that subnormal results are rounded only once
+template <typename V>
+TLAP_INLINE inline V	scale2i(V y, V k) {
+	V k1 = floor(k * V(value_t<V>(0.5)));
+	return y * pow2i(k1) * pow2i(k - k1);
+}
+
+// x = k*ln2 + r with |r| <= ln2/2, ln2 split in hi/lo (Cody-Waite),
+// exp(r) from the fdlibm rational form, 2^k built from the exponent bits.
+// 2^k through scale2i, so that subnormal results stay exact.
+// fast: 1 + r + r^2 * Q(r) with a minimax Q (degree 3 float, 8 double), no division
+template <typename P = precise, typename V>
+TLAP_INLINE inline V	exp(V x) {
+	using T = value_t<V>;
+	const V	invln2 = T(1.44269504088896338700e+00);
+	V		ln2hi, ln2lo, c, xc;
+
+	if constexpr (std::is_same<T, float>::value) {
+		ln2hi = T(6.9314575195e-01f);
+		ln2lo = T(1.4286067653e-06f);
+		xc = min(max(x, V(T(-104))), V(T(89)));
+	} else {
+		ln2hi = T(6.93147180369123816490e-01);
+		ln2lo = T(1.90821492927058770002e-10);
+		xc = min(max(x, V(T(-746))), V(T(710)));
+	}
+
+	V k = round(xc * invln2);
+	V hi = fma(-k, ln2hi, xc);
+	V lo = k * ln2lo;
+	V r = hi - lo;
+	V rr = r * r;
+	V y;
+
+	if constexpr (is_fast<P>) {
+		if constexpr (std::is_same<T, float>::value)
+			c = horner(r, 0.49998994883132458f, 0.16666523181133777f, 0.041917529687926162f, 0.008369150982490723f);
+		else
+			c = horner(r, 0.49999999999998324, 0.16666666666611557, 0.041666666668136239,
+				0.0083333333708696649, 0.0013888888516296574, 0.00019841185236791224,
+				2.4801931642534547e-05, 2.7634990545464447e-06, 2.7476824427758874e-07);
+		y = fma(rr, c, r) + V(T(1));
+	} else {
+		if constexpr (std::is_same<T, float>::value)
+			c = r - rr * horner(rr, 1.6666625440e-1f, -2.7667332906e-3f);
+		else
+			c = r - rr * horner(rr, 1.66666666666666019037e-01, -2.77777777770155933842e-03,
+				6.61375632143793436117e-05, -1.65339022054652515390e-06, 4.13813679705723846039e-08);
+		y = V(T(1)) - ((lo - (r * c) / (V(T(2)) - c)) - hi);
+	}
+	return select(isnan(x), x, scale2i(y, k));
+}
+
+// s + e == a + b exactly (Knuth two-sum, no ordering requirement)
+template <typename V>
+TLAP_INLINE inline void	two_sum(V a, V b, V &s, V &e) {
+	s = a + b;
+	V bb = s - a;
+	e = (a - (s - bb)) + (b - bb);
+}
+
+// a * b - p exactly for p = a * b rounded: one fma, or Dekker's splitting
+// when the scalar fallback has no hardware fma to rely on
+template <typename V>
+TLAP_INLINE inline V	prod_err(V a, V b, V p) {
+#ifdef __FMA__
+	return fma(a, b, -p);
+#else
+	using T = value_t<V>;
+	if constexpr (V::width > 1)
+		return fma(a, b, -p);
+	else {
+		const V	split = T((1ULL << ((std::numeric_limits<T>::digits + 1) / 2)) + 1);
+		V ca = split * a, cb = split * b;
+		V ahi = ca - (ca - a), bhi = cb - (cb - b);
+		V alo = a - ahi, blo = b - bhi;
+		return ((ahi * bhi - p) + ahi * blo + alo * bhi) + alo * blo;
+	}
+#endif
+}
+
+// x = 2^k * m with m in [sqrt(2)/2, sqrt(2)), log(m) = f - hfsq + r
+// with f = m - 1, hfsq = f^2/2, s = f / (2 + f) and r = s*(hfsq + R(s^2)),
+// R being the fdlibm minimax polynomial (7 terms double, 4 terms float).
+// fast: s from the approximate reciprocal, R refitted with 6 / 2 terms
+template <typename V>
+struct log_parts {
+	V	k, f, hfsq, r, s, R;
+};
+
+template <typename P = precise, typename V>
+TLAP_INLINE inline log_parts<V>	log_reduce(V x) {
+	using T = value_t<V>;
+	using L = std::numeric_limits<T>;
+	log_parts<V>	p;
+	V				R;
+
+	typename V::mask sub = (x < V(L::min())) & (x > V(T(0)));
+	V xs = select(sub, x * V(T(1ULL << (L::digits + 1))), x);
+	V k = getexp(xs) + select(sub, V(-T(L::digits + 1)), V(T(0)));
+	V m = getmant(xs);
+
+	typename V::mask big = m > V(T(1.41421356237309504880));
+	p.k = select(big, k + V(T(1)), k);
+	p.f = select(big, m * V(T(0.5)), m) - V(T(1));
+
+	V s = quot<P>(p.f, V(T(2)) + p.f);
+	V z = s * s;
+	p.s = s;
+	V w = z * z;
+	if constexpr (is_fast<P> && std::is_same<T, float>::value)
+		R = z * horner(z, 0.66653849933407638f, 0.41296188330105665f);
+	else if constexpr (is_fast<P>)
+		R = z * horner(z, 0.66666666666610941, 0.40000000046018852, 0.28571417507308017,
+			0.22223377653934645, 0.18122673153735819, 0.16838378271839669);
+	else if constexpr (std::is_same<T, float>::value)
+		R = z * horner(w, 0.66666662693f, 0.28498786688f) + w * horner(w, 0.40000972152f, 0.24279078841f);
+	else
+		R = z * horner(w, 6.666666666666735130e-01, 2.857142874366239149e-01,
+				1.818357216161805012e-01, 1.479819860511658591e-01)
+			+ w * horner(w, 3.999999999940941908e-01, 2.222219843214978396e-01, 1.531383769920937332e-01);
+	p.hfsq = V(T(0.5)) * p.f * p.f;
+	p.r = s * (p.hfsq + R);
+	p.R = R;
+	return p;
+}
+
+// log(0) = -inf, log(inf) = inf, log(x < 0) = log(nan) = nan
+template <typename V>
+TLAP_INLINE inline V	log_special(V x, V res) {
+	using T = value_t<V>;
+	using L = std::numeric_limits<T>;
+
+	res = select(x == V(L::infinity()), x, res);
+	res = select(x == V(T(0)), V(-L::infinity()), res);
+	return select((x < V(T(0))) | isnan(x), V(L::quiet_NaN()), res);
+}
+
+// f - hfsq + r as an unevaluated sum hi + lo
+template <typename V>
+TLAP_INLINE inline void	log1p_split(const log_parts<V> &p, V &hi, V &lo) {
+	V hfsq_err = prod_err(p.f * V(value_t<V>(0.5)), p.f, p.hfsq);
+
+	hi = p.f - p.hfsq;
+	lo = (((p.f - hi) - p.hfsq) - hfsq_err) + p.r;
+}
+
+template <typename P = precise, typename V>
+TLAP_INLINE inline V	ln(V x) {
+	using T = value_t<V>;
+	log_parts<V>	p = log_reduce<P>(x);
+	V				ln2hi, ln2lo;
+
+	if constexpr (std::is_same<T, float>::value) {
+		ln2hi = T(6.9313812256e-01f);
+		ln2lo = T(9.0580006145e-06f);
+	} else {
+		ln2hi = T(6.93147180369123816490e-01);
+		ln2lo = T(1.90821492927058770002e-10);
+	}
+	V res = p.k * ln2hi - ((p.hfsq - (p.r + p.k * ln2lo)) - p.f);
+	return log_special(x, res);
+}
+
+// log2(x) = k + log(m) / ln2, the product kept in two parts through fma
+// (fast: a single product)
+template <typename P = precise, typename V>
+TLAP_INLINE inline V	log2(V x) {
+	using T = value_t<V>;
+
+	if constexpr (is_fast<P>)
+		return tlap::kernel::ln<P>(x) * V(T(1.44269504088896340736));
+
+	log_parts<V>	p = log_reduce(x);
+	V				c, clo, hi, lo, s, e;
+
+	if constexpr (std::is_same<T, float>::value) {
+		c = T(1.4426950216293335f);
+		clo = T(1.925963033500011e-08f);
+	} else {
+		c = T(1.4426950408889634);
+		clo = T(2.0355273740931033e-17);
+	}
+	log1p_split(p, hi, lo);
+	V y = hi * c;
+	V yerr = prod_err(hi, c, y) + fma(lo, c, hi * clo);
+	two_sum(p.k, y, s, e);
+	return log_special(x, s + (e + yerr));
+}
+
+// log10(x) = k*log10(2) + log(m) / ln10, both products kept in two parts
+// (fast: a single product)
+template <typename P = precise, typename V>
+TLAP_INLINE inline V	log10(V x) {
+	using T = value_t<V>;
+
+	if constexpr (is_fast<P>)
+		return tlap::kernel::ln<P>(x) * V(T(0.43429448190325182765));
+
+	log_parts<V>	p = log_reduce(x);
+	V				c, clo, l2, l2lo, hi, lo, s, e;
+
+	if constexpr (std::is_same<T, float>::value) {
+		c = T(0.4342944920063019f);
+		clo = T(-1.0103049952192578e-08f);
+		l2 = T(0.3010300099849701f);
+		l2lo = T(-1.432098883924482e-08f);
+	} else {
+		c = T(0.4342944819032518);
+		clo = T(1.098319650216765e-17);
+		l2 = T(0.3010299956639812);
+		l2lo = T(-2.8037281277851704e-18);
+	}
+	log1p_split(p, hi, lo);
+	V y = hi * c;
+	V yerr = prod_err(hi, c, y) + fma(lo, c, hi * clo);
+	V a = p.k * l2;
+	V aerr = prod_err(p.k, l2, a) + p.k * l2lo;
+	two_sum(a, y, s, e);
+	return log_special(x, s + (e + (yerr + aerr)));
+}
+
+// log(x) as hi + lo to about 2^-67 relative, for the precise pow, root and
+// log(x, base): with s = f / (2 + f), log(m) = 2s + 2s^3/3 + 2s^5/5 + s^7 T(s^2),
+// the atanh series to s^25 (|s| <= 0.1716), s, s^3, s^5 and k*ln2 kept in two
+// parts. the fdlibm R(s^2) of log_reduce is only good to 2^-58, which pow
+// would amplify by up to |n * log(x)|
+template <typename V>
+TLAP_INLINE inline void	ln_split(V x, V &hi, V &lo) {
+	using T = value_t<V>;
+	log_parts<V>	p = log_reduce(x);
+	V				d, dlo, sl, z, zl, c, cl, b, bl, f, fl, g, gl, t, e, e2, e3;
+	const V			ln2hi = T(6.93147180369123816490e-01);
+	const V			ln2lo = T(1.90821492927058770002e-10);
+	const V			two3 = T(0.6666666666666666);
+	const V			two3lo = T(3.700743415417188e-17);
+	const V			two5 = T(0.4);
+	const V			two5lo = T(-2.2204460492503132e-17);
+
+	static_assert(std::is_same<T, double>::value, "ln_split is only tuned for double");
+	two_sum(V(T(2)), p.f, d, dlo);
+	V sh = p.s;
+	V r = sh * d;
+	sl = (((p.f - r) - prod_err(sh, d, r)) - sh * dlo) / d;
+	z = sh * sh;
+	zl = prod_err(sh, sh, z) + V(T(2)) * sh * sl;
+	c = z * sh;
+	cl = prod_err(z, sh, c) + (zl * sh + z * sl);
+	b = c * two3;
+	bl = prod_err(c, two3, b) + (cl * two3 + c * two3lo);
+	f = c * z;
+	fl = prod_err(c, z, f) + (cl * z + c * zl);
+	g = f * two5;
+	gl = prod_err(f, two5, g) + (fl * two5 + f * two5lo);
+	V tail = f * z * horner(z, 0.2857142857142857, 0.2222222222222222, 0.18181818181818182,
+		0.15384615384615385, 0.13333333333333333, 0.11764705882352941, 0.10526315789473684,
+		0.09523809523809523, 0.08695652173913043, 0.08);
+
+	two_sum(p.k * ln2hi, V(T(2)) * sh, t, e);
+	two_sum(t, b, t, e2);
+	two_sum(t, g, t, e3);
+	e = ((e + e2) + e3) + ((((V(T(2)) * sl + bl) + gl) + tail) + p.k * ln2lo);
+	two_sum(t, e, hi, lo);
+}
+
+// exp(x) - 1 without cancellation near 0: exp(r) - 1 from the same rational
+// form as exp, then 2^k * (exp(r) - 1) + (2^k - 1) while 2^k - 1 is exact
+template <typename V>
+TLAP_INLINE inline V	expm1(V x) {
+	using T = value_t<V>;
+	using L = std::numeric_limits<T>;
+	const V	invln2 = T(1.44269504088896338700e+00);
+	V		ln2hi, ln2lo, c, xc;
+
+	if constexpr (std::is_same<T, float>::value) {
+		ln2hi = T(6.9314575195e-01f);
+		ln2lo = T(1.4286067653e-06f);
+		xc = min(max(x, V(T(-30))), V(T(89)));
+	} else {
+		ln2hi = T(6.93147180369123816490e-01);
+		ln2lo = T(1.90821492927058770002e-10);
+		xc = min(max(x, V(T(-60))), V(T(710)));
+	}
+
+	V k = round(xc * invln2);
+	V hi = fma(-k, ln2hi, xc);
+	V lo = k * ln2lo;
+	V r = hi - lo;
+	V rr = r * r;
+
+	if constexpr (std::is_same<T, float>::value)
+		c = r - rr * horner(rr, 1.6666625440e-1f, -2.7667332906e-3f);
+	else
+		c = r - rr * horner(rr, 1.66666666666666019037e-01, -2.77777777770155933842e-03,
+			6.61375632143793436117e-05, -1.65339022054652515390e-06, 4.13813679705723846039e-08);
+
+	V em = hi - (lo - (r * c) / (V(T(2)) - c));
+	V t = pow2i(min(k, V(T(L::digits + 2))));
+	V small = fma(em, t, t - V(T(1)));
+	V large = scale2i(em + V(T(1)), k);
+	V res = select(k > V(T(L::digits + 1)), large, small);
+	return select(isnan(x), x, res);
+}
+
+
+// e^(x + xl) = 2^k * (hi + lo) to about 2^-62 relative, for the precise double
+// functions that cannot afford the rounding of a plain exp (pow, root, the
+// hyperbolic ones): r = x + xl - k*ln2 is kept in two parts and e^r - 1
+// comes from its Taylor series to r^14 (< 2^-63 for |r| <= ln2/2), with
+// r + r^2/2 + r^3/6 summed exactly. hi + lo is in [sqrt(1/2), sqrt(2)], x
+// is clamped to [-746, 711] and |xl| must stay below ulp(x)
+template <typename V>
+TLAP_INLINE inline void	exp_split(V x, V xl, V &k, V &hi, V &lo) {
+	using T = value_t<V>;
+	const V	ln2hi = T(6.93147180369123816490e-01);
+	const V	ln2lo = T(1.90821492927058770002e-10);
+	const V	sixth = T(0.16666666666666666);
+	const V	sixthlo = T(9.25185853854297e-18);
+	V		r, rl, e, e2, e3, s;
+
+	static_assert(std::is_same<T, double>::value, "exp_split is only tuned for double");
+	V xc = min(max(x, V(T(-746))), V(T(711)));
+	k = round(xc * V(T(1.44269504088896338700e+00)));
+	V a = fma(-k, ln2hi, xc);
+	V b = k * ln2lo;
+	two_sum(a, -b, r, e);
+	rl = (e - prod_err(k, ln2lo, b)) + xl;
+	two_sum(r, rl, r, rl);
+
+	V rr = r * r;
+	V rrl = prod_err(r, r, rr);
+	V h2 = V(T(0.5)) * rr;
+	V r3 = rr * r;
+	V r3l = prod_err(rr, r, r3) + rrl * r;
+	V c3 = r3 * sixth;
+	V c3l = prod_err(r3, sixth, c3) + (r3l * sixth + r3 * sixthlo);
+	V c = rr * rr * horner(r, 0.041666666666666664, 0.008333333333333333, 0.001388888888888889,
+		0.0001984126984126984, 2.48015873015873e-05, 2.7557319223985893e-06, 2.755731922398589e-07,
+		2.505210838544172e-08, 2.08767569878681e-09, 1.6059043836821613e-10, 1.1470745597729725e-11);
+	two_sum(r, h2, s, e);
+	two_sum(s, c3, s, e2);
+	two_sum(s, c, s, e3);
+	e = ((e + e2) + e3) + ((V(T(0.5)) * rrl + c3l) + fma(rl, r + h2, rl));
+	two_sum(V(T(1)), s, hi, lo);
+	lo = lo + e;
+}
+
+// (ah + al) / (bh + bl) as hi + lo
+template <typename V>
+TLAP_INLINE inline void	quot_split(V ah, V al, V bh, V bl, V &hi, V &lo) {
+	hi = ah / bh;
+	V p = hi * bh;
+	lo = (((ah - p) - prod_err(hi, bh, p)) + (al - hi * bl)) / bh;
+}
+
+
+// hyperbolic, all on a single expm1: for |x| close to overflow the argument
+// is halved and the result squared, exp(|x|) / 2 = exp(|x| / 2)^2 / 2.
+// precise double goes through exp_split instead (hyp_split below)
+
+template <typename T>
+constexpr T	hyp_big() {
+	if constexpr (std::is_same<T, float>::value)
+		return T(88);
+	else
+		return T(709);
+}
+
+// fast: odd minimax polynomial below 1 (3 terms float, 6 double), above it
+// (e^|x| - e^-|x|) / 2 from h = exp(|x| / 2) and its approximate reciprocal
+template <typename V>
+TLAP_INLINE inline V	sinh_poly(V x) {
+	V z = x * x;
+
+	if constexpr (std::is_same<value_t<V>, float>::value)
+		return fma(x * z, horner(z, 0.16666676499096286f, 0.0083314879210765278f, 0.00020294073176205474f), x);
+	else
+		return fma(x * z, horner(z, 0.16666666666666663, 0.0083333333333398783, 0.00019841269826739692,
+			2.7557328029868314e-06, 2.5050017447350361e-08, 1.6270710746330791e-10), x);
+}
+
+// h = exp(|x| / 2), r = 1 / h (r is not needed past 2^32)
+template <typename P, typename V>
+TLAP_INLINE inline void	hyp_halves(V ax, V &h, V &r) {
+	using T = value_t<V>;
+	h = tlap::kernel::exp<P>(ax * V(T(0.5)));
+	r = recip<P>(min(h, V(T(4294967296.0))));
+}
+
+// precise double: e^|x| = 2^k * M from exp_split and 2^-2k / M, both in two
+// parts, so that sinh = 2^(k-1) * (M - 2^-2k / M) keeps the low part of M
+// through the cancellation of small |x|, and cosh = 2^(k-1) * (M + 2^-2k / M)
+template <typename V>
+TLAP_INLINE inline void	hyp_split(V ax, V &k, V &mh, V &ml, V &ih, V &il) {
+	using T = value_t<V>;
+	exp_split(ax, V(T(0)), k, mh, ml);
+	quot_split(pow2i(max(V(T(-2)) * k, V(T(-1000)))), V(T(0)), mh, ml, ih, il);
+}
+
+template <typename P = precise, typename V>
+TLAP_INLINE inline V	sinh(V x) {
+	using T = value_t<V>;
+	V ax = abs(x);
+
+	if constexpr (is_fast<P>) {
+		V h, r;
+		hyp_halves<P>(ax, h, r);
+		V big = (V(T(0.5)) * h) * h - (V(T(0.5)) * r) * r;
+		return select(ax < V(T(1)), sinh_poly(x), copysign(big, x));
+	} else if constexpr (std::is_same<T, double>::value) {
+		V k, mh, ml, ih, il, s, e;
+		hyp_split(ax, k, mh, ml, ih, il);
+		two_sum(mh, -ih, s, e);
+		V res = scale2i(s + (e + (ml - il)), k - V(T(1)));
+		return select(isnan(x), x, copysign(res, x));
+	}
+
+	typename V::mask big = ax > V(hyp_big<T>());
+	V t = tlap::kernel::expm1(select(big, ax * V(T(0.5)), ax));
+	V w = t + V(T(1));
+	V res = select(big, V(T(0.5)) * w * w, V(T(0.5)) * (t + t / w));
+	return copysign(res, x);
+}
+
+template <typename P = precise, typename V>
+TLAP_INLINE inline V	cosh(V x) {
+	using T = value_t<V>;
+	V ax = abs(x);
+
+	if constexpr (is_fast<P>) {
+		V h, r;
+		hyp_halves<P>(ax, h, r);
+		return (V(T(0.5)) * h) * h + (V(T(0.5)) * r) * r;
+	} else if constexpr (std::is_same<T, double>::value) {
+		V k, mh, ml, ih, il, s, e;
+		hyp_split(ax, k, mh, ml, ih, il);
+		two_sum(mh, ih, s, e);
+		return select(isnan(x), x, scale2i(s + (e + (ml + il)), k - V(T(1))));
+	}
+
+	typename V::mask big = ax > V(hyp_big<T>());
+	V t = tlap::kernel::expm1(select(big, ax * V(T(0.5)), ax));
+	V w = t + V(T(1));
+	V res = select(ax < V(T(0.34657359027997265)), V(T(1)) + (t * t) / (w + w), V(T(0.5)) * w + V(T(0.5)) / w);
+	return select(big, V(T(0.5)) * w * w, res);
+}
+
+// fast: sinh(x) / sqrt(1 + sinh(x)^2), |x| clamped where tanh rounds to 1.
+// precise double: (E - 1) / (E + 1) with E = e^2|x| = 2^k * M, the numerator,
+// the denominator and the quotient all in two parts
+template <typename P = precise, typename V>
+TLAP_INLINE inline V	tanh(V x) {
+	using T = value_t<V>;
+	V ax = abs(x);
+
+	if constexpr (is_fast<P>) {
+		V s = tlap::kernel::sinh<P>(min(ax, V(T(std::is_same<T, float>::value ? 9 : 20))));
+		return copysign(s * rroot2<P>(fma(s, s, V(T(1)))), x);
+	} else if constexpr (std::is_same<T, double>::value) {
+		V k, mh, ml, nh, nl, dh, dl, qh, ql, e;
+		exp_split(V(T(2)) * min(ax, V(T(20))), V(T(0)), k, mh, ml);
+		V t = pow2i(k);
+		mh = mh * t;
+		ml = ml * t;
+		two_sum(mh, V(T(-1)), nh, e);
+		nl = e + ml;
+		two_sum(mh, V(T(1)), dh, e);
+		dl = e + ml;
+		quot_split(nh, nl, dh, dl, qh, ql);
+		return select(isnan(x), x, copysign(qh + ql, x));
+	}
+
+	typename V::mask small = ax < V(T(1));
+	V t = tlap::kernel::expm1(select(small, V(T(-2)) * ax, V(T(2)) * ax));
+	V res = select(small, -t / (t + V(T(2))), V(T(1)) - V(T(2)) / (t + V(T(2))));
+	return copysign(res, x);
+}
+
+
+// trigonometry
+
+// largest |x| for which the Cody-Waite reduction below is exact; bigger
+// arguments go through reduce_pio2_large (Payne-Hanek)
+template <typename T>
+constexpr T	trig_limit() {
+	if constexpr (std::is_same<T, float>::value)
+		return T(8192);
+	else
+		return T(823549.6);
+}
+
+// x = n*pi/2 + r with |r| <= pi/4, q = n mod 4. pi/2 is split in parts with
+// short mantissas so that n * part is exact even without hardware fma
+template <typename V>
+TLAP_INLINE inline void	reduce_pio2(V x, V &r, V &q) {
+	using T = value_t<V>;
+	V n = round(x * V(T(6.36619772367581382433e-01)));
+
+	if constexpr (std::is_same<T, float>::value)
+		r = fma(-n, V(T(6.123234262925839e-17f)), fma(-n, V(T(2.5632829192545614e-12f)),
+			fma(-n, V(T(7.549533620476723e-08f)), fma(-n, V(T(4.837512969970703125e-4f)),
+			fma(-n, V(T(1.5703125f)), x)))));
+	else
+		r = fma(-n, V(T(2.02226624879595063154e-21)),
+			fma(-n, V(T(6.07710050630396597660e-11)), fma(-n, V(T(1.57079632673412561417e+00)), x)));
+	q = n - V(T(4)) * floor(n * V(T(0.25)));
+}
+
+// x = n*pi/2 + rh + rl for the precise double kernels: pi/2 in four parts,
+// the first three of 33 bits so that n times each is exact below trig_limit
+// (fdlibm pio2_1, pio2_2, pio2_3 and pio2_3t), the differences summed exactly
+template <typename V>
+TLAP_INLINE inline void	reduce_pio2_split(V x, V &rh, V &rl, V &q) {
+	using T = value_t<V>;
+	V n = round(x * V(T(6.36619772367581382433e-01)));
+	V e1, e2;
+
+	two_sum(fma(-n, V(T(1.57079632673412561417e+00)), x), -n * V(T(6.07710050630396597660e-11)), rh, e1);
+	two_sum(rh, -n * V(T(2.02226624871116645580e-21)), rh, e2);
+	rl = (e1 + e2) - n * V(T(8.47842766036889956997e-32));
+	two_sum(rh, rl, rh, rl);
+	q = n - V(T(4)) * floor(n * V(T(0.25)));
+}
+
+// bits of 2/pi, enough for the largest double exponent
+inline constexpr std::uint64_t	two_over_pi[] = {
+	0xA2F9836E4E441529, 0xFC2757D1F534DDC0, 0xDB6295993C439041, 0xFE5163ABDEBBC561,
+	0xB7246E3A424DD2E0, 0x06492EEA09D1921C, 0xFE1DEB1CB129A73E, 0xE88235F52EBB4484,
+	0xE99C7026B45F7E41, 0x3991D639835339F4, 0x9C845F8BBDF9283B, 0x1FF897FFDE05980F,
+	0xEF2F118B5A0A6D1F, 0x6D367ECF27CB09B7, 0x4F463F669E5FEA2D, 0x7527BAC7EBE5F17B,
+	0x3D0739F78A5292EA, 0x6BFB5FB11F8D5D08, 0x56033046FC7B6BAB, 0xF0CFBC209AF4361D,
+};
+
+// 64 bits of 2/pi starting at bit pos (bit 0 is the first bit after the point),
+// bits before the point are 0
+inline std::uint64_t	two_over_pi_bits(int pos) {
+	constexpr int	words = sizeof(two_over_pi) / sizeof(two_over_pi[0]);
+	int				w = (pos >= 0 ? pos / 64 : -((63 - pos) / 64));
+	int				sh = pos - 64 * w;
+	auto			word = [](int i) { return (i >= 0 && i < words ? two_over_pi[i] : std::uint64_t(0)); };
+
+	if (sh == 0)
+		return word(w);
+	return (word(w) << sh) | (word(w + 1) >> (64 - sh));
+}
+
+// Payne-Hanek reduction of a finite x: x * 2/pi is only needed modulo 4, so
+// the bits of 2/pi worth more than 4 once multiplied by x are skipped and
+// a 192-bit window of the rest is multiplied by the 53-bit mantissa of x.
+// the top 2 bits of the product are the quadrant, the next 128 the fraction,
+// x = q*pi/2 + rh + rl
+inline void	reduce_pio2_large(double x, double &rh, double &rl, double &q) {
+	using u128 = unsigned __int128;
+	std::uint64_t	bits = std::bit_cast<std::uint64_t>(x);
+	int				e = static_cast<int>((bits >> 52) & 0x7FF);
+	std::uint64_t	m = bits & ((std::uint64_t(1) << 52) - 1);
+
+	if (e == 0)
+		e = 1;
+	else
+		m |= std::uint64_t(1) << 52;
+	e -= 1075;	// |x| = m * 2^e
+
+	int				pos = e - 2;
+	std::uint64_t	w0 = two_over_pi_bits(pos);
+	std::uint64_t	w1 = two_over_pi_bits(pos + 64);
+	std::uint64_t	w2 = two_over_pi_bits(pos + 128);
+
+	// m * (w0, w1, w2) modulo 2^192
+	u128			p2 = u128(m) * w2;
+	u128			p1 = u128(m) * w1 + std::uint64_t(p2 >> 64);
+	std::uint64_t	hi = m * w0 + std::uint64_t(p1 >> 64);
+	std::uint64_t	mid = std::uint64_t(p1);
+	std::uint64_t	lo = std::uint64_t(p2);
+
+	unsigned		quad = unsigned(hi >> 62);
+	u128			f = (u128((hi << 2) | (mid >> 62)) << 64) | ((mid << 2) | (lo >> 62));
+	double			sign = 1;
+
+	if (f >> 127) {		// fraction >= 1/2, round to the next quadrant
+		f = -f;
+		quad += 1;
+		sign = -1;
+	}
+	std::uint64_t	fhi = std::uint64_t(f >> 64);
+	double			dhi = double(fhi);
+	double			dlo = double(std::int64_t(fhi - std::uint64_t(dhi))) + double(std::uint64_t(f)) * 0x1p-64;
+
+	// (dhi + dlo) * 2^-64 * pi/2 in two parts
+	using S = simd::pack<double, simd::isa::scalar>;
+	const double	pio2_hi = 1.57079632679489655800e+00;
+	const double	pio2_lo = 6.12323399573676603587e-17;
+	dhi *= 0x1p-64;
+	dlo *= 0x1p-64;
+	double			rhi = dhi * pio2_hi;
+	double			rlo = prod_err(S(dhi), S(pio2_hi), S(rhi)).v + (dhi * pio2_lo + dlo * pio2_hi);
+
+	rh = rhi + rlo;
+	rl = rlo - (rh - rhi);
+	if (std::signbit(x)) {
+		sign = -sign;
+		quad = 4 - quad;
+	}
+	rh *= sign;
+	rl *= sign;
+	q = double(quad & 3);
+}
+
+// sin and cos of |r| <= pi/4
+template <typename V>
+TLAP_INLINE inline V	sin_poly(V r) {
+	using T = value_t<V>;
+	V z = r * r;
+
+	if constexpr (std::is_same<T, float>::value)
+		return fma(r * z, horner(z, -1.6666654611e-1f, 8.3321608736e-3f, -1.9515295891e-4f), r);
+	else
+		return fma(r * z, horner(z, -1.66666666666666324348e-01, 8.33333333332248946124e-03,
+			-1.98412698298579493134e-04, 2.75573137070700676789e-06,
+			-2.50507602534068634195e-08, 1.58969099521155010221e-10), r);
+}
+
+// fast: minimax refit with one term less (2 float, 5 double), no compensation
+template <typename P = precise, typename V>
+TLAP_INLINE inline V	cos_poly(V r) {
+	using T = value_t<V>;
+	V z = r * r;
+
+	if constexpr (is_fast<P> && std::is_same<T, float>::value)
+		return fma(z * z, horner(z, 0.04166432631674602f, -0.0013698974819040268f), fma(z, V(T(-0.5)), V(T(1))));
+	else if constexpr (is_fast<P>)
+		return fma(z * z, horner(z, 0.041666666666666276, -0.0013888888888116098, 2.4801585806655827e-05,
+			-2.7556499705438553e-07, 2.0709346752523995e-09), fma(z, V(T(-0.5)), V(T(1))));
+	else if constexpr (std::is_same<T, float>::value)
+		return fma(z * z, horner(z, 4.166664568298827e-2f, -1.388731625493765e-3f, 2.443315711809948e-5f),
+			fma(z, V(T(-0.5)), V(T(1))));
+	else {
+		V hz = V(T(0.5)) * z;
+		V w = V(T(1)) - hz;
+		V p = horner(z, 4.16666666666666019037e-02, -1.38888888888741095749e-03,
+			2.48015872894767294178e-05, -2.75573143513906633035e-07,
+			2.08757232129817482790e-09, -1.13596475577881948265e-11);
+		return w + (((V(T(1)) - w) - hz) + z * z * p);
+	}
+}
+
+// fdlibm __kernel_sin and __kernel_cos: sin and cos of x + y for |x| <= pi/4
+// and the reduction tail y, double only
+template <typename V>
+TLAP_INLINE inline V	sin_tail(V x, V y) {
+	using T = value_t<V>;
+	V z = x * x;
+	V v = z * x;
+	V r = horner(z, 8.33333333332248946124e-03, -1.98412698298579493134e-04, 2.75573137070700676789e-06,
+		-2.50507602534068634195e-08, 1.58969099521155010221e-10);
+	return x - ((z * (V(T(0.5)) * y - v * r) - y) - v * V(T(-1.66666666666666324348e-01)));
+}
+
+template <typename V>
+TLAP_INLINE inline V	cos_tail(V x, V y) {
+	using T = value_t<V>;
+	V z = x * x;
+	V hz = V(T(0.5)) * z;
+	V w = V(T(1)) - hz;
+	V p = horner(z, 4.16666666666666019037e-02, -1.38888888888741095749e-03,
+		2.48015872894767294178e-05, -2.75573143513906633035e-07,
+		2.08757232129817482790e-09, -1.13596475577881948265e-11);
+	return w + (((V(T(1)) - w) - hz) + (z * z * p - x * y));
+}
+
+// fdlibm __kernel_tan: tan(x + y) for the even quadrants, -1 / tan(x + y) for
+// the odd ones. |x| >= 0.6744 goes through tan(pi/4 - x), and the odd
+// quotient -1 / (x + r) is corrected by its exact residual (fdlibm truncates
+// the low word of both sides instead)
+template <typename V>
+TLAP_INLINE inline V	tan_tail(V x, V y, typename V::mask odd) {
+	using T = value_t<V>;
+	const V	one = T(1);
+	typename V::mask big = abs(x) >= V(T(0.67434));
+	V sgn = select(big & signbit(x), V(T(-1)), one);
+
+	x = x * sgn;
+	y = y * sgn;
+	x = select(big, (V(T(7.85398163397448278999e-01)) - x) + (V(T(3.06161699786838301793e-17)) - y), x);
+	y = select(big, V(T(0)), y);
+
+	V z = x * x;
+	V w = z * z;
+	V r = horner(w, 1.33333333333201242699e-01, 2.18694882948595424599e-02, 3.59207910759131235356e-03,
+		5.88041240820264096874e-04, 7.81794442939557092300e-05, -1.85586374855275456654e-05);
+	V v = z * horner(w, 5.39682539762260521377e-02, 8.86323982359930005737e-03, 1.45620945432529025516e-03,
+		2.46463134818469906812e-04, 7.14072491382608190305e-05, 2.59073051863633712884e-05);
+	V s = z * x;
+	r = y + z * (s * (r + v) + y);
+	r = r + V(T(3.33333333333334091986e-01)) * s;
+	w = x + r;
+
+	V iy = select(odd, -one, one);
+	V far = sgn * (iy - V(T(2)) * (x - (w * w / (w + iy) - r)));
+	// a (1 + rho) = -1 / (w + wl) with a = -1 / w, rho = 1 + a * (w + wl)
+	V wl = r - (w - x);
+	V a = -one / w;
+	V aw = a * w;
+	V rho = ((one + aw) + prod_err(a, w, aw)) + a * wl;
+	return select(big, far, select(odd, fma(a, rho, a), w));
+}
+
+// sin and cos of the reduced argument and the quadrant q of x, from the
+// fdlibm kernels and the reduction tail for precise double
+template <typename P, typename V>
+TLAP_INLINE inline void	sincos_reduced(V x, V &s, V &c, V &q) {
+	if constexpr (!is_fast<P> && std::is_same<value_t<V>, double>::value) {
+		V rh, rl;
+		reduce_pio2_split(x, rh, rl, q);
+		s = sin_tail(rh, rl);
+		c = cos_tail(rh, rl);
+	} else {
+		V r;
+		reduce_pio2(x, r, q);
+		s = sin_poly(r);
+		c = cos_poly<P>(r);
+	}
+}
+
+// sin(x), cos(x) and tan(x) from sin(r), cos(r) and the quadrant q of x
+template <typename V>
+TLAP_INLINE inline V	sin_quadrant(V s, V c, V q) {
+	using T = value_t<V>;
+	V res = select((q == V(T(1))) | (q == V(T(3))), c, s);
+	return select(q >= V(T(2)), -res, res);
+}
+
+template <typename V>
+TLAP_INLINE inline V	cos_quadrant(V s, V c, V q) {
+	using T = value_t<V>;
+	V res = select((q == V(T(1))) | (q == V(T(3))), s, c);
+	return select((q == V(T(1))) | (q == V(T(2))), -res, res);
+}
+
+template <typename P = precise, typename V>
+TLAP_INLINE inline V	tan_quadrant(V s, V c, V q) {
+	using T = value_t<V>;
+	typename V::mask odd = (q == V(T(1))) | (q == V(T(3)));
+	return quot<P>(select(odd, -c, s), select(odd, s, c));
+}
+
+// lanes with |x| > trig_limit are wrong here, see the *_large versions
+template <typename P = precise, typename V>
+TLAP_INLINE inline V	sin(V x) {
+	V s, c, q;
+	sincos_reduced<P>(x, s, c, q);
+	return select(x == V(value_t<V>(0)), x, sin_quadrant(s, c, q));
+}
+
+template <typename P = precise, typename V>
+TLAP_INLINE inline V	cos(V x) {
+	V s, c, q;
+	sincos_reduced<P>(x, s, c, q);
+	return cos_quadrant(s, c, q);
+}
+
+template <typename P = precise, typename V>
+TLAP_INLINE inline V	tan(V x) {
+	using T = value_t<V>;
+	V r, q, res;
+
+	if constexpr (!is_fast<P> && std::is_same<T, double>::value) {
+		V rl;
+		reduce_pio2_split(x, r, rl, q);
+		res = tan_tail(r, rl, (q == V(T(1))) | (q == V(T(3))));
+	} else {
+		reduce_pio2(x, r, q);
+		res = tan_quadrant<P>(sin_poly(r), cos_poly<P>(r), q);
+	}
+	return select(x == V(T(0)), x, res);
+}
+
+// one reduction and one pair of polynomials for both results
+template <typename P = precise, typename V>
+TLAP_INLINE inline void	sincos(V x, V &s, V &c) {
+	V sr, cr, q;
+	sincos_reduced<P>(x, sr, cr, q);
+	s = select(x == V(value_t<V>(0)), x, sin_quadrant(sr, cr, q));
+	c = cos_quadrant(sr, cr, q);
+}
+
+// one lane with |x| > trig_limit: Payne-Hanek reduction, then the fdlibm
+// double kernels (float arguments included, their result is rounded once).
+// this path is rare enough to stay precise under every policy
+template <typename T>
+inline void	sincos_large(T x, T &s, T &c) {
+	using S = simd::pack<double, simd::isa::scalar>;
+	double	rh, rl, q;
+
+	if (!std::isfinite(x)) {
+		s = c = x - x;
+		return;
+	}
+	reduce_pio2_large(double(x), rh, rl, q);
+	S sr = sin_tail(S(rh), S(rl));
+	S cr = cos_tail(S(rh), S(rl));
+	s = T(sin_quadrant(sr, cr, S(q)).v);
+	c = T(cos_quadrant(sr, cr, S(q)).v);
+}
+
+template <typename T>
+T	sin_large(T x) {
+	T s, c;
+	sincos_large(x, s, c);
+	return s;
+}
+
+template <typename T>
+T	cos_large(T x) {
+	T s, c;
+	sincos_large(x, s, c);
+	return c;
+}
+
+template <typename T>
+T	tan_large(T x) {
+	using S = simd::pack<double, simd::isa::scalar>;
+	double	rh, rl, q;
+
+	if (!std::isfinite(x))
+		return x - x;
+	reduce_pio2_large(double(x), rh, rl, q);
+	return T(tan_tail(S(rh), S(rl), S::mask{q == 1 || q == 3}).v);
+}
+
+// pi/2 = hi + lo in the precision of V
+template <typename V>
+TLAP_INLINE inline void	pio2_split(V &hi, V &lo) {
+	if constexpr (std::is_same<value_t<V>, float>::value) {
+		hi = 1.5707963705e+00f;
+		lo = -4.3711390063e-08f;
+	} else {
+		hi = 1.57079632679489655800e+00;
+		lo = 6.12323399573676603587e-17;
+	}
+}
+
+// asin(|x|) = |x| + |x|*R(x^2) for |x| < 1/2, pi/2 - 2*asin(sqrt((1 - |x|)/2))
+// above. returns the asin of the reduced argument (u + u*R) and the mask of
+// the lanes that need the pi/2 - 2*a reconstruction. R is the fdlibm
+// rational approximation for double, the Cephes polynomial for float.
+// c is the rounding error of u = sqrt(t), used to keep the double result exact,
+// and pi/2 - 2u is summed exactly: 2u is as large as the result.
+// fast: c = 0, approximate sqrt and division, 4-term float polynomial
+template <typename P = precise, typename V>
+TLAP_INLINE inline V	asin_reduced(V ax, typename V::mask &big, V &u, V &c) {
+	using T = value_t<V>;
+	big = ax > V(T(0.5));
+	V t = select(big, (V(T(1)) - ax) * V(T(0.5)), ax * ax);
+	V s = root2<P>(t);
+	u = select(big, s, ax);
+	if constexpr (is_fast<P>)
+		c = T(0);
+	else
+		c = select(big & (t > V(T(0))), ((t - s * s) - prod_err(s, s, s * s)) / (s + s), V(T(0)));
+
+	if constexpr (is_fast<P> && std::is_same<T, float>::value)
+		return t * horner(t, 0.16666614338546165f, 0.075110520747580553f, 0.042151316373588966f,
+			0.045566332203831689f);
+	else if constexpr (std::is_same<T, float>::value)
+		return t * horner(t, 1.6666752422e-1f, 7.4953002686e-2f, 4.5470025998e-2f,
+			2.4181311049e-2f, 4.2163199048e-2f);
+	else {
+		V p = t * horner(t, 1.66666666666666657415e-01, -3.25565818622400915405e-01,
+			2.01212532134862925881e-01, -4.00555345006794114027e-02,
+			7.91534994289814532176e-04, 3.47933107596021167570e-05);
+		V qq = horner(t, 1.0, -2.40339491173441421878e+00, 2.02094576023350569471e+00,
+			-6.88283971605453293030e-01, 7.70381505559019352791e-02);
+		return quot<P>(p, qq);
+	}
+}
+
+template <typename P = precise, typename V>
+TLAP_INLINE inline V	asin(V x) {
+	using T = value_t<V>;
+	typename V::mask	big;
+	V					u, c;
+	V					ax = abs(x);
+	V					R = asin_reduced<P>(ax, big, u, c);
+	V					pio2_hi, pio2_lo;
+
+	pio2_split(pio2_hi, pio2_lo);
+
+	V a = fma(u, R, u);
+	V b;
+	if constexpr (is_fast<P>)
+		b = pio2_hi - (V(T(2)) * u - (pio2_lo - V(T(2)) * fma(u, R, c)));
+	else {
+		V e;
+		two_sum(pio2_hi, V(T(-2)) * u, b, e);
+		b = b + (e + (pio2_lo - V(T(2)) * fma(u, R, c)));
+	}
+	V res = select(big, b, a);
+	res = select(ax > V(T(1)), V(std::numeric_limits<T>::quiet_NaN()), res);
+	return copysign(res, x);
+}
+
+// acos(x) = pi/2 - asin(x) for |x| < 1/2, 2*asin(sqrt((1 - x)/2)) for x > 1/2,
+// pi - 2*asin(sqrt((1 + x)/2)) for x < -1/2
+template <typename P = precise, typename V>
+TLAP_INLINE inline V	acos(V x) {
+	using T = value_t<V>;
+	typename V::mask	big;
+	V					u, c;
+	V					ax = abs(x);
+	V					R = asin_reduced<P>(ax, big, u, c);
+	V					pio2_hi, pio2_lo;
+
+	pio2_split(pio2_hi, pio2_lo);
+
+	V small = pio2_hi - (x - (pio2_lo - x * R));
+	V w = V(T(2)) * (u + fma(u, R, c));
+	V neg;
+	if constexpr (is_fast<P>)
+		neg = V(T(2)) * pio2_hi - (w - V(T(2)) * pio2_lo);
+	else {
+		V e;
+		two_sum(V(T(2)) * pio2_hi, V(T(-2)) * u, neg, e);
+		neg = neg + (e + V(T(2)) * (pio2_lo - fma(u, R, c)));
+	}
+	V res = select(big, select(signbit(x), neg, w), small);
+	return select(ax > V(T(1)), V(std::numeric_limits<T>::quiet_NaN()), res);
+}
+
+// precise double atan(|x|) as hi + lo, on the 5 intervals of fdlibm:
+// t = (|x| - a) / (1 + a|x|) in two parts (the numerator is exact, the
+// denominator alpha|x| + beta is summed exactly) and atan(a) + t summed
+// exactly. dx is a tail of |x|, atan2 passes the rounding of its quotient,
+// added as dx / (1 + x^2)
+template <typename V>
+TLAP_INLINE inline void	atan_split(V ax, V dx, V &hi, V &lo) {
+	using T = value_t<V>;
+	const V	zero = T(0);
+	const V	one = T(1);
+	const V	c15 = T(1.5);
+	const V	two = T(2);
+	V		d, dl, e;
+
+	typename V::mask m3 = ax >= V(T(2.4375));
+	typename V::mask m2 = ax >= V(T(1.1875));
+	typename V::mask m1 = ax >= V(T(0.6875));
+	typename V::mask m0 = ax >= V(T(0.4375));
+
+	V num = select(m3, -one, select(m2, ax - c15, select(m1, ax - one, select(m0, two * ax - one, ax))));
+	V alpha = select(m3, one, select(m2, c15, select(m0, one, zero)));
+	V beta = select(m3, zero, select(m1, one, select(m0, two, one)));
+	V axc = min(ax, V(T(1e300)));
+	V p = alpha * axc;
+	two_sum(p, beta, d, dl);
+	dl = dl + prod_err(alpha, axc, p);
+	V h = select(m3, V(T(1.57079632679489655800e+00)), select(m2, V(T(9.82793723247329054082e-01)),
+		select(m1, V(T(7.85398163397448278999e-01)), select(m0, V(T(4.63647609000806093515e-01)), zero))));
+	V l = select(m3, V(T(6.12323399573676603587e-17)), select(m2, V(T(1.39033110312309984516e-17)),
+		select(m1, V(T(3.06161699786838301793e-17)), select(m0, V(T(2.26987774529616870924e-17)), zero))));
+
+	V t = num / d;
+	V td = t * d;
+	V tl = (((num - td) - prod_err(t, d, td)) - t * dl) / d;
+	V z = t * t;
+	V w = z * z;
+	V s1 = z * horner(w, 3.33333333333329318027e-01, 1.42857142725034663711e-01, 9.09088713343650656196e-02,
+		6.66107313738753120669e-02, 4.97687799461593236017e-02, 1.62858201153657823623e-02);
+	V s2 = w * horner(w, -1.99999999998764832476e-01, -1.11111104054623557880e-01, -7.69187620504482999495e-02,
+		-5.83357013379057348645e-02, -3.65315727442169155270e-02);
+	two_sum(h, t, hi, e);
+	lo = e + (((l + tl / (one + z)) + dx / fma(ax, ax, one)) - t * (s1 + s2));
+}
+
+// atan(|x|) reduced to a small interval through t = (|x| - a) / (1 + a|x|),
+// atan(|x|) = atan(a) + atan(t), then an odd polynomial in t. float and fast
+// double use 3 intervals (|t| <= tan(pi/8)), precise double atan_split
+template <typename P = precise, typename V>
+TLAP_INLINE inline V	atan(V x) {
+	using T = value_t<V>;
+	const V	one = T(1);
+	V		ax = abs(x);
+	V		res;
+
+	if constexpr (is_fast<P> || std::is_same<T, float>::value) {
+		typename V::mask far = ax > V(T(2.414213562373095));
+		typename V::mask mid = ax > V(T(0.4142135623730950));
+		V num = select(far, -one, select(mid, ax - one, ax));
+		V den = select(far, min(V(T(1e18)), ax), select(mid, ax + one, one));
+		V y0 = select(far, V(T(1.5707963267948966)), select(mid, V(T(0.7853981633974483)), V(T(0))));
+		V t = quot<P>(num, den);
+		V z = t * t;
+		V p;
+		if constexpr (std::is_same<T, float>::value)
+			p = horner(z, -3.33329491539e-1f, 1.99777106478e-1f, -1.38776856032e-1f, 8.05374449538e-2f);
+		else
+			p = horner(z, -0.33333333333333331, 0.1999999999999921, -0.14285714285056117, 0.11111110978500909,
+				-0.090908989021723619, 0.076919319280155954, -0.066591469087672536, 0.057956589851068462,
+				-0.04679512349834114, 0.025421380853349444);
+		res = y0 + fma(p * z, t, t);
+	} else {
+		V hi, lo;
+		atan_split(ax, V(T(0)), hi, lo);
+		res = hi + lo;
+	}
+	return copysign(res, x);
+}
+
+// atan2 follows the std::atan2 conventions for signed zeros and infinities.
+// precise double: u = min / max in [0, 1] with its rounding error, then one
+// of atan(u), pi/2 - atan(u), pi/2 + atan(u) and pi - atan(u) summed in two
+// parts, none of them is rounded before the result
+template <typename P = precise, typename V>
+TLAP_INLINE inline V	atan2(V y, V x) {
+	using T = value_t<V>;
+	using L = std::numeric_limits<T>;
+	V	ax = abs(x);
+	V	ay = abs(y);
+	V	pi, pi_lo;
+
+	if constexpr (std::is_same<T, float>::value) {
+		pi = T(3.1415927410e+00f);
+		pi_lo = T(-8.7422776573e-08f);
+	} else {
+		pi = T(3.1415926535897931160e+00);
+		pi_lo = T(1.2246467991473531772e-16);
+	}
+
+	if constexpr (!is_fast<P> && std::is_same<T, double>::value) {
+		V	pio2_hi, pio2_lo, hi, lo, s, e;
+		V	mn = min(ax, ay);
+		V	mx = max(ax, ay);
+		V	u = mn / mx;
+		// the remainder of mn / mx from both scaled by a power of 2 that keeps
+		// the splitting of prod_err away from overflow and underflow
+		V	sc = select(mx > V(T(0x1p900)), V(T(0x1p-600)), select(mx < V(T(0x1p-900)), V(T(0x1p600)), V(T(1))));
+		V	mxs = mx * sc;
+		V	um = u * mxs;
+		V	ul = ((mn * sc - um) - prod_err(u, mxs, um)) / mxs;
+
+		pio2_split(pio2_hi, pio2_lo);
+		ul = select((mn > V(T(0))) & (mx < V(L::infinity())), ul, V(T(0)));
+		u = select((ax == V(T(0))) & (ay == V(T(0))), V(T(0)), u);
+		u = select((ax == V(L::infinity())) & (ay == V(L::infinity())), V(T(1)), u);
+		atan_split(u, ul, hi, lo);
+
+		typename V::mask swap = ay > ax;
+		typename V::mask neg = signbit(x);
+		V bh = select(swap, pio2_hi, select(neg, pi, V(T(0))));
+		V bl = select(swap, pio2_lo, select(neg, pi_lo, V(T(0))));
+		V sg = select((swap & ~neg) | (~swap & neg), V(T(-1)), V(T(1)));
+		two_sum(bh, sg * hi, s, e);
+		V res = s + (e + (bl + sg * lo));
+		return select(isnan(x) | isnan(y), x + y, copysign(res, y));
+	}
+
+	V ratio = ay / ax;
+	ratio = select((ax == V(T(0))) & (ay == V(T(0))), V(T(0)), ratio);
+	ratio = select((ax == V(L::infinity())) & (ay == V(L::infinity())), V(T(1)), ratio);
+
+	V a = tlap::kernel::atan<P>(ratio);
+	a = select(signbit(x), pi - (a - pi_lo), a);
+	return copysign(a, y);
+}
+
+// roots
+//
+// subnormal inputs are scaled into the normal range first. the iterations run
+// on the mantissa, whose range is fixed, and the exponent is applied at the
+// end, so the fast reciprocal stays inside its valid range
+template <typename V>
+TLAP_INLINE inline typename V::mask	is_tiny(V ax) {
+	return ax < V(std::numeric_limits<value_t<V>>::min());
+}
+
+// |x| = m * 2^e with m in [1, 2), subnormals included
+template <typename V>
+TLAP_INLINE inline void	split_exp(V ax, V &m, V &e) {
+	using T = value_t<V>;
+	constexpr int	digits = std::numeric_limits<T>::digits;
+	typename V::mask	tiny = is_tiny(ax);
+	V xs = select(tiny, ax * V(std::ldexp(T(1), digits)), ax);
+	m = getmant(xs);
+	e = getexp(xs) - select(tiny, V(T(digits)), V(T(0)));
+}
+
+// precise: hardware sqrt, correctly rounded. fast: x * rsqrt(x) refined by Newton
+template <typename P = precise, typename V>
+TLAP_INLINE inline V	sqrt(V x) {
+	if constexpr (is_fast<P>) {
+		using T = value_t<V>;
+		constexpr int	half = std::numeric_limits<T>::digits / 2 + 1;
+		typename V::mask	tiny = is_tiny(x) & (x > V(T(0)));
+		V res = root2<P>(select(tiny, x * V(std::ldexp(T(1), 2 * half)), x));
+		return select(tiny, res * V(std::ldexp(T(1), -half)), res);
+	} else
+		return sqrt(x);
+}
+
+// 1 / sqrt(x), rsqrt(+-0) = +-inf, rsqrt(inf) = 0, negative gives nan.
+// precise: r = 1 / sqrt(x) corrected by the exact rounding errors of the
+// sqrt and of the division (< 0.6 ulp). fast: the rsqrt estimate plus the
+// Newton steps the type needs (one for float on AVX-512)
+template <typename P = precise, typename V>
+TLAP_INLINE inline V	rsqrt(V x) {
+	using T = value_t<V>;
+	using L = std::numeric_limits<T>;
+	constexpr int	half = L::digits / 2 + 1;
+	// the precise correction needs s^2 and its rounding error to stay normal
+	// and finite: tiny and large x are scaled by 2^(+-2 half) first
+	typename V::mask	tiny = x < V(std::ldexp(L::min(), 2 * half));
+	typename V::mask	big = x > V(std::ldexp(L::max(), -2 * half));
+	V xs = select(tiny, x * V(std::ldexp(T(1), 2 * half)), select(big, x * V(std::ldexp(T(1), -2 * half)), x));
+	V res;
+
+	if constexpr (is_fast<P>)
+		res = rroot2<P>(xs);
+	else {
+		// s = sqrt(x) (1 + d1), r = (1 - d2) / s, 1 / sqrt(x) = r (1 + d1 + d2)
+		V s = sqrt(xs);
+		V r = V(T(1)) / s;
+		V s2 = s * s;
+		V sr = s * r;
+		V d1 = (((s2 - xs) + prod_err(s, s, s2)) * r) * (r * V(T(0.5)));
+		V d2 = (V(T(1)) - sr) - prod_err(s, r, sr);
+		res = fma(r, d1 + d2, r);
+	}
+	res = select(tiny, res * V(std::ldexp(T(1), half)), select(big, res * V(std::ldexp(T(1), -half)), res));
+	res = select(x < V(T(0)), V(L::quiet_NaN()), res);
+	res = select(x == V(T(0)), copysign(V(L::infinity()), x), res);
+	return select(x == V(L::infinity()), V(T(0)), res);
+}
+
+// |x| = w * 2^3q with w = m * 2^r in [1, 8): cbrt(m) from a degree 4 minimax
+// seed (16.7 bits) times cbrt(2^r), then Newton steps on w: one for float, two
+// for double. precise: the last step takes w - y^3 exactly (prod_err), the
+// result is within 0.8 ulp
+template <typename P = precise, typename V>
+TLAP_INLINE inline V	cbrt(V x) {
+	using T = value_t<V>;
+	using L = std::numeric_limits<T>;
+	const V	one = T(1);
+	const V	third = T(1) / T(3);
+	V ax = abs(x);
+	V m, e;
+
+	split_exp(ax, m, e);
+	V q = floor((e + V(T(0.5))) * third);
+	V r = e - V(T(3)) * q;
+	V w = m * select(r == one, V(T(2)), select(r == V(T(2)), V(T(4)), one));
+	V y = horner(m, 0.50697935960217777, 0.71815399072458286, -0.30061161410072201,
+		0.086091372291346266, -0.010603900874235975)
+		* select(r == one, V(T(1.2599210498948731648)), select(r == V(T(2)), V(T(1.5874010519681994748)), one));
+
+	if constexpr (std::is_same<T, double>::value)
+		y = fma(V(T(2)), y, quot<P>(w, y * y)) * third;
+	if constexpr (is_fast<P>)
+		y = fma(V(T(2)), y, quot<P>(w, y * y)) * third;
+	else {
+		V y2 = y * y;
+		V y3 = y2 * y;
+		V err = prod_err(y2, y, y3) + prod_err(y, y, y2) * y;
+		y = y + ((w - y3) - err) / (V(T(3)) * y2);
+	}
+
+	y = y * pow2i(q);
+	y = select((ax == V(T(0))) | (ax == V(L::infinity())) | isnan(x), ax, y);
+	return copysign(y, x);
+}
+
+// y^n for a fixed n >= 1, square and multiply
+template <typename V>
+TLAP_INLINE inline V	powi(V y, unsigned n) {
+	V res = value_t<V>(1);
+	for (; n; n >>= 1, y = y * y)
+		if (n & 1)
+			res = res * y;
+	return res;
+}
+
+// n-th root, n != 0. n = +-1, +-2, 3 and 4 go through the kernels above, 4
+// except in precise double where sqrt(sqrt(x)) rounds twice. other degrees:
+// |x| = m * 2^(nq + r), root = 2^q * exp((log(m) + r*ln2) / n), the exp
+// argument stays below ln2 whatever x. precise double: the log, the
+// quotient and the exp in two parts (ln_split, exp_split), rounded once.
+// precise float: one Newton correction z += z * (m * 2^r / z^n - 1) / n
+// while 2^n is finite.
+// negative x gives nan for even n and -root(-x) for odd n
+template <typename P = precise, typename V>
+TLAP_INLINE inline V	rootn(V x, int n) {
+	using T = value_t<V>;
+	using L = std::numeric_limits<T>;
+
+	switch (n) {
+		case 1: return x;
+		case -1: return V(T(1)) / x;
+		case 2: return tlap::kernel::sqrt<P>(x);
+		case -2: return tlap::kernel::rsqrt<P>(x);
+		case 3: return tlap::kernel::cbrt<P>(x);
+		case 4:
+			if constexpr (is_fast<P> || !std::is_same<T, double>::value)
+				return tlap::kernel::sqrt<P>(tlap::kernel::sqrt<P>(x));
+			break;
+		case 0: return V(L::quiet_NaN());
+	}
+
+	unsigned	an = static_cast<unsigned>(n < 0 ? -static_cast<long>(n) : n);
+	const V		vn = T(an);
+	const V		inv_n = T(1) / T(an);
+	V			ax = abs(x);
+	V			m, e, ln2hi, ln2lo;
+
+	if constexpr (std::is_same<T, float>::value) {
+		ln2hi = T(6.9313812256e-01f);
+		ln2lo = T(9.0580006145e-06f);
+	} else {
+		ln2hi = T(6.93147180369123816490e-01);
+		ln2lo = T(1.90821492927058770002e-10);
+	}
+
+	split_exp(ax, m, e);
+	V q = floor((e + V(T(0.5))) / vn);
+	V r = e - vn * q;
+	V y;
+
+	if constexpr (!is_fast<P> && std::is_same<T, double>::value) {
+		V hi, lo, a, al, k, zh, zl;
+		ln_split(m, hi, lo);
+		two_sum(r * ln2hi, hi, a, al);
+		al = al + (lo + r * ln2lo);
+		if (n < 0) {
+			a = -a;
+			al = -al;
+		}
+		V qh = a / vn;
+		V qn = qh * vn;
+		exp_split(qh, (((a - qn) - prod_err(qh, vn, qn)) + al) / vn, k, zh, zl);
+		y = scale2i(zh + zl, k + (n < 0 ? -q : q));
+	} else {
+		V z = tlap::kernel::exp<P>((r * ln2hi + fma(r, ln2lo, tlap::kernel::ln<P>(m))) * inv_n);
+
+		if constexpr (!is_fast<P>)
+			if (an < static_cast<unsigned>(L::max_exponent)) {
+				V zn = powi(z, an);
+				z = fma(z * inv_n, (m * pow2i(r)) / zn - V(T(1)), z);
+			}
+		if (n < 0)
+			y = quot<P>(V(T(1)), z) * pow2i(-q);
+		else
+			y = z * pow2i(q);
+	}
+	y = select(ax == V(T(0)), V(n < 0 ? L::infinity() : T(0)), y);
+	y = select(ax == V(L::infinity()), V(n < 0 ? T(0) : L::infinity()), y);
+	y = select(isnan(x), x, y);
+	if (an % 2 == 0)
+		return select(x < V(T(0)), V(L::quiet_NaN()), y);
+	return copysign(y, x);
+}
+
+} // namespace tlap::kernel
@@ -4,44 +4,74 @@
 #pragma once
 
 #include "../hyperp.hpp"
+#include "policy.hpp"
 #include <concepts>
 
 #define T_FLOAT			template <std::floating_point T> auto
 #define T_ARITHMETIC	template <typename T> auto
 #define T_INT			template <std::integral T> auto
+#define T_POLICY		template <math_policy P, std::floating_point T> auto
+#define T_POLICY_ARITHMETIC	template <math_policy P, typename T> auto
 
+// every inexact function also exists as f<P>(x) with P = tlap::precise or
+// tlap::fast (see policy.hpp), f(x) uses MATH_POLICY
 namespace	tlap {
 	// power
 	T_ARITHMETIC	pow(T x, int n);
 	T_ARITHMETIC	pow(T x, T n);
+	T_POLICY_ARITHMETIC	pow(T x, T n);
 
 	// exp and log
 	T_FLOAT			exp(T x);
+	T_POLICY		exp(T x);
 	T_FLOAT			ln(T x);
+	T_POLICY		ln(T x);
 	T_FLOAT			log10(T x);
+	T_POLICY		log10(T x);
 	T_FLOAT			log2(T x);
+	T_POLICY		log2(T x);
 	T_FLOAT			log(T x, int base);
+	T_POLICY		log(T x, int base);
 	T_FLOAT			log(T x, T base);
+	T_POLICY		log(T x, T base);
 
 	// root
 	T_FLOAT			sqrt(T x);
+	T_POLICY		sqrt(T x);
+	T_FLOAT			rsqrt(T x);
+	T_POLICY		rsqrt(T x);
 	T_FLOAT			cbrt(T x);
+	T_POLICY		cbrt(T x);
 	T_FLOAT			root(T x, int n);
+	T_POLICY		root(T x, int n);
 	T_FLOAT			root(T x, T n);
+	T_POLICY		root(T x, T n);
 
 	// trigonometry
 	T_FLOAT			sin(T x);
+	T_POLICY		sin(T x);
 	T_FLOAT			cos(T x);
+	T_POLICY		cos(T x);
 	T_FLOAT			tan(T x);
+	T_POLICY		tan(T x);
+	T_FLOAT			sincos(T x, T &s, T &c);
+	T_POLICY		sincos(T x, T &s, T &c);
 	T_FLOAT			asin(T x);
+	T_POLICY		asin(T x);
 	T_FLOAT			acos(T x);
+	T_POLICY		acos(T x);
 	T_FLOAT			atan(T x);
+	T_POLICY		atan(T x);
 	T_FLOAT			atan2(T y, T x);
+	T_POLICY		atan2(T y, T x);
 
 	// hyperbolic
 	T_FLOAT			sinh(T x);
+	T_POLICY		sinh(T x);
 	T_FLOAT			cosh(T x);
+	T_POLICY		cosh(T x);
 	T_FLOAT			tanh(T x);
+	T_POLICY		tanh(T x);
 
 	// rounding
 	T_FLOAT			floor(T x);
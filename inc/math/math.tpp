@@ -5,20 +5,83 @@
 #include <limits>
 #include <cmath>
 #include "math.hpp"
+#include "kernels.tpp"
 #include "../hyperp.hpp"
 
 
 namespace tlap {
 
+namespace detail {
+
+// one-lane pack running the SIMD kernels, long double goes through the double kernels
+template <typename T>
+using lane = simd::pack<std::conditional_t<std::is_same<T, float>::value, float, double>, simd::isa::scalar>;
+
+// the same for the functions whose float kernels miss 1 ulp: float arguments
+// of the precise policy run the double kernels and are rounded once, as in
+// their batch versions
+template <typename T, typename P>
+using wide_lane = std::conditional_t<kernel::is_fast<P>, lane<T>, lane<double>>;
+
+// e^(p + perr) from exp_split, rounded once. |p| >= 1000 over- or underflows
+inline double	exp_rounded(double p, double perr) {
+	lane<double> k, hi, lo;
+
+	if (!(std::fabs(p) < 1000))
+		return kernel::exp(lane<double>(p)).v;
+	kernel::exp_split(lane<double>(p), lane<double>(perr), k, hi, lo);
+	return kernel::scale2i(hi + lo, k).v;
+}
+
+// x^n for x > 0 as exp(n * log(x)), the log, the product and the exp all in
+// two parts, so that the rounding of n * log(x) does not get amplified by exp
+inline double	pow_positive(double x, double n) {
+	lane<double> hi, lo;
+
+	if (x == std::numeric_limits<double>::infinity())
+		return (n > 0 ? x : 0);
+	kernel::ln_split(lane<double>(x), hi, lo);
+	double p = n * hi.v;
+	return exp_rounded(p, kernel::prod_err(lane<double>(n), hi, lane<double>(p)).v + n * lo.v);
+}
+
+// x^(1 / n) for x > 0 as exp(log(x) / n), from the same two part log: the
+// quotient keeps its remainder, so that neither a subnormal x nor |n| < 1
+// gets the rounding of log(x) / n amplified by exp
+inline double	root_positive(double x, double n) {
+	lane<double> hi, lo;
+	kernel::ln_split(lane<double>(x), hi, lo);
+
+	double q = hi.v / n;
+	if (!(std::fabs(n) < 0x1p900)) // e^q rounds to 1 or next to it, no remainder needed
+		return exp_rounded(q, 0);
+	double p = q * n;
+	return exp_rounded(q, (((hi.v - p) - kernel::prod_err(lane<double>(q), lane<double>(n), lane<double>(p)).v) + lo.v) / n);
+}
+
+// log(x) / log(base) for finite x, base > 0, both logs and the quotient in two parts
+inline double	log_ratio(double x, double base) {
+	lane<double> xh, xl, bh, bl, qh, ql;
+
+	if (!std::isfinite(x) || !std::isfinite(base))
+		return kernel::ln(lane<double>(x)).v / kernel::ln(lane<double>(base)).v;
+	kernel::ln_split(lane<double>(x), xh, xl);
+	kernel::ln_split(lane<double>(base), bh, bl);
+	kernel::quot_split(xh, xl, bh, bl, qh, ql);
+	return (qh + ql).v;
+}
+
+} // namespace detail
+
 // power
 T_ARITHMETIC	pow(T x, int n) {
-    if (n == 0) return 1;
+    if (n == 0) return T(1);
     if (x == 0) {
-        if (n > 0) return 0;
+        if (n > 0) return T(0);
         else throw std::invalid_argument("0^0 is undefined");
     }
     if (n == 1) return x;
-    if (n == 2) return x * x;
+    if (n == 2) return T(x * x);
     if (n < 0) {
         x = 1 / x;
         n = -n;
@@ -34,296 +97,246 @@ T_ARITHMETIC	pow(T x, int n) {
     return result;
 }
 
-//70 chaussures-chaussettes decathlon + 90 chf nouvelles chaussures + 50 euros maillots de bain et tongues intersport + 110 chf manger
-
-T_ARITHMETIC	 pow(T x, T n) {
-    if (n == 0) return 1;
+T_POLICY_ARITHMETIC	pow(T x, T n) {
+    if (n == 0) return T(1);
     if (x == 0) {
-        if (n > 0) return 0;
+        if (n > 0) return T(0);
         else
 			throw std::invalid_argument("0^0 is undefined");
     }
     if (x < 0 && std::floor(n) != n)
         throw std::invalid_argument("Negative base with non-integer exponent is undefined in real numbers.");
     if (n == 1) return x;
-    if (n == 2) return x * x;
-    if (n == 0.5) return tlap::sqrt(x);
-    if (n == -0.5) return 1 / tlap::sqrt(x);
-    if (n == -1) return 1 / x;
-    return tlap::exp(n * tlap::ln(x));
+    if (n == 2) return T(x * x);
+    if constexpr (std::is_integral<T>::value)
+        return T(tlap::pow(x, static_cast<int>(n)));
+    else {
+        if (n == 0.5) return tlap::sqrt<P>(x);
+        if (n == -0.5) return tlap::rsqrt<P>(x);
+        if (n == -1) return T(1 / x);
+
+        T result;
+        if constexpr (kernel::is_fast<P>) {
+            using L = detail::lane<T>;
+            result = static_cast<T>(kernel::exp<P>(L(n) * kernel::ln<P>(L(tlap::abs(x)))).v);
+        } else
+            result = static_cast<T>(detail::pow_positive(static_cast<double>(tlap::abs(x)), static_cast<double>(n)));
+        if (x < 0 && std::fmod(n, T(2)) != 0)
+            result = -result;
+        return result;
+    }
 }
 
-
-// exp and log
-T_FLOAT			exp(T x) {
-	if (x < 0)
-		return 1 / tlap::exp(-x);
-	else if (x == 0)
-		return 1;
-	else if (x == 1)
-		return E;
-	else if (x > EXP_LIMIT)
-		return std::numeric_limits<T>::infinity();
-	else if (x < -EXP_LIMIT)
-		return 0;
-	
-	T result = 1;
-	T term = 1;
-
-	for (int n = 1; n < EXP_TERMS; ++n) {
-		term *= x / n;
-		if (tlap::abs(term) < EPSILON)
-			break;
-		result += term;
-	}
-	return result;
+T_ARITHMETIC	 pow(T x, T n) {
+	return tlap::pow<default_policy>(x, n);
 }
 
-T_FLOAT			ln(T x) {
-	if (x <= 0)
-		return std::numeric_limits<T>::quiet_NaN();
-	else if (x == 1)
-		return 0;
-
-	int exponent = 0;
 
-	while (x > 2) {
-		x /= 2;
-		++exponent;
-	}
-	while (x < 0.5) {
-		x *= 2;
-		--exponent;
-	}
-
-	T result = 0;
-	T term = (x - 1) / (x + 1);
-	T termSquared = term * term;
+// exp and log
+// all of them run the branch-free kernels of kernels.tpp on a single lane, so
+// their latency does not depend on the input. measured error against a
+// correctly rounded reference, float and double, precise policy:
+//   exp, ln, log2, log10	< 0.9 ulp
+//   sinh, cosh, tanh		< 0.6 ulp (float evaluated in double)
+//   pow, log(x, base)		< 0.8 ulp, over the whole range of n * log(x)
+// fast policy:
+//   exp, ln, log2, log10	< 4.5 ulp
+//   sinh, cosh, tanh		< 8 ulp
+//   pow					exp and ln errors amplified by |n * log(x)|, in the type of x
+T_POLICY		exp(T x) {
+	return static_cast<T>(kernel::exp<P>(detail::lane<T>(x)).v);
+}
 
-	for (int n = 1; n <= LN_TERMS; n += 2) {
-		result += term / n;
-		term *= termSquared;
-	}
-	return (result * 2 + exponent * LN2);
+T_POLICY		ln(T x) {
+	return static_cast<T>(kernel::ln<P>(detail::lane<T>(x)).v);
 }
 
-T_FLOAT			log10(T x) {
-	if (x <= 0)
-		return std::numeric_limits<T>::quiet_NaN();
-	return tlap::ln(x) / LN10;
+T_POLICY		log10(T x) {
+	return static_cast<T>(kernel::log10<P>(detail::lane<T>(x)).v);
 }
 
-T_FLOAT			log2(T x) {
-	if (x <= 0)
-		return std::numeric_limits<T>::quiet_NaN();
-	return tlap::ln(x) / LN2;
+T_POLICY		log2(T x) {
+	return static_cast<T>(kernel::log2<P>(detail::lane<T>(x)).v);
 }
 
-T_FLOAT			log(T x, int base) {
-	if (x <= 0 || base <= 0 || base == 1)
-		return std::numeric_limits<T>::quiet_NaN();
-	return tlap::ln(x) / tlap::ln(static_cast<T>(base));
+T_POLICY		log(T x, int base) {
+	return tlap::log<P>(x, static_cast<T>(base));
 }
 
-T_FLOAT			log(T x, T base) {
+T_POLICY		log(T x, T base) {
 	if (x <= 0 || base <= 0 || base == 1)
 		return std::numeric_limits<T>::quiet_NaN();
-	return tlap::ln(x) / tlap::ln(base);
+	if constexpr (kernel::is_fast<P>)
+		return tlap::ln<P>(x) / tlap::ln<P>(base);
+	else
+		return static_cast<T>(detail::log_ratio(static_cast<double>(x), static_cast<double>(base)));
 }
 
+T_FLOAT			exp(T x) { return tlap::exp<default_policy>(x); }
+T_FLOAT			ln(T x) { return tlap::ln<default_policy>(x); }
+T_FLOAT			log10(T x) { return tlap::log10<default_policy>(x); }
+T_FLOAT			log2(T x) { return tlap::log2<default_policy>(x); }
+T_FLOAT			log(T x, int base) { return tlap::log<default_policy>(x, base); }
+T_FLOAT			log(T x, T base) { return tlap::log<default_policy>(x, base); }
+
 // root
-T_FLOAT			sqrt(T x) {
+// branch-free kernels seeded from rsqrt or from the exponent / mantissa split,
+// with a fixed number of Newton steps. measured error over the whole range,
+// subnormals included, precise policy: sqrt, rsqrt 0.5 ulp, cbrt < 0.8 ulp,
+// root(x, int) < 0.6 ulp (float evaluated in double), root(x, T) < 0.7 ulp.
+// fast policy: sqrt, rsqrt < 3 ulp, cbrt < 2 ulp, root(x, int) < 4 ulp,
+// root(x, T) carries the fast pow error
+T_POLICY		sqrt(T x) {
 	if (x < 0)
 		return std::numeric_limits<T>::quiet_NaN();
-	else if (x == 0 || x == 1)
-		return x;
-
-	T result = x / 2.0;
-
-	while (tlap::abs(result * result - x) > EPSILON)
-		result = (result + x / result) / 2.0;
-	return result;
+	return static_cast<T>(kernel::sqrt<P>(detail::lane<T>(x)).v);
 }
 
-T_FLOAT			cbrt(T x) {
-	if (x == 0 || x == 1)
-		return x;
-
-	T result = x / 3.0;
+T_POLICY		rsqrt(T x) {
+	return static_cast<T>(kernel::rsqrt<P>(detail::lane<T>(x)).v);
+}
 
-	while (tlap::abs(result * result * result - x) > EPSILON)
-		result = (2 * result + x / (result * result)) / 3.0;
-	return result;
+T_POLICY		cbrt(T x) {
+	return static_cast<T>(kernel::cbrt<P>(detail::lane<T>(x)).v);
 }
 
-T_FLOAT			root(T x, int n) {
+T_POLICY		root(T x, int n) {
 	if (n == 0)
 		throw std::invalid_argument("The root of degree 0 is undefined.");
-	if (x < 0 && n % 2 == 0)
-		return std::numeric_limits<T>::quiet_NaN();
-	if (x == 0)
-		return 0;
-
-	T result = x / n;
-	T epsilon = static_cast<T>(1e-10);
-
-	while (tlap::abs(tlap::pow(result, n) - x) > epsilon)
-		result = (1.0 / n) * ((n - 1) * result + x / tlap::pow(result, n - 1));
-	return result;
+	return static_cast<T>(kernel::rootn<P>(detail::wide_lane<T, P>(x), n).v);
 }
 
-T_FLOAT			root(T x, T n) {
+// integer degrees go through root(x, int), others through exp(log(x) / n):
+// precise from the two part log in double (detail::root_positive), float
+// rounded once from it
+T_POLICY		root(T x, T n) {
 	if (n == 0)
 		throw std::invalid_argument("The root of degree 0 is undefined.");
-	if (x < 0 && tlap::floor(n) != n && static_cast<int>(n) % 2 == 0)
+	if (tlap::abs(n) <= T(std::numeric_limits<int>::max()) && tlap::floor(n) == n)
+		return tlap::root<P>(x, static_cast<int>(n));
+	if (x < 0)
 		return std::numeric_limits<T>::quiet_NaN();
 	if (x == 0)
-		return 0;
-
-	T result = x / n;
-	T epsilon = static_cast<T>(1e-10);
-
-	while (tlap::abs(tlap::pow(result, n) - x) > epsilon)
-		result = ((n - 1.0) * result + x / tlap::pow(result, n - 1)) / n;
-	return result;
+		return T(0);
+	if (x == std::numeric_limits<T>::infinity() || n != n)
+		return (n > 0 ? x : n < 0 ? T(0) : n);
+
+	if constexpr (kernel::is_fast<P>)
+		return tlap::exp<P>(tlap::ln<P>(x) / n);
+	else
+		return static_cast<T>(detail::root_positive(static_cast<double>(x), static_cast<double>(n)));
 }
 
+T_FLOAT			sqrt(T x) { return tlap::sqrt<default_policy>(x); }
+T_FLOAT			rsqrt(T x) { return tlap::rsqrt<default_policy>(x); }
+T_FLOAT			cbrt(T x) { return tlap::cbrt<default_policy>(x); }
+T_FLOAT			root(T x, int n) { return tlap::root<default_policy>(x, n); }
+T_FLOAT			root(T x, T n) { return tlap::root<default_policy>(x, n); }
+
 // trigonometry
-T_FLOAT			sin(T x) {
-	x = tlap::mod(x, 2.0 * PI);
-
-	T term = x;
-	T result = x;
-	T x_squared = x * x;
-	int n = 1;
-
-	while (tlap::abs(term) > EPSILON) {
-		n += 2;
-		term *= -x_squared / (n * (n - 1));
-		result += term;
-	}
-	return result;
+// quadrant reduction to [-pi/4, pi/4] (Cody-Waite, Payne-Hanek past
+// kernel::trig_limit) and fixed-degree polynomials, no loop depends on x.
+// precise: the reduced argument in two parts and the fdlibm double kernels,
+// float evaluated in double. measured error: sin, cos, tan < 0.85 ulp,
+// asin, acos < 0.8 ulp, atan, atan2 < 0.65 ulp.
+// fast policy: float sin, cos < 6 ulp, tan, asin, acos < 8.5 ulp,
+// atan < 2.5 ulp; double sin, cos, atan < 11 ulp, tan < 16 ulp, asin, acos < 3 ulp
+T_POLICY		sin(T x) {
+	using F = typename detail::wide_lane<T, P>::value_type;
+	if (std::fabs(x) > kernel::trig_limit<F>())
+		return static_cast<T>(kernel::sin_large(static_cast<F>(x)));
+	return static_cast<T>(kernel::sin<P>(detail::wide_lane<T, P>(x)).v);
 }
 
-T_FLOAT			cos(T x) {
-	x = tlap::mod(x, 2 * PI);
-
-	T term = 1;
-	T result = 1;
-	T x_squared = x * x;
-	int n = 2;
-
-	while (tlap::abs(term) > EPSILON) {
-		term *= -x_squared / (n * (n - 1));
-		result += term;
-		n += 2;
-	}
-	return result;
+T_POLICY		cos(T x) {
+	using F = typename detail::wide_lane<T, P>::value_type;
+	if (std::fabs(x) > kernel::trig_limit<F>())
+		return static_cast<T>(kernel::cos_large(static_cast<F>(x)));
+	return static_cast<T>(kernel::cos<P>(detail::wide_lane<T, P>(x)).v);
 }
 
-T_FLOAT			tan(T x) {
-	x = tlap::mod(x, 2 * PI);
-
-	T cosine_value = cos(x);
+T_POLICY		tan(T x) {
+	using F = typename detail::wide_lane<T, P>::value_type;
+	if (std::fabs(x) > kernel::trig_limit<F>())
+		return static_cast<T>(kernel::tan_large(static_cast<F>(x)));
+	return static_cast<T>(kernel::tan<P>(detail::wide_lane<T, P>(x)).v);
+}
 
-	if (tlap::abs(cosine_value) < EPSILON)
-		throw std::overflow_error("Tangent undefined (cos(x) is too close to 0).");
-	return tlap::sin(x) / cosine_value;
+T_POLICY		sincos(T x, T &s, T &c) {
+	using F = typename detail::wide_lane<T, P>::value_type;
+	if (std::fabs(x) > kernel::trig_limit<F>()) {
+		F fs, fc;
+		kernel::sincos_large(static_cast<F>(x), fs, fc);
+		s = static_cast<T>(fs);
+		c = static_cast<T>(fc);
+		return;
+	}
+	detail::wide_lane<T, P> ls, lc;
+	kernel::sincos<P>(detail::wide_lane<T, P>(x), ls, lc);
+	s = static_cast<T>(ls.v);
+	c = static_cast<T>(lc.v);
 }
 
-T_FLOAT			asin(T x) {
+T_POLICY		asin(T x) {
 	if (x < -1 || x > 1)
 		throw std::invalid_argument("asin() is undefined for |x| > 1.");
-
-	T result = x;
-	T term = x;
-	T x_squared = x * x;
-	int n = 1;
-
-	while (tlap::abs(term) > EPSILON && n < MAX_RECURSION) {
-		term *= x_squared * (2 * n - 1) / (2 * n);
-		result += term / (2 * n + 1);
-		n++;
-	}
-	return result;
+	return static_cast<T>(kernel::asin<P>(detail::wide_lane<T, P>(x)).v);
 }
 
-T_FLOAT			acos(T x) {
+T_POLICY		acos(T x) {
 	if (x < -1 || x > 1)
 		throw std::invalid_argument("acos() is undefined for |x| > 1.");
-
-	return PI / 2 - tlap::asin(x);
+	return static_cast<T>(kernel::acos<P>(detail::wide_lane<T, P>(x)).v);
 }
 
-T_FLOAT			atan(T x) {
-	if (tlap::abs(x) > 1) {
-		if (x > 1)
-			return PI / 2 - tlap::atan(1 / x);
-		else
-			return -PI / 2 - tlap::atan(1 / x);
-	}
-
-	T result = x;
-	T term = x;
-	T x_squared = x * x;
-	int n = 1;
-
-	while (tlap::abs(term) > EPSILON && n < MAX_RECURSION) {
-		term *= -x_squared;
-		result += term / (2 * n + 1);
-		n++;
-	}
-	return result;
+T_POLICY		atan(T x) {
+	return static_cast<T>(kernel::atan<P>(detail::wide_lane<T, P>(x)).v);
 }
 
-T_FLOAT			atan2(T y, T x) {
-	if (x == 0) {
-		if (y == 0)
-			throw std::invalid_argument("atan2(0, 0) is undefined.");
-		return (y > 0 ? PI / 2 : -PI / 2);
-	}
-	else if (y == 0)
-		return (x > 0 ? 0 : PI);
-
-	T result = tlap::atan(y / x);
-	if (x < 0)
-		result += (y >= 0 ? PI : -PI);
-	return result;
+T_POLICY		atan2(T y, T x) {
+	if (x == 0 && y == 0)
+		throw std::invalid_argument("atan2(0, 0) is undefined.");
+	return static_cast<T>(kernel::atan2<P>(detail::wide_lane<T, P>(y), detail::wide_lane<T, P>(x)).v);
 }
 
+T_FLOAT			sin(T x) { return tlap::sin<default_policy>(x); }
+T_FLOAT			cos(T x) { return tlap::cos<default_policy>(x); }
+T_FLOAT			tan(T x) { return tlap::tan<default_policy>(x); }
+T_FLOAT			sincos(T x, T &s, T &c) { return tlap::sincos<default_policy>(x, s, c); }
+T_FLOAT			asin(T x) { return tlap::asin<default_policy>(x); }
+T_FLOAT			acos(T x) { return tlap::acos<default_policy>(x); }
+T_FLOAT			atan(T x) { return tlap::atan<default_policy>(x); }
+T_FLOAT			atan2(T y, T x) { return tlap::atan2<default_policy>(y, x); }
+
 // hyperbolic
-T_FLOAT			sinh(T x) {
-	return (tlap::exp(x) - tlap::exp(-x)) / 2;
+T_POLICY		sinh(T x) {
+	return static_cast<T>(kernel::sinh<P>(detail::wide_lane<T, P>(x)).v);
 }
 
-T_FLOAT			cosh(T x) {
-	return (tlap::exp(x) + tlap::exp(-x)) / 2;
+T_POLICY		cosh(T x) {
+	return static_cast<T>(kernel::cosh<P>(detail::wide_lane<T, P>(x)).v);
 }
 
-T_FLOAT			tanh(T x) {
-	T exp_x = tlap::exp(x);
-	T exp_minus_x = tlap::exp(-x);
-	if (exp_x == std::numeric_limits<T>::infinity())
-		return 1;
-	else if (exp_minus_x == std::numeric_limits<T>::infinity())
-		return -1;
-	if (exp_x + exp_minus_x == 0)
-		throw std::overflow_error("Tanh undefined (exp(x) + exp(-x) is too close to 0).");
-	return (exp_x - exp_minus_x) / (exp_x + exp_minus_x);
+T_POLICY		tanh(T x) {
+	return static_cast<T>(kernel::tanh<P>(detail::wide_lane<T, P>(x)).v);
 }
 
+T_FLOAT			sinh(T x) { return tlap::sinh<default_policy>(x); }
+T_FLOAT			cosh(T x) { return tlap::cosh<default_policy>(x); }
+T_FLOAT			tanh(T x) { return tlap::tanh<default_policy>(x); }
+
 // rounding
 T_FLOAT			floor(T x) {
 	T int_part = static_cast<T>(static_cast<long long>(x));
 	if (x < int_part)
-		return int_part - 1.0;
+		return int_part - T(1);
 	return int_part;
 }
 
 T_FLOAT			ceil(T x) {
 	T int_part = static_cast<T>(static_cast<long long>(x));
 	if (x > int_part)
-		return int_part + 1.0;
+		return int_part + T(1);
 	return int_part;
 }
 
@@ -332,9 +345,9 @@ T_FLOAT			round(T x) {
 	T fractional = x - int_part;
 	
 	if (fractional >= 0.5)
-		return int_part + 1.0;
+		return int_part + T(1);
 	else if (fractional <= -0.5)
-		return int_part - 1.0;
+		return int_part - T(1);
 	return int_part;
 }
 
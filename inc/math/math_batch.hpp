@@ -0,0 +1,84 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: batch versions of the math functions, one call for a whole array
+// File version: 0.1
+#pragma once
+
+#include "../hyperp.hpp"
+#include "../Vector/Vector.hpp"
+#include <concepts>
+#include <span>
+
+#define T_BATCH			template <std::floating_point T> void
+#define T_BATCH_VECTOR	template <std::floating_point T> Vector<T>
+
+// out[i] = f(in[i]) for i < n, out may alias in (in-place).
+// span overloads require out.size() >= in.size(), Vector overloads return a new Vector.
+// sincos writes both results from a single argument reduction.
+// sqrt and root give nan for negative inputs (odd degrees excepted), degree 0 throws.
+namespace	tlap {
+	// exp and log
+	T_BATCH			exp(const T *in, T *out, size_t n);
+	T_BATCH			exp(std::span<const T> in, std::span<T> out);
+	T_BATCH_VECTOR	exp(const Vector<T> &v);
+	T_BATCH			ln(const T *in, T *out, size_t n);
+	T_BATCH			ln(std::span<const T> in, std::span<T> out);
+	T_BATCH_VECTOR	ln(const Vector<T> &v);
+	T_BATCH			log10(const T *in, T *out, size_t n);
+	T_BATCH			log10(std::span<const T> in, std::span<T> out);
+	T_BATCH_VECTOR	log10(const Vector<T> &v);
+	T_BATCH			log2(const T *in, T *out, size_t n);
+	T_BATCH			log2(std::span<const T> in, std::span<T> out);
+	T_BATCH_VECTOR	log2(const Vector<T> &v);
+
+	// root
+	T_BATCH			sqrt(const T *in, T *out, size_t n);
+	T_BATCH			sqrt(std::span<const T> in, std::span<T> out);
+	T_BATCH_VECTOR	sqrt(const Vector<T> &v);
+	T_BATCH			rsqrt(const T *in, T *out, size_t n);
+	T_BATCH			rsqrt(std::span<const T> in, std::span<T> out);
+	T_BATCH_VECTOR	rsqrt(const Vector<T> &v);
+	T_BATCH			cbrt(const T *in, T *out, size_t n);
+	T_BATCH			cbrt(std::span<const T> in, std::span<T> out);
+	T_BATCH_VECTOR	cbrt(const Vector<T> &v);
+	T_BATCH			root(const T *in, T *out, size_t n, int degree);
+	T_BATCH			root(std::span<const T> in, std::span<T> out, int degree);
+	T_BATCH_VECTOR	root(const Vector<T> &v, int degree);
+
+	// trigonometry
+	T_BATCH			sin(const T *in, T *out, size_t n);
+	T_BATCH			sin(std::span<const T> in, std::span<T> out);
+	T_BATCH_VECTOR	sin(const Vector<T> &v);
+	T_BATCH			cos(const T *in, T *out, size_t n);
+	T_BATCH			cos(std::span<const T> in, std::span<T> out);
+	T_BATCH_VECTOR	cos(const Vector<T> &v);
+	T_BATCH			tan(const T *in, T *out, size_t n);
+	T_BATCH			tan(std::span<const T> in, std::span<T> out);
+	T_BATCH_VECTOR	tan(const Vector<T> &v);
+	T_BATCH			asin(const T *in, T *out, size_t n);
+	T_BATCH			asin(std::span<const T> in, std::span<T> out);
+	T_BATCH_VECTOR	asin(const Vector<T> &v);
+	T_BATCH			acos(const T *in, T *out, size_t n);
+	T_BATCH			acos(std::span<const T> in, std::span<T> out);
+	T_BATCH_VECTOR	acos(const Vector<T> &v);
+	T_BATCH			atan(const T *in, T *out, size_t n);
+	T_BATCH			atan(std::span<const T> in, std::span<T> out);
+	T_BATCH_VECTOR	atan(const Vector<T> &v);
+	T_BATCH			atan2(const T *y, const T *x, T *out, size_t n);
+	T_BATCH			atan2(std::span<const T> y, std::span<const T> x, std::span<T> out);
+	T_BATCH_VECTOR	atan2(const Vector<T> &y, const Vector<T> &x);
+	T_BATCH			sincos(const T *in, T *s, T *c, size_t n);
+	T_BATCH			sincos(std::span<const T> in, std::span<T> s, std::span<T> c);
+
+	// hyperbolic
+	T_BATCH			sinh(const T *in, T *out, size_t n);
+	T_BATCH			sinh(std::span<const T> in, std::span<T> out);
+	T_BATCH_VECTOR	sinh(const Vector<T> &v);
+	T_BATCH			cosh(const T *in, T *out, size_t n);
+	T_BATCH			cosh(std::span<const T> in, std::span<T> out);
+	T_BATCH_VECTOR	cosh(const Vector<T> &v);
+	T_BATCH			tanh(const T *in, T *out, size_t n);
+	T_BATCH			tanh(std::span<const T> in, std::span<T> out);
+	T_BATCH_VECTOR	tanh(const Vector<T> &v);
+}
+
+#include "math_batch.tpp"
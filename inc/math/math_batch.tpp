@@ -0,0 +1,261 @@
+#pragma once
+
+// implementation of the batch math functions: full packs of the dispatched isa
+// level through the SIMD kernels, remaining elements through the same kernels
+// on one lane. the functions whose float kernels miss 1 ulp run float data
+// through the double kernels, two double packs per float pack
+#include <stdexcept>
+#include <cmath>
+#include "math_batch.hpp"
+#include "kernels.tpp"
+#include "../hyperp.hpp"
+#include "../parallel/pool.hpp"
+#include "../profile/profile.hpp"
+#include "../simd/dispatch.hpp"
+#include <algorithm>
+
+
+namespace tlap {
+
+namespace detail {
+
+// the level of the packs of a batch call: that of the dispatched Vector
+// kernels (the isa of the compile flags with SIMD_DISPATCH 0), one lane only
+// below SIMD_MATH_THRESHOLD
+template <typename T>
+simd::dispatch::level	batch_level(size_t n) {
+	if (n < SIMD_MATH_THRESHOLD)
+		return simd::dispatch::level::scalar;
+	return (dispatched<T> ? simd::dispatch::active() : simd::dispatch::native);
+}
+
+// the loops of a batch call are a generic lambda of the pack V, instantiated
+// once per isa level as the Vector expressions (VectorExpr.tpp): the lambda,
+// the kernel lambda it calls and the kernels are always inlined into these
+template <typename T, typename Run>
+TLAP_TARGET_AVX512 void	batch_avx512(const Run &run, size_t begin, size_t simd_end, size_t end) {
+	run.template operator()<simd::pack<T, simd::isa::avx512>>(begin, simd_end, end);
+}
+
+template <typename T, typename Run>
+TLAP_TARGET_AVX2 void	batch_avx2(const Run &run, size_t begin, size_t simd_end, size_t end) {
+	run.template operator()<simd::pack<T, simd::isa::avx2>>(begin, simd_end, end);
+}
+
+// run<V>(begin, simd_end, end) over pieces of whole BATCH_GRAIN elements,
+// spread over the threads from BATCH_PARALLEL_MIN elements on: packs V of
+// batch_level() up to simd_end, one lane past it. the packs and the lanes do
+// not depend on the split
+template <typename T, typename Run>
+void	batch_split(size_t n, Run run) {
+	using level = simd::dispatch::level;
+	const level		l = batch_level<T>(n);
+	const size_t	width = (l == level::avx512 ? simd::pack<T, simd::isa::avx512>::width
+		: l == level::avx2 ? simd::pack<T, simd::isa::avx2>::width : 1);
+	const size_t	simd_end = n - n % width;
+
+	parallel::parallel_for(0, n, (n >= BATCH_PARALLEL_MIN ? BATCH_GRAIN : n), [&](size_t begin, size_t end) {
+		const size_t	mid = std::clamp(simd_end, begin, end);
+		switch (l) {
+			case level::avx512:	return batch_avx512<T>(run, begin, mid, end);
+			case level::avx2:	return batch_avx2<T>(run, begin, mid, end);
+			default:			return run.template operator()<simd::pack<T, simd::isa::scalar>>(begin, mid, end);
+		}
+	}, "batch");
+}
+
+// the pack of compute type C at the isa level of the data pack V: C is T, or
+// kernel::wide_t<T> for the functions computed in double
+template <typename C, typename V>
+using compute_pack = simd::pack<C, typename V::isa_type>;
+
+template <typename C, typename T, typename F>
+void	batch_map(const T *in, T *out, size_t n, F f) {
+	using S = simd::pack<C, simd::isa::scalar>;
+
+	batch_split<T>(n, [&] <typename V> (size_t i, size_t simd_end, size_t end) TLAP_INLINE {
+		using W = compute_pack<C, V>;
+		for (; i < simd_end; i += W::width)
+			f(W::loadu(in + i)).storeu(out + i);
+		for (; i < end; ++i)
+			out[i] = static_cast<T>(f(S(in[i])).v);
+	});
+}
+
+// same as batch_map, lanes with |x| > limit are recomputed by the scalar fix
+template <typename C, typename T, typename F, typename Fix>
+void	batch_map(const T *in, T *out, size_t n, F f, C limit, Fix fix) {
+	using S = simd::pack<C, simd::isa::scalar>;
+
+	batch_split<T>(n, [&] <typename V> (size_t i, size_t simd_end, size_t end) TLAP_INLINE {
+		using W = compute_pack<C, V>;
+		for (; i < simd_end; i += W::width) {
+			W x = W::loadu(in + i);
+			if ((abs(x) > W(limit)).any()) {
+				C tmp[W::width];
+				x.storeu(tmp);
+				f(x).storeu(out + i);
+				for (size_t j = 0; j < W::width; ++j)
+					if (std::fabs(tmp[j]) > limit)
+						out[i + j] = fix(static_cast<T>(tmp[j]));
+			} else
+				f(x).storeu(out + i);
+		}
+		for (; i < end; ++i) {
+			T x = in[i];
+			out[i] = (std::fabs(x) > limit ? fix(x) : static_cast<T>(f(S(x)).v));
+		}
+	});
+}
+
+template <typename C, typename T, typename F>
+void	batch_map(const T *a, const T *b, T *out, size_t n, F f) {
+	using S = simd::pack<C, simd::isa::scalar>;
+
+	batch_split<T>(n, [&] <typename V> (size_t i, size_t simd_end, size_t end) TLAP_INLINE {
+		using W = compute_pack<C, V>;
+		for (; i < simd_end; i += W::width)
+			f(W::loadu(a + i), W::loadu(b + i)).storeu(out + i);
+		for (; i < end; ++i)
+			out[i] = static_cast<T>(f(S(a[i]), S(b[i])).v);
+	});
+}
+
+template <typename T>
+void	check_span(size_t in, size_t out) {
+	if (out < in)
+		throw std::invalid_argument("Output span is smaller than input span.");
+}
+
+} // namespace detail
+
+// the counters of one batch function over n elements, below SIMD_MATH_THRESHOLD
+// a threshold fallback to the one-lane kernels
+#define TLAP_PROFILE_BATCH(name)																\
+	TLAP_PROFILE_KERNEL("math." name, T, detail::batch_level<T>(n),							\
+		n, n < SIMD_MATH_THRESHOLD)
+
+// C: the compute type, T or kernel::wide_t<T>
+#define TLAP_BATCH_UNARY(name, C, ...)														\
+	T_BATCH			name(const T *in, T *out, size_t n) {									\
+		TLAP_PROFILE_BATCH(#name);															\
+		detail::batch_map<C>(in, out, n, [](auto v) TLAP_INLINE { return kernel::name(v); } __VA_OPT__(,) __VA_ARGS__);	\
+	}																						\
+	T_BATCH			name(std::span<const T> in, std::span<T> out) {							\
+		detail::check_span<T>(in.size(), out.size());										\
+		tlap::name(in.data(), out.data(), in.size());										\
+	}																						\
+	T_BATCH_VECTOR	name(const Vector<T> &v) {												\
+		Vector<T> res = Vector<T>::uninitialized(v.shape());								\
+		tlap::name(v.data(), res.data(), v.shape());										\
+		return res;																			\
+	}
+
+// exp and log
+TLAP_BATCH_UNARY(exp, T)
+TLAP_BATCH_UNARY(ln, T)
+TLAP_BATCH_UNARY(log10, T)
+TLAP_BATCH_UNARY(log2, T)
+
+// root
+TLAP_BATCH_UNARY(sqrt, T)
+TLAP_BATCH_UNARY(rsqrt, T)
+TLAP_BATCH_UNARY(cbrt, T)
+
+T_BATCH			root(const T *in, T *out, size_t n, int degree) {
+	TLAP_PROFILE_BATCH("root");
+	if (degree == 0)
+		throw std::invalid_argument("The root of degree 0 is undefined.");
+	detail::batch_map<kernel::wide_t<T>>(in, out, n, [degree](auto v) TLAP_INLINE { return kernel::rootn(v, degree); });
+}
+
+T_BATCH			root(std::span<const T> in, std::span<T> out, int degree) {
+	detail::check_span<T>(in.size(), out.size());
+	tlap::root(in.data(), out.data(), in.size(), degree);
+}
+
+T_BATCH_VECTOR	root(const Vector<T> &v, int degree) {
+	Vector<T> res = Vector<T>::uninitialized(v.shape());
+	tlap::root(v.data(), res.data(), v.shape(), degree);
+	return res;
+}
+
+// trigonometry
+TLAP_BATCH_UNARY(sin, kernel::wide_t<T>, kernel::trig_limit<kernel::wide_t<T>>(), kernel::sin_large<T>)
+TLAP_BATCH_UNARY(cos, kernel::wide_t<T>, kernel::trig_limit<kernel::wide_t<T>>(), kernel::cos_large<T>)
+TLAP_BATCH_UNARY(tan, kernel::wide_t<T>, kernel::trig_limit<kernel::wide_t<T>>(), kernel::tan_large<T>)
+TLAP_BATCH_UNARY(asin, kernel::wide_t<T>)
+TLAP_BATCH_UNARY(acos, kernel::wide_t<T>)
+TLAP_BATCH_UNARY(atan, kernel::wide_t<T>)
+
+T_BATCH			sincos(const T *in, T *s, T *c, size_t n) {
+	TLAP_PROFILE_BATCH("sincos");
+	using C = kernel::wide_t<T>;
+	using S = simd::pack<C, simd::isa::scalar>;
+	const C	limit = kernel::trig_limit<C>();
+
+	detail::batch_split<T>(n, [&] <typename V> (size_t i, size_t simd_end, size_t end) TLAP_INLINE {
+		using W = detail::compute_pack<C, V>;
+		for (; i < simd_end; i += W::width) {
+			W x = W::loadu(in + i);
+			W vs, vc;
+			kernel::sincos(x, vs, vc);
+			vs.storeu(s + i);
+			vc.storeu(c + i);
+			if ((abs(x) > W(limit)).any()) {
+				C tmp[W::width];
+				x.storeu(tmp);
+				for (size_t j = 0; j < W::width; ++j)
+					if (std::fabs(tmp[j]) > limit)
+						kernel::sincos_large(static_cast<T>(tmp[j]), s[i + j], c[i + j]);
+			}
+		}
+		for (; i < end; ++i) {
+			T x = in[i];
+			if (std::fabs(x) > limit)
+				kernel::sincos_large(x, s[i], c[i]);
+			else {
+				S vs, vc;
+				kernel::sincos(S(x), vs, vc);
+				s[i] = static_cast<T>(vs.v);
+				c[i] = static_cast<T>(vc.v);
+			}
+		}
+	});
+}
+
+T_BATCH			sincos(std::span<const T> in, std::span<T> s, std::span<T> c) {
+	detail::check_span<T>(in.size(), s.size());
+	detail::check_span<T>(in.size(), c.size());
+	tlap::sincos(in.data(), s.data(), c.data(), in.size());
+}
+
+T_BATCH			atan2(const T *y, const T *x, T *out, size_t n) {
+	TLAP_PROFILE_BATCH("atan2");
+	detail::batch_map<kernel::wide_t<T>>(y, x, out, n, [](auto a, auto b) TLAP_INLINE { return kernel::atan2(a, b); });
+}
+
+T_BATCH			atan2(std::span<const T> y, std::span<const T> x, std::span<T> out) {
+	if (x.size() != y.size())
+		throw std::invalid_argument("atan2() needs spans of the same size.");
+	detail::check_span<T>(y.size(), out.size());
+	tlap::atan2(y.data(), x.data(), out.data(), y.size());
+}
+
+T_BATCH_VECTOR	atan2(const Vector<T> &y, const Vector<T> &x) {
+	if (x.shape() != y.shape())
+		throw std::invalid_argument("atan2() needs vectors of the same size.");
+	Vector<T> res = Vector<T>::uninitialized(y.shape());
+	tlap::atan2(y.data(), x.data(), res.data(), y.shape());
+	return res;
+}
+
+// hyperbolic
+TLAP_BATCH_UNARY(sinh, kernel::wide_t<T>)
+TLAP_BATCH_UNARY(cosh, kernel::wide_t<T>)
+TLAP_BATCH_UNARY(tanh, kernel::wide_t<T>)
+
+#undef TLAP_BATCH_UNARY
+#undef TLAP_PROFILE_BATCH
+
+} // namespace tlap
@@ -0,0 +1,24 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: accuracy policies of the math functions
+// File version: 0.1
+#pragma once
+
+#include "../hyperp.hpp"
+#include <concepts>
+
+// every function of math.hpp takes an optional policy, tlap::exp<tlap::fast>(x)
+// or tlap::exp<tlap::precise>(x); without one it uses MATH_POLICY (hyperp.hpp).
+namespace	tlap {
+	// within 1 ulp, measured bounds listed in math.tpp: compensated double
+	// kernels, float run through them where the float kernels would miss it
+	struct	precise {};
+	// a few ulp: shorter polynomials, no compensated sums, divisions and square
+	// roots through the approximate rcp / rsqrt instructions plus Newton steps
+	struct	fast {};
+
+	template <typename P>
+	concept math_policy = std::same_as<P, precise> || std::same_as<P, fast>;
+
+	using default_policy = MATH_POLICY;
+	using reduce_policy = REDUCE_POLICY; // of the Vector reductions, precise is Kahan-compensated
+}
@@ -0,0 +1,107 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: where tlap storage comes from, recycled size classes, arenas
+// File version: 0.1
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// every Vector, Matrix and Tensor buffer and every gemm packing buffer comes
+// from memory::allocate() (simd::aligned_alloc): alignment-aligned bytes from
+// the allocator of the calling thread, a scope one if any, else the one the
+// thread gave to use(), else the recycler. each block keeps its allocator in
+// a header of alignment bytes just below it, so it is always given back to
+// the allocator it came from, whatever is current when it is freed.
+namespace	tlap::memory {
+	inline constexpr size_t	alignment = 64; // simd::alignment
+
+	// bytes on an alignment boundary; deallocate gets the same bytes back
+	class	allocator {
+		public:
+			virtual ~allocator() = default;
+			virtual void	*allocate(size_t bytes) = 0;
+			virtual void	deallocate(void *p, size_t bytes) = 0;
+	};
+
+	// the default: blocks up to MEMORY_RECYCLE_MAX bytes are rounded up to a
+	// size class (64-byte steps to 1 KiB, then 4 classes per power of two) and
+	// freed blocks wait on a free list of their class, per thread, for the
+	// next allocation of the class. at most MEMORY_RECYCLE_KEEP blocks a class
+	// and MEMORY_RECYCLE_BYTES a thread are kept, the rest goes back to the
+	// system, as do the lists of a thread when it ends
+	class	recycler final : public allocator {
+		public:
+			void	*allocate(size_t bytes) override;
+			void	deallocate(void *p, size_t bytes) override;
+			static void	trim(); // frees the lists of the calling thread
+	};
+
+	// bump allocation from chunks of at least MEMORY_ARENA_CHUNK bytes: no
+	// bookkeeping per block, deallocate only takes back the last block. reset()
+	// reclaims everything at once (a request done) and keeps the chunks; no
+	// block of the arena may be used after it. one thread at a time
+	class	arena final : public allocator {
+		private:
+			struct	chunk {
+				char	*base;
+				size_t	size;
+				size_t	used;
+			};
+
+			std::vector<chunk>	_chunks;
+			size_t				_current; // chunks before it are full
+			size_t				_chunk;
+
+		public:
+			explicit arena(size_t chunk = 0); // 0: MEMORY_ARENA_CHUNK
+			~arena();
+			arena(const arena &) = delete;
+			arena	&operator=(const arena &) = delete;
+
+			void	*allocate(size_t bytes) override;
+			void	deallocate(void *p, size_t bytes) override;
+			void	reset();
+			size_t	used() const; // bytes handed out since the last reset
+			size_t	reserved() const; // bytes of the chunks
+	};
+
+	// a makes the allocations of the calling thread while the scope lives,
+	// scopes nest. the threads of parallel/pool.hpp keep their own allocator
+	class	scope {
+		private:
+			allocator	*_saved;
+
+		public:
+			explicit scope(allocator &a);
+			~scope();
+			scope(const scope &) = delete;
+			scope	&operator=(const scope &) = delete;
+	};
+
+	// the allocator of the calling thread outside a scope, nullptr for the
+	// recycler: an arena per request thread, reset() between requests. other
+	// threads, the pool ones included, never see it
+	void		use(allocator *a);
+	allocator	&current(); // of the calling thread
+
+	void		*allocate(size_t bytes); // bytes may be 0, never returns null (throws std::bad_alloc)
+	void		deallocate(void *p); // p from allocate() or null
+
+	// a standard allocator on allocate(), buffers rounded up to whole aligned
+	// blocks: a std::vector<T, aligned_allocator<T>> moves into a Vector without a copy
+	template <typename T>
+	struct	aligned_allocator {
+		using value_type = T;
+
+		aligned_allocator() = default;
+		template <typename U>
+		aligned_allocator(const aligned_allocator<U> &) {}
+
+		T		*allocate(size_t n) { return static_cast<T *>(memory::allocate((n * sizeof(T) + alignment - 1) / alignment * alignment)); }
+		void	deallocate(T *p, size_t) { memory::deallocate(p); }
+		template <typename U>
+		bool	operator==(const aligned_allocator<U> &) const { return true; }
+	};
+}
+
+#include "allocator.tpp"
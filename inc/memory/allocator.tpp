@@ -0,0 +1,229 @@
+#pragma once
+
+#include "allocator.hpp"
+#include "../hyperp.hpp"
+#include "../profile/profile.hpp"
+#include <algorithm>
+#include <bit>
+#include <new>
+
+namespace tlap::memory {
+
+namespace detail {
+
+// below every block handed out by memory::allocate()
+struct	header {
+	allocator	*owner;
+	size_t		bytes; // asked of owner, the header included
+};
+static_assert(sizeof(header) <= alignment);
+
+inline void	*system_alloc(size_t bytes) {
+	return ::operator new(bytes, std::align_val_t(alignment));
+}
+
+inline void	system_free(void *p) {
+	::operator delete(p, std::align_val_t(alignment));
+}
+
+// 64-byte steps up to 1 KiB (classes 0 to 15), then quarters of a power of two
+inline size_t	size_class(size_t bytes, size_t &size) {
+	if (bytes <= 1024) {
+		size = std::max<size_t>((bytes + 63) / 64, 1) * 64;
+		return size / 64 - 1;
+	}
+	const size_t	p = std::bit_width(bytes - 1) - 1; // 2^p < bytes <= 2^(p + 1)
+	const size_t	q = size_t(1) << (p - 2);
+	size = (bytes + q - 1) / q * q;
+	return 16 + (p - 10) * 4 + size / q - 5;
+}
+
+inline constexpr size_t	size_classes = 16 + (std::bit_width(size_t(MEMORY_RECYCLE_MAX) - 1) - 10) * 4;
+
+// a freed block holds the next one of its list in its first bytes
+struct	free_lists {
+	void	*head[size_classes] = {};
+	size_t	count[size_classes] = {};
+	size_t	bytes = 0;
+
+	void	clear() {
+		for (size_t c = 0; c < size_classes; ++c) {
+			while (head[c]) {
+				void *next = *static_cast<void **>(head[c]);
+				system_free(head[c]);
+				head[c] = next;
+			}
+			count[c] = 0;
+		}
+		bytes = 0;
+	}
+};
+
+// a block freed on a thread that is ending, or by a static object after the
+// lists of the main thread are gone, goes straight back to the system
+inline thread_local bool	lists_gone = false;
+
+struct	thread_lists : free_lists {
+	~thread_lists() {
+		clear();
+		lists_gone = true;
+	}
+};
+
+inline free_lists	*lists() {
+	if (lists_gone)
+		return nullptr;
+	static thread_local thread_lists l;
+	return &l;
+}
+
+inline thread_local allocator	*scoped = nullptr;
+inline thread_local allocator	*used = nullptr; // use(), under the scopes
+
+inline allocator	&default_allocator() {
+	static recycler r;
+	return r;
+}
+
+} // namespace detail
+
+// recycler
+
+inline void	*recycler::allocate(size_t bytes) {
+	if (bytes > MEMORY_RECYCLE_MAX)
+		return detail::system_alloc(bytes);
+	size_t				size;
+	const size_t		c = detail::size_class(bytes, size);
+	detail::free_lists	*l = detail::lists();
+
+	if (l && l->head[c]) {
+		void *p = l->head[c];
+		l->head[c] = *static_cast<void **>(p);
+		--l->count[c];
+		l->bytes -= size;
+		return p;
+	}
+	return detail::system_alloc(size);
+}
+
+inline void	recycler::deallocate(void *p, size_t bytes) {
+	if (bytes > MEMORY_RECYCLE_MAX)
+		return detail::system_free(p);
+	size_t				size;
+	const size_t		c = detail::size_class(bytes, size);
+	detail::free_lists	*l = detail::lists();
+
+	if (!l || l->count[c] >= MEMORY_RECYCLE_KEEP || l->bytes + size > MEMORY_RECYCLE_BYTES)
+		return detail::system_free(p);
+	*static_cast<void **>(p) = l->head[c];
+	l->head[c] = p;
+	++l->count[c];
+	l->bytes += size;
+}
+
+inline void	recycler::trim() {
+	if (detail::free_lists *l = detail::lists())
+		l->clear();
+}
+
+// arena
+
+inline arena::arena(size_t chunk)
+	: _current(0), _chunk(chunk ? chunk : MEMORY_ARENA_CHUNK) {
+}
+
+inline arena::~arena() {
+	for (chunk &c : _chunks)
+		detail::system_free(c.base);
+}
+
+// a block that does not fit what is left of the current chunk moves on to the
+// next chunk big enough (after a reset), or to a new one
+inline void	*arena::allocate(size_t bytes) {
+	bytes = (bytes + alignment - 1) / alignment * alignment;
+	for (; _current < _chunks.size(); ++_current) {
+		chunk &c = _chunks[_current];
+		if (c.size - c.used >= bytes) {
+			void *p = c.base + c.used;
+			c.used += bytes;
+			return p;
+		}
+	}
+	const size_t size = std::max(_chunk, bytes);
+	_chunks.push_back({static_cast<char *>(detail::system_alloc(size)), size, bytes});
+	_current = _chunks.size() - 1;
+	return _chunks.back().base;
+}
+
+inline void	arena::deallocate(void *p, size_t bytes) {
+	bytes = (bytes + alignment - 1) / alignment * alignment;
+	if (_current < _chunks.size()) {
+		chunk &c = _chunks[_current];
+		if (static_cast<char *>(p) + bytes == c.base + c.used)
+			c.used -= bytes;
+	}
+}
+
+inline void	arena::reset() {
+	for (chunk &c : _chunks)
+		c.used = 0;
+	_current = 0;
+}
+
+inline size_t	arena::used() const {
+	size_t n = 0;
+	for (const chunk &c : _chunks)
+		n += c.used;
+	return n;
+}
+
+inline size_t	arena::reserved() const {
+	size_t n = 0;
+	for (const chunk &c : _chunks)
+		n += c.size;
+	return n;
+}
+
+// scope
+
+inline scope::scope(allocator &a)
+	: _saved(detail::scoped) {
+	detail::scoped = &a;
+}
+
+inline scope::~scope() {
+	detail::scoped = _saved;
+}
+
+// current allocator
+
+inline void	use(allocator *a) {
+	detail::used = a;
+}
+
+inline allocator	&current() {
+	if (detail::scoped)
+		return *detail::scoped;
+	return (detail::used ? *detail::used : detail::default_allocator());
+}
+
+inline void	*allocate(size_t bytes) {
+	TLAP_PROFILE_MEMORY(allocate, bytes);
+	allocator	&a = current();
+	char		*base = static_cast<char *>(a.allocate(bytes + alignment));
+
+	*reinterpret_cast<detail::header *>(base) = {&a, bytes + alignment};
+	return base + alignment;
+}
+
+inline void	deallocate(void *p) {
+	if (!p)
+		return;
+	char					*base = static_cast<char *>(p) - alignment;
+	const detail::header	h = *reinterpret_cast<detail::header *>(base);
+	TLAP_PROFILE_MEMORY(deallocate, h.bytes - alignment);
+
+	h.owner->deallocate(base, h.bytes);
+}
+
+} // namespace tlap::memory
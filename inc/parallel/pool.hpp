@@ -0,0 +1,97 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: the threads of tlap, a work-stealing pool behind every parallel kernel
+// File version: 0.1
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// every parallel loop of tlap (Vector elementwise operations and reductions,
+// batch math, gemm / gemv, transformBatch, Tensor, einsum, sparse products)
+// is a parallel_for run by one executor: the tlap pool by default, or one the
+// application supplies with use(), so that tlap shares the threads of a
+// multithreaded service instead of adding its own.
+// the tlap pool starts on first use with TLAP_THREADS threads (environment),
+// std::thread::hardware_concurrency() without it; the calling thread counts as
+// one of them and runs tasks too. a parallel_for inside a task runs inline on
+// that task's thread, calls from several application threads share the pool.
+namespace	tlap::parallel {
+	// runs task(0) .. task(tasks - 1), possibly concurrently, and returns when
+	// all of them are done. the first exception a task throws is rethrown
+	class	executor {
+		public:
+			virtual ~executor() = default;
+			virtual size_t	concurrency() const = 0; // threads one run() may use, the caller included
+			virtual void	run(size_t tasks, const std::function<void(size_t)> &task) = 0;
+	};
+
+	// a deque of tasks per worker: a worker takes its own newest task first and
+	// steals the oldest of another when its deque is empty; run() deals the
+	// tasks out in contiguous runs and the caller steals until its call is done
+	class	pool final : public executor {
+		private:
+			struct	job;
+			struct	queue;
+
+			std::vector<std::thread>			_workers;
+			std::vector<std::unique_ptr<queue>>	_queues; // one per worker
+			std::mutex							_sleep;
+			std::condition_variable				_wake;
+			size_t								_pending; // queued tasks, under _sleep
+			bool								_stop;
+
+			void	_work(size_t self);
+			bool	_runOne(size_t first); // one task from any deque, first tried first
+
+		public:
+			explicit pool(size_t threads = 0, bool pin = false); // 0: hardware_concurrency(); pin worker i to core i + 1 (linux)
+			~pool();
+			pool(const pool &) = delete;
+			pool	&operator=(const pool &) = delete;
+
+			size_t	concurrency() const override;
+			void	run(size_t tasks, const std::function<void(size_t)> &task) override;
+	};
+
+	void		configure(size_t threads, bool pin = false); // rebuilds the tlap pool, 1 runs everything on the caller; not while tlap calls run
+	void		use(executor *e); // all parallel loops run on e from now on, nullptr goes back to the tlap pool
+	executor	&current();
+
+	// f(b, e) over [begin, end) cut into tasks of whole grains: at most
+	// PARALLEL_TASKS_PER_THREAD tasks per thread of the executor (so that
+	// stealing can even out uneven tasks), never a task of less than grain
+	// items, and every task boundary at begin + a multiple of grain. a range of
+	// one grain, a single thread or a call from inside a task runs inline
+	template <typename F>
+	void		parallel_for(size_t begin, size_t end, size_t grain, F &&f, const char *label = "");
+
+	// profiling: while on, every parallel_for is timed and added to the totals
+	// of its label (the kernel: "gemm", "vector", "reduce"...), then handed to
+	// observer if any. off by default, a call then reads no clock. built with
+	// TLAP_PROFILE, each call and each of its tasks is also a trace region of
+	// profile/profile.hpp
+	struct	report {
+		const char	*label;
+		size_t		items;
+		size_t		tasks; // 1 when it ran inline
+		size_t		threads;
+		double		seconds; // wall time of the call
+	};
+
+	struct	totals {
+		size_t	serialCalls, parallelCalls;
+		double	serialSeconds, parallelSeconds; // inline calls, calls spread over the threads
+	};
+
+	void		profile(bool on, void (*observer)(const report &) = nullptr);
+	totals		stats(const char *label = nullptr); // of one label, of all of them without
+	void		resetStats();
+}
+
+#include "pool.tpp"
@@ -0,0 +1,301 @@
+#pragma once
+
+#include "pool.hpp"
+#include "../hyperp.hpp"
+#include "../profile/profile.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <map>
+#include <string>
+#include <utility>
+#if defined(__linux__)
+# include <pthread.h>
+# include <sched.h>
+#endif
+
+namespace tlap::parallel {
+
+namespace detail {
+
+// set while this thread runs a task of a parallel_for: loops nested in it run inline
+inline thread_local bool	in_task = false;
+
+struct	task_scope {
+	bool	saved;
+
+	task_scope() : saved(in_task) { in_task = true; }
+	~task_scope() { in_task = saved; }
+};
+
+struct	state {
+	std::mutex						lock;
+	std::unique_ptr<pool>			own;
+	std::atomic<executor *>			ownPtr{nullptr};
+	std::atomic<executor *>			active{nullptr}; // supplied by use(), null for the tlap pool
+	std::atomic<bool>				profiling{false};
+	void							(*observer)(const report &) = nullptr;
+	std::map<std::string, totals>	byLabel; // under lock
+};
+
+inline state	&global() {
+	static state s;
+	return s;
+}
+
+inline size_t	env_threads() {
+	const char *v = std::getenv("TLAP_THREADS");
+	const long	n = (v ? std::strtol(v, nullptr, 10) : 0);
+	return (n > 0 ? static_cast<size_t>(n) : 0);
+}
+
+inline void	record(const report &r) {
+	state	&s = global();
+	void	(*observer)(const report &);
+	{
+		std::lock_guard<std::mutex> guard(s.lock);
+		totals &t = s.byLabel[r.label];
+		if (r.tasks > 1) {
+			++t.parallelCalls;
+			t.parallelSeconds += r.seconds;
+		} else {
+			++t.serialCalls;
+			t.serialSeconds += r.seconds;
+		}
+		observer = s.observer;
+	}
+	if (observer)
+		observer(r);
+}
+
+} // namespace detail
+
+// pool
+
+struct	pool::job {
+	const std::function<void(size_t)>	*task;
+	std::atomic<size_t>					left;
+	std::mutex							errorLock;
+	std::exception_ptr					error;
+};
+
+struct	pool::queue {
+	std::mutex										lock;
+	std::deque<std::pair<std::shared_ptr<job>, size_t>>	tasks;
+};
+
+inline pool::pool(size_t threads, bool pin)
+	: _pending(0), _stop(false) {
+	const size_t cores = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	if (!threads)
+		threads = cores;
+	for (size_t i = 0; i + 1 < threads; ++i)
+		_queues.push_back(std::make_unique<queue>());
+	for (size_t i = 0; i + 1 < threads; ++i) {
+		_workers.emplace_back([this, i] { _work(i); });
+#if defined(__linux__)
+		if (pin) {
+			cpu_set_t set;
+			CPU_ZERO(&set);
+			CPU_SET((i + 1) % cores, &set);
+			pthread_setaffinity_np(_workers.back().native_handle(), sizeof(set), &set);
+		}
+#else
+		(void)pin;
+#endif
+	}
+}
+
+inline pool::~pool() {
+	{
+		std::lock_guard<std::mutex> guard(_sleep);
+		_stop = true;
+	}
+	_wake.notify_all();
+	for (std::thread &t : _workers)
+		t.join();
+}
+
+inline size_t	pool::concurrency() const {
+	return _workers.size() + 1;
+}
+
+// a worker's own deque from the back (the newest task), any other from the
+// front (the oldest, the furthest from what its owner works on)
+inline bool	pool::_runOne(size_t first) {
+	std::pair<std::shared_ptr<job>, size_t>	item;
+	const size_t							w = _queues.size();
+
+	for (size_t k = 0; k < w && !item.first; ++k) {
+		queue						&q = *_queues[(first + k) % w];
+		std::lock_guard<std::mutex>	guard(q.lock);
+		if (q.tasks.empty())
+			continue;
+		if (k == 0 && first < w) {
+			item = std::move(q.tasks.back());
+			q.tasks.pop_back();
+		} else {
+			item = std::move(q.tasks.front());
+			q.tasks.pop_front();
+		}
+	}
+	if (!item.first)
+		return false;
+	{
+		std::lock_guard<std::mutex> guard(_sleep);
+		--_pending;
+	}
+
+	job &j = *item.first;
+	try {
+		(*j.task)(item.second);
+	} catch (...) {
+		std::lock_guard<std::mutex> guard(j.errorLock);
+		if (!j.error)
+			j.error = std::current_exception();
+	}
+	if (j.left.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		j.left.notify_all();
+	return true;
+}
+
+inline void	pool::_work(size_t self) {
+	for (;;) {
+		if (_runOne(self))
+			continue;
+		std::unique_lock<std::mutex> lock(_sleep);
+		_wake.wait(lock, [this] { return _stop || _pending > 0; });
+		if (_stop)
+			return;
+	}
+}
+
+// the job is shared with the deques: a worker may still notify it after the
+// caller has seen it finished and returned
+inline void	pool::run(size_t tasks, const std::function<void(size_t)> &task) {
+	if (_workers.empty() || tasks <= 1) {
+		for (size_t t = 0; t < tasks; ++t)
+			task(t);
+		return;
+	}
+	auto			j = std::make_shared<job>();
+	const size_t	w = _queues.size();
+
+	j->task = &task;
+	j->left = tasks;
+	for (size_t q = 0; q < w; ++q) {
+		std::lock_guard<std::mutex> guard(_queues[q]->lock);
+		for (size_t t = q * tasks / w; t < (q + 1) * tasks / w; ++t)
+			_queues[q]->tasks.emplace_back(j, t);
+	}
+	{
+		std::lock_guard<std::mutex> guard(_sleep);
+		_pending += tasks;
+	}
+	_wake.notify_all();
+
+	const size_t first = w + std::hash<std::thread::id>()(std::this_thread::get_id()) % w; // >= w: steals only
+	for (size_t left; (left = j->left.load(std::memory_order_acquire)) != 0;)
+		if (!_runOne(first))
+			j->left.wait(left, std::memory_order_acquire); // the last tasks run on workers
+	if (j->error)
+		std::rethrow_exception(j->error);
+}
+
+// the tlap pool and the executor in use
+
+inline void	configure(size_t threads, bool pin) {
+	detail::state				&s = detail::global();
+	std::lock_guard<std::mutex>	guard(s.lock);
+
+	s.ownPtr = nullptr;
+	s.own.reset();
+	s.own = std::make_unique<pool>(threads, pin);
+	s.ownPtr = s.own.get();
+}
+
+inline void	use(executor *e) {
+	detail::global().active = e;
+}
+
+inline executor	&current() {
+	detail::state	&s = detail::global();
+	executor		*e = s.active.load(std::memory_order_acquire);
+
+	if (!e)
+		e = s.ownPtr.load(std::memory_order_acquire);
+	if (e)
+		return *e;
+	std::lock_guard<std::mutex> guard(s.lock);
+	if (!s.own) {
+		s.own = std::make_unique<pool>(detail::env_threads());
+		s.ownPtr = s.own.get();
+	}
+	return *s.own;
+}
+
+template <typename F>
+void	parallel_for(size_t begin, size_t end, size_t grain, F &&f, const char *label) {
+	using clock = std::chrono::steady_clock;
+	if (end <= begin)
+		return;
+	TLAP_PROFILE_REGION(*label ? label : "parallel_for");
+	grain = std::max<size_t>(grain, 1);
+	const size_t			n = end - begin;
+	const size_t			grains = (n + grain - 1) / grain;
+	const bool				timed = detail::global().profiling.load(std::memory_order_relaxed);
+	const clock::time_point	start = (timed ? clock::now() : clock::time_point());
+	executor				*e = (grains > 1 && !detail::in_task ? &current() : nullptr);
+	const size_t			threads = (e ? e->concurrency() : 1);
+	const size_t			tasks = (threads > 1 ? std::min(grains, threads * PARALLEL_TASKS_PER_THREAD) : 1);
+
+	if (tasks == 1)
+		f(begin, end);
+	else {
+		const size_t per = grains / tasks, extra = grains % tasks;
+		e->run(tasks, [&](size_t t) {
+			const size_t		g0 = t * per + std::min(t, extra), g1 = g0 + per + (t < extra);
+			detail::task_scope	scope;
+			TLAP_PROFILE_REGION(*label ? label : "parallel_for");
+			f(begin + g0 * grain, std::min(end, begin + g1 * grain));
+		});
+	}
+	if (timed)
+		detail::record({label, n, tasks, threads, std::chrono::duration<double>(clock::now() - start).count()});
+}
+
+// profiling
+
+inline void	profile(bool on, void (*observer)(const report &)) {
+	detail::state				&s = detail::global();
+	std::lock_guard<std::mutex>	guard(s.lock);
+
+	s.observer = observer;
+	s.profiling = on;
+}
+
+inline totals	stats(const char *label) {
+	detail::state				&s = detail::global();
+	std::lock_guard<std::mutex>	guard(s.lock);
+	totals						res = {};
+
+	for (const auto &[name, t] : s.byLabel)
+		if (!label || name == label) {
+			res.serialCalls += t.serialCalls;
+			res.parallelCalls += t.parallelCalls;
+			res.serialSeconds += t.serialSeconds;
+			res.parallelSeconds += t.parallelSeconds;
+		}
+	return res;
+}
+
+inline void	resetStats() {
+	detail::state				&s = detail::global();
+	std::lock_guard<std::mutex>	guard(s.lock);
+
+	s.byLabel.clear();
+}
+
+} // namespace tlap::parallel
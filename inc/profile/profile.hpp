@@ -0,0 +1,78 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: hot path counters and trace regions, compiled out unless TLAP_PROFILE is 1
+// File version: 0.1
+#pragma once
+
+#include "../hyperp.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace	tlap::simd::dispatch {
+	enum class	level; // simd/dispatch.hpp
+}
+
+// built with -DTLAP_PROFILE=1, every kernel call of tlap adds to the counters
+// of its kernel (calls, elements, cycles, the isa level it ran at, the calls
+// a size threshold sent to the one-lane path) and every memory::allocate()
+// / deallocate() to the allocation counters. capture() reads them all, for a
+// service to publish. trace(true) also records the parallel loops and the
+// TLAP_PROFILE_REGION scopes of any thread, writeTrace() exports them in the
+// Chrome trace event format (chrome://tracing, Perfetto).
+// with TLAP_PROFILE 0 (the default) the macros are empty and tlap reads no
+// clock; the functions below still exist and return empty results.
+// cycles are time stamp counter cycles (reference cycles, not core cycles)
+namespace	tlap::profile {
+	inline constexpr bool	enabled = TLAP_PROFILE;
+
+	struct	kernel_stats {
+		const char	*name; // "dispatch.add", "gemm", "math.exp"...
+		const char	*type; // element type
+		size_t		calls;
+		size_t		elements;
+		uint64_t	cycles;
+		size_t		byLevel[3]; // calls per simd::dispatch::level
+		size_t		fallbacks; // calls sent to the one-lane kernels by a size threshold
+	};
+
+	struct	memory_stats {
+		size_t		allocations, allocatedBytes;
+		size_t		deallocations, deallocatedBytes;
+		uint64_t	cycles; // inside allocate() and deallocate()
+	};
+
+	struct	snapshot {
+		std::vector<kernel_stats>	kernels; // in the order of their first call
+		memory_stats				memory;
+		size_t						events; // trace regions held
+		size_t						dropped; // past PROFILE_TRACE_MAX on their thread
+	};
+
+	snapshot	capture();
+	void		reset(); // counters to 0, trace emptied
+	void		trace(bool on); // off by default
+	void		writeTrace(std::ostream &out);
+	void		writeJson(std::ostream &out, const snapshot &s);
+	uint64_t	cycles(); // time stamp counter, steady_clock nanoseconds off x86
+
+	template <typename T>
+	const char	*type_name();
+}
+
+#if TLAP_PROFILE
+// one counter per (name, T) for the whole program; the statement times the
+// rest of its scope. fallback (optional) is true for a threshold fallback
+# define TLAP_PROFILE_KERNEL(name, T, level, elements, ...)											\
+	static ::tlap::profile::detail::counter	tlap_profile_counter_(name, ::tlap::profile::type_name<T>());	\
+	const ::tlap::profile::detail::kernel_scope	tlap_profile_kernel_(tlap_profile_counter_, level, elements __VA_OPT__(,) __VA_ARGS__)
+// a trace region over the rest of the scope, name a string literal
+# define TLAP_PROFILE_REGION(name)	const ::tlap::profile::detail::region	tlap_profile_region_(name)
+# define TLAP_PROFILE_MEMORY(op, bytes)	const ::tlap::profile::detail::memory_scope	tlap_profile_memory_(::tlap::profile::detail::memory_op::op, bytes)
+#else
+# define TLAP_PROFILE_KERNEL(name, T, level, elements, ...)	((void)0)
+# define TLAP_PROFILE_REGION(name)	((void)0)
+# define TLAP_PROFILE_MEMORY(op, bytes)	((void)0)
+#endif
+
+#include "profile.tpp"
@@ -0,0 +1,313 @@
+#pragma once
+
+#include "profile.hpp"
+#include "../math/half.hpp"
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#if defined(__x86_64__) || defined(__i386__)
+# include <x86intrin.h>
+#endif
+
+namespace tlap::profile {
+
+namespace detail {
+
+struct	entry {
+	const char				*name;
+	const char				*type;
+	std::atomic<size_t>		calls{0};
+	std::atomic<size_t>		elements{0};
+	std::atomic<uint64_t>	cycles{0};
+	std::atomic<size_t>		byLevel[3]{};
+	std::atomic<size_t>		fallbacks{0};
+
+	entry(const char *n, const char *t) : name(n), type(t) {}
+};
+
+enum class	memory_op { allocate, deallocate };
+
+struct	event {
+	const char	*name;
+	uint64_t	start; // nanoseconds since the first trace region
+	uint64_t	duration;
+};
+
+// one per thread that recorded a region, kept after the thread ends
+struct	thread_trace {
+	std::mutex			lock; // against writeTrace() and reset() only
+	std::vector<event>	events;
+	size_t				dropped = 0;
+	size_t				id;
+};
+
+struct	state {
+	std::mutex									lock;
+	std::deque<entry>							entries; // under lock, never moved
+	std::atomic<size_t>							allocations{0}, allocatedBytes{0};
+	std::atomic<size_t>							deallocations{0}, deallocatedBytes{0};
+	std::atomic<uint64_t>						memoryCycles{0};
+	std::atomic<bool>							tracing{false};
+	std::vector<std::shared_ptr<thread_trace>>	threads; // under lock
+	const std::chrono::steady_clock::time_point	epoch = std::chrono::steady_clock::now();
+};
+
+// never destroyed: blocks are still freed by the destructors of other statics
+inline state	&global() {
+	static state *s = new state;
+	return *s;
+}
+
+inline uint64_t	since_epoch() {
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - global().epoch).count());
+}
+
+inline thread_trace	&local_trace() {
+	static thread_local std::shared_ptr<thread_trace>	t = [] {
+		state						&s = global();
+		std::lock_guard<std::mutex>	guard(s.lock);
+		auto						created = std::make_shared<thread_trace>();
+		created->id = s.threads.size() + 1;
+		s.threads.push_back(created);
+		return created;
+	}();
+	return *t;
+}
+
+// the entry of (name, type), shared by every instantiation of the kernel
+class	counter {
+	private:
+		entry	*_entry;
+
+	public:
+		counter(const char *name, const char *type) {
+			state						&s = global();
+			std::lock_guard<std::mutex>	guard(s.lock);
+			for (entry &e : s.entries)
+				if (!std::strcmp(e.name, name) && !std::strcmp(e.type, type)) {
+					_entry = &e;
+					return;
+				}
+			_entry = &s.entries.emplace_back(name, type);
+		}
+
+		entry	&get() const { return *_entry; }
+};
+
+class	kernel_scope {
+	private:
+		entry		&_entry;
+		size_t		_level;
+		size_t		_elements;
+		bool		_fallback;
+		uint64_t	_start;
+
+	public:
+		kernel_scope(const counter &c, simd::dispatch::level l, size_t elements, bool fallback = false)
+			: _entry(c.get()), _level(static_cast<size_t>(l)), _elements(elements), _fallback(fallback), _start(cycles()) {}
+		~kernel_scope() {
+			_entry.cycles.fetch_add(cycles() - _start, std::memory_order_relaxed);
+			_entry.calls.fetch_add(1, std::memory_order_relaxed);
+			_entry.elements.fetch_add(_elements, std::memory_order_relaxed);
+			_entry.byLevel[_level].fetch_add(1, std::memory_order_relaxed);
+			if (_fallback)
+				_entry.fallbacks.fetch_add(1, std::memory_order_relaxed);
+		}
+		kernel_scope(const kernel_scope &) = delete;
+		kernel_scope	&operator=(const kernel_scope &) = delete;
+};
+
+class	memory_scope {
+	private:
+		memory_op	_op;
+		size_t		_bytes;
+		uint64_t	_start;
+
+	public:
+		memory_scope(memory_op op, size_t bytes) : _op(op), _bytes(bytes), _start(cycles()) {}
+		~memory_scope() {
+			state	&s = global();
+			s.memoryCycles.fetch_add(cycles() - _start, std::memory_order_relaxed);
+			if (_op == memory_op::allocate) {
+				s.allocations.fetch_add(1, std::memory_order_relaxed);
+				s.allocatedBytes.fetch_add(_bytes, std::memory_order_relaxed);
+			} else {
+				s.deallocations.fetch_add(1, std::memory_order_relaxed);
+				s.deallocatedBytes.fetch_add(_bytes, std::memory_order_relaxed);
+			}
+		}
+		memory_scope(const memory_scope &) = delete;
+		memory_scope	&operator=(const memory_scope &) = delete;
+};
+
+// reads the clock only while tracing is on
+class	region {
+	private:
+		const char	*_name;
+		bool		_on;
+		uint64_t	_start;
+
+	public:
+		explicit region(const char *name)
+			: _name(name), _on(global().tracing.load(std::memory_order_relaxed)), _start(_on ? since_epoch() : 0) {}
+		~region() {
+			if (!_on)
+				return;
+			const uint64_t				end = since_epoch();
+			thread_trace				&t = local_trace();
+			std::lock_guard<std::mutex>	guard(t.lock);
+			if (t.events.size() < PROFILE_TRACE_MAX)
+				t.events.push_back({_name, _start, end - _start});
+			else
+				++t.dropped;
+		}
+		region(const region &) = delete;
+		region	&operator=(const region &) = delete;
+};
+
+// names are string literals of tlap or of the caller, escaped all the same
+inline void	write_string(std::ostream &out, const char *s) {
+	out << '"';
+	for (; *s; ++s) {
+		if (*s == '"' || *s == '\\')
+			out << '\\';
+		if (static_cast<unsigned char>(*s) >= 0x20)
+			out << *s;
+	}
+	out << '"';
+}
+
+// nanoseconds as microseconds with three decimals
+inline void	write_us(std::ostream &out, uint64_t ns) {
+	char	buf[32];
+	std::snprintf(buf, sizeof(buf), "%llu.%03llu", static_cast<unsigned long long>(ns / 1000), static_cast<unsigned long long>(ns % 1000));
+	out << buf;
+}
+
+} // namespace detail
+
+inline uint64_t	cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+template <typename T>
+const char	*type_name() {
+	if constexpr (std::is_same<T, float>::value)
+		return "float";
+	else if constexpr (std::is_same<T, double>::value)
+		return "double";
+	else if constexpr (std::is_same<T, long double>::value)
+		return "long double";
+	else if constexpr (std::is_same<T, half>::value)
+		return "half";
+	else if constexpr (std::is_same<T, bfloat16>::value)
+		return "bfloat16";
+	else if constexpr (std::is_integral<T>::value) {
+		constexpr const char	*names[2][4] = {{"uint8", "uint16", "uint32", "uint64"}, {"int8", "int16", "int32", "int64"}};
+		return names[std::is_signed<T>::value][std::bit_width(sizeof(T)) - 1];
+	} else
+		return "other";
+}
+
+inline snapshot	capture() {
+	detail::state	&s = detail::global();
+	snapshot		res = {};
+	{
+		std::lock_guard<std::mutex> guard(s.lock);
+		for (const detail::entry &e : s.entries) {
+			kernel_stats	k = {e.name, e.type, e.calls.load(), e.elements.load(), e.cycles.load(), {}, e.fallbacks.load()};
+			for (size_t l = 0; l < 3; ++l)
+				k.byLevel[l] = e.byLevel[l].load();
+			res.kernels.push_back(k);
+		}
+		for (const auto &t : s.threads) {
+			std::lock_guard<std::mutex> tguard(t->lock);
+			res.events += t->events.size();
+			res.dropped += t->dropped;
+		}
+	}
+	res.memory = {s.allocations.load(), s.allocatedBytes.load(), s.deallocations.load(), s.deallocatedBytes.load(), s.memoryCycles.load()};
+	return res;
+}
+
+inline void	reset() {
+	detail::state				&s = detail::global();
+	std::lock_guard<std::mutex>	guard(s.lock);
+
+	for (detail::entry &e : s.entries) {
+		e.calls = 0;
+		e.elements = 0;
+		e.cycles = 0;
+		for (auto &l : e.byLevel)
+			l = 0;
+		e.fallbacks = 0;
+	}
+	s.allocations = s.allocatedBytes = 0;
+	s.deallocations = s.deallocatedBytes = 0;
+	s.memoryCycles = 0;
+	for (const auto &t : s.threads) {
+		std::lock_guard<std::mutex> tguard(t->lock);
+		t->events.clear();
+		t->dropped = 0;
+	}
+}
+
+inline void	trace(bool on) {
+	detail::global().tracing = on;
+}
+
+// complete events ("ph": "X"), microseconds
+inline void	writeTrace(std::ostream &out) {
+	detail::state				&s = detail::global();
+	std::lock_guard<std::mutex>	guard(s.lock);
+	const char					*sep = "\n";
+
+	out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+	for (const auto &t : s.threads) {
+		std::lock_guard<std::mutex> tguard(t->lock);
+		for (const detail::event &e : t->events) {
+			out << sep << "{\"name\": ";
+			detail::write_string(out, e.name);
+			out << ", \"cat\": \"tlap\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << t->id << ", \"ts\": ";
+			detail::write_us(out, e.start);
+			out << ", \"dur\": ";
+			detail::write_us(out, e.duration);
+			out << '}';
+			sep = ",\n";
+		}
+	}
+	out << "\n]}\n";
+}
+
+inline void	writeJson(std::ostream &out, const snapshot &s) {
+	const char	*sep = "\n";
+
+	out << "{\"kernels\": [";
+	for (const kernel_stats &k : s.kernels) {
+		out << sep << "{\"name\": ";
+		detail::write_string(out, k.name);
+		out << ", \"type\": ";
+		detail::write_string(out, k.type);
+		out << ", \"calls\": " << k.calls << ", \"elements\": " << k.elements << ", \"cycles\": " << k.cycles
+			<< ", \"scalar\": " << k.byLevel[0] << ", \"avx2\": " << k.byLevel[1] << ", \"avx512\": " << k.byLevel[2]
+			<< ", \"fallbacks\": " << k.fallbacks << '}';
+		sep = ",\n";
+	}
+	out << "\n], \"memory\": {\"allocations\": " << s.memory.allocations << ", \"allocated_bytes\": " << s.memory.allocatedBytes
+		<< ", \"deallocations\": " << s.memory.deallocations << ", \"deallocated_bytes\": " << s.memory.deallocatedBytes
+		<< ", \"cycles\": " << s.memory.cycles << "}, \"trace\": {\"events\": " << s.events << ", \"dropped\": " << s.dropped << "}}\n";
+}
+
+} // namespace tlap::profile
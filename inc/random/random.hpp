@@ -0,0 +1,89 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: counter-based random numbers and bulk fills of Vector, Matrix and Tensor
+// File version: 0.1
+#pragma once
+
+#include "../Vector/Vector.hpp"
+#include "../Matrix/Matrix.hpp"
+#include "../Tensor/Tensor.hpp"
+#include "../math/half.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace	tlap::random {
+	// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2,
+	// 3"): block c of a stream is a fixed function of (seed, stream, c), four
+	// 32-bit words, so any block is computed without the ones before it. the
+	// fills compute many blocks at once on the simd level of active() (see
+	// simd/dispatch.hpp), every level giving the same words.
+	// a philox is a position in its stream: operator() hands out its words one
+	// at a time (a UniformRandomBitGenerator for the <random> distributions),
+	// a fill takes the blocks it needs from counter() on and moves it past them.
+	// split() gives a stream of its own to each thread or job of one seed
+	class	philox {
+		private:
+			uint64_t	_seed; // the key
+			uint64_t	_stream; // upper half of the counter
+			uint64_t	_counter; // next block
+			uint32_t	_words[4]; // of the block operator() is on
+			unsigned	_next; // first word of _words not handed out, 4 when none
+
+		public:
+			using result_type = uint32_t;
+
+			explicit philox(uint64_t seed = 0, uint64_t stream = 0);
+
+			static constexpr result_type	min() { return 0; }
+			static constexpr result_type	max() { return std::numeric_limits<result_type>::max(); }
+			result_type	operator()(); // next word
+			void		discard(unsigned long long words);
+
+			void		blocks(uint64_t first, uint32_t *out, size_t count) const; // blocks first .. first + count - 1, 4 words each, counter() unchanged
+			uint64_t	advance(uint64_t count); // counter() before, then skips count blocks
+			philox		split(uint64_t stream) const; // same seed, block 0 of another stream
+
+			uint64_t	seed() const;
+			uint64_t	stream() const;
+			uint64_t	counter() const;
+	};
+
+	// the type the bounds, mean and stddev of a fill are given in
+	template <typename T>
+	using param_t = std::conditional_t<std::is_integral<T>::value, T, compute_t<T>>;
+
+	// element i of a fill is computed from the blocks at counter() plus a fixed
+	// function of i: the same values whatever the threads or the layout (the
+	// padding of a Vector or of the Matrix rows is left as is, a Tensor view is
+	// filled in row-major order), and the simd level but for the last bits of
+	// a normal fill on the scalar level, which has no fma.
+	// floating types are computed in float (float, half, bfloat16) or double,
+	// integers from one 32-bit word, two for 64-bit types.
+	// uniform: [lo, hi) for floating types, from 24 / 53 random bits and
+	// clamped below hi as stored (lo when lo == hi); [lo, hi]
+	// for integers by a multiply-shift of the word. no rejection, so that the
+	// value of i stays fixed: a bias below (hi - lo + 1) / 2^32 (2^64).
+	// normal: Box-Muller on the simd math kernels of MATH_POLICY, floating
+	// types only.
+	// throws std::invalid_argument if lo > hi or stddev < 0
+	template <typename T>
+	void	fillUniform(T *data, size_t n, param_t<T> lo, param_t<T> hi, philox &gen);
+	template <typename T>
+	void	fillUniform(Vector<T> &v, param_t<T> lo, param_t<T> hi, philox &gen);
+	template <typename T>
+	void	fillUniform(Matrix<T> &m, param_t<T> lo, param_t<T> hi, philox &gen);
+	template <typename T>
+	void	fillUniform(Tensor<T> &t, param_t<T> lo, param_t<T> hi, philox &gen);
+
+	template <typename T>
+	void	fillNormal(T *data, size_t n, param_t<T> mean, param_t<T> stddev, philox &gen);
+	template <typename T>
+	void	fillNormal(Vector<T> &v, param_t<T> mean, param_t<T> stddev, philox &gen);
+	template <typename T>
+	void	fillNormal(Matrix<T> &m, param_t<T> mean, param_t<T> stddev, philox &gen);
+	template <typename T>
+	void	fillNormal(Tensor<T> &t, param_t<T> mean, param_t<T> stddev, philox &gen);
+}
+
+#include "random.tpp"
@@ -0,0 +1,268 @@
+#pragma once
+
+#include "random.hpp"
+#include "random_kernels.tpp"
+#include "../hyperp.hpp"
+#include "../parallel/pool.hpp"
+#include "../simd/dispatch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace tlap::random {
+
+// philox
+
+inline philox::philox(uint64_t seed, uint64_t stream)
+	: _seed(seed), _stream(stream), _counter(0), _words{}, _next(4) {
+}
+
+inline philox::result_type	philox::operator()() {
+	if (_next == 4) {
+		blocks(_counter++, _words, 1);
+		_next = 0;
+	}
+	return _words[_next++];
+}
+
+inline void	philox::discard(unsigned long long words) {
+	const unsigned long long	left = 4 - _next;
+	if (words <= left) {
+		_next += static_cast<unsigned>(words);
+		return;
+	}
+	words -= left;
+	_counter += words / 4;
+	_next = 4;
+	if (words % 4) {
+		blocks(_counter++, _words, 1);
+		_next = static_cast<unsigned>(words % 4);
+	}
+}
+
+inline void	philox::blocks(uint64_t first, uint32_t *out, size_t count) const {
+	detail::rng::philox_blocks(_seed, _stream, first, out, count);
+}
+
+// the words left of the block operator() is on are dropped
+inline uint64_t	philox::advance(uint64_t count) {
+	const uint64_t	first = _counter;
+	_counter += count;
+	_next = 4;
+	return first;
+}
+
+inline philox	philox::split(uint64_t stream) const {
+	return philox(_seed, stream);
+}
+
+inline uint64_t	philox::seed() const {
+	return _seed;
+}
+
+inline uint64_t	philox::stream() const {
+	return _stream;
+}
+
+inline uint64_t	philox::counter() const {
+	return _counter;
+}
+
+} // namespace tlap::random
+
+namespace tlap::detail {
+
+// the type a fill of T computes in
+template <typename T>
+using random_t = std::conditional_t<std::is_integral<T>::value, T, std::conditional_t<sizeof(compute_t<T>) <= 4, float, double>>;
+
+// 32-bit words per element
+template <typename T>
+inline constexpr size_t	random_words = (sizeof(random_t<T>) > 4 ? 2 : 1);
+
+// [0, 1) from word i, pair i for double
+template <typename R>
+inline R	random_unit(const uint32_t *w, size_t i) {
+	if constexpr (sizeof(R) <= 4)
+		return static_cast<R>(w[i] >> 8) * 0x1p-24f;
+	else
+		return static_cast<R>(((static_cast<uint64_t>(w[2 * i + 1]) << 32) | w[2 * i]) >> 11) * 0x1p-53;
+}
+
+// the n elements in tiles of RANDOM_TILE from index 0, tile t from the blocks
+// gen.counter() + t * (blocks per tile) on. tile(words, values) computes a
+// whole tile, store(first, values, count) writes count of them from index
+// first: whole tiles and fixed blocks, the values do not depend on the split
+// over the threads
+template <typename T, typename Tile, typename Store>
+void	random_tiles(size_t n, random::philox &gen, Tile tile, Store store) {
+	static_assert(RANDOM_TILE % 16 == 0, "RANDOM_TILE must be a multiple of 16");
+	using R = random_t<T>;
+	constexpr size_t	per_tile = RANDOM_TILE * random_words<T> / 4; // blocks
+	const size_t		tiles = (n + RANDOM_TILE - 1) / RANDOM_TILE;
+	const uint64_t		first = gen.advance(tiles * per_tile);
+	const size_t		grain = (n >= RANDOM_PARALLEL_MIN ? std::max<size_t>(RANDOM_GRAIN / RANDOM_TILE, 1) : tiles);
+
+	parallel::parallel_for(0, tiles, std::max<size_t>(grain, 1), [&](size_t t0, size_t t1) {
+		alignas(simd::alignment) uint32_t	words[RANDOM_TILE * random_words<T>];
+		alignas(simd::alignment) R			values[RANDOM_TILE];
+		for (size_t t = t0; t < t1; ++t) {
+			gen.blocks(first + t * per_tile, words, per_tile);
+			tile(words, values);
+			store(t * RANDOM_TILE, values, std::min<size_t>(RANDOM_TILE, n - t * RANDOM_TILE));
+		}
+	}, "random");
+}
+
+// the largest value below hi, once stored as T (lo if the range is empty):
+// low + span * unit can round up to hi, in R or in the narrowing to T
+template <typename T>
+random_t<T>	random_below(random::param_t<T> lo, random::param_t<T> hi) {
+	if (!(lo < hi))
+		return lo;
+	if constexpr (is_reduced_float<T>) {
+		T	h = static_cast<T>(hi);
+		if (!(static_cast<float>(h) < hi))
+			h = T::fromBits(static_cast<uint16_t>(h.bits & 0x8000 ? h.bits + 1 : (h.bits ? h.bits - 1 : 0x8001)));
+		return static_cast<float>(h);
+	} else
+		return std::nextafter(hi, lo);
+}
+
+template <typename T>
+auto	random_uniform(random::param_t<T> lo, random::param_t<T> hi) {
+	using R = random_t<T>;
+	if (hi < lo)
+		throw std::invalid_argument("fillUniform needs lo <= hi.");
+	if constexpr (std::is_integral<T>::value) {
+		using U = std::make_unsigned_t<T>;
+		const uint64_t	range = static_cast<uint64_t>(static_cast<U>(static_cast<U>(hi) - static_cast<U>(lo))) + 1; // 0: all of the 64 bits
+		return [lo, range](const uint32_t *w, R *out) {
+			if constexpr (sizeof(T) <= 4) {
+				TLAP_SIMD_LOOP
+				for (size_t i = 0; i < RANDOM_TILE; ++i)
+					out[i] = static_cast<T>(static_cast<U>(lo) + static_cast<U>((static_cast<uint64_t>(w[i]) * range) >> 32));
+			} else
+				for (size_t i = 0; i < RANDOM_TILE; ++i) {
+					const uint64_t	x = (static_cast<uint64_t>(w[2 * i + 1]) << 32) | w[2 * i];
+					const uint64_t	k = (range ? static_cast<uint64_t>((static_cast<unsigned __int128>(x) * range) >> 64) : x);
+					out[i] = static_cast<T>(static_cast<U>(lo) + static_cast<U>(k));
+				}
+		};
+	} else {
+		const R	low = static_cast<R>(lo), span = static_cast<R>(hi) - static_cast<R>(lo);
+		const R	top = random_below<T>(lo, hi);
+		return [low, span, top](const uint32_t *w, R *out) {
+			TLAP_SIMD_LOOP
+			for (size_t i = 0; i < RANDOM_TILE; ++i)
+				out[i] = std::min(low + span * random_unit<R>(w, i), top);
+		};
+	}
+}
+
+// pair j of the tile from 1 - unit(j) in (0, 1] and unit(j + half), to the
+// elements j and j + half
+template <typename T>
+auto	random_normal(random::param_t<T> mean, random::param_t<T> stddev) {
+	using R = random_t<T>;
+	if (stddev < 0)
+		throw std::invalid_argument("fillNormal needs stddev >= 0.");
+	const R	mu = static_cast<R>(mean), sigma = static_cast<R>(stddev);
+	return [mu, sigma](const uint32_t *w, R *out) {
+		constexpr size_t				half = RANDOM_TILE / 2;
+		alignas(simd::alignment) R		u[half];
+		alignas(simd::alignment) R		v[half];
+		TLAP_SIMD_LOOP
+		for (size_t j = 0; j < half; ++j) {
+			u[j] = R(1) - random_unit<R>(w, j);
+			v[j] = random_unit<R>(w, j + half);
+		}
+		rng::normal_pairs(u, v, out, half, mu, sigma);
+	};
+}
+
+// values to n contiguous elements
+template <typename T>
+auto	random_store(T *data) {
+	return [data](size_t first, const random_t<T> *values, size_t count) {
+		if constexpr (is_reduced_float<T>)
+			simd::dispatch::reduced<T>().narrow(data + first, values, count);
+		else
+			std::copy(values, values + count, data + first);
+	};
+}
+
+// element i at row i / cols, column i % cols of the padded rows
+template <typename T>
+auto	random_store(Matrix<T> &m) {
+	return [data = m.data(), cols = m.cols(), stride = m.stride()](size_t first, const random_t<T> *values, size_t count) {
+		while (count) {
+			const size_t	row = first / cols, col = first % cols;
+			const size_t	n = std::min(count, cols - col);
+			random_store(data + row * stride)(col, values, n);
+			first += n;
+			values += n;
+			count -= n;
+		}
+	};
+}
+
+// a strided view is filled through a contiguous copy
+template <typename T, typename Fill>
+void	random_tensor(Tensor<T> &t, Fill fill) {
+	if (t.isContiguous())
+		return fill(t.data(), t.size());
+	Tensor<T>	tmp = Tensor<T>::uninitialized(t.shape());
+	fill(tmp.data(), tmp.size());
+	t.assign(tmp);
+}
+
+} // namespace tlap::detail
+
+namespace tlap::random {
+
+// fills
+
+template <typename T>
+void	fillUniform(T *data, size_t n, param_t<T> lo, param_t<T> hi, philox &gen) {
+	static_assert(is_element<T> && !std::is_same<T, bool>::value, "fillUniform fills arithmetic types, half and bfloat16");
+	detail::random_tiles<T>(n, gen, detail::random_uniform<T>(lo, hi), detail::random_store(data));
+}
+
+template <typename T>
+void	fillUniform(Vector<T> &v, param_t<T> lo, param_t<T> hi, philox &gen) {
+	fillUniform(v.data(), v.shape(), lo, hi, gen);
+}
+
+template <typename T>
+void	fillUniform(Matrix<T> &m, param_t<T> lo, param_t<T> hi, philox &gen) {
+	detail::random_tiles<T>(m.rows() * m.cols(), gen, detail::random_uniform<T>(lo, hi), detail::random_store(m));
+}
+
+template <typename T>
+void	fillUniform(Tensor<T> &t, param_t<T> lo, param_t<T> hi, philox &gen) {
+	detail::random_tensor(t, [&](T *data, size_t n) { fillUniform(data, n, lo, hi, gen); });
+}
+
+template <typename T>
+void	fillNormal(T *data, size_t n, param_t<T> mean, param_t<T> stddev, philox &gen) {
+	static_assert(is_element<T> && !std::is_integral<T>::value, "fillNormal fills floating types, half and bfloat16");
+	detail::random_tiles<T>(n, gen, detail::random_normal<T>(mean, stddev), detail::random_store(data));
+}
+
+template <typename T>
+void	fillNormal(Vector<T> &v, param_t<T> mean, param_t<T> stddev, philox &gen) {
+	fillNormal(v.data(), v.shape(), mean, stddev, gen);
+}
+
+template <typename T>
+void	fillNormal(Matrix<T> &m, param_t<T> mean, param_t<T> stddev, philox &gen) {
+	detail::random_tiles<T>(m.rows() * m.cols(), gen, detail::random_normal<T>(mean, stddev), detail::random_store(m));
+}
+
+template <typename T>
+void	fillNormal(Tensor<T> &t, param_t<T> mean, param_t<T> stddev, philox &gen) {
+	detail::random_tensor(t, [&](T *data, size_t n) { fillNormal(data, n, mean, stddev, gen); });
+}
+
+} // namespace tlap::random
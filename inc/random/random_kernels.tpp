@@ -0,0 +1,195 @@
+#pragma once
+
+#include "../hyperp.hpp"
+#include "../math/kernels.tpp"
+#include "../math/policy.hpp"
+#include "../simd/simd.hpp"
+#include "../simd/dispatch.hpp"
+#include "../profile/profile.hpp"
+#include <cstddef>
+#include <cstdint>
+
+// philox blocks, one per 32-bit lane: a round is two vpmuludq per product (the
+// even and the odd lanes) and a blend of their halves. four vectors of
+// counters are in flight to hide the latency of the ten rounds, then a 4 x 4
+// transpose within the 128-bit lanes turns them into blocks of 4 words: the
+// counters are given to the lanes in the order that transpose puts back in
+// sequence. the rest goes through the scalar loop, every level gives the same
+// words.
+// the Box-Muller step runs on the math kernels (math/kernels.tpp) built for
+// the packs of the active() level, as the Vector maps (Vector/Vector.tpp)
+namespace tlap::detail::rng {
+
+inline constexpr uint32_t	philox_m0 = 0xD2511F53;
+inline constexpr uint32_t	philox_m1 = 0xCD9E8D57;
+inline constexpr uint32_t	philox_w0 = 0x9E3779B9; // key increments
+inline constexpr uint32_t	philox_w1 = 0xBB67AE85;
+inline constexpr size_t		philox_groups = 4; // vectors of counters in flight
+
+// counters (first + b, stream) under the key seed, 4 words per block to out
+inline void	philox_loop(uint64_t seed, uint64_t stream, uint64_t first, uint32_t *out, size_t count) {
+	for (size_t b = 0; b < count; ++b) {
+		const uint64_t	c = first + b;
+		uint32_t		x0 = static_cast<uint32_t>(c), x1 = static_cast<uint32_t>(c >> 32);
+		uint32_t		x2 = static_cast<uint32_t>(stream), x3 = static_cast<uint32_t>(stream >> 32);
+		uint32_t		k0 = static_cast<uint32_t>(seed), k1 = static_cast<uint32_t>(seed >> 32);
+		for (int r = 0; r < 10; ++r) {
+			const uint64_t	p0 = static_cast<uint64_t>(philox_m0) * x0;
+			const uint64_t	p1 = static_cast<uint64_t>(philox_m1) * x2;
+			x0 = static_cast<uint32_t>(p1 >> 32) ^ x1 ^ k0;
+			x1 = static_cast<uint32_t>(p1);
+			x2 = static_cast<uint32_t>(p0 >> 32) ^ x3 ^ k1;
+			x3 = static_cast<uint32_t>(p0);
+			k0 += philox_w0;
+			k1 += philox_w1;
+		}
+		out[4 * b] = x0;
+		out[4 * b + 1] = x1;
+		out[4 * b + 2] = x2;
+		out[4 * b + 3] = x3;
+	}
+}
+
+TLAP_TARGET_AVX512 inline void	philox_round_avx512(__m512i (&c)[4], __m512i k0, __m512i k1) {
+	const __m512i	m0 = _mm512_set1_epi32(static_cast<int>(philox_m0));
+	const __m512i	m1 = _mm512_set1_epi32(static_cast<int>(philox_m1));
+	const __m512i	e0 = _mm512_mul_epu32(c[0], m0), o0 = _mm512_mul_epu32(_mm512_srli_epi64(c[0], 32), m0);
+	const __m512i	e1 = _mm512_mul_epu32(c[2], m1), o1 = _mm512_mul_epu32(_mm512_srli_epi64(c[2], 32), m1);
+	const __m512i	hi0 = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(e0, 32), o0);
+	const __m512i	hi1 = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(e1, 32), o1);
+	c[0] = _mm512_ternarylogic_epi32(hi1, c[1], k0, 0x96); // three-way xor
+	c[1] = _mm512_mask_blend_epi32(0xAAAA, e1, _mm512_slli_epi64(o1, 32));
+	c[2] = _mm512_ternarylogic_epi32(hi0, c[3], k1, 0x96);
+	c[3] = _mm512_mask_blend_epi32(0xAAAA, e0, _mm512_slli_epi64(o0, 32));
+}
+
+TLAP_TARGET_AVX512 inline void	philox_avx512(uint64_t seed, uint64_t stream, uint64_t first, uint32_t *out, size_t count) {
+	constexpr size_t	step = 16 * philox_groups;
+	const __m512i		order = _mm512_setr_epi32(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+	size_t				b = 0;
+
+	for (; b + step <= count; b += step) {
+		__m512i	c[philox_groups][4];
+		for (size_t g = 0; g < philox_groups; ++g) {
+			const uint64_t	base = first + b + 16 * g;
+			const __m512i	high = _mm512_set1_epi32(static_cast<int>(base >> 32));
+			c[g][0] = _mm512_add_epi32(_mm512_set1_epi32(static_cast<int>(base)), order);
+			c[g][1] = _mm512_mask_add_epi32(high, _mm512_cmplt_epu32_mask(c[g][0], order), high, _mm512_set1_epi32(1)); // carry
+			c[g][2] = _mm512_set1_epi32(static_cast<int>(stream));
+			c[g][3] = _mm512_set1_epi32(static_cast<int>(stream >> 32));
+		}
+		uint32_t	k0 = static_cast<uint32_t>(seed), k1 = static_cast<uint32_t>(seed >> 32);
+		for (int r = 0; r < 10; ++r) {
+			const __m512i	kv0 = _mm512_set1_epi32(static_cast<int>(k0)), kv1 = _mm512_set1_epi32(static_cast<int>(k1));
+			for (size_t g = 0; g < philox_groups; ++g)
+				philox_round_avx512(c[g], kv0, kv1);
+			k0 += philox_w0;
+			k1 += philox_w1;
+		}
+		for (size_t g = 0; g < philox_groups; ++g) {
+			uint32_t		*o = out + 4 * (b + 16 * g);
+			const __m512i	t0 = _mm512_unpacklo_epi32(c[g][0], c[g][1]), t1 = _mm512_unpackhi_epi32(c[g][0], c[g][1]);
+			const __m512i	t2 = _mm512_unpacklo_epi32(c[g][2], c[g][3]), t3 = _mm512_unpackhi_epi32(c[g][2], c[g][3]);
+			_mm512_storeu_si512(o, _mm512_unpacklo_epi64(t0, t2));
+			_mm512_storeu_si512(o + 16, _mm512_unpackhi_epi64(t0, t2));
+			_mm512_storeu_si512(o + 32, _mm512_unpacklo_epi64(t1, t3));
+			_mm512_storeu_si512(o + 48, _mm512_unpackhi_epi64(t1, t3));
+		}
+	}
+	philox_loop(seed, stream, first + b, out + 4 * b, count - b);
+}
+
+TLAP_TARGET_AVX2 inline void	philox_round_avx2(__m256i (&c)[4], __m256i k0, __m256i k1) {
+	const __m256i	m0 = _mm256_set1_epi32(static_cast<int>(philox_m0));
+	const __m256i	m1 = _mm256_set1_epi32(static_cast<int>(philox_m1));
+	const __m256i	e0 = _mm256_mul_epu32(c[0], m0), o0 = _mm256_mul_epu32(_mm256_srli_epi64(c[0], 32), m0);
+	const __m256i	e1 = _mm256_mul_epu32(c[2], m1), o1 = _mm256_mul_epu32(_mm256_srli_epi64(c[2], 32), m1);
+	const __m256i	hi0 = _mm256_blend_epi32(_mm256_srli_epi64(e0, 32), o0, 0xAA);
+	const __m256i	hi1 = _mm256_blend_epi32(_mm256_srli_epi64(e1, 32), o1, 0xAA);
+	c[0] = _mm256_xor_si256(_mm256_xor_si256(hi1, c[1]), k0);
+	c[1] = _mm256_blend_epi32(e1, _mm256_slli_epi64(o1, 32), 0xAA);
+	c[2] = _mm256_xor_si256(_mm256_xor_si256(hi0, c[3]), k1);
+	c[3] = _mm256_blend_epi32(e0, _mm256_slli_epi64(o0, 32), 0xAA);
+}
+
+TLAP_TARGET_AVX2 inline void	philox_avx2(uint64_t seed, uint64_t stream, uint64_t first, uint32_t *out, size_t count) {
+	constexpr size_t	step = 8 * philox_groups;
+	const __m256i		order = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+	const __m256i		sign = _mm256_set1_epi32(static_cast<int>(0x80000000));
+	size_t				b = 0;
+
+	for (; b + step <= count; b += step) {
+		__m256i	c[philox_groups][4];
+		for (size_t g = 0; g < philox_groups; ++g) {
+			const uint64_t	base = first + b + 8 * g;
+			c[g][0] = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(base)), order);
+			const __m256i	carry = _mm256_cmpgt_epi32(_mm256_xor_si256(order, sign), _mm256_xor_si256(c[g][0], sign)); // -1 where it wrapped
+			c[g][1] = _mm256_sub_epi32(_mm256_set1_epi32(static_cast<int>(base >> 32)), carry);
+			c[g][2] = _mm256_set1_epi32(static_cast<int>(stream));
+			c[g][3] = _mm256_set1_epi32(static_cast<int>(stream >> 32));
+		}
+		uint32_t	k0 = static_cast<uint32_t>(seed), k1 = static_cast<uint32_t>(seed >> 32);
+		for (int r = 0; r < 10; ++r) {
+			const __m256i	kv0 = _mm256_set1_epi32(static_cast<int>(k0)), kv1 = _mm256_set1_epi32(static_cast<int>(k1));
+			for (size_t g = 0; g < philox_groups; ++g)
+				philox_round_avx2(c[g], kv0, kv1);
+			k0 += philox_w0;
+			k1 += philox_w1;
+		}
+		for (size_t g = 0; g < philox_groups; ++g) {
+			uint32_t		*o = out + 4 * (b + 8 * g);
+			const __m256i	t0 = _mm256_unpacklo_epi32(c[g][0], c[g][1]), t1 = _mm256_unpackhi_epi32(c[g][0], c[g][1]);
+			const __m256i	t2 = _mm256_unpacklo_epi32(c[g][2], c[g][3]), t3 = _mm256_unpackhi_epi32(c[g][2], c[g][3]);
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(o), _mm256_unpacklo_epi64(t0, t2));
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(o + 8), _mm256_unpackhi_epi64(t0, t2));
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(o + 16), _mm256_unpacklo_epi64(t1, t3));
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(o + 24), _mm256_unpackhi_epi64(t1, t3));
+		}
+	}
+	philox_loop(seed, stream, first + b, out + 4 * b, count - b);
+}
+
+inline void	philox_blocks(uint64_t seed, uint64_t stream, uint64_t first, uint32_t *out, size_t count) {
+	TLAP_PROFILE_KERNEL("random.philox", uint32_t, simd::dispatch::active(), count);
+	switch (simd::dispatch::active()) {
+		case simd::dispatch::level::avx512:	return philox_avx512(seed, stream, first, out, count);
+		case simd::dispatch::level::avx2:	return philox_avx2(seed, stream, first, out, count);
+		default:							return philox_loop(seed, stream, first, out, count);
+	}
+}
+
+// out[j] = mu + sigma r cos t, out[j + n] = mu + sigma r sin t for j < n, with
+// r = sqrt(-2 ln u[j]), t = 2 pi v[j]: u in (0, 1], v in [0, 1) (the small
+// argument path of sincos). n is a multiple of the pack width, all aligned.
+// always inlined into the isa kernels with the math kernels it calls
+template <typename X, typename R>
+TLAP_INLINE inline void	box_muller(const R *u, const R *v, R *out, size_t n, R mu, R sigma) {
+	for (size_t j = 0; j < n; j += X::width) {
+		const X	r = kernel::sqrt<MATH_POLICY>(X(R(-2)) * kernel::ln<MATH_POLICY>(X::load(u + j)));
+		X		s, c;
+		kernel::sincos<MATH_POLICY>(X(R(2 * PI)) * X::load(v + j), s, c);
+		fma(r * c, X(sigma), X(mu)).store(out + j);
+		fma(r * s, X(sigma), X(mu)).store(out + j + n);
+	}
+}
+
+template <typename R>
+[[gnu::flatten]] TLAP_TARGET_AVX512 void	box_muller_avx512(const R *u, const R *v, R *out, size_t n, R mu, R sigma) {
+	box_muller<simd::pack<R, simd::isa::avx512>>(u, v, out, n, mu, sigma);
+}
+
+template <typename R>
+[[gnu::flatten]] TLAP_TARGET_AVX2 void	box_muller_avx2(const R *u, const R *v, R *out, size_t n, R mu, R sigma) {
+	box_muller<simd::pack<R, simd::isa::avx2>>(u, v, out, n, mu, sigma);
+}
+
+template <typename R>
+void	normal_pairs(const R *u, const R *v, R *out, size_t n, R mu, R sigma) {
+	switch (simd::dispatch::active()) {
+		case simd::dispatch::level::avx512:	return box_muller_avx512(u, v, out, n, mu, sigma);
+		case simd::dispatch::level::avx2:	return box_muller_avx2(u, v, out, n, mu, sigma);
+		default:							return box_muller<simd::pack<R, simd::isa::scalar>>(u, v, out, n, mu, sigma);
+	}
+}
+
+} // namespace tlap::detail::rng
@@ -0,0 +1,72 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: run time choice of the isa of the hot elementwise kernels
+// File version: 0.1
+#pragma once
+
+#include "simd.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// the kernels of dispatch_kernels.tpp are built once per isa level in every
+// binary, whatever -march says. the first call to table<T>() picks the best
+// level the cpu supports (cpuid, through __builtin_cpu_supports) and hands
+// out that level's function pointer table from then on.
+// TLAP_SIMD=scalar|avx2|avx512 in the environment forces a level for testing,
+// a level above what the cpu supports falls back to the detected one, an
+// unknown value (a warning on stderr) to the detected level. there is no
+// sse4.2 level: such cpus run the scalar kernels.
+namespace	tlap::simd::dispatch {
+	enum class	level { scalar, avx2, avx512 };
+
+	// level of the isa of the compile flags (simd::isa::native)
+	inline constexpr level	native =
+		std::is_same<isa::native, isa::avx512>::value ? level::avx512 :
+		std::is_same<isa::native, isa::avx2>::value ? level::avx2 : level::scalar;
+
+	// what kernels::reduce folds: sum of a, of |a|, of a * b, of (a - b)^2;
+	// smallest a, largest a, largest |a|
+	enum class	reduction { sum, asum, dot, dist2, min, max, amax };
+
+	// n elements of aligned storage, n a multiple of alignment / sizeof(T)
+	// (Vector storage); out may be one of the inputs
+	template <typename T>
+	struct	kernels {
+		void	(*fill)(T *out, size_t n, T value);
+		void	(*add)(T *out, const T *a, const T *b, size_t n);
+		void	(*sub)(T *out, const T *a, const T *b, size_t n);
+		void	(*mul)(T *out, const T *a, const T *b, size_t n);
+		void	(*scale)(T *out, const T *a, size_t n, T s); // a * s
+		void	(*divide)(T *out, const T *a, size_t n, T s); // a / s
+		void	(*axpby)(T *out, const T *a, const T *b, size_t n, T fa, T fb); // a * fa + b * fb
+		void	(*axpy)(T *out, const T *a, const T *b, size_t n, T k); // a + b * k
+		void	(*clamp)(T *out, const T *a, size_t n, T low, T high);
+		bool	(*equal)(const T *a, const T *b, size_t n);
+		// any n, a aligned, b read by dot and dist2 only, n >= 1 for min, max and
+		// amax. compensated sums keep a Kahan correction per lane
+		T		(*reduce)(reduction r, bool compensated, const T *a, const T *b, size_t n);
+		// sum of a[i] * x[index[i]] over any n, a of any alignment: a sparse row
+		// against a dense vector
+		T		(*gather_dot)(const T *a, const uint32_t *index, const T *x, size_t n);
+	};
+
+	// half and bfloat16 (math/half.hpp): stored in 16 bits, computed in float
+	template <typename H>
+	struct	reduced_kernels {
+		void	(*widen)(float *out, const H *a, size_t n); // any n and alignment
+		void	(*narrow)(H *out, const float *a, size_t n); // rounds to nearest even
+		// as kernels::reduce, accumulated in float
+		float	(*reduce)(reduction r, bool compensated, const H *a, const H *b, size_t n);
+	};
+
+	level		detected(); // best level of this cpu
+	level		active(); // level in use, detected() unless TLAP_SIMD lowers it
+	const char	*name(level l);
+
+	template <typename T>
+	const kernels<T>	&table(); // kernels of active(), float and double only
+	template <typename H>
+	const reduced_kernels<H>	&reduced(); // kernels of active(), half and bfloat16 only
+}
+
+#include "dispatch.tpp"
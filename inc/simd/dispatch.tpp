@@ -0,0 +1,108 @@
+#pragma once
+
+#include "dispatch.hpp"
+#include "../profile/profile.hpp"
+#include <algorithm>
+#include <cpuid.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+// one copy of the kernels per level, each built for its own isa.
+// gcc 12 flags the self-initialized _mm512_undefined_* of its headers once
+// they are inlined here, see simd.hpp
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#define TLAP_DISPATCH_ISA scalar
+#include "dispatch_kernels.tpp"
+#undef TLAP_DISPATCH_ISA
+
+#pragma GCC push_options
+#if !(defined(__AVX2__) && defined(__FMA__) && defined(__F16C__))
+# pragma GCC target("avx2,fma,f16c")
+#endif
+#define TLAP_DISPATCH_ISA avx2
+#include "dispatch_kernels.tpp"
+#undef TLAP_DISPATCH_ISA
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#if !(defined(__AVX512F__) && defined(__AVX512DQ__))
+# pragma GCC target("avx512f,avx512dq")
+#endif
+#define TLAP_DISPATCH_ISA avx512
+#include "dispatch_kernels.tpp"
+#undef TLAP_DISPATCH_ISA
+#pragma GCC pop_options
+#pragma GCC diagnostic pop
+
+
+namespace tlap::simd::dispatch {
+
+inline level	detected() {
+	static const level	best = [] {
+		__builtin_cpu_init(); // may run before the constructors of libgcc
+		if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq"))
+			return level::avx512;
+		unsigned a, b, c, d; // f16c, unknown to __builtin_cpu_supports
+		if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __get_cpuid(1, &a, &b, &c, &d) && (c & bit_F16C))
+			return level::avx2;
+		return level::scalar;
+	}();
+	return best;
+}
+
+inline level	active() {
+	static const level	chosen = [] {
+		const char	*forced = std::getenv("TLAP_SIMD");
+		if (!forced || !*forced)
+			return detected();
+		for (level l : {level::scalar, level::avx2, level::avx512})
+			if (!std::strcmp(forced, name(l)))
+				return std::min(l, detected());
+		// a test override must not make every operation throw: one warning, then
+		// the detected level
+		std::fprintf(stderr, "tlap: TLAP_SIMD=%s is not scalar, avx2 or avx512, using %s\n", forced, name(detected()));
+		return detected();
+	}();
+	return chosen;
+}
+
+inline const char	*name(level l) {
+	switch (l) {
+		case level::avx512:	return "avx512";
+		case level::avx2:	return "avx2";
+		default:			return "scalar";
+	}
+}
+
+template <typename T>
+const kernels<T>	&table() {
+	static_assert(std::is_same<T, float>::value || std::is_same<T, double>::value, "only float and double kernels are dispatched");
+	static const kernels<T>	&chosen = [] () -> const kernels<T> & {
+		switch (active()) {
+			case level::avx512:	return avx512::table<T>;
+			case level::avx2:	return avx2::table<T>;
+			default:			return scalar::table<T>;
+		}
+	}();
+	return chosen;
+}
+
+template <typename H>
+const reduced_kernels<H>	&reduced() {
+	static_assert(is_reduced_float<H>, "only half and bfloat16 have reduced kernels");
+	static const reduced_kernels<H>	&chosen = [] () -> const reduced_kernels<H> & {
+		switch (active()) {
+			case level::avx512:	return avx512::reduced_table<H>;
+			case level::avx2:	return avx2::reduced_table<H>;
+			default:			return scalar::reduced_table<H>;
+		}
+	}();
+	return chosen;
+}
+
+} // namespace tlap::simd::dispatch
@@ -0,0 +1,278 @@
+// one level of the dispatched kernels, included by dispatch.tpp once per level
+// with TLAP_DISPATCH_ISA naming both the level and its isa, inside the matching
+// #pragma GCC target region. no include guard on purpose.
+
+namespace tlap::simd::dispatch::TLAP_DISPATCH_ISA {
+
+template <typename T>
+using V = pack<T, isa::TLAP_DISPATCH_ISA>;
+
+// the one-lane packs of the scalar level are left to the compiler to vectorize
+// for the baseline isa (sse2 on x86-64)
+template <typename T, typename F>
+inline void	map(T *out, const T *a, size_t n, F f) {
+	if constexpr (V<T>::width == 1) {
+		TLAP_SIMD_LOOP
+		for (size_t i = 0; i < n; ++i)
+			out[i] = f(V<T>(a[i])).v;
+	} else
+		for (size_t i = 0; i < n; i += V<T>::width)
+			f(V<T>::load(a + i)).store(out + i);
+}
+
+template <typename T, typename F>
+inline void	map(T *out, const T *a, const T *b, size_t n, F f) {
+	if constexpr (V<T>::width == 1) {
+		TLAP_SIMD_LOOP
+		for (size_t i = 0; i < n; ++i)
+			out[i] = f(V<T>(a[i]), V<T>(b[i])).v;
+	} else
+		for (size_t i = 0; i < n; i += V<T>::width)
+			f(V<T>::load(a + i), V<T>::load(b + i)).store(out + i);
+}
+
+template <typename T>
+void	fill(T *out, size_t n, T value) {
+	TLAP_PROFILE_KERNEL("dispatch.fill", T, level::TLAP_DISPATCH_ISA, n);
+	const V<T> v = value;
+	for (size_t i = 0; i < n; i += V<T>::width)
+		v.store(out + i);
+}
+
+template <typename T>
+void	add(T *out, const T *a, const T *b, size_t n) {
+	TLAP_PROFILE_KERNEL("dispatch.add", T, level::TLAP_DISPATCH_ISA, n);
+	map(out, a, b, n, [](V<T> x, V<T> y) { return x + y; });
+}
+
+template <typename T>
+void	sub(T *out, const T *a, const T *b, size_t n) {
+	TLAP_PROFILE_KERNEL("dispatch.sub", T, level::TLAP_DISPATCH_ISA, n);
+	map(out, a, b, n, [](V<T> x, V<T> y) { return x - y; });
+}
+
+template <typename T>
+void	mul(T *out, const T *a, const T *b, size_t n) {
+	TLAP_PROFILE_KERNEL("dispatch.mul", T, level::TLAP_DISPATCH_ISA, n);
+	map(out, a, b, n, [](V<T> x, V<T> y) { return x * y; });
+}
+
+template <typename T>
+void	scale(T *out, const T *a, size_t n, T s) {
+	TLAP_PROFILE_KERNEL("dispatch.scale", T, level::TLAP_DISPATCH_ISA, n);
+	const V<T> vs = s;
+	map(out, a, n, [vs](V<T> x) { return x * vs; });
+}
+
+template <typename T>
+void	divide(T *out, const T *a, size_t n, T s) {
+	TLAP_PROFILE_KERNEL("dispatch.divide", T, level::TLAP_DISPATCH_ISA, n);
+	const V<T> vs = s;
+	map(out, a, n, [vs](V<T> x) { return x / vs; });
+}
+
+template <typename T>
+void	axpby(T *out, const T *a, const T *b, size_t n, T fa, T fb) {
+	TLAP_PROFILE_KERNEL("dispatch.axpby", T, level::TLAP_DISPATCH_ISA, n);
+	const V<T> va = fa, vb = fb;
+	map(out, a, b, n, [va, vb](V<T> x, V<T> y) { return fma(x, va, y * vb); });
+}
+
+template <typename T>
+void	axpy(T *out, const T *a, const T *b, size_t n, T k) {
+	TLAP_PROFILE_KERNEL("dispatch.axpy", T, level::TLAP_DISPATCH_ISA, n);
+	const V<T> vk = k;
+	map(out, a, b, n, [vk](V<T> x, V<T> y) { return fma(y, vk, x); });
+}
+
+template <typename T>
+void	clamp(T *out, const T *a, size_t n, T low, T high) {
+	TLAP_PROFILE_KERNEL("dispatch.clamp", T, level::TLAP_DISPATCH_ISA, n);
+	const V<T> lo = low, hi = high;
+	map(out, a, n, [lo, hi](V<T> x) { return min(max(x, lo), hi); });
+}
+
+template <typename T>
+bool	equal(const T *a, const T *b, size_t n) {
+	TLAP_PROFILE_KERNEL("dispatch.equal", T, level::TLAP_DISPATCH_ISA, n);
+	for (size_t i = 0; i < n; i += V<T>::width)
+		if (!(V<T>::load(a + i) == V<T>::load(b + i)).all())
+			return false;
+	return true;
+}
+
+// what fold() adds per element, fused into the accumulator when it can be
+struct	r_sum {
+	template <typename X> static X	term(X x, X) { return x; }
+	template <typename X> static X	fold(X acc, X x, X) { return acc + x; }
+};
+struct	r_asum {
+	template <typename X> static X	term(X x, X) { return abs(x); }
+	template <typename X> static X	fold(X acc, X x, X) { return acc + abs(x); }
+};
+struct	r_dot {
+	template <typename X> static X	term(X x, X y) { return x * y; }
+	template <typename X> static X	fold(X acc, X x, X y) { return fma(x, y, acc); }
+};
+struct	r_dist2 {
+	template <typename X> static X	term(X x, X y) { return (x - y) * (x - y); }
+	template <typename X> static X	fold(X acc, X x, X y) { return fma(x - y, x - y, acc); }
+};
+// what extremum() keeps, merge combines two of its results
+struct	r_min {
+	using merge = r_min;
+	template <typename X> static X	fold(X acc, X x) { return min(acc, x); }
+};
+struct	r_max {
+	using merge = r_max;
+	template <typename X> static X	fold(X acc, X x) { return max(acc, x); }
+};
+struct	r_amax {
+	using merge = r_max;
+	template <typename X> static X	fold(X acc, X x) { return max(acc, abs(x)); }
+};
+
+// eight independent accumulators hide the add / fma latency (two ports of
+// four cycles). compensated, each lane carries the low part its sum lost
+// (Kahan). the last partial pack goes through one-lane packs. half and
+// bfloat16 are widened by the loads and summed in float
+template <typename A, typename Op, bool Compensated>
+inline compute_t<A>	fold(const A *a, const A *b, size_t n) {
+	using T = compute_t<A>;
+	using P = V<T>;
+	using S = pack<T, isa::scalar>;
+	constexpr size_t	k = 8;
+	P					acc[k], err[k];
+	S					sacc(T(0)), serr(T(0));
+	size_t				i = 0;
+
+	auto step = [] <typename X> (X &sum, X &c, X x, X y) {
+		if constexpr (Compensated) {
+			const X t = Op::term(x, y) - c;
+			const X u = sum + t;
+			c = (u - sum) - t;
+			sum = u;
+		} else
+			sum = Op::fold(sum, x, y);
+	};
+	for (size_t j = 0; j < k; ++j)
+		acc[j] = err[j] = P(T(0));
+	for (; i + k * P::width <= n; i += k * P::width)
+#pragma GCC unroll 8
+		for (size_t j = 0; j < k; ++j)
+			step(acc[j], err[j], P::load(a + i + j * P::width), P::load(b + i + j * P::width));
+	for (; i + P::width <= n; i += P::width)
+		step(acc[0], err[0], P::load(a + i), P::load(b + i));
+	for (; i < n; ++i)
+		step(sacc, serr, S(T(a[i])), S(T(b[i])));
+
+	const P	total = ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+	if constexpr (Compensated) {
+		const P	lost = ((err[0] + err[1]) + (err[2] + err[3])) + ((err[4] + err[5]) + (err[6] + err[7]));
+		return (reduce_add(total) + sacc.v) - (reduce_add(lost) + serr.v);
+	} else
+		return reduce_add(total) + sacc.v;
+}
+
+// min / max of n >= 1 elements, four accumulators started on the first element
+template <typename A, typename Op>
+inline compute_t<A>	extremum(const A *a, size_t n) {
+	using T = compute_t<A>;
+	using P = V<T>;
+	using S = pack<T, isa::scalar>;
+	const T	first = T(a[0]);
+	P		acc[4];
+	S		res = Op::fold(S(first), S(first));
+	size_t	i = 0;
+
+	for (size_t j = 0; j < 4; ++j)
+		acc[j] = Op::fold(P(first), P(first));
+	for (; i + 4 * P::width <= n; i += 4 * P::width)
+		for (size_t j = 0; j < 4; ++j)
+			acc[j] = Op::fold(acc[j], P::load(a + i + j * P::width));
+	for (; i + P::width <= n; i += P::width)
+		acc[0] = Op::fold(acc[0], P::load(a + i));
+	for (; i < n; ++i)
+		res = Op::fold(res, S(T(a[i])));
+
+	using M = typename Op::merge;
+	alignas(alignment) T	lanes[P::width];
+	M::fold(M::fold(acc[0], acc[1]), M::fold(acc[2], acc[3])).store(lanes);
+	for (size_t l = 0; l < P::width; ++l)
+		res = M::fold(res, S(lanes[l]));
+	return res.v;
+}
+
+template <typename T>
+compute_t<T>	reduce(reduction r, bool compensated, const T *a, const T *b, size_t n) {
+	TLAP_PROFILE_KERNEL("dispatch.reduce", T, level::TLAP_DISPATCH_ISA, n);
+	switch (r) {
+		case reduction::sum:	return compensated ? fold<T, r_sum, true>(a, a, n) : fold<T, r_sum, false>(a, a, n);
+		case reduction::asum:	return compensated ? fold<T, r_asum, true>(a, a, n) : fold<T, r_asum, false>(a, a, n);
+		case reduction::dot:	return compensated ? fold<T, r_dot, true>(a, b, n) : fold<T, r_dot, false>(a, b, n);
+		case reduction::dist2:	return compensated ? fold<T, r_dist2, true>(a, b, n) : fold<T, r_dist2, false>(a, b, n);
+		case reduction::min:	return extremum<T, r_min>(a, n);
+		case reduction::max:	return extremum<T, r_max>(a, n);
+		default:				return extremum<T, r_amax>(a, n);
+	}
+}
+
+// two accumulators: the gathers, not the fma latency, bound the loop. the
+// tail keeps two scalar chains, sparse rows are often shorter than a pack
+template <typename T>
+T		gather_dot(const T *a, const uint32_t *index, const T *x, size_t n) {
+	TLAP_PROFILE_KERNEL("dispatch.gather_dot", T, level::TLAP_DISPATCH_ISA, n);
+	using P = V<T>;
+	P		acc0(T(0)), acc1(T(0));
+	T		tail0 = T(0), tail1 = T(0);
+	size_t	i = 0;
+
+	for (; i + 2 * P::width <= n; i += 2 * P::width) {
+		acc0 = fma(P::loadu(a + i), P::gather(x, index + i), acc0);
+		acc1 = fma(P::loadu(a + i + P::width), P::gather(x, index + i + P::width), acc1);
+	}
+	for (; i + 2 <= n; i += 2) {
+		tail0 += a[i] * x[index[i]];
+		tail1 += a[i + 1] * x[index[i + 1]];
+	}
+	if (i < n)
+		tail0 += a[i] * x[index[i]];
+	return reduce_add(acc0 + acc1) + (tail0 + tail1);
+}
+
+// half and bfloat16 to float and back, through the converting pack loads and
+// stores of simd.hpp
+template <typename H>
+void	widen(float *out, const H *a, size_t n) {
+	TLAP_PROFILE_KERNEL("dispatch.widen", H, level::TLAP_DISPATCH_ISA, n);
+	using P = V<float>;
+	size_t	i = 0;
+
+	for (; i + P::width <= n; i += P::width)
+		P::loadu(a + i).storeu(out + i);
+	for (; i < n; ++i)
+		out[i] = static_cast<float>(a[i]);
+}
+
+template <typename H>
+void	narrow(H *out, const float *a, size_t n) {
+	TLAP_PROFILE_KERNEL("dispatch.narrow", H, level::TLAP_DISPATCH_ISA, n);
+	using P = V<float>;
+	size_t	i = 0;
+
+	for (; i + P::width <= n; i += P::width)
+		P::loadu(a + i).storeu(out + i);
+	for (; i < n; ++i)
+		out[i] = H(a[i]);
+}
+
+template <typename T>
+inline constexpr kernels<T>	table = {
+	fill<T>, add<T>, sub<T>, mul<T>, scale<T>, divide<T>, axpby<T>, axpy<T>,
+	clamp<T>, equal<T>, reduce<T>, gather_dot<T>
+};
+
+template <typename H>
+inline constexpr reduced_kernels<H>	reduced_table = {widen<H>, narrow<H>, reduce<H>};
+
+} // namespace tlap::simd::dispatch::TLAP_DISPATCH_ISA
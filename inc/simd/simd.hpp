@@ -0,0 +1,555 @@
+// Author: alde-oli, date: 17/10/2026
+// Description: thin SIMD pack abstraction used by the batch kernels
+// File version: 0.1
+#pragma once
+
+// gcc 12 flags the self-initialized _mm512_undefined_* helpers of its own headers
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+#include "../memory/allocator.hpp"
+#include "../math/half.hpp"
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+// a pack<T, Isa> holds pack<T, Isa>::width lanes of T and exposes the same small
+// set of operations for every instruction set, so a kernel is written once as
+// template <typename V> V f(V x) and instantiated for scalar, AVX2 and AVX-512.
+// the scalar pack has width 1 and is used for loop tails and scalar functions.
+
+namespace tlap::simd {
+
+namespace isa {
+	struct scalar {};
+	struct avx2 {};
+	struct avx512 {};
+
+#if defined(__AVX512F__) && defined(__AVX512DQ__)
+	using native = avx512;
+#elif defined(__AVX2__) && defined(__FMA__) && defined(__F16C__)
+	using native = avx2;
+#else
+	using native = scalar;
+#endif
+}
+
+template <typename T, typename Isa = isa::native>
+struct pack;
+
+// the AVX2 and AVX-512 packs exist whatever the compile flags: outside of the
+// native isa they are built for their own through #pragma GCC target, and may
+// only be used from code built for it too (see simd/dispatch.hpp). the pragma
+// does not reach hidden friends, they carry the target attribute themselves
+#if defined(__AVX2__) && defined(__FMA__) && defined(__F16C__)
+# define TLAP_TARGET_AVX2
+#else
+# define TLAP_TARGET_AVX2 __attribute__((target("avx2,fma,f16c")))
+#endif
+#if defined(__AVX512F__) && defined(__AVX512DQ__)
+# define TLAP_TARGET_AVX512
+#else
+# define TLAP_TARGET_AVX512 __attribute__((target("avx512f,avx512dq")))
+#endif
+
+// untargeted code between a target function and the packs it uses (expression
+// nodes, math kernels, library lambdas): always inlined into the caller, so
+// that no pack crosses a call built without the isa, -O0 included
+#define TLAP_INLINE __attribute__((always_inline))
+
+template <typename T>
+using uint_of = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+
+// byte alignment of aligned storage: one full register of the native isa,
+// and never less than a cache line so that blocks do not straddle two lines
+inline constexpr size_t	alignment = memory::alignment;
+
+// n elements of T on an alignment boundary, uninitialized; n may be 0. from
+// the allocator of the calling thread, see memory/allocator.hpp
+template <typename T>
+T		*aligned_alloc(size_t n) {
+	return static_cast<T *>(memory::allocate(n * sizeof(T)));
+}
+
+template <typename T>
+void	aligned_free(T *p) {
+	memory::deallocate(p);
+}
+
+// loop hint for the types without a pack (integers): lets the compiler
+// vectorize an element loop over aligned storage without a runtime alias check
+#if defined(_OPENMP)
+# define TLAP_SIMD_LOOP _Pragma("omp simd")
+#else
+# define TLAP_SIMD_LOOP _Pragma("GCC ivdep")
+#endif
+
+
+// ---------------------------------------------------------------------------
+// scalar (width 1), also the reference semantics of every operation
+// ---------------------------------------------------------------------------
+
+template <typename T>
+struct pack<T, isa::scalar> {
+	static_assert(std::is_floating_point<T>::value, "pack only supports float and double");
+
+	using value_type = T;
+	using isa_type = isa::scalar;
+	static constexpr size_t width = 1;
+	static constexpr int approx_bits = std::numeric_limits<T>::digits;	// of rcp / rsqrt
+
+	struct mask {
+		bool	m;
+		mask	operator&(mask o) const { return {m && o.m}; }
+		mask	operator|(mask o) const { return {m || o.m}; }
+		mask	operator~() const { return {!m}; }
+		bool	any() const { return m; }
+		bool	all() const { return m; }
+	};
+
+	T	v;
+
+	pack() = default;
+	pack(T x) : v(x) {}
+
+	static pack	load(const T *p) { return *p; }
+	static pack	loadu(const T *p) { return *p; }
+	static pack	gather(const T *base, const uint32_t *index) { return base[*index]; }
+	void		store(T *p) const { *p = v; }
+	void		storeu(T *p) const { *p = v; }
+	// 16-bit float storage (math/half.hpp), converted on load and store
+	template <typename H> requires is_reduced_float<H>
+	static pack	load(const H *p) { return static_cast<T>(static_cast<float>(*p)); }
+	template <typename H> requires is_reduced_float<H>
+	static pack	loadu(const H *p) { return static_cast<T>(static_cast<float>(*p)); }
+	template <typename H> requires is_reduced_float<H>
+	void		store(H *p) const { *p = H(static_cast<float>(v)); }
+	template <typename H> requires is_reduced_float<H>
+	void		storeu(H *p) const { *p = H(static_cast<float>(v)); }
+	// float storage of a double pack, widened on load and rounded on store
+	template <typename F> requires (std::is_same<F, float>::value && !std::is_same<T, float>::value)
+	static pack	loadu(const F *p) { return static_cast<T>(*p); }
+	template <typename F> requires (std::is_same<F, float>::value && !std::is_same<T, float>::value)
+	void		storeu(F *p) const { *p = static_cast<F>(v); }
+
+	pack	operator-() const { return -v; }
+	friend pack	operator+(pack a, pack b) { return a.v + b.v; }
+	friend pack	operator-(pack a, pack b) { return a.v - b.v; }
+	friend pack	operator*(pack a, pack b) { return a.v * b.v; }
+	friend pack	operator/(pack a, pack b) { return a.v / b.v; }
+
+	friend mask	operator<(pack a, pack b) { return {a.v < b.v}; }
+	friend mask	operator<=(pack a, pack b) { return {a.v <= b.v}; }
+	friend mask	operator>(pack a, pack b) { return {a.v > b.v}; }
+	friend mask	operator>=(pack a, pack b) { return {a.v >= b.v}; }
+	friend mask	operator==(pack a, pack b) { return {a.v == b.v}; }
+
+#ifdef __FMA__
+	friend pack	fma(pack a, pack b, pack c) { return std::fma(a.v, b.v, c.v); }
+#else
+	friend pack	fma(pack a, pack b, pack c) { return a.v * b.v + c.v; } // std::fma is a libm call without FMA
+#endif
+	friend pack	select(mask m, pack a, pack b) { return m.m ? a : b; }
+	friend pack	min(pack a, pack b) { return a.v < b.v ? a : b; }
+	friend pack	max(pack a, pack b) { return a.v > b.v ? a : b; }
+	friend pack	abs(pack a) { return std::fabs(a.v); }
+	friend pack	sqrt(pack a) { return std::sqrt(a.v); }
+	friend pack	rcp(pack a) { return T(1) / a.v; }
+	friend pack	rsqrt(pack a) { return T(1) / std::sqrt(a.v); }
+	friend pack	round(pack a) { return std::nearbyint(a.v); }
+	friend pack	floor(pack a) { return std::floor(a.v); }
+	friend pack	copysign(pack mag, pack sgn) { return std::copysign(mag.v, sgn.v); }
+	friend mask	signbit(pack a) { return {std::signbit(a.v)}; }
+	friend mask	isnan(pack a) { return {a.v != a.v}; }
+	// sum of the lanes
+	friend T	reduce_add(pack a) { return a.v; }
+
+	// 2^n for integer-valued n inside the normal exponent range
+	friend pack	pow2i(pack n) {
+		constexpr int mant = std::numeric_limits<T>::digits - 1;
+		constexpr int bias = std::numeric_limits<T>::max_exponent - 1;
+		return std::bit_cast<T>(static_cast<uint_of<T>>(static_cast<int64_t>(n.v) + bias) << mant);
+	}
+	// unbiased exponent of a positive normal value
+	friend pack	getexp(pack a) {
+		constexpr int mant = std::numeric_limits<T>::digits - 1;
+		constexpr int bias = std::numeric_limits<T>::max_exponent - 1;
+		return static_cast<T>(static_cast<int64_t>(std::bit_cast<uint_of<T>>(a.v) >> mant) - bias);
+	}
+	// mantissa of a positive normal value, in [1, 2)
+	friend pack	getmant(pack a) {
+		constexpr int mant = std::numeric_limits<T>::digits - 1;
+		constexpr uint_of<T> frac = (uint_of<T>(1) << mant) - 1;
+		constexpr uint_of<T> one = std::bit_cast<uint_of<T>>(T(1));
+		return std::bit_cast<T>((std::bit_cast<uint_of<T>>(a.v) & frac) | one);
+	}
+};
+
+
+// ---------------------------------------------------------------------------
+// AVX2 + FMA, 256-bit
+// ---------------------------------------------------------------------------
+
+#pragma GCC push_options
+#if !(defined(__AVX2__) && defined(__FMA__) && defined(__F16C__))
+# pragma GCC target("avx2,fma,f16c")
+#endif
+
+template <>
+struct pack<float, isa::avx2> {
+	using value_type = float;
+	using isa_type = isa::avx2;
+	static constexpr size_t width = 8;
+	static constexpr int approx_bits = 12;
+
+	struct mask {
+		__m256	m;
+		mask	operator&(mask o) const { return {_mm256_and_ps(m, o.m)}; }
+		mask	operator|(mask o) const { return {_mm256_or_ps(m, o.m)}; }
+		mask	operator~() const { return {_mm256_xor_ps(m, _mm256_castsi256_ps(_mm256_set1_epi32(-1)))}; }
+		bool	any() const { return _mm256_movemask_ps(m) != 0; }
+		bool	all() const { return _mm256_movemask_ps(m) == 0xff; }
+	};
+
+	__m256	v;
+
+	pack() = default;
+	pack(__m256 x) : v(x) {}
+	pack(float x) : v(_mm256_set1_ps(x)) {}
+
+	static pack	load(const float *p) { return _mm256_load_ps(p); }
+	static pack	loadu(const float *p) { return _mm256_loadu_ps(p); }
+	static pack	gather(const float *base, const uint32_t *index) { return _mm256_i32gather_ps(base, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(index)), 4); }
+	void		store(float *p) const { _mm256_store_ps(p, v); }
+	void		storeu(float *p) const { _mm256_storeu_ps(p, v); }
+	// half through f16c, bfloat16 is the upper half of a float
+	static pack	load(const half *p) { return _mm256_cvtph_ps(_mm_load_si128(reinterpret_cast<const __m128i *>(p))); }
+	static pack	loadu(const half *p) { return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p))); }
+	static pack	load(const bfloat16 *p) { return widen(_mm_load_si128(reinterpret_cast<const __m128i *>(p))); }
+	static pack	loadu(const bfloat16 *p) { return widen(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p))); }
+	void		store(half *p) const { _mm_store_si128(reinterpret_cast<__m128i *>(p), _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT)); }
+	void		storeu(half *p) const { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT)); }
+	void		store(bfloat16 *p) const { _mm_store_si128(reinterpret_cast<__m128i *>(p), narrow()); }
+	void		storeu(bfloat16 *p) const { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), narrow()); }
+
+	static pack	widen(__m128i h) { return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(h), 16)); }
+	// round to nearest even on the integer bits, a nan made quiet
+	__m128i		narrow() const {
+		const __m256i	u = _mm256_castps_si256(v);
+		__m256i			r = _mm256_add_epi32(u, _mm256_add_epi32(_mm256_set1_epi32(0x7fff), _mm256_and_si256(_mm256_srli_epi32(u, 16), _mm256_set1_epi32(1))));
+		r = _mm256_blendv_epi8(r, _mm256_or_si256(u, _mm256_set1_epi32(0x400000)), _mm256_castps_si256(_mm256_cmp_ps(v, v, _CMP_UNORD_Q)));
+		r = _mm256_srli_epi32(r, 16);
+		return _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packus_epi32(r, r), 0x08));
+	}
+
+	pack	operator-() const { return _mm256_xor_ps(v, _mm256_set1_ps(-0.0f)); }
+	friend TLAP_TARGET_AVX2 pack	operator+(pack a, pack b) { return _mm256_add_ps(a.v, b.v); }
+	friend TLAP_TARGET_AVX2 pack	operator-(pack a, pack b) { return _mm256_sub_ps(a.v, b.v); }
+	friend TLAP_TARGET_AVX2 pack	operator*(pack a, pack b) { return _mm256_mul_ps(a.v, b.v); }
+	friend TLAP_TARGET_AVX2 pack	operator/(pack a, pack b) { return _mm256_div_ps(a.v, b.v); }
+
+	friend TLAP_TARGET_AVX2 mask	operator<(pack a, pack b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)}; }
+	friend TLAP_TARGET_AVX2 mask	operator<=(pack a, pack b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ)}; }
+	friend TLAP_TARGET_AVX2 mask	operator>(pack a, pack b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)}; }
+	friend TLAP_TARGET_AVX2 mask	operator>=(pack a, pack b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ)}; }
+	friend TLAP_TARGET_AVX2 mask	operator==(pack a, pack b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ)}; }
+
+	friend TLAP_TARGET_AVX2 pack	fma(pack a, pack b, pack c) { return _mm256_fmadd_ps(a.v, b.v, c.v); }
+	friend TLAP_TARGET_AVX2 pack	select(mask m, pack a, pack b) { return _mm256_blendv_ps(b.v, a.v, m.m); }
+	friend TLAP_TARGET_AVX2 pack	min(pack a, pack b) { return _mm256_min_ps(a.v, b.v); }
+	friend TLAP_TARGET_AVX2 pack	max(pack a, pack b) { return _mm256_max_ps(a.v, b.v); }
+	friend TLAP_TARGET_AVX2 pack	abs(pack a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v); }
+	friend TLAP_TARGET_AVX2 pack	sqrt(pack a) { return _mm256_sqrt_ps(a.v); }
+	friend TLAP_TARGET_AVX2 pack	rcp(pack a) { return _mm256_rcp_ps(a.v); }
+	friend TLAP_TARGET_AVX2 pack	rsqrt(pack a) { return _mm256_rsqrt_ps(a.v); }
+	friend TLAP_TARGET_AVX2 pack	round(pack a) { return _mm256_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+	friend TLAP_TARGET_AVX2 pack	floor(pack a) { return _mm256_round_ps(a.v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+	friend TLAP_TARGET_AVX2 pack	copysign(pack mag, pack sgn) {
+		__m256 s = _mm256_set1_ps(-0.0f);
+		return _mm256_or_ps(_mm256_andnot_ps(s, mag.v), _mm256_and_ps(s, sgn.v));
+	}
+	friend TLAP_TARGET_AVX2 mask	signbit(pack a) { return {_mm256_castsi256_ps(_mm256_srai_epi32(_mm256_castps_si256(a.v), 31))}; }
+	friend TLAP_TARGET_AVX2 mask	isnan(pack a) { return {_mm256_cmp_ps(a.v, a.v, _CMP_UNORD_Q)}; }
+	friend TLAP_TARGET_AVX2 float	reduce_add(pack a) {
+		__m128 s = _mm_add_ps(_mm256_castps256_ps128(a.v), _mm256_extractf128_ps(a.v, 1));
+		s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+		return _mm_cvtss_f32(_mm_add_ss(s, _mm_movehdup_ps(s)));
+	}
+
+	friend TLAP_TARGET_AVX2 pack	pow2i(pack n) {
+		__m256i e = _mm256_add_epi32(_mm256_cvtps_epi32(n.v), _mm256_set1_epi32(127));
+		return _mm256_castsi256_ps(_mm256_slli_epi32(e, 23));
+	}
+	friend TLAP_TARGET_AVX2 pack	getexp(pack a) {
+		__m256i e = _mm256_srli_epi32(_mm256_castps_si256(a.v), 23);
+		return _mm256_cvtepi32_ps(_mm256_sub_epi32(e, _mm256_set1_epi32(127)));
+	}
+	friend TLAP_TARGET_AVX2 pack	getmant(pack a) {
+		__m256i m = _mm256_and_si256(_mm256_castps_si256(a.v), _mm256_set1_epi32(0x007fffff));
+		return _mm256_castsi256_ps(_mm256_or_si256(m, _mm256_set1_epi32(0x3f800000)));
+	}
+};
+
+template <>
+struct pack<double, isa::avx2> {
+	using value_type = double;
+	using isa_type = isa::avx2;
+	static constexpr size_t width = 4;
+	static constexpr int approx_bits = 9;
+
+	struct mask {
+		__m256d	m;
+		mask	operator&(mask o) const { return {_mm256_and_pd(m, o.m)}; }
+		mask	operator|(mask o) const { return {_mm256_or_pd(m, o.m)}; }
+		mask	operator~() const { return {_mm256_xor_pd(m, _mm256_castsi256_pd(_mm256_set1_epi64x(-1)))}; }
+		bool	any() const { return _mm256_movemask_pd(m) != 0; }
+		bool	all() const { return _mm256_movemask_pd(m) == 0xf; }
+	};
+
+	__m256d	v;
+
+	pack() = default;
+	pack(__m256d x) : v(x) {}
+	pack(double x) : v(_mm256_set1_pd(x)) {}
+
+	static pack	load(const double *p) { return _mm256_load_pd(p); }
+	static pack	loadu(const double *p) { return _mm256_loadu_pd(p); }
+	static pack	gather(const double *base, const uint32_t *index) { return _mm256_i32gather_pd(base, _mm_loadu_si128(reinterpret_cast<const __m128i *>(index)), 8); }
+	void		store(double *p) const { _mm256_store_pd(p, v); }
+	void		storeu(double *p) const { _mm256_storeu_pd(p, v); }
+	// float storage, widened on load and rounded once on store (the precise
+	// float math of math_batch.tpp runs on double packs)
+	static pack	loadu(const float *p) { return _mm256_cvtps_pd(_mm_loadu_ps(p)); }
+	void		storeu(float *p) const { _mm_storeu_ps(p, _mm256_cvtpd_ps(v)); }
+
+	pack	operator-() const { return _mm256_xor_pd(v, _mm256_set1_pd(-0.0)); }
+	friend TLAP_TARGET_AVX2 pack	operator+(pack a, pack b) { return _mm256_add_pd(a.v, b.v); }
+	friend TLAP_TARGET_AVX2 pack	operator-(pack a, pack b) { return _mm256_sub_pd(a.v, b.v); }
+	friend TLAP_TARGET_AVX2 pack	operator*(pack a, pack b) { return _mm256_mul_pd(a.v, b.v); }
+	friend TLAP_TARGET_AVX2 pack	operator/(pack a, pack b) { return _mm256_div_pd(a.v, b.v); }
+
+	friend TLAP_TARGET_AVX2 mask	operator<(pack a, pack b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ)}; }
+	friend TLAP_TARGET_AVX2 mask	operator<=(pack a, pack b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_LE_OQ)}; }
+	friend TLAP_TARGET_AVX2 mask	operator>(pack a, pack b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ)}; }
+	friend TLAP_TARGET_AVX2 mask	operator>=(pack a, pack b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_GE_OQ)}; }
+	friend TLAP_TARGET_AVX2 mask	operator==(pack a, pack b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_EQ_OQ)}; }
+
+	friend TLAP_TARGET_AVX2 pack	fma(pack a, pack b, pack c) { return _mm256_fmadd_pd(a.v, b.v, c.v); }
+	friend TLAP_TARGET_AVX2 pack	select(mask m, pack a, pack b) { return _mm256_blendv_pd(b.v, a.v, m.m); }
+	friend TLAP_TARGET_AVX2 pack	min(pack a, pack b) { return _mm256_min_pd(a.v, b.v); }
+	friend TLAP_TARGET_AVX2 pack	max(pack a, pack b) { return _mm256_max_pd(a.v, b.v); }
+	friend TLAP_TARGET_AVX2 pack	abs(pack a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v); }
+	friend TLAP_TARGET_AVX2 pack	sqrt(pack a) { return _mm256_sqrt_pd(a.v); }
+	// no double estimate before AVX-512: rcp goes through the float one (float
+	// range only), rsqrt is the exponent-halving bit trick plus one Newton step,
+	// which covers the whole double range with about 9 correct bits
+	friend TLAP_TARGET_AVX2 pack	rcp(pack a) { return _mm256_cvtps_pd(_mm_rcp_ps(_mm256_cvtpd_ps(a.v))); }
+	friend TLAP_TARGET_AVX2 pack	rsqrt(pack a) {
+		__m256i i = _mm256_sub_epi64(_mm256_set1_epi64x(0x5fe6eb50c7b537a9LL), _mm256_srli_epi64(_mm256_castpd_si256(a.v), 1));
+		__m256d y = _mm256_castsi256_pd(i);
+		__m256d h = _mm256_mul_pd(_mm256_mul_pd(a.v, _mm256_set1_pd(-0.5)), y);
+		return _mm256_mul_pd(y, _mm256_fmadd_pd(h, y, _mm256_set1_pd(1.5)));
+	}
+	friend TLAP_TARGET_AVX2 pack	round(pack a) { return _mm256_round_pd(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+	friend TLAP_TARGET_AVX2 pack	floor(pack a) { return _mm256_round_pd(a.v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+	friend TLAP_TARGET_AVX2 pack	copysign(pack mag, pack sgn) {
+		__m256d s = _mm256_set1_pd(-0.0);
+		return _mm256_or_pd(_mm256_andnot_pd(s, mag.v), _mm256_and_pd(s, sgn.v));
+	}
+	friend TLAP_TARGET_AVX2 mask	signbit(pack a) {
+		return {_mm256_castsi256_pd(_mm256_cmpgt_epi64(_mm256_setzero_si256(), _mm256_castpd_si256(a.v)))};
+	}
+	friend TLAP_TARGET_AVX2 mask	isnan(pack a) { return {_mm256_cmp_pd(a.v, a.v, _CMP_UNORD_Q)}; }
+	friend TLAP_TARGET_AVX2 double	reduce_add(pack a) {
+		__m128d s = _mm_add_pd(_mm256_castpd256_pd128(a.v), _mm256_extractf128_pd(a.v, 1));
+		return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+	}
+
+	// no int64 <-> double conversion before AVX-512DQ: adding 1.5 * 2^52 leaves
+	// the integer in the low mantissa bits, and the shift drops everything else
+	friend TLAP_TARGET_AVX2 pack	pow2i(pack n) {
+		__m256i i = _mm256_castpd_si256(_mm256_add_pd(n.v, _mm256_set1_pd(6755399441055744.0)));
+		return _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_add_epi64(i, _mm256_set1_epi64x(1023)), 52));
+	}
+	friend TLAP_TARGET_AVX2 pack	getexp(pack a) {
+		__m256i e = _mm256_srli_epi64(_mm256_castpd_si256(a.v), 52);
+		__m256d two52 = _mm256_set1_pd(4503599627370496.0);
+		__m256d d = _mm256_castsi256_pd(_mm256_or_si256(e, _mm256_castpd_si256(two52)));
+		return _mm256_sub_pd(d, _mm256_set1_pd(4503599627370496.0 + 1023.0));
+	}
+	friend TLAP_TARGET_AVX2 pack	getmant(pack a) {
+		__m256i m = _mm256_and_si256(_mm256_castpd_si256(a.v), _mm256_set1_epi64x(0x000fffffffffffffLL));
+		return _mm256_castsi256_pd(_mm256_or_si256(m, _mm256_set1_epi64x(0x3ff0000000000000LL)));
+	}
+};
+#pragma GCC pop_options
+
+
+// ---------------------------------------------------------------------------
+// AVX-512 F + DQ, 512-bit
+// ---------------------------------------------------------------------------
+
+#pragma GCC push_options
+#if !(defined(__AVX512F__) && defined(__AVX512DQ__))
+# pragma GCC target("avx512f,avx512dq")
+#endif
+
+template <>
+struct pack<float, isa::avx512> {
+	using value_type = float;
+	using isa_type = isa::avx512;
+	static constexpr size_t width = 16;
+	static constexpr int approx_bits = 14;
+
+	struct mask {
+		__mmask16	m;
+		mask	operator&(mask o) const { return {static_cast<__mmask16>(m & o.m)}; }
+		mask	operator|(mask o) const { return {static_cast<__mmask16>(m | o.m)}; }
+		mask	operator~() const { return {static_cast<__mmask16>(~m)}; }
+		bool	any() const { return m != 0; }
+		bool	all() const { return m == 0xffff; }
+	};
+
+	__m512	v;
+
+	pack() = default;
+	pack(__m512 x) : v(x) {}
+	pack(float x) : v(_mm512_set1_ps(x)) {}
+
+	static pack	load(const float *p) { return _mm512_load_ps(p); }
+	static pack	loadu(const float *p) { return _mm512_loadu_ps(p); }
+	static pack	gather(const float *base, const uint32_t *index) { return _mm512_i32gather_ps(_mm512_loadu_si512(index), base, 4); }
+	void		store(float *p) const { _mm512_store_ps(p, v); }
+	void		storeu(float *p) const { _mm512_storeu_ps(p, v); }
+	static pack	load(const half *p) { return _mm512_cvtph_ps(_mm256_load_si256(reinterpret_cast<const __m256i *>(p))); }
+	static pack	loadu(const half *p) { return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p))); }
+	static pack	load(const bfloat16 *p) { return widen(_mm256_load_si256(reinterpret_cast<const __m256i *>(p))); }
+	static pack	loadu(const bfloat16 *p) { return widen(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p))); }
+	void		store(half *p) const { _mm256_store_si256(reinterpret_cast<__m256i *>(p), _mm512_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT)); }
+	void		storeu(half *p) const { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), _mm512_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT)); }
+	void		store(bfloat16 *p) const { _mm256_store_si256(reinterpret_cast<__m256i *>(p), narrow()); }
+	void		storeu(bfloat16 *p) const { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), narrow()); }
+
+	static pack	widen(__m256i h) { return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(h), 16)); }
+	__m256i		narrow() const {
+		const __m512i	u = _mm512_castps_si512(v);
+		__m512i			r = _mm512_add_epi32(u, _mm512_add_epi32(_mm512_set1_epi32(0x7fff), _mm512_and_si512(_mm512_srli_epi32(u, 16), _mm512_set1_epi32(1))));
+		r = _mm512_mask_or_epi32(r, _mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q), u, _mm512_set1_epi32(0x400000));
+		return _mm512_cvtepi32_epi16(_mm512_srli_epi32(r, 16));
+	}
+
+	pack	operator-() const { return _mm512_xor_ps(v, _mm512_set1_ps(-0.0f)); }
+	friend TLAP_TARGET_AVX512 pack	operator+(pack a, pack b) { return _mm512_add_ps(a.v, b.v); }
+	friend TLAP_TARGET_AVX512 pack	operator-(pack a, pack b) { return _mm512_sub_ps(a.v, b.v); }
+	friend TLAP_TARGET_AVX512 pack	operator*(pack a, pack b) { return _mm512_mul_ps(a.v, b.v); }
+	friend TLAP_TARGET_AVX512 pack	operator/(pack a, pack b) { return _mm512_div_ps(a.v, b.v); }
+
+	friend TLAP_TARGET_AVX512 mask	operator<(pack a, pack b) { return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ)}; }
+	friend TLAP_TARGET_AVX512 mask	operator<=(pack a, pack b) { return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_LE_OQ)}; }
+	friend TLAP_TARGET_AVX512 mask	operator>(pack a, pack b) { return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_GT_OQ)}; }
+	friend TLAP_TARGET_AVX512 mask	operator>=(pack a, pack b) { return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_GE_OQ)}; }
+	friend TLAP_TARGET_AVX512 mask	operator==(pack a, pack b) { return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_EQ_OQ)}; }
+
+	friend TLAP_TARGET_AVX512 pack	fma(pack a, pack b, pack c) { return _mm512_fmadd_ps(a.v, b.v, c.v); }
+	friend TLAP_TARGET_AVX512 pack	select(mask m, pack a, pack b) { return _mm512_mask_blend_ps(m.m, b.v, a.v); }
+	friend TLAP_TARGET_AVX512 pack	min(pack a, pack b) { return _mm512_min_ps(a.v, b.v); }
+	friend TLAP_TARGET_AVX512 pack	max(pack a, pack b) { return _mm512_max_ps(a.v, b.v); }
+	friend TLAP_TARGET_AVX512 pack	abs(pack a) { return _mm512_abs_ps(a.v); }
+	friend TLAP_TARGET_AVX512 pack	sqrt(pack a) { return _mm512_sqrt_ps(a.v); }
+	friend TLAP_TARGET_AVX512 pack	rcp(pack a) { return _mm512_rcp14_ps(a.v); }
+	friend TLAP_TARGET_AVX512 pack	rsqrt(pack a) { return _mm512_rsqrt14_ps(a.v); }
+	friend TLAP_TARGET_AVX512 pack	round(pack a) { return _mm512_roundscale_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+	friend TLAP_TARGET_AVX512 pack	floor(pack a) { return _mm512_roundscale_ps(a.v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+	friend TLAP_TARGET_AVX512 pack	copysign(pack mag, pack sgn) {
+		__m512 s = _mm512_set1_ps(-0.0f);
+		return _mm512_or_ps(_mm512_andnot_ps(s, mag.v), _mm512_and_ps(s, sgn.v));
+	}
+	friend TLAP_TARGET_AVX512 mask	signbit(pack a) { return {_mm512_movepi32_mask(_mm512_castps_si512(a.v))}; }
+	friend TLAP_TARGET_AVX512 mask	isnan(pack a) { return {_mm512_cmp_ps_mask(a.v, a.v, _CMP_UNORD_Q)}; }
+	friend TLAP_TARGET_AVX512 float	reduce_add(pack a) { return _mm512_reduce_add_ps(a.v); }
+
+	friend TLAP_TARGET_AVX512 pack	pow2i(pack n) {
+		__m512i e = _mm512_add_epi32(_mm512_cvtps_epi32(n.v), _mm512_set1_epi32(127));
+		return _mm512_castsi512_ps(_mm512_slli_epi32(e, 23));
+	}
+	friend TLAP_TARGET_AVX512 pack	getexp(pack a) { return _mm512_getexp_ps(a.v); }
+	friend TLAP_TARGET_AVX512 pack	getmant(pack a) { return _mm512_getmant_ps(a.v, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_src); }
+};
+
+template <>
+struct pack<double, isa::avx512> {
+	using value_type = double;
+	using isa_type = isa::avx512;
+	static constexpr size_t width = 8;
+	static constexpr int approx_bits = 14;
+
+	struct mask {
+		__mmask8	m;
+		mask	operator&(mask o) const { return {static_cast<__mmask8>(m & o.m)}; }
+		mask	operator|(mask o) const { return {static_cast<__mmask8>(m | o.m)}; }
+		mask	operator~() const { return {static_cast<__mmask8>(~m)}; }
+		bool	any() const { return m != 0; }
+		bool	all() const { return m == 0xff; }
+	};
+
+	__m512d	v;
+
+	pack() = default;
+	pack(__m512d x) : v(x) {}
+	pack(double x) : v(_mm512_set1_pd(x)) {}
+
+	static pack	load(const double *p) { return _mm512_load_pd(p); }
+	static pack	loadu(const double *p) { return _mm512_loadu_pd(p); }
+	static pack	gather(const double *base, const uint32_t *index) { return _mm512_i32gather_pd(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(index)), base, 8); }
+	void		store(double *p) const { _mm512_store_pd(p, v); }
+	void		storeu(double *p) const { _mm512_storeu_pd(p, v); }
+	// float storage, as the AVX2 pack
+	static pack	loadu(const float *p) { return _mm512_cvtps_pd(_mm256_loadu_ps(p)); }
+	void		storeu(float *p) const { _mm256_storeu_ps(p, _mm512_cvtpd_ps(v)); }
+
+	pack	operator-() const { return _mm512_xor_pd(v, _mm512_set1_pd(-0.0)); }
+	friend TLAP_TARGET_AVX512 pack	operator+(pack a, pack b) { return _mm512_add_pd(a.v, b.v); }
+	friend TLAP_TARGET_AVX512 pack	operator-(pack a, pack b) { return _mm512_sub_pd(a.v, b.v); }
+	friend TLAP_TARGET_AVX512 pack	operator*(pack a, pack b) { return _mm512_mul_pd(a.v, b.v); }
+	friend TLAP_TARGET_AVX512 pack	operator/(pack a, pack b) { return _mm512_div_pd(a.v, b.v); }
+
+	friend TLAP_TARGET_AVX512 mask	operator<(pack a, pack b) { return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_LT_OQ)}; }
+	friend TLAP_TARGET_AVX512 mask	operator<=(pack a, pack b) { return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_LE_OQ)}; }
+	friend TLAP_TARGET_AVX512 mask	operator>(pack a, pack b) { return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_GT_OQ)}; }
+	friend TLAP_TARGET_AVX512 mask	operator>=(pack a, pack b) { return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_GE_OQ)}; }
+	friend TLAP_TARGET_AVX512 mask	operator==(pack a, pack b) { return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_EQ_OQ)}; }
+
+	friend TLAP_TARGET_AVX512 pack	fma(pack a, pack b, pack c) { return _mm512_fmadd_pd(a.v, b.v, c.v); }
+	friend TLAP_TARGET_AVX512 pack	select(mask m, pack a, pack b) { return _mm512_mask_blend_pd(m.m, b.v, a.v); }
+	friend TLAP_TARGET_AVX512 pack	min(pack a, pack b) { return _mm512_min_pd(a.v, b.v); }
+	friend TLAP_TARGET_AVX512 pack	max(pack a, pack b) { return _mm512_max_pd(a.v, b.v); }
+	friend TLAP_TARGET_AVX512 pack	abs(pack a) { return _mm512_abs_pd(a.v); }
+	friend TLAP_TARGET_AVX512 pack	sqrt(pack a) { return _mm512_sqrt_pd(a.v); }
+	friend TLAP_TARGET_AVX512 pack	rcp(pack a) { return _mm512_rcp14_pd(a.v); }
+	friend TLAP_TARGET_AVX512 pack	rsqrt(pack a) { return _mm512_rsqrt14_pd(a.v); }
+	friend TLAP_TARGET_AVX512 pack	round(pack a) { return _mm512_roundscale_pd(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+	friend TLAP_TARGET_AVX512 pack	floor(pack a) { return _mm512_roundscale_pd(a.v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+	friend TLAP_TARGET_AVX512 pack	copysign(pack mag, pack sgn) {
+		__m512d s = _mm512_set1_pd(-0.0);
+		return _mm512_or_pd(_mm512_andnot_pd(s, mag.v), _mm512_and_pd(s, sgn.v));
+	}
+	friend TLAP_TARGET_AVX512 mask	signbit(pack a) { return {_mm512_movepi64_mask(_mm512_castpd_si512(a.v))}; }
+	friend TLAP_TARGET_AVX512 mask	isnan(pack a) { return {_mm512_cmp_pd_mask(a.v, a.v, _CMP_UNORD_Q)}; }
+	friend TLAP_TARGET_AVX512 double	reduce_add(pack a) { return _mm512_reduce_add_pd(a.v); }
+
+	friend TLAP_TARGET_AVX512 pack	pow2i(pack n) {
+		__m512i e = _mm512_add_epi64(_mm512_cvtpd_epi64(n.v), _mm512_set1_epi64(1023));
+		return _mm512_castsi512_pd(_mm512_slli_epi64(e, 52));
+	}
+	friend TLAP_TARGET_AVX512 pack	getexp(pack a) { return _mm512_getexp_pd(a.v); }
+	friend TLAP_TARGET_AVX512 pack	getmant(pack a) { return _mm512_getmant_pd(a.v, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_src); }
+};
+#pragma GCC pop_options
+
+} // namespace tlap::simd